@@ -29,6 +29,7 @@
 #include <cerrno>
 //#include <cstring>
 #include <dirent.h>
+#include <algorithm>
 #include <map>
 
 #include <SDL/SDL.h>
@@ -63,6 +64,9 @@ using namespace std;
 #define DIR_SEPARATOR "/"
 #define DIR_SEPARATOR_CHAR '/'
 
+#define ATLAS_GUTTER 1 // pixels of repeated edge around each packed image, so filtering doesn't pick up its neighbours
+#define ATLAS_ALIGN  4 // packed images start on a DXT block
+
 int NP2( unsigned x )
 {
   --x;
@@ -257,9 +261,8 @@ bool HasAlpha(unsigned char *argb, unsigned int width, unsigned int height)
   return false;
 }
 
-CXBTFFrame createXBTFFrame(SDL_Surface* image, CXBTFWriter& writer, double maxMSE, unsigned int flags)
+SDL_Surface* ConvertToARGB(SDL_Surface* image)
 {
-  // Convert to ARGB
   SDL_PixelFormat argbFormat;
   memset(&argbFormat, 0, sizeof(SDL_PixelFormat));
   argbFormat.BitsPerPixel = 32;
@@ -286,9 +289,16 @@ CXBTFFrame createXBTFFrame(SDL_Surface* image, CXBTFWriter& writer, double maxMS
   argbFormat.Bshift = 0;
 #endif
 
+  return SDL_ConvertSurface(image, &argbFormat, 0);
+}
+
+CXBTFFrame createXBTFFrame(SDL_Surface* image, CXBTFWriter& writer, double maxMSE, unsigned int flags)
+{
+  // Convert to ARGB
+  SDL_Surface *argbImage = ConvertToARGB(image);
+
   int width, height;
   unsigned int format = 0;
-  SDL_Surface *argbImage = SDL_ConvertSurface(image, &argbFormat, 0);
   unsigned char* argb = (unsigned char*)argbImage->pixels;
   unsigned int compressedSize = 0;
   unsigned char* compressed = NULL;
@@ -373,6 +383,83 @@ void Usage()
   puts("  -use_lzo         Use lz0 packing.     Default: on");
   puts("  -use_dxt         Use DXT compression. Default: on");
   puts("  -use_none        Use No  compression. Default: off");
+  puts("  -atlas           Pack small images into shared atlas pages. Default: off");
+  puts("  -atlas_size <n>  Width and height of the atlas pages. Default: 1024");
+}
+
+struct AtlasImage
+{
+  unsigned int file;    // index into the bundle's files
+  SDL_Surface* argb;    // the image, converted to ARGB
+  bool hasAlpha;
+  int x, y;             // position of the image within its page
+  unsigned int page;
+};
+
+static bool compareAtlasHeight(const AtlasImage* a, const AtlasImage* b)
+{
+  if (a->argb->h != b->argb->h)
+    return a->argb->h > b->argb->h;
+  return a->argb->w > b->argb->w;
+}
+
+static int alignAtlas(int size)
+{
+  return (size + ATLAS_ALIGN - 1) & ~(ATLAS_ALIGN - 1);
+}
+
+// copy an image into its page, repeating its edge pixels out into the gutter
+static void blitAtlasImage(const AtlasImage& image, SDL_Surface* page)
+{
+  SDL_Surface* src = image.argb;
+  for (int y = -ATLAS_GUTTER; y < src->h + ATLAS_GUTTER; y++)
+  {
+    int srcY = std::min(std::max(y, 0), src->h - 1);
+    const uint32_t* srcRow = (const uint32_t*)((const uint8_t*)src->pixels + srcY * src->pitch);
+    uint32_t* dstRow = (uint32_t*)((uint8_t*)page->pixels + (image.y + y) * page->pitch) + image.x;
+    for (int x = -ATLAS_GUTTER; x < 0; x++)
+      dstRow[x] = srcRow[0];
+    memcpy(dstRow, srcRow, src->w * 4);
+    for (int x = src->w; x < src->w + ATLAS_GUTTER; x++)
+      dstRow[x] = srcRow[src->w - 1];
+  }
+}
+
+/*! \brief Shelf-pack the images (next fit, decreasing height) into pages of the given size.
+ Each image gets a gutter of repeated edge pixels and a cell aligned to DXT blocks.
+ \return the number of pages used. pageHeights receives the used height of each page.
+ */
+static unsigned int packAtlas(vector<AtlasImage*>& images, int size, vector<int>& pageHeights)
+{
+  std::sort(images.begin(), images.end(), compareAtlasHeight);
+
+  int shelfX = 0, shelfY = 0, shelfHeight = 0;
+  pageHeights.clear();
+  for (size_t i = 0; i < images.size(); i++)
+  {
+    AtlasImage* image = images[i];
+    int cellWidth = alignAtlas(image->argb->w + 2 * ATLAS_GUTTER);
+    int cellHeight = alignAtlas(image->argb->h + 2 * ATLAS_GUTTER);
+    if (pageHeights.empty())
+      pageHeights.push_back(0);
+    if (shelfX + cellWidth > size)
+    { // next shelf
+      shelfY += shelfHeight;
+      shelfX = shelfHeight = 0;
+    }
+    if (shelfY + cellHeight > size)
+    { // next page
+      pageHeights.push_back(0);
+      shelfX = shelfY = shelfHeight = 0;
+    }
+    image->page = pageHeights.size() - 1;
+    image->x = shelfX + ATLAS_GUTTER;
+    image->y = shelfY + ATLAS_GUTTER;
+    shelfX += cellWidth;
+    shelfHeight = std::max(shelfHeight, cellHeight);
+    pageHeights.back() = shelfY + shelfHeight;
+  }
+  return pageHeights.size();
 }
 
 static bool checkDupe(struct MD5Context* ctx,
@@ -402,10 +489,11 @@ static bool checkDupe(struct MD5Context* ctx,
   return false;
 }
 
-int createBundle(const std::string& InputDir, const std::string& OutputFile, double maxMSE, unsigned int flags, bool dupecheck)
+int createBundle(const std::string& InputDir, const std::string& OutputFile, double maxMSE, unsigned int flags, bool dupecheck, int atlasSize)
 {
   map<string,unsigned int> hashes;
   vector<unsigned int> dupes;
+  vector<AtlasImage*> atlasImages;
   CXBTF xbtf;
   CreateSkeletonHeader(xbtf, InputDir);
   dupes.resize(xbtf.GetFiles().size());
@@ -460,6 +548,18 @@ int createBundle(const std::string& InputDir, const std::string& OutputFile, dou
         }
       }
 
+      if (!skip && atlasSize > 0 && image->w <= atlasSize / 8 && image->h <= atlasSize / 8)
+      { // small enough to share a page - packed once we've seen everything
+        AtlasImage* atlasImage = new AtlasImage;
+        atlasImage->file = i;
+        atlasImage->argb = ConvertToARGB(image);
+        atlasImage->hasAlpha = HasAlpha((unsigned char*)atlasImage->argb->pixels, image->w, image->h);
+        atlasImages.push_back(atlasImage);
+        printf("(atlas)\n");
+        file.SetLoop(0);
+        skip = true;
+      }
+
       if (!skip)
       {
         CXBTFFrame frame = createXBTFFrame(image, writer, maxMSE, flags);
@@ -515,6 +615,79 @@ int createBundle(const std::string& InputDir, const std::string& OutputFile, dou
     }
   }
 
+  if (!atlasImages.empty())
+  {
+    vector<int> pageHeights;
+    unsigned int numPages = packAtlas(atlasImages, atlasSize, pageHeights);
+    for (unsigned int page = 0; page < numPages; page++)
+    {
+      SDL_Surface* pageImage = SDL_CreateRGBSurface(SDL_SWSURFACE, atlasSize, alignAtlas(pageHeights[page]), 32,
+                                                    atlasImages[0]->argb->format->Rmask, atlasImages[0]->argb->format->Gmask,
+                                                    atlasImages[0]->argb->format->Bmask, atlasImages[0]->argb->format->Amask);
+      if (!pageImage)
+      {
+        printf("Error creating atlas page %u\n", page);
+        return 1;
+      }
+      memset(pageImage->pixels, 0, pageImage->h * pageImage->pitch);
+      for (size_t j = 0; j < atlasImages.size(); j++)
+      {
+        if (atlasImages[j]->page == page)
+          blitAtlasImage(*atlasImages[j], pageImage);
+      }
+
+      char pageName[32];
+      sprintf(pageName, XBTF_ATLAS_PREFIX "%u", page);
+      std::string output = pageName;
+      while (output.size() < 46)
+        output += ' ';
+      printf("%s", output.c_str());
+
+      CXBTFFile pageFile;
+      pageFile.SetPath(pageName);
+      pageFile.SetLoop(0);
+      CXBTFFrame pageFrame = createXBTFFrame(pageImage, writer, maxMSE, flags);
+      printf("%s%c (%d,%d @ %"PRIu64" bytes)\n", GetFormatString(pageFrame.GetFormat()), pageFrame.HasAlpha() ? ' ' : '*',
+        pageFrame.GetWidth(), pageFrame.GetHeight(), pageFrame.GetUnpackedSize());
+      pageFile.GetFrames().push_back(pageFrame);
+      SDL_FreeSurface(pageImage);
+
+      unsigned int pageIndex = files.size();
+      files.push_back(pageFile);
+      dupes.push_back(pageIndex);
+
+      for (size_t j = 0; j < atlasImages.size(); j++)
+      {
+        AtlasImage* image = atlasImages[j];
+        if (image->page != page)
+          continue;
+        // the frame is only a window onto the page - it has no content of its own
+        CXBTFFrame frame;
+        frame.SetWidth(image->argb->w);
+        frame.SetHeight(image->argb->h);
+        frame.SetFormat(pageFrame.GetFormat() | (image->hasAlpha ? 0 : XB_FMT_OPAQUE));
+        frame.SetPackedSize(0);
+        frame.SetUnpackedSize(0);
+        frame.SetAtlas(pageIndex, image->x, image->y);
+        files[image->file].GetFrames().push_back(frame);
+      }
+    }
+    printf("Packed %u images into %u atlas pages\n", (unsigned int)atlasImages.size(), numPages);
+
+    for (size_t j = 0; j < atlasImages.size(); j++)
+    {
+      SDL_FreeSurface(atlasImages[j]->argb);
+      delete atlasImages[j];
+    }
+
+    // duplicates of atlased images were found before their original had a frame
+    for (size_t j = 0; j < files.size(); j++)
+    {
+      if (dupes[j] != j && files[j].GetFrames().empty())
+        files[j].GetFrames() = files[dupes[j]].GetFrames();
+    }
+  }
+
   if (!writer.UpdateHeader(dupes))
   {
     printf("Error writing header to file\n");
@@ -539,6 +712,7 @@ int main(int argc, char* argv[])
   bool valid = false;
   unsigned int flags = 0;
   bool dupecheck = false;
+  int atlasSize = 0;
   CmdLineArgs args(argc, (const char**)argv);
 
   // setup some defaults, dxt with lzo post packing,
@@ -589,6 +763,15 @@ int main(int argc, char* argv[])
     {
       flags |= FLAGS_USE_DXT;
     }
+    else if (!stricmp(args[i], "-atlas"))
+    {
+      if (!atlasSize)
+        atlasSize = 1024;
+    }
+    else if (!stricmp(args[i], "-atlas_size"))
+    {
+      atlasSize = alignAtlas(atoi(args[++i]));
+    }
 #ifdef USE_LZO_PACKING
     else if (!stricmp(args[i], "-use_lzo"))
     {
@@ -612,5 +795,5 @@ int main(int argc, char* argv[])
     InputDir += DIR_SEPARATOR;
 
   double maxMSE = 1.5;    // HQ only please
-  createBundle(InputDir, OutputFilename, maxMSE, flags, dupecheck);
+  createBundle(InputDir, OutputFilename, maxMSE, flags, dupecheck, atlasSize);
 }
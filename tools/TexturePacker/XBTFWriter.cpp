@@ -105,12 +105,30 @@ bool CXBTFWriter::UpdateHeader(const std::vector<unsigned int>& dupes)
     return false;
   }
 
+  std::vector<CXBTFFile>& files = m_xbtf.GetFiles();
+
+  // only bundles with atlas pages need the version 3 frame header, anything
+  // else stays readable by older versions
+  char version = XBTF_VERSION_MIN[0];
+  for (size_t i = 0; i < files.size() && version != XBTF_VERSION[0]; i++)
+  {
+    std::vector<CXBTFFrame>& frames = files[i].GetFrames();
+    for (size_t j = 0; j < frames.size(); j++)
+    {
+      if (frames[j].GetAtlas() != XBTF_NO_ATLAS)
+      {
+        version = XBTF_VERSION[0];
+        break;
+      }
+    }
+  }
+  m_xbtf.SetVersion(version);
+
   uint64_t offset = m_xbtf.GetHeaderSize();
 
   WRITE_STR(XBTF_MAGIC, 4, m_file);
-  WRITE_STR(XBTF_VERSION, 1, m_file);
+  WRITE_STR(&version, 1, m_file);
 
-  std::vector<CXBTFFile>& files = m_xbtf.GetFiles();
   WRITE_U32(files.size(), m_file);
   for (size_t i = 0; i < files.size(); i++)
   {
@@ -147,6 +165,12 @@ bool CXBTFWriter::UpdateHeader(const std::vector<unsigned int>& dupes)
       WRITE_U64(frame.GetUnpackedSize(), m_file);
       WRITE_U32(frame.GetDuration(), m_file);
       WRITE_U64(frame.GetOffset(), m_file);
+      if (version >= '3')
+      {
+        WRITE_U32(frame.GetAtlas(), m_file);
+        WRITE_U32(frame.GetAtlasX(), m_file);
+        WRITE_U32(frame.GetAtlasY(), m_file);
+      }
     }
   }
 
@@ -2322,6 +2322,8 @@ void CApplication::Render()
   if(!g_Windowing.BeginRender())
     return;
 
+  g_largeTextureManager.UploadImages();
+  g_windowManager.SetBufferAge(g_Windowing.GetBufferAge());
   CDirtyRegionList dirtyRegions = g_windowManager.GetDirty();
   if (RenderNoPresent())
     hasRendered = true;
@@ -722,6 +722,31 @@ void CFileItem::ToSortable(SortItem &sortable)
     GetPVRChannelInfoTag()->ToSortable(sortable);
 }
 
+size_t CFileItem::GetMemoryUsage() const
+{
+  size_t size = CGUIListItem::GetMemoryUsage() - sizeof(CGUIListItem) + sizeof(CFileItem);
+  size += m_strPath.capacity() + m_mimetype.capacity() + m_extrainfo.capacity();
+  size += m_strDVDLabel.capacity() + m_strTitle.capacity() + m_strLockCode.capacity();
+
+  // the tags are only allocated once they are asked for, count their objects
+  if (m_musicInfoTag)
+    size += sizeof(*m_musicInfoTag);
+  if (m_videoInfoTag)
+    size += sizeof(*m_videoInfoTag);
+  if (m_epgInfoTag)
+    size += sizeof(*m_epgInfoTag);
+  if (m_pvrChannelInfoTag)
+    size += sizeof(*m_pvrChannelInfoTag);
+  if (m_pvrRecordingInfoTag)
+    size += sizeof(*m_pvrRecordingInfoTag);
+  if (m_pvrTimerInfoTag)
+    size += sizeof(*m_pvrTimerInfoTag);
+  if (m_pictureInfoTag)
+    size += sizeof(*m_pictureInfoTag);
+
+  return size;
+}
+
 bool CFileItem::Exists(bool bUseCache /* = true */) const
 {
   if (m_strPath.IsEmpty()
@@ -1717,7 +1742,8 @@ void CFileItemList::Assign(const CFileItemList& itemlist, bool append)
   m_sortDetails = itemlist.m_sortDetails;
   m_replaceListing = itemlist.m_replaceListing;
   m_content = itemlist.m_content;
-  m_mapProperties = itemlist.m_mapProperties;
+  m_properties = itemlist.m_properties;
+  m_namedProperties = itemlist.m_namedProperties;
   m_cacheToDisc = itemlist.m_cacheToDisc;
 }
 
@@ -1729,7 +1755,8 @@ bool CFileItemList::Copy(const CFileItemList& items, bool copyItems /* = true */
   // assign the rest of the CFileItemList properties
   m_replaceListing = items.m_replaceListing;
   m_content        = items.m_content;
-  m_mapProperties  = items.m_mapProperties;
+  m_properties     = items.m_properties;
+  m_namedProperties = items.m_namedProperties;
   m_cacheToDisc    = items.m_cacheToDisc;
   m_sortDetails    = items.m_sortDetails;
   m_sortMethod     = items.m_sortMethod;
@@ -1910,6 +1937,16 @@ void CFileItemList::Randomize()
   random_shuffle(m_items.begin(), m_items.end());
 }
 
+size_t CFileItemList::GetMemoryUsage() const
+{
+  CSingleLock lock(m_lock);
+  size_t size = CFileItem::GetMemoryUsage() - sizeof(CFileItem) + sizeof(CFileItemList);
+  size += m_items.capacity() * sizeof(CFileItemPtr);
+  for (VECFILEITEMS::const_iterator it = m_items.begin(); it != m_items.end(); ++it)
+    size += (*it)->GetMemoryUsage();
+  return size;
+}
+
 void CFileItemList::Archive(CArchive& ar)
 {
   CSingleLock lock(m_lock);
@@ -92,6 +92,7 @@ public:
   CFileItem(const CMediaSource& share);
   virtual ~CFileItem(void);
   virtual CGUIListItem *Clone() const { return new CFileItem(*this); };
+  virtual size_t GetMemoryUsage() const;
 
   const CStdString &GetPath() const { return m_strPath; };
   void SetPath(const CStdString &path) { m_strPath = path; };
@@ -414,6 +415,7 @@ private:
   bool m_bIsParentFolder;
   bool m_bCanQueue;
   bool m_bLabelPreformated;
+  bool m_bIsAlbum;
   CStdString m_mimetype;
   CStdString m_extrainfo;
   MUSIC_INFO::CMusicInfoTag* m_musicInfoTag;
@@ -423,7 +425,6 @@ private:
   PVR::CPVRRecording* m_pvrRecordingInfoTag;
   PVR::CPVRTimerInfoTag * m_pvrTimerInfoTag;
   CPictureInfoTag* m_pictureInfoTag;
-  bool m_bIsAlbum;
 };
 
 /*!
@@ -478,6 +479,7 @@ public:
   CFileItemList(const CStdString& strPath);
   virtual ~CFileItemList();
   virtual void Archive(CArchive& ar);
+  virtual size_t GetMemoryUsage() const;
   CFileItemPtr operator[] (int iItem);
   const CFileItemPtr operator[] (int iItem) const;
   CFileItemPtr operator[] (const CStdString& strPath);
@@ -65,6 +65,7 @@
 #include "storage/MediaManager.h"
 #include "utils/TimeUtils.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 
 #include "pvr/PVRManager.h"
@@ -108,6 +109,9 @@ CGUIInfoManager::CGUIInfoManager(void) :
   m_frameCounter = 0;
   m_lastFPSTime = 0;
   m_updateTime = 1;
+  m_clockTicks = 0;
+  m_lastClock = 0;
+  m_lastProfileLog = 0;
   m_MusicBitrate = 0;
   m_playerShowTime = false;
   m_playerShowCodec = false;
@@ -2013,10 +2017,119 @@ bool CGUIInfoManager::EvaluateBool(const CStdString &expression, int contextWind
 bool CGUIInfoManager::GetBoolValue(unsigned int expression, const CGUIListItem *item)
 {
   if (expression && --expression < m_bools.size())
-    return m_bools[expression]->Get(m_updateTime, item);
+  {
+    InfoBool *info = m_bools[expression];
+    unsigned int stamp = GetDependencyStamp(info->GetDependencies());
+    if (!g_advancedSettings.m_guiProfileConditions)
+      return info->Get(stamp, item);
+
+    int64_t start = CurrentHostCounter();
+    bool result = info->Get(stamp, item);
+    if (m_boolCosts.size() < m_bools.size())
+      m_boolCosts.resize(m_bools.size());
+    m_boolCosts[expression].count++;
+    m_boolCosts[expression].time += CurrentHostCounter() - start;
+    return result;
+  }
   return false;
 }
 
+unsigned int CGUIInfoManager::GetDependencies(unsigned int expression) const
+{
+  if (expression && --expression < m_bools.size())
+    return m_bools[expression]->GetDependencies();
+  return DEPENDS_ON_FRAME;
+}
+
+static bool IsListItemInfo(int info)
+{
+  return info >= LISTITEM_START && info < LISTITEM_END;
+}
+
+unsigned int CGUIInfoManager::GetConditionDependencies(int condition) const
+{
+  condition = abs(condition);
+  if (IsListItemInfo(condition))
+    return DEPENDS_ON_FRAME | DEPENDS_ON_ITEM;
+
+  if (condition == SYSTEM_ALWAYS_TRUE || condition == SYSTEM_ALWAYS_FALSE ||
+      condition == SYSTEM_ETHERNET_LINK_ACTIVE || condition == SYSTEM_HAS_PVR ||
+      (condition >= SYSTEM_PLATFORM_LINUX && condition <= SYSTEM_PLATFORM_ANDROID))
+    return 0;
+
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END &&
+      condition - MULTI_INFO_START < (int)m_multiInfo.size())
+  {
+    const GUIInfo &info = m_multiInfo[condition - MULTI_INFO_START];
+    int multiCondition = abs(info.m_info);
+    if (multiCondition >= LISTITEM_START && multiCondition <= LISTITEM_END)
+      return DEPENDS_ON_FRAME | DEPENDS_ON_ITEM;
+
+    switch (multiCondition)
+    {
+    case SKIN_BOOL:
+    case SKIN_STRING:
+      return DEPENDS_ON_SKIN_SETTINGS;
+    case SYSTEM_TIME:
+    case SYSTEM_DATE:
+      return DEPENDS_ON_CLOCK;
+    case STRING_COMPARE:
+      if (info.GetData2() < 0 && IsListItemInfo(-info.GetData2()))
+        return DEPENDS_ON_FRAME | DEPENDS_ON_ITEM;
+      // fall through
+    case STRING_IS_EMPTY:
+    case STRING_STR:
+    case STRING_STR_LEFT:
+    case STRING_STR_RIGHT:
+    case INTEGER_GREATER_THAN:
+      if (IsListItemInfo(info.GetData1()))
+        return DEPENDS_ON_FRAME | DEPENDS_ON_ITEM;
+      break;
+    }
+  }
+
+  return DEPENDS_ON_FRAME;
+}
+
+unsigned int CGUIInfoManager::GetDependencyStamp(unsigned int dependencies) const
+{
+  // all counters only ever increase, so their sum changes whenever one does
+  unsigned int stamp = 0;
+  if (dependencies & DEPENDS_ON_FRAME)
+    stamp += m_updateTime;
+  if (dependencies & DEPENDS_ON_CLOCK)
+    stamp += m_clockTicks;
+  if (dependencies & DEPENDS_ON_SKIN_SETTINGS)
+    stamp += g_settings.GetSkinSettingsVersion();
+  return stamp;
+}
+
+void CGUIInfoManager::LogConditionProfile(unsigned int count)
+{
+  CSingleLock lock(m_critInfo);
+  vector< pair<int64_t, unsigned int> > costs;
+  for (unsigned int i = 0; i < m_boolCosts.size() && i < m_bools.size(); i++)
+  {
+    if (m_boolCosts[i].count)
+      costs.push_back(make_pair(m_boolCosts[i].time, i));
+  }
+  if (costs.empty())
+    return;
+
+  sort(costs.begin(), costs.end());
+  double freq = (double)CurrentHostFrequency();
+  CLog::Log(LOGNOTICE, "%s - %u of %u conditions evaluated, most expensive:", __FUNCTION__,
+            (unsigned int)costs.size(), (unsigned int)m_bools.size());
+  for (vector< pair<int64_t, unsigned int> >::reverse_iterator it = costs.rbegin(); it != costs.rend() && count > 0; ++it, --count)
+  {
+    const ConditionCost &cost = m_boolCosts[it->second];
+    const InfoBool *info = m_bools[it->second];
+    CLog::Log(LOGNOTICE, "  %8.2f ms %8u calls %6.2f us/call  deps 0x%x  %s",
+              cost.time * 1000.0 / freq, cost.count, cost.time * 1000000.0 / freq / cost.count,
+              info->GetDependencies(), info->GetExpression().c_str());
+  }
+}
+
 // checks the condition and returns it as necessary.  Currently used
 // for toggle button controls and visibility of images.
 bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListItem *item)
@@ -4117,6 +4230,10 @@ CStdString CGUIInfoManager::GetAudioScrobblerLabel(int item)
 void CGUIInfoManager::Clear()
 {
   CSingleLock lock(m_critInfo);
+  if (g_advancedSettings.m_guiProfileConditions)
+    LogConditionProfile();
+  m_boolCosts.clear();
+
   for (unsigned int i = 0; i < m_bools.size(); ++i)
     delete m_bools[i];
   m_bools.clear();
@@ -5038,6 +5155,23 @@ void CGUIInfoManager::ResetCache()
   // reset any animation triggers as well
   m_containerMoves.clear();
   m_updateTime++;
+
+  time_t now = time(NULL);
+  if (now != m_lastClock)
+  {
+    m_lastClock = now;
+    m_clockTicks++;
+  }
+
+  if (g_advancedSettings.m_guiProfileConditions)
+  {
+    unsigned int nowMillis = XbmcThreads::SystemClockMillis();
+    if (nowMillis - m_lastProfileLog > 60000)
+    {
+      LogConditionProfile();
+      m_lastProfileLog = nowMillis;
+    }
+  }
 }
 
 // Called from tuxbox service thread to update current status
@@ -702,6 +702,33 @@ public:
    */
   bool GetBoolValue(unsigned int expression, const CGUIListItem *item = NULL);
 
+  /*! \brief Get what can change the value of a previously registered boolean expression
+   \param expression the identifier returned by Register
+   \return a combination of INFO::InfoDependency flags
+   \sa Register, GetConditionDependencies
+   */
+  unsigned int GetDependencies(unsigned int expression) const;
+
+  /*! \brief Get what can change the value of a single translated condition
+   \param condition the condition as returned by TranslateSingleString
+   \return a combination of INFO::InfoDependency flags
+   \sa GetDependencies
+   */
+  unsigned int GetConditionDependencies(int condition) const;
+
+  /*! \brief Get a stamp that changes whenever one of the given dependencies is invalidated
+   \param dependencies a combination of INFO::InfoDependency flags
+   \return the current stamp of those dependencies
+   */
+  unsigned int GetDependencyStamp(unsigned int dependencies) const;
+
+  /*! \brief Log the boolean conditions that took the most time to evaluate
+   Only available when condition profiling is enabled in advancedsettings.xml.
+   Times are inclusive, so the time of an expression includes its operands.
+   \param count the number of conditions to list
+   */
+  void LogConditionProfile(unsigned int count = 20);
+
   /*! \brief Evaluate a boolean expression
    \param expression the expression to evaluate
    \param context the context in which to evaluate the expression (currently windows)
@@ -914,6 +941,18 @@ protected:
   std::vector<INFO::InfoBool*> m_bools;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
   unsigned int m_updateTime;
+  unsigned int m_clockTicks;            ///< bumped whenever the second changes
+  time_t m_lastClock;
+
+  // condition profiling
+  struct ConditionCost
+  {
+    ConditionCost() : count(0), time(0) {};
+    unsigned int count;
+    int64_t time;
+  };
+  std::vector<ConditionCost> m_boolCosts;
+  unsigned int m_lastProfileLog;
 
   int m_libraryHasMusic;
   int m_libraryHasMovies;
@@ -28,9 +28,13 @@
 #include "guilib/GraphicContext.h"
 #include "utils/log.h"
 #include "TextureCache.h"
+#include "settings/AdvancedSettings.h"
 
 using namespace std;
 
+// number of bytes uploaded between checks of the upload budget
+#define UPLOAD_CHUNK_SIZE (256 * 1024)
+
 
 CImageLoader::CImageLoader(const CStdString &path)
 {
@@ -163,6 +167,17 @@ bool CGUILargeTextureManager::GetImage(const CStdString &path, CTextureArray &te
     }
   }
 
+  for (listIterator it = m_uploading.begin(); it != m_uploading.end(); ++it)
+  {
+    CLargeTexture *image = *it;
+    if (image->GetPath() == path)
+    {
+      if (firstRequest)
+        image->AddRef();
+      return true; // still uploading
+    }
+  }
+
   if (firstRequest)
     QueueImage(path);
 
@@ -182,6 +197,16 @@ void CGUILargeTextureManager::ReleaseImage(const CStdString &path, bool immediat
       return;
     }
   }
+  for (listIterator it = m_uploading.begin(); it != m_uploading.end(); ++it)
+  {
+    CLargeTexture *image = *it;
+    if (image->GetPath() == path)
+    {
+      if (image->DecrRef(true))
+        m_uploading.erase(it);
+      return;
+    }
+  }
   for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
   {
     unsigned int id = it->first;
@@ -229,7 +254,10 @@ void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJ
       image->SetTexture(loader->m_texture);
       loader->m_texture = NULL; // we want to keep the texture, and jobs are auto-deleted.
       m_queued.erase(it);
-      m_allocated.push_back(image);
+      if (image->GetTexture().size())
+        m_uploading.push_back(image); // uploaded on the render thread by UploadImages()
+      else
+        m_allocated.push_back(image);
       return;
     }
   }
@@ -237,3 +265,37 @@ void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJ
 
 
 
+
+void CGUILargeTextureManager::UploadImages()
+{
+  CSingleLock lock(m_listSection);
+  if (m_uploading.empty())
+    return;
+
+  int64_t start = CurrentHostCounter();
+  int64_t budget = (int64_t)g_advancedSettings.m_guiTextureUploadBudget * CurrentHostFrequency() / 1000;
+
+  listIterator it = m_uploading.begin();
+  while (it != m_uploading.end())
+  {
+    CLargeTexture *image = *it;
+    CBaseTexture *texture = image->GetTexture().m_textures[0];
+
+    bool ready;
+    do
+    {
+      unsigned int rows = UPLOAD_CHUNK_SIZE / max(texture->GetPitch(), 1U);
+      ready = texture->LoadToGPUPartial(rows);
+    } while (!ready && texture->GetPixels() && (budget <= 0 || CurrentHostCounter() - start < budget));
+
+    if (ready)
+    {
+      m_allocated.push_back(image);
+      it = m_uploading.erase(it);
+    }
+    else if (texture->GetPixels())
+      return; // out of budget for this frame
+    else
+      ++it; // uploaded, waiting for the GPU to consume it
+  }
+}
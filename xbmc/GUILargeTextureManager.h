@@ -111,6 +111,16 @@ public:
    */
   void CleanupUnusedImages(bool immediately = false);
 
+  /*!
+   \brief Upload loaded images to the GPU.
+
+   Loaded images are uploaded in chunks of rows, spending at most the configured time per frame
+   (see CAdvancedSettings::m_guiTextureUploadBudget), so that large images never stall rendering.
+   Images are handed out by GetImage() once their upload has completed. Must be called from the
+   rendering thread.
+   */
+  void UploadImages();
+
 private:
   class CLargeTexture
   {
@@ -138,6 +148,7 @@ private:
   void QueueImage(const CStdString &path);
 
   std::vector< std::pair<unsigned int, CLargeTexture *> > m_queued;
+  std::vector<CLargeTexture *> m_uploading;
   std::vector<CLargeTexture *> m_allocated;
   typedef std::vector<CLargeTexture *>::iterator listIterator;
   typedef std::vector< std::pair<unsigned int, CLargeTexture *> >::iterator queueIterator;
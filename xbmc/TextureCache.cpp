@@ -22,15 +22,22 @@
 #include "TextureCacheJob.h"
 #include "filesystem/File.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/Crc32.h"
 #include "settings/Settings.h"
 #include "settings/AdvancedSettings.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
+#include "utils/CPUInfo.h"
 #include "URL.h"
 
 using namespace XFILE;
 
+#define USECOUNT_BATCH_SIZE   100
+#define USECOUNT_FLUSH_PERIOD 30000 // ms
+#define INDEX_MAX_SIZE        10000
+#define INDEX_MISS_LIFETIME   2000  // ms
+
 CTextureCache &CTextureCache::Get()
 {
   static CTextureCache s_cache;
@@ -38,7 +45,10 @@ CTextureCache &CTextureCache::Get()
 }
 
 CTextureCache::CTextureCache()
+: CJobQueue(false, std::max(1, g_cpuInfo.getCPUCount()), CJob::PRIORITY_LOW),
+  m_useCountTimer(this)
 {
+  // decode, scale and encode of each image are independent, so cache one image per core
 }
 
 CTextureCache::~CTextureCache()
@@ -50,13 +60,19 @@ void CTextureCache::Initialize()
   CSingleLock lock(m_databaseSection);
   if (!m_database.IsOpen())
     m_database.Open();
+  m_useCountTimer.Start(USECOUNT_FLUSH_PERIOD, true);
 }
 
 void CTextureCache::Deinitialize()
 {
+  m_useCountTimer.Stop(true);
   CancelJobs();
+  FlushUseCounts();
   CSingleLock lock(m_databaseSection);
   m_database.Close();
+  CSingleLock indexLock(m_indexSection);
+  m_index.clear();
+  m_indexLRU.clear();
 }
 
 bool CTextureCache::IsCachedImage(const CStdString &url) const
@@ -222,39 +238,147 @@ void CTextureCache::ClearCachedImage(const CStdString &url, bool deleteSource /*
 
 bool CTextureCache::GetCachedTexture(const CStdString &url, CTextureDetails &details)
 {
-  CSingleLock lock(m_databaseSection);
-  return m_database.GetCachedTexture(url, details);
+  CIndexEntry entry;
+  bool found = false;
+  {
+    CSingleLock lock(m_indexSection);
+    std::map<CStdString, CIndexEntry>::iterator i = m_index.find(url);
+    if (i != m_index.end())
+    {
+      if (i->second.cached || (int)(i->second.expires - XbmcThreads::SystemClockMillis()) > 0)
+      {
+        m_indexLRU.splice(m_indexLRU.begin(), m_indexLRU, i->second.lru);
+        entry = i->second;
+        found = true;
+      }
+      else
+      { // the image may have been cached by another process since
+        m_indexLRU.erase(i->second.lru);
+        m_index.erase(i);
+      }
+    }
+  }
+
+  if (!found)
+  { // not seen recently - ask the database, and remember the answer
+    CSingleLock lock(m_databaseSection);
+    entry.cached = m_database.GetCachedTexture(url, entry.details, entry.lastCheck);
+    if (m_database.IsOpen())
+    {
+      CSingleLock indexLock(m_indexSection);
+      AddToIndex(url, entry.cached, entry.details, entry.lastCheck);
+    }
+  }
+
+  if (!entry.cached)
+    return false;
+
+  details = entry.details;
+  if (!CTextureDatabase::NeedsHashCheck(entry.lastCheck))
+    details.hash.clear();
+  return true;
+}
+
+void CTextureCache::AddToIndex(const CStdString &url, bool cached, const CTextureDetails &details, const CDateTime &lastCheck)
+{
+  std::map<CStdString, CIndexEntry>::iterator i = m_index.find(url);
+  if (i == m_index.end())
+  {
+    if (m_index.size() >= INDEX_MAX_SIZE)
+    {
+      m_index.erase(m_indexLRU.back());
+      m_indexLRU.pop_back();
+    }
+    i = m_index.insert(std::make_pair(url, CIndexEntry())).first;
+    m_indexLRU.push_front(url);
+  }
+  else
+    m_indexLRU.splice(m_indexLRU.begin(), m_indexLRU, i->second.lru);
+
+  CIndexEntry &entry = i->second;
+  entry.cached = cached;
+  entry.details = details;
+  entry.lastCheck = lastCheck;
+  entry.expires = XbmcThreads::SystemClockMillis() + INDEX_MISS_LIFETIME;
+  entry.lru = m_indexLRU.begin();
+}
+
+void CTextureCache::RemoveFromIndex(const CStdString &url)
+{
+  CSingleLock lock(m_indexSection);
+  std::map<CStdString, CIndexEntry>::iterator i = m_index.find(url);
+  if (i != m_index.end())
+  {
+    m_indexLRU.erase(i->second.lru);
+    m_index.erase(i);
+  }
 }
 
 bool CTextureCache::AddCachedTexture(const CStdString &url, const CTextureDetails &details)
 {
   CSingleLock lock(m_databaseSection);
-  return m_database.AddCachedTexture(url, details);
+  bool success = m_database.AddCachedTexture(url, details);
+  RemoveFromIndex(url);
+  return success;
 }
 
 void CTextureCache::IncrementUseCount(const CTextureDetails &details)
 {
-  static const size_t count_before_update = 100;
   CSingleLock lock(m_useCountSection);
-  m_useCounts.reserve(count_before_update);
+  if (m_useCounts.empty())
+    m_useCounts.reserve(USECOUNT_BATCH_SIZE);
   m_useCounts.push_back(details);
-  if (m_useCounts.size() >= count_before_update)
+  // smaller batches are written out by OnTimeout()
+  if (m_useCounts.size() >= USECOUNT_BATCH_SIZE)
   {
     AddJob(new CTextureUseCountJob(m_useCounts));
     m_useCounts.clear();
   }
 }
 
+void CTextureCache::OnTimeout()
+{
+  CSingleLock lock(m_useCountSection);
+  if (!m_useCounts.empty())
+  {
+    AddJob(new CTextureUseCountJob(m_useCounts));
+    m_useCounts.clear();
+  }
+}
+
+void CTextureCache::FlushUseCounts()
+{
+  std::vector<CTextureDetails> useCounts;
+  {
+    CSingleLock lock(m_useCountSection);
+    useCounts.swap(m_useCounts);
+  }
+  if (!useCounts.empty())
+    CTextureUseCountJob(useCounts).DoWork();
+}
+
 bool CTextureCache::SetCachedTextureValid(const CStdString &url, bool updateable)
 {
   CSingleLock lock(m_databaseSection);
-  return m_database.SetCachedTextureValid(url, updateable);
+  bool success = m_database.SetCachedTextureValid(url, updateable);
+  RemoveFromIndex(url);
+  return success;
 }
 
 bool CTextureCache::ClearCachedTexture(const CStdString &url, CStdString &cachedURL)
 {
   CSingleLock lock(m_databaseSection);
-  return m_database.ClearCachedTexture(url, cachedURL);
+  bool success = m_database.ClearCachedTexture(url, cachedURL);
+  RemoveFromIndex(url);
+  return success;
+}
+
+void CTextureCache::InvalidateCachedImage(const CStdString &image)
+{
+  CStdString url = UnwrapImageURL(image);
+  CSingleLock lock(m_databaseSection);
+  m_database.InvalidateCachedTexture(url);
+  RemoveFromIndex(url);
 }
 
 CStdString CTextureCache::GetCacheFile(const CStdString &url)
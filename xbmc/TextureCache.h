@@ -20,11 +20,15 @@
 
 #pragma once
 
+#include <list>
+#include <map>
 #include <set>
 #include "utils/StdString.h"
 #include "utils/JobManager.h"
 #include "TextureDatabase.h"
+#include "XBDateTime.h"
 #include "threads/Event.h"
+#include "threads/Timer.h"
 
 class CURL;
 class CBaseTexture;
@@ -39,7 +43,7 @@ class CBaseTexture;
  unused for a set period of time.
 
  */
-class CTextureCache : public CJobQueue
+class CTextureCache : public CJobQueue, private ITimerCallback
 {
 public:
   /*!
@@ -115,6 +119,12 @@ public:
    */
   void ClearCachedImage(const CStdString &image, bool deleteSource = false);
 
+  /*! \brief Invalidate the cached version of the given image so it is checked for updates on next use
+   Thread-safe wrapper of CTextureDatabase::InvalidateCachedTexture
+   \param image url of the image
+   */
+  void InvalidateCachedImage(const CStdString &image);
+
   /*! \brief retrieve a cache file (relative to the cache path) to associate with the given image, excluding extension
    Use GetCachedPath(GetCacheFile(url)+extension) for the full path to the file.
    \param url location of the image
@@ -229,12 +239,47 @@ private:
    */
   void OnCachingComplete(bool success, CTextureCacheJob *job);
 
+  /*! \brief Drop an image from the in-memory index so the next lookup rereads the database.
+   Must be called with m_databaseSection held, after the database has been updated.
+   */
+  void RemoveFromIndex(const CStdString &url);
+
+  /*! \brief Write any pending use counts to the database straight away
+   */
+  void FlushUseCounts();
+
+  /*! \brief Hand the pending use counts to a job, called periodically by m_useCountTimer
+   */
+  virtual void OnTimeout();
+
+  /*! \brief Add the result of a database lookup to the in-memory index, dropping the least recently used entry when full
+   Must be called with m_indexSection held.
+   */
+  void AddToIndex(const CStdString &url, bool cached, const CTextureDetails &details, const CDateTime &lastCheck);
+
+  /*! \brief An image's row in the texture database, as seen by the in-memory index.
+   Lookups that found nothing are kept for a moment too, so a burst of requests for an
+   uncached image doesn't hit the database each time.
+   */
+  struct CIndexEntry
+  {
+    bool            cached;
+    CTextureDetails details;   ///< details.hash is the stored hash, whether or not a check is due
+    CDateTime       lastCheck;
+    unsigned int    expires;   ///< time at which a miss is looked up again, unused for cached images
+    std::list<CStdString>::iterator lru; ///< position in m_indexLRU
+  };
+
   CCriticalSection m_databaseSection;
   CTextureDatabase m_database;
+  std::map<CStdString, CIndexEntry> m_index; ///< url -> texture details, filled as images are looked up
+  std::list<CStdString>             m_indexLRU; ///< urls of m_index, most recently used first
+  CCriticalSection                  m_indexSection;
   std::set<CStdString> m_processing; ///< currently processing list to avoid 2 jobs being processed at once
   CCriticalSection     m_processingSection;
   CEvent               m_completeEvent; ///< Set whenever a job has finished
   std::vector<CTextureDetails> m_useCounts; ///< Use count tracking
+  CTimer                       m_useCountTimer; ///< Writes out pending use counts periodically
   CCriticalSection             m_useCountSection;
 };
 
@@ -30,6 +30,7 @@
 #include "pictures/Picture.h"
 #include "utils/URIUtils.h"
 #include "utils/StringUtils.h"
+#include <algorithm>
 #include "URL.h"
 #include "FileItem.h"
 #include "music/MusicThumbLoader.h"
@@ -271,9 +272,24 @@ bool CTextureUseCountJob::DoWork()
   CTextureDatabase db;
   if (db.Open())
   {
-    db.BeginTransaction();
+    // a texture on screen is usually used many times per batch, so update each one once
+    std::vector<CTextureDetails> textures;
+    std::vector<unsigned int> counts;
     for (std::vector<CTextureDetails>::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
-      db.IncrementUseCount(*i);
+    {
+      std::vector<CTextureDetails>::const_iterator j = std::find(textures.begin(), textures.end(), *i);
+      if (j == textures.end())
+      {
+        textures.push_back(*i);
+        counts.push_back(1);
+      }
+      else
+        counts[j - textures.begin()]++;
+    }
+
+    db.BeginTransaction();
+    for (unsigned int i = 0; i < textures.size(); i++)
+      db.IncrementUseCount(textures[i], counts[i]);
     db.CommitTransaction();
   }
   return true;
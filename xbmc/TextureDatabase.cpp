@@ -140,13 +140,28 @@ bool CTextureDatabase::UpdateOldVersion(int version)
   return true;
 }
 
-bool CTextureDatabase::IncrementUseCount(const CTextureDetails &details)
+bool CTextureDatabase::IncrementUseCount(const CTextureDetails &details, unsigned int count)
 {
-  CStdString sql = PrepareSQL("UPDATE sizes SET usecount=usecount+1, lastusetime=CURRENT_TIMESTAMP WHERE idtexture=%u AND width=%u AND height=%u", details.id, details.width, details.height);
+  CStdString sql = PrepareSQL("UPDATE sizes SET usecount=usecount+%u, lastusetime=CURRENT_TIMESTAMP WHERE idtexture=%u AND width=%u AND height=%u", count, details.id, details.width, details.height);
   return ExecuteQuery(sql);
 }
 
+bool CTextureDatabase::NeedsHashCheck(const CDateTime &lastCheck)
+{
+  return lastCheck.IsValid() && lastCheck + CDateTimeSpan(1,0,0,0) < CDateTime::GetCurrentDateTime();
+}
+
 bool CTextureDatabase::GetCachedTexture(const CStdString &url, CTextureDetails &details)
+{
+  CDateTime lastCheck;
+  if (!GetCachedTexture(url, details, lastCheck))
+    return false;
+  if (!NeedsHashCheck(lastCheck))
+    details.hash.clear();
+  return true;
+}
+
+bool CTextureDatabase::GetCachedTexture(const CStdString &url, CTextureDetails &details, CDateTime &lastCheck)
 {
   try
   {
@@ -159,10 +174,8 @@ bool CTextureDatabase::GetCachedTexture(const CStdString &url, CTextureDetails &
     { // have some information
       details.id = m_pDS->fv(0).get_asInt();
       details.file  = m_pDS->fv(1).get_asString();
-      CDateTime lastCheck;
       lastCheck.SetFromDBDateTime(m_pDS->fv(2).get_asString());
-      if (lastCheck.IsValid() && lastCheck + CDateTimeSpan(1,0,0,0) < CDateTime::GetCurrentDateTime())
-        details.hash = m_pDS->fv(3).get_asString();
+      details.hash = m_pDS->fv(3).get_asString();
       details.width = m_pDS->fv(4).get_asInt();
       details.height = m_pDS->fv(5).get_asInt();
       m_pDS->close();
@@ -23,6 +23,8 @@
 #include "dbwrappers/Database.h"
 #include "TextureCacheJob.h"
 
+class CDateTime;
+
 class CTextureDatabase : public CDatabase
 {
 public:
@@ -31,10 +33,24 @@ public:
   virtual bool Open();
 
   bool GetCachedTexture(const CStdString &originalURL, CTextureDetails &details);
+
+  /*! \brief Get a texture's details along with when its hash was last checked
+   Unlike GetCachedTexture, details.hash is always the stored image hash.
+   \param originalURL the url of the image
+   \param details [out] the texture details
+   \param lastCheck [out] when the image was last checked for updates
+   \return true if the texture is in the database, false otherwise
+   \sa NeedsHashCheck
+   */
+  bool GetCachedTexture(const CStdString &originalURL, CTextureDetails &details, CDateTime &lastCheck);
+
+  /*! \brief Whether a texture last checked at the given time is due to be checked for updates again
+   */
+  static bool NeedsHashCheck(const CDateTime &lastCheck);
   bool AddCachedTexture(const CStdString &originalURL, const CTextureDetails &details);
   bool SetCachedTextureValid(const CStdString &originalURL, bool updateable);
   bool ClearCachedTexture(const CStdString &originalURL, CStdString &cacheFile);
-  bool IncrementUseCount(const CTextureDetails &details);
+  bool IncrementUseCount(const CTextureDetails &details, unsigned int count = 1);
 
   /*! \brief Invalidate a previously cached texture
    Invalidates the texture hash, and sets the texture update time to the current time so that
@@ -39,6 +39,15 @@
 #define LOGFATAL   6
 #define LOGNONE    7
 
+// a component can be or'ed to the level of a message so that it is
+// filtered by the log level set for the component (if any)
+#define LOGMASKBIT   16
+#define LOGMASK      ((1 << LOGMASKBIT) - 1)
+#define LOGDATABASE  (1 << LOGMASKBIT)
+#define LOGWEBSERVER (2 << LOGMASKBIT)
+#define LOGJSONRPC   (3 << LOGMASKBIT)
+#define LOGCOMPONENT_COUNT 4
+
 #ifdef __GNUC__
 #define ATTRIB_LOG_FORMAT __attribute__((format(printf,3,4)))
 #else
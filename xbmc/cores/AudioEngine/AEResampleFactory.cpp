@@ -0,0 +1,68 @@
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+
+#include "AEResampleFactory.h"
+#include "Utils/AEResamplePolyphase.h"
+#include "Utils/AEResampleSRC.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/log.h"
+
+enum AEResampleQuality CAEResampleFactory::GetQuality()
+{
+  return (enum AEResampleQuality)g_advancedSettings.m_audioResampleQuality;
+}
+
+IAEResample *CAEResampleFactory::Create(enum AEResampleQuality quality, unsigned int channels, unsigned int inRate, unsigned int outRate)
+{
+  double ratio = (double)outRate / (double)inRate;
+
+  /*
+    medium and high stay on libsamplerate's sinc as before, the polyphase FIR
+    trades some stopband for CPU and is only used when low was asked for
+  */
+  if (quality == AE_RESAMPLE_LOW && CAEResamplePolyphase::IsSupported(inRate, outRate))
+  {
+    IAEResample *resampler = new CAEResamplePolyphase(quality, inRate, outRate);
+    if (resampler->Initialize(channels, ratio))
+    {
+      CLog::Log(LOGDEBUG, "CAEResampleFactory::Create - %u -> %u using %s", inRate, outRate, resampler->GetName());
+      return resampler;
+    }
+    delete resampler;
+  }
+
+  IAEResample *resampler = CreateVariable(quality, channels, ratio);
+  if (resampler)
+    CLog::Log(LOGDEBUG, "CAEResampleFactory::Create - %u -> %u using %s", inRate, outRate, resampler->GetName());
+  return resampler;
+}
+
+IAEResample *CAEResampleFactory::CreateVariable(enum AEResampleQuality quality, unsigned int channels, double ratio)
+{
+  IAEResample *resampler = new CAEResampleSRC(quality);
+  if (!resampler->Initialize(channels, ratio))
+  {
+    delete resampler;
+    return NULL;
+  }
+  return resampler;
+}
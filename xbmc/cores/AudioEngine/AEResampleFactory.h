@@ -0,0 +1,38 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "Interfaces/AEResample.h"
+
+class CAEResampleFactory
+{
+public:
+  /* the quality tier configured in advancedsettings.xml */
+  static enum AEResampleQuality GetQuality();
+
+  /*
+    Create an initialized resampler for a fixed inRate -> outRate conversion,
+    the fast polyphase path is used when the tier and ratio allow it.
+  */
+  static IAEResample *Create(enum AEResampleQuality quality, unsigned int channels, unsigned int inRate, unsigned int outRate);
+
+  /* Create an initialized resampler that can follow arbitrary ratio changes */
+  static IAEResample *CreateVariable(enum AEResampleQuality quality, unsigned int channels, double ratio);
+};
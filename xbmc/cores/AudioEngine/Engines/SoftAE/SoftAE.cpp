@@ -1208,7 +1208,7 @@ bool CSoftAE::FinalizeSamples(float *buffer, unsigned int samples, bool hasAudio
   if (!clamp)
     return true;
 
-  CLog::Log(LOGDEBUG, "CSoftAE::FinalizeSamples - Clamping buffer of %d samples, clamp value(%f)", samples, clamp_value);
+  CLOG(LOGDEBUG, "CSoftAE::FinalizeSamples - Clamping buffer of %d samples, clamp value(%f)", samples, clamp_value);
   CAEUtil::ClampArray(buffer, samples);
   return true;
 }
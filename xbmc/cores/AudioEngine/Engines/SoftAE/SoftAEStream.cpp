@@ -19,12 +19,16 @@
  */
 
 #include "system.h"
+#include "threads/Atomics.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/MathUtils.h"
+#include "utils/TimeUtils.h"
 
 #include "AEFactory.h"
+#include "AEResampleFactory.h"
 #include "Utils/AEUtil.h"
+#include "Sinks/AESinkProfiler.h"
 
 #include "SoftAE.h"
 #include "SoftAEStream.h"
@@ -44,19 +48,25 @@ CSoftAEStream::CSoftAEStream(enum AEDataFormat dataFormat, unsigned int sampleRa
   m_rgain           (1.0f ),
   m_refillBuffer    (0    ),
   m_convertFn       (NULL ),
-  m_ssrc            (NULL ),
-  m_framesBuffered  (0    ),
+  m_resampler       (NULL ),
+  m_resampleBuffer  (NULL ),
+  m_resampleFrames  (0    ),
+  m_framesWritten   (0    ),
+  m_framesRead      (0    ),
+  m_generation      (0    ),
+  m_readGeneration  (0    ),
+  m_drained         (false),
   m_newPacket       (NULL ),
   m_packet          (NULL ),
   m_vizPacketPos    (NULL ),
   m_draining        (false),
   m_vizBufferSamples(0    ),
   m_audioCallback   (NULL ),
+  m_fadeSeq         (0    ),
+  m_fadeSeen        (0    ),
   m_fadeRunning     (false),
   m_slave           (NULL )
 {
-  m_ssrcData.data_out = NULL;
-
   m_initDataFormat        = dataFormat;
   m_initSampleRate        = sampleRate;
   m_initEncodedSampleRate = encodedSampleRate;
@@ -74,6 +84,7 @@ CSoftAEStream::CSoftAEStream(enum AEDataFormat dataFormat, unsigned int sampleRa
 
 void CSoftAEStream::InitializeRemap()
 {
+  /* called by CSoftAE with its stream lock held, the mixer is not running */
   CExclusiveLock lock(m_lock);
   if (!AE_IS_RAW(m_initDataFormat))
   {
@@ -96,6 +107,7 @@ void CSoftAEStream::InitializeRemap()
 
 void CSoftAEStream::Initialize()
 {
+  /* called by CSoftAE with its stream lock held, the mixer is not running */
   CExclusiveLock lock(m_lock);
   if (m_valid)
   {
@@ -107,8 +119,10 @@ void CSoftAEStream::Initialize()
 
     if (m_resample)
     {
-      _aligned_free(m_ssrcData.data_out);
-      m_ssrcData.data_out = NULL;
+      delete m_resampler;
+      m_resampler = NULL;
+      _aligned_free(m_resampleBuffer);
+      m_resampleBuffer = NULL;
     }
   }
 
@@ -188,14 +202,15 @@ void CSoftAEStream::Initialize()
   /* if we need to resample, set it up */
   if (m_resample)
   {
-    int err;
-    m_ssrc                   = src_new(SRC_SINC_MEDIUM_QUALITY, m_initChannelLayout.Count(), &err);
-    m_ssrcData.data_in       = m_convertBuffer;
-    m_internalRatio          = (double)AE.GetSampleRate() / (double)m_initSampleRate;
-    m_ssrcData.src_ratio     = m_internalRatio;
-    m_ssrcData.data_out      = (float*)_aligned_malloc(m_format.m_frameSamples * (int)std::ceil(m_ssrcData.src_ratio) * sizeof(float), 16);
-    m_ssrcData.output_frames = m_format.m_frames * (long)std::ceil(m_ssrcData.src_ratio);
-    m_ssrcData.end_of_input  = 0;
+    m_resampler      = CAEResampleFactory::Create(CAEResampleFactory::GetQuality(), m_initChannelLayout.Count(), m_initSampleRate, AE.GetSampleRate());
+    if (!m_resampler)
+    {
+      m_valid = false;
+      return;
+    }
+    m_internalRatio  = (double)AE.GetSampleRate() / (double)m_initSampleRate;
+    m_resampleBuffer = (float*)_aligned_malloc(m_format.m_frameSamples * (int)std::ceil(m_internalRatio) * sizeof(float), 16);
+    m_resampleFrames = m_format.m_frames * (unsigned int)std::ceil(m_internalRatio);
     // we must buffer the same amount as before but taking the source sample rate into account
     // there is no reason to decrease the buffer for upsampling
     if (m_internalRatio < 1)
@@ -205,6 +220,18 @@ void CSoftAEStream::Initialize()
     }
   }
 
+  /*
+    size the hand-off ring for a full water level worth of packets plus what a
+    single input buffer can produce, with room to spare for ratio changes
+  */
+  unsigned int maxPackets = (m_waterLevel + m_format.m_frames - 1) / m_format.m_frames;
+  maxPackets += m_resample ? (unsigned int)std::ceil(m_internalRatio) : 1;
+  if (!m_outBuffer.Create((maxPackets + 2) * 2))
+  {
+    m_valid = false;
+    return;
+  }
+
   m_limiter.SetSamplerate(AE.GetSampleRate());
 
   m_chLayoutCount = m_format.m_channelLayout.Count();
@@ -223,14 +250,19 @@ CSoftAEStream::~CSoftAEStream()
   CExclusiveLock lock(m_lock);
 
   InternalFlush();
+
+  /* the mixer is gone, drop what it would have dropped */
+  PPacket *p;
+  while (m_outBuffer.Pop(p))
+    delete p;
   if (m_convert)
     _aligned_free(m_convertBuffer);
 
   if (m_resample)
   {
-    _aligned_free(m_ssrcData.data_out);
-    src_delete(m_ssrc);
-    m_ssrc = NULL;
+    _aligned_free(m_resampleBuffer);
+    delete m_resampler;
+    m_resampler = NULL;
   }
 
   delete m_newPacket;
@@ -244,10 +276,11 @@ unsigned int CSoftAEStream::GetSpace()
   if (!m_valid || m_draining)
     return 0;
 
-  if (m_framesBuffered >= m_waterLevel)
+  unsigned int framesBuffered = GetFramesBuffered();
+  if (framesBuffered >= m_waterLevel)
     return 0;
 
-  return m_inputBuffer.Free() + (std::max(0U, (m_waterLevel - m_framesBuffered)) * m_format.m_frameSize);
+  return m_inputBuffer.Free() + (std::max(0U, (m_waterLevel - framesBuffered)) * m_format.m_frameSize);
 }
 
 unsigned int CSoftAEStream::AddData(void *data, unsigned int size)
@@ -260,7 +293,7 @@ unsigned int CSoftAEStream::AddData(void *data, unsigned int size)
   if (m_draining)
   {
     /* if the stream has finished draining, cork it */
-    if (m_packet && !m_packet->data.Used() && m_outBuffer.empty())
+    if (m_drained)
       m_draining = false;
     else
       return 0;
@@ -293,7 +326,7 @@ unsigned int CSoftAEStream::AddData(void *data, unsigned int size)
   lock.Leave();
 
   /* if the stream is flagged to autoStart when the buffer is full, then do it */
-  if (m_autoStart && m_framesBuffered >= m_waterLevel)
+  if (m_autoStart && GetFramesBuffered() >= m_waterLevel)
     Resume();
 
   return taken;
@@ -329,12 +362,13 @@ unsigned int CSoftAEStream::ProcessFrameBuffer()
   /* resample it if we need to */
   if (m_resample)
   {
-    m_ssrcData.input_frames = samples / m_chLayoutCount;
-    if (src_process(m_ssrc, &m_ssrcData) != 0)
+    unsigned int used;
+    int generated = m_resampler->Resample(m_convertBuffer, samples / m_chLayoutCount, used, m_resampleBuffer, m_resampleFrames);
+    if (generated < 0)
       return 0;
-    data     = (uint8_t*)m_ssrcData.data_out;
-    frames   = m_ssrcData.output_frames_gen;
-    consumed = m_ssrcData.input_frames_used * m_bytesPerFrame;
+    data     = (uint8_t*)m_resampleBuffer;
+    frames   = generated;
+    consumed = used * m_bytesPerFrame;
     if (!frames)
       return consumed;
 
@@ -347,16 +381,8 @@ unsigned int CSoftAEStream::ProcessFrameBuffer()
     consumed = frames * m_bytesPerFrame;
   }
 
-  if (m_refillBuffer)
-  {
-    if (frames > m_refillBuffer)
-      m_refillBuffer = 0;
-    else
-      m_refillBuffer -= frames;
-  }
-
-  /* buffer the data */
-  m_framesBuffered += frames;
+  /* buffer the data, counted before the mixer can see any of it */
+  m_framesWritten += frames;
   const unsigned int inputBlockSize = m_format.m_frames * m_format.m_channelLayout.Count() * sampleSize;
 
   size_t remaining = samples * sampleSize;
@@ -374,7 +400,7 @@ unsigned int CSoftAEStream::ProcessFrameBuffer()
     /* if we have a full block of data */
     if (AE_IS_RAW(m_initDataFormat))
     {
-      m_outBuffer.push_back(m_newPacket);
+      QueuePacket(m_newPacket);
       m_newPacket = new PPacket();
       m_newPacket->data.Alloc(inputBlockSize);
       continue;
@@ -406,84 +432,165 @@ unsigned int CSoftAEStream::ProcessFrameBuffer()
     }
 
     /* add the packet to the output */
-    m_outBuffer.push_back(pkt);
+    QueuePacket(pkt);
     m_newPacket->data.Empty();
   }
 
+  /*
+    only count down the refill once the packets are visible to the mixer, the
+    mixer may raise it again concurrently when it underruns
+  */
+  long refill;
+  do
+  {
+    refill = m_refillBuffer;
+    if (refill <= 0)
+      break;
+  } while (cas(&m_refillBuffer, refill, (long)frames >= refill ? 0 : refill - (long)frames) != refill);
+
   return consumed;
 }
 
+void CSoftAEStream::QueuePacket(PPacket *pkt)
+{
+  pkt->queuedAt   = CurrentHostCounter();
+  pkt->generation = m_generation;
+  if (!m_outBuffer.Push(pkt))
+  {
+    /* the ring is sized for the water level so this should never happen */
+    unsigned int frames = pkt->data.Used() / m_aeBytesPerFrame;
+    CLog::Log(LOGERROR, "CSoftAEStream::QueuePacket - Hand-off ring is full, dropping %u frames", frames);
+    m_framesWritten -= frames;
+    delete pkt;
+  }
+}
+
 uint8_t* CSoftAEStream::GetFrame()
 {
-  CExclusiveLock lock(m_lock);
+  /*
+    this is called by the mixer for every frame, it must never wait. The
+    producer only hands it packets, flushes and fades through the ring and
+    atomics, everything else it touches is owned by the mixer.
+  */
+
+  /* pick up a fade from FadeVolume, unless it is being written right now */
+  long fadeSeq = m_fadeSeq;
+  if (fadeSeq != m_fadeSeen && !(fadeSeq & 1))
+  {
+    AtomicMemoryBarrier();
+    FadeRequest request = m_fadeRequest;
+    AtomicMemoryBarrier();
+    if (m_fadeSeq == fadeSeq)
+    {
+      m_fadeTarget  = request.target;
+      m_fadeStep    = request.step;
+      m_fadeDirUp   = request.step > 0.0f;
+      m_fadeRunning = true;
+      m_fadeSeen    = fadeSeq;
+    }
+  }
 
   /* if we are fading, this runs even if we have underrun as it is time based */
   if (m_fadeRunning)
   {
-    m_volume += m_fadeStep;
-    m_volume = std::min(1.0f, std::max(0.0f, m_volume));
+    float volume = std::min(1.0f, std::max(0.0f, m_volume + m_fadeStep));
+    m_volume = volume;
     if (m_fadeDirUp)
     {
-      if (m_volume >= m_fadeTarget)
+      if (volume >= m_fadeTarget)
         m_fadeRunning = false;
     }
     else
     {
-      if (m_volume <= m_fadeTarget)
+      if (volume <= m_fadeTarget)
         m_fadeRunning = false;
     }
   }
 
+  /* catch up with a flush, the packets queued before it are dropped below */
+  long generation = m_generation;
+  if (generation != m_readGeneration)
+    StartGeneration(generation);
+
   /* if we have been deleted or are refilling but not draining */
   if (!m_valid || m_delete || (m_refillBuffer && !m_draining))
     return NULL;
 
-  /* if the packet is empty, advance to the next one */
-  if (!m_packet || m_packet->data.CursorEnd())
+  /* if the packet is empty or was flushed, advance to the next one */
+  if (!m_packet || m_packet->data.CursorEnd() || m_packet->generation != m_readGeneration)
   {
     delete m_packet;
     m_packet = NULL;
 
-    /* no more packets, return null */
-    if (m_outBuffer.empty())
+    /* get the next packet, if there are no more return null */
+    while (m_outBuffer.Pop(m_packet))
+    {
+      /* a flush since we looked, the packet already belongs to it */
+      if (m_packet->generation - m_readGeneration > 0)
+        StartGeneration(m_packet->generation);
+      if (m_packet->generation == m_readGeneration)
+        break;
+
+      delete m_packet;
+      m_packet = NULL;
+    }
+
+    if (!m_packet)
     {
       if (m_draining)
+      {
+        m_drained = true;
         return NULL;
+      }
       else
       {
         /* underrun, we need to refill our buffers */
         CLog::Log(LOGDEBUG, "CSoftAEStream::GetFrame - Underrun");
-        ASSERT(m_waterLevel > m_framesBuffered);
-        m_refillBuffer = m_waterLevel - m_framesBuffered;
+        CAESinkProfiler::ReportUnderrun();
+
+        /* the producer may have just queued more, in which case it is not a real underrun */
+        unsigned int framesBuffered = GetFramesBuffered();
+        if (framesBuffered < m_waterLevel)
+          cas(&m_refillBuffer, 0, m_waterLevel - framesBuffered);
         return NULL;
       }
     }
 
-    /* get the next packet */
-    m_packet = m_outBuffer.front();
-    m_outBuffer.pop_front();
+    CAESinkProfiler::ReportHandOff(m_packet->queuedAt);
   }
 
   /* fetch one frame of data */
   uint8_t *ret = (uint8_t*)m_packet->data.CursorRead(m_aeBytesPerFrame);
 
-  /* we have a frame, if we have a viz we need to hand the data to it */
-  if (m_audioCallback && !m_packet->vizData.CursorEnd())
+  /* we have a frame, if we have a viz we need to hand the data to it, unless it is being changed */
+  if (!m_packet->vizData.CursorEnd())
   {
     float *vizData = (float*)m_packet->vizData.CursorRead(2 * sizeof(float));
-    memcpy(m_vizBuffer + m_vizBufferSamples, vizData, 2 * sizeof(float));
-    m_vizBufferSamples += 2;
-    if (m_vizBufferSamples == 512)
+    CSingleTryLock vizLock(m_vizLock);
+    if (vizLock.IsOwner() && m_audioCallback)
     {
-      m_audioCallback->OnAudioData(m_vizBuffer, 512);
-      m_vizBufferSamples = 0;
+      memcpy(m_vizBuffer + m_vizBufferSamples, vizData, 2 * sizeof(float));
+      m_vizBufferSamples += 2;
+      if (m_vizBufferSamples == 512)
+      {
+        m_audioCallback->OnAudioData(m_vizBuffer, 512);
+        m_vizBufferSamples = 0;
+      }
     }
   }
 
-  --m_framesBuffered;
+  ++m_framesRead;
   return ret;
 }
 
+void CSoftAEStream::StartGeneration(long generation)
+{
+  /* the count has to be reset before the new generation is published, see GetFramesBuffered */
+  m_framesRead = 0;
+  AtomicMemoryBarrier();
+  m_readGeneration = generation;
+}
+
 double CSoftAEStream::GetDelay()
 {
   if (m_delete)
@@ -491,7 +598,7 @@ double CSoftAEStream::GetDelay()
 
   double delay = AE.GetDelay();
   delay += (double)(m_inputBuffer.Used() / m_format.m_frameSize) / (double)m_format.m_sampleRate;
-  delay += (double)m_framesBuffered                              / (double)AE.GetSampleRate();
+  delay += (double)GetFramesBuffered()                           / (double)AE.GetSampleRate();
   return delay;
 }
 
@@ -502,7 +609,7 @@ double CSoftAEStream::GetCacheTime()
 
   double time = AE.GetCacheTime();
   time += (double)(m_inputBuffer.Used() / m_format.m_frameSize) / (double)m_format.m_sampleRate;
-  time += (double)m_framesBuffered                              / (double)AE.GetSampleRate();
+  time += (double)GetFramesBuffered()                           / (double)AE.GetSampleRate();
   return time;
 }
 
@@ -537,13 +644,14 @@ void CSoftAEStream::Resume()
 void CSoftAEStream::Drain()
 {
   CSharedLock lock(m_lock);
+  m_drained  = false;
   m_draining = true;
 }
 
 bool CSoftAEStream::IsDrained()
 {
   CSharedLock lock(m_lock);
-  return (m_draining && !m_packet && m_outBuffer.empty());
+  return (m_draining && m_drained);
 }
 
 void CSoftAEStream::Flush()
@@ -561,32 +669,23 @@ void CSoftAEStream::InternalFlush()
   /* reset the resampler */
   if (m_resample)
   {
-    m_ssrcData.end_of_input = 0;
-    src_reset(m_ssrc);
+    m_resampler->Reset();
   }
 
   /* invalidate any incoming samples */
   m_newPacket->data.Empty();
 
   /*
-    clear the current buffered packet, we cant delete the data as it may be
-    in use by the AE thread, so we just seek to the end of the buffer
+    the read side of the hand-off belongs to the mixer, it drops the current
+    packet and those still queued once it sees the new generation
   */
-  if (m_packet)
-    m_packet->data.CursorSeek(m_packet->data.Size());
+  AtomicIncrement(&m_generation);
 
-  /* clear any other buffered packets */
-  while (!m_outBuffer.empty())
-  {
-    PPacket *p = m_outBuffer.front();
-    m_outBuffer.pop_front();
-    delete p;
-  }
-
-  /* reset our counts */
-  m_framesBuffered = 0;
+  /* reset our counts, the mixer restarts its own with the new generation */
+  m_framesWritten  = 0;
   m_refillBuffer   = m_waterLevel;
   m_draining       = false;
+  m_drained        = false;
 }
 
 double CSoftAEStream::GetResampleRatio()
@@ -595,7 +694,7 @@ double CSoftAEStream::GetResampleRatio()
     return 1.0f;
 
   CSharedLock lock(m_lock);
-  return m_ssrcData.src_ratio;
+  return m_resampler->GetRatio();
 }
 
 bool CSoftAEStream::SetResampleRatio(double ratio)
@@ -603,21 +702,38 @@ bool CSoftAEStream::SetResampleRatio(double ratio)
   if (!m_resample)
     return false;
 
-  CSharedLock lock(m_lock);
+  CExclusiveLock lock(m_lock);
 
-  int oldRatioInt = (int)std::ceil(m_ssrcData.src_ratio);
+  int oldRatioInt = (int)std::ceil(m_resampler->GetRatio());
 
   m_resampleRatio = ratio;
+  double newRatio = m_resampleRatio * m_internalRatio;
 
-  src_set_ratio(m_ssrc, m_resampleRatio * m_internalRatio);
-  m_ssrcData.src_ratio = m_resampleRatio * m_internalRatio;
+  if (!m_resampler->SetRatio(newRatio))
+  {
+    /* a fixed ratio resampler can not follow clock adjustments, hand over to one that can */
+    IAEResample *resampler = CAEResampleFactory::CreateVariable(CAEResampleFactory::GetQuality(), m_chLayoutCount, newRatio);
+    if (!resampler)
+      return false;
+
+    /* carry over the input the old one still holds so the switch neither drops nor repeats audio */
+    std::vector<float> history;
+    double lead;
+    unsigned int frames = m_resampler->GetHistory(history, lead);
+    if (frames)
+      resampler->SetHistory(&history[0], frames, lead);
+
+    CLog::Log(LOGDEBUG, "CSoftAEStream::SetResampleRatio - Switching from %s to %s resampler", m_resampler->GetName(), resampler->GetName());
+    delete m_resampler;
+    m_resampler = resampler;
+  }
 
   //Check the resample buffer size and resize if necessary.
-  if (oldRatioInt < std::ceil(m_ssrcData.src_ratio))
+  if (oldRatioInt < std::ceil(newRatio))
   {
-    _aligned_free(m_ssrcData.data_out);
-    m_ssrcData.data_out      = (float*)_aligned_malloc(m_format.m_frameSamples * (int)std::ceil(m_ssrcData.src_ratio) * sizeof(float), 16);
-    m_ssrcData.output_frames = m_format.m_frames * (long)std::ceil(m_ssrcData.src_ratio);
+    _aligned_free(m_resampleBuffer);
+    m_resampleBuffer = (float*)_aligned_malloc(m_format.m_frameSamples * (int)std::ceil(newRatio) * sizeof(float), 16);
+    m_resampleFrames = m_format.m_frames * (unsigned int)std::ceil(newRatio);
   }
   return true;
 }
@@ -625,6 +741,7 @@ bool CSoftAEStream::SetResampleRatio(double ratio)
 void CSoftAEStream::RegisterAudioCallback(IAudioCallback* pCallback)
 {
   CExclusiveLock lock(m_lock);
+  CSingleLock vizLock(m_vizLock);
   m_vizBufferSamples = 0;
   m_audioCallback = pCallback;
   if (m_audioCallback)
@@ -634,6 +751,7 @@ void CSoftAEStream::RegisterAudioCallback(IAudioCallback* pCallback)
 void CSoftAEStream::UnRegisterAudioCallback()
 {
   CExclusiveLock lock(m_lock);
+  CSingleLock vizLock(m_vizLock);
   m_audioCallback = NULL;
   m_vizBufferSamples = 0;
 }
@@ -644,18 +762,18 @@ void CSoftAEStream::FadeVolume(float from, float target, unsigned int time)
   if (AE_IS_RAW(m_initDataFormat))
     return;
 
+  /* the mixer picks the request up on its next frame, the sequence keeps it from reading it half written */
   CExclusiveLock lock(m_lock);
-  float delta   = target - from;
-  m_fadeDirUp   = target > from;
-  m_fadeTarget  = target;
-  m_fadeStep    = delta / (((float)AE.GetSampleRate() / 1000.0f) * (float)time);
-  m_fadeRunning = true;
+  float delta = target - from;
+  AtomicIncrement(&m_fadeSeq);
+  m_fadeRequest.target = target;
+  m_fadeRequest.step   = delta / (((float)AE.GetSampleRate() / 1000.0f) * (float)time);
+  AtomicIncrement(&m_fadeSeq);
 }
 
 bool CSoftAEStream::IsFading()
 {
-  CSharedLock lock(m_lock);
-  return m_fadeRunning;
+  return m_fadeRunning || m_fadeSeen != m_fadeSeq;
 }
 
 void CSoftAEStream::RegisterSlave(IAEStream *slave)
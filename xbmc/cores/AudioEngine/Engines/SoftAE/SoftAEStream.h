@@ -19,17 +19,20 @@
  *
  */
 
-#include <samplerate.h>
 #include <list>
 
+#include "threads/CriticalSection.h"
 #include "threads/SharedSection.h"
+#include "threads/Atomics.h"
 
 #include "AEAudioFormat.h"
 #include "Interfaces/AEStream.h"
+#include "Interfaces/AEResample.h"
 #include "Utils/AEConvert.h"
 #include "Utils/AERemap.h"
 #include "Utils/AEBuffer.h"
 #include "Utils/AELimiter.h"
+#include "Utils/AERingBuffer.h"
 
 class IAEPostProc;
 class CSoftAEStream : public IAEStream
@@ -91,7 +94,22 @@ private:
   void InternalFlush();
   void CheckResampleBuffers();
 
-  CSharedSection    m_lock;
+  /* frames converted but not yet handed to the mixer, safe to call from any thread */
+  inline unsigned int GetFramesBuffered()
+  {
+    /* read side first, it can only have moved closer to the write side since */
+    long         readGeneration = m_readGeneration;
+    AtomicMemoryBarrier();
+    unsigned int read    = m_framesRead;
+    unsigned int written = m_framesWritten;
+    /* the mixer has not caught up with a flush yet, none of the new data is read */
+    if (readGeneration != m_generation)
+      read = 0;
+    return written >= read ? written - read : 0;
+  }
+
+  CSharedSection    m_lock;     /* guards the producer side (AddData and friends) */
+  CCriticalSection  m_vizLock;  /* guards the viz callback, GetFrame only ever try-locks it */
   enum AEDataFormat m_initDataFormat;
   unsigned int      m_initSampleRate;
   unsigned int      m_initEncodedSampleRate;
@@ -102,6 +120,8 @@ private:
   {
     CAEBuffer data;
     CAEBuffer vizData;
+    int64_t   queuedAt;   /* host counter when it was handed to the mixer */
+    long      generation; /* m_generation when it was handed to the mixer */
   } PPacket;
 
   AEAudioFormat m_format;
@@ -118,7 +138,7 @@ private:
   float                   m_volume;        /* the volume level */
   float                   m_rgain;         /* replay gain level */
   unsigned int            m_waterLevel;    /* the fill level to fall below before calling the data callback */
-  unsigned int            m_refillBuffer;  /* how many frames that need to be buffered before we return any frames */
+  volatile long           m_refillBuffer;  /* how many frames that need to be buffered before we return any frames */
 
   CAEConvert::AEConvertToFn m_convertFn;
 
@@ -128,11 +148,18 @@ private:
   unsigned int        m_samplesPerFrame;
   CAEChannelInfo      m_aeChannelLayout;
   unsigned int        m_aeBytesPerFrame;
-  SRC_STATE          *m_ssrc;
-  SRC_DATA            m_ssrcData;
-  unsigned int        m_framesBuffered;
-  std::list<PPacket*> m_outBuffer;
+  IAEResample        *m_resampler;
+  float              *m_resampleBuffer; /* resampler output */
+  unsigned int        m_resampleFrames; /* size of m_resampleBuffer in frames */
+  volatile unsigned int m_framesWritten; /* frames produced, only written by the producer */
+  volatile unsigned int m_framesRead;    /* frames consumed, only written by the mixer    */
+  volatile long       m_generation;      /* bumped by InternalFlush(), the mixer drops packets of older generations */
+  volatile long       m_readGeneration;  /* the generation m_framesRead counts, only written by the mixer */
+  volatile bool       m_drained;         /* set by the mixer when it ran dry while draining */
+  AESPSCRing<PPacket*> m_outBuffer;      /* producer to mixer hand-off */
   unsigned int        ProcessFrameBuffer();
+  void                QueuePacket(PPacket *pkt);
+  void                StartGeneration(long generation);
   PPacket            *m_newPacket;
   PPacket            *m_packet;
   uint8_t            *m_packetPos;
@@ -148,12 +175,19 @@ private:
   unsigned int       m_vizBufferSamples;
   IAudioCallback    *m_audioCallback;
 
-  /* fade values */
-  bool               m_fadeRunning;
+  /* fade values, FadeVolume() hands a fade to the mixer through m_fadeRequest */
+  struct FadeRequest
+  {
+    float target;
+    float step;
+  };
+  FadeRequest        m_fadeRequest;  /* written under m_lock while m_fadeSeq is odd */
+  volatile long      m_fadeSeq;      /* bumped before and after m_fadeRequest is written */
+  volatile long      m_fadeSeen;     /* the last m_fadeSeq the mixer picked up */
+  volatile bool      m_fadeRunning;  /* this and the rest are only written by the mixer */
   bool               m_fadeDirUp;
   float              m_fadeStep;
   float              m_fadeTarget;
-  unsigned int       m_fadeTime;
 
   /* slave stream */
   CSoftAEStream     *m_slave;
@@ -0,0 +1,89 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+
+/*
+  resampler quality tiers, selectable via <audio><resamplequality> in advancedsettings.xml.
+  Medium is libsamplerate's medium sinc, which is what the engine always used.
+  Low swaps in the polyphase FIR for fixed ratios to save CPU on slow hardware.
+*/
+enum AEResampleQuality
+{
+  AE_RESAMPLE_LOW = 0,
+  AE_RESAMPLE_MEDIUM,
+  AE_RESAMPLE_HIGH
+};
+
+/*
+  Interleaved float sample rate converter used by the engine streams.
+  Instances are obtained from CAEResampleFactory.
+*/
+class IAEResample
+{
+public:
+  /* return the name of this resampler for logging */
+  virtual const char *GetName() = 0;
+
+  IAEResample() {};
+  virtual ~IAEResample() {};
+
+  /*
+    Prepare to convert interleaved audio with the given channel count at
+    ratio (output rate / input rate).
+  */
+  virtual bool Initialize(unsigned int channels, double ratio) = 0;
+
+  /*
+    Change the conversion ratio on the fly. Returns false if this resampler
+    can not follow the new ratio, in which case the caller should switch to
+    one that can.
+  */
+  virtual bool SetRatio(double ratio) = 0;
+  virtual double GetRatio() = 0;
+
+  /*
+    Drop all buffered input and filter state.
+  */
+  virtual void Reset() = 0;
+
+  /*
+    Copy the input still held in the filter history to out, interleaved, so
+    a replacement resampler can carry on where this one stopped. lead is set
+    to how many of those frames (possibly fractional) have already been
+    turned into output. Returns the number of frames copied.
+  */
+  virtual unsigned int GetHistory(std::vector<float> &out, double &lead) { lead = 0.0; out.clear(); return 0; }
+
+  /*
+    Prime with the history of a previous resampler, see GetHistory. The
+    frames are run before the next input, the output for the first lead
+    frames is dropped.
+  */
+  virtual void SetHistory(const float *in, unsigned int frames, double lead) {}
+
+  /*
+    Convert up to inFrames frames from in, writing at most outFrames frames to
+    out. Returns the number of frames written and sets inUsed to the number of
+    input frames consumed. Returns -1 on error.
+  */
+  virtual int Resample(float *in, unsigned int inFrames, unsigned int &inUsed, float *out, unsigned int outFrames) = 0;
+};
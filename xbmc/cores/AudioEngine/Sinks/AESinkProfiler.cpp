@@ -29,8 +29,16 @@
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 #include "settings/GUISettings.h"
+#include "threads/Atomics.h"
 
-CAESinkProfiler::CAESinkProfiler()
+volatile long CAESinkProfiler::m_underruns    = 0;
+volatile long CAESinkProfiler::m_handOffs     = 0;
+volatile long CAESinkProfiler::m_handOffTotal = 0;
+volatile long CAESinkProfiler::m_handOffMax   = 0;
+
+CAESinkProfiler::CAESinkProfiler() :
+  m_ts        (0),
+  m_lastReport(0)
 {
 }
 
@@ -77,6 +85,24 @@ unsigned int CAESinkProfiler::AddPackets(uint8_t *data, unsigned int frames, boo
   int64_t ts = CurrentHostCounter();
   CLog::Log(LOGDEBUG, "CAESinkProfiler::AddPackets - latency %f ms", (float)(ts - m_ts) / 1000000.0f);
   m_ts = ts;
+
+  /* once a second dump the hand-off counters and start over */
+  if (ts - m_lastReport >= CurrentHostFrequency())
+  {
+    long underruns = m_underruns;
+    long handOffs  = m_handOffs;
+    long total     = m_handOffTotal;
+    long worst     = m_handOffMax;
+    AtomicSubtract(&m_underruns   , underruns);
+    AtomicSubtract(&m_handOffs    , handOffs );
+    AtomicSubtract(&m_handOffTotal, total    );
+    cas(&m_handOffMax, worst, 0);
+
+    CLog::Log(LOGDEBUG, "CAESinkProfiler::AddPackets - underruns %ld, hand-offs %ld, queue latency avg %.3f ms max %.3f ms",
+      underruns, handOffs, handOffs ? (float)total / handOffs / 1000.0f : 0.0f, (float)worst / 1000.0f);
+    m_lastReport = ts;
+  }
+
   return frames;
 }
 
@@ -84,6 +110,26 @@ void CAESinkProfiler::Drain()
 {
 }
 
+void CAESinkProfiler::ReportUnderrun()
+{
+  AtomicIncrement(&m_underruns);
+}
+
+void CAESinkProfiler::ReportHandOff(int64_t queuedAt)
+{
+  long latency = (long)((CurrentHostCounter() - queuedAt) * 1000000 / CurrentHostFrequency());
+  AtomicIncrement(&m_handOffs);
+  AtomicAdd(&m_handOffTotal, latency);
+
+  long worst;
+  do
+  {
+    worst = m_handOffMax;
+    if (latency <= worst)
+      break;
+  } while (cas(&m_handOffMax, worst, latency) != worst);
+}
+
 void CAESinkProfiler::EnumerateDevices (AEDeviceList &devices, bool passthrough)
 {
   devices.push_back(AEDevice("Profiler", "Profiler"));
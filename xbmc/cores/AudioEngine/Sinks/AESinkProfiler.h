@@ -42,6 +42,16 @@ public:
   virtual unsigned int AddPackets      (uint8_t *data, unsigned int frames, bool hasAudio);
   virtual void         Drain           ();
   static void          EnumerateDevices(AEDeviceList &devices, bool passthrough);
+
+  /* stream to mixer hand-off statistics, fed by the engine's mixer thread */
+  static void          ReportUnderrun  ();
+  static void          ReportHandOff   (int64_t queuedAt);
 private:
   int64_t m_ts;
+  int64_t m_lastReport;
+
+  static volatile long m_underruns;    /* stream underruns since the last report */
+  static volatile long m_handOffs;     /* packets handed to the mixer since the last report */
+  static volatile long m_handOffTotal; /* summed queue latency of those packets in us */
+  static volatile long m_handOffMax;   /* worst queue latency in us */
 };
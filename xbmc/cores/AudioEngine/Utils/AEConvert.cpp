@@ -25,11 +25,13 @@
 #include "AEUtil.h"
 #include "utils/MathUtils.h"
 #include "utils/EndianSwap.h"
+#include "utils/CPUInfo.h"
 #include <stdint.h>
 
 #if defined(TARGET_WINDOWS)
 #include <unistd.h>
 #endif
+#include <algorithm>
 #include <math.h>
 #include <string.h>
 
@@ -65,66 +67,145 @@ static inline int safeRound(double f)
   return MathUtils::round_int(f);
 }
 
-CAEConvert::AEConvertToFn CAEConvert::ToFloat(enum AEDataFormat dataFormat)
+/* map the native endian formats to their explicit counterparts */
+static enum AEDataFormat ResolveNE(enum AEDataFormat dataFormat)
 {
   switch (dataFormat)
   {
-    case AE_FMT_U8    : return &U8_Float;
-    case AE_FMT_S8    : return &S8_Float;
 #ifdef __BIG_ENDIAN__
-    case AE_FMT_S16NE : return &S16BE_Float;
-    case AE_FMT_S32NE : return &S32BE_Float;
-    case AE_FMT_S24NE4: return &S24BE4_Float;
-    case AE_FMT_S24NE3: return &S24BE3_Float;
+    case AE_FMT_S16NE : return AE_FMT_S16BE;
+    case AE_FMT_S32NE : return AE_FMT_S32BE;
+    case AE_FMT_S24NE4: return AE_FMT_S24BE4;
+    case AE_FMT_S24NE3: return AE_FMT_S24BE3;
 #else
-    case AE_FMT_S16NE : return &S16LE_Float;
-    case AE_FMT_S32NE : return &S32LE_Float;
-    case AE_FMT_S24NE4: return &S24LE4_Float;
-    case AE_FMT_S24NE3: return &S24LE3_Float;
+    case AE_FMT_S16NE : return AE_FMT_S16LE;
+    case AE_FMT_S32NE : return AE_FMT_S32LE;
+    case AE_FMT_S24NE4: return AE_FMT_S24LE4;
+    case AE_FMT_S24NE3: return AE_FMT_S24LE3;
+#endif
+    default:
+      return dataFormat;
+  }
+}
+
+CAEConvert::AEConvertToFn CAEConvert::ToFloat(enum AEDataFormat dataFormat, bool allowSIMD /* = true */)
+{
+  dataFormat = ResolveNE(dataFormat);
+
+#if defined(__SSE__)
+  if (allowSIMD && (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2))
+  {
+    switch (dataFormat)
+    {
+      case AE_FMT_U8    : return &U8_Float_SSE;
+      case AE_FMT_S8    : return &S8_Float_SSE;
+      case AE_FMT_S16LE : return &S16LE_Float_SSE;
+      case AE_FMT_S16BE : return &S16BE_Float_SSE;
+      case AE_FMT_S24LE4: return &S24LE4_Float_SSE;
+      case AE_FMT_S24BE4: return &S24BE4_Float_SSE;
+      case AE_FMT_S24LE3: return &S24LE3_Float_SSE;
+      case AE_FMT_S24BE3: return &S24BE3_Float_SSE;
+      case AE_FMT_S32LE : return &S32LE_Float_SSE;
+      case AE_FMT_S32BE : return &S32BE_Float_SSE;
+      default:
+        break;
+    }
+  }
+#endif
+
+#if defined(__ARM_NEON__)
+  if (allowSIMD && (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_NEON))
+  {
+    switch (dataFormat)
+    {
+      case AE_FMT_U8    : return &U8_Float_Neon;
+      case AE_FMT_S8    : return &S8_Float_Neon;
+      case AE_FMT_S16LE : return &S16LE_Float_Neon;
+      case AE_FMT_S16BE : return &S16BE_Float_Neon;
+      case AE_FMT_S24LE4: return &S24LE4_Float_Neon;
+      case AE_FMT_S24BE4: return &S24BE4_Float_Neon;
+      case AE_FMT_S24LE3: return &S24LE3_Float_Neon;
+      case AE_FMT_S24BE3: return &S24BE3_Float_Neon;
+      case AE_FMT_S32LE : return &S32LE_Float_Neon;
+      case AE_FMT_S32BE : return &S32BE_Float_Neon;
+      default:
+        break;
+    }
+  }
 #endif
+
+  switch (dataFormat)
+  {
+    case AE_FMT_U8    : return &U8_Float;
+    case AE_FMT_S8    : return &S8_Float;
     case AE_FMT_S16LE : return &S16LE_Float;
     case AE_FMT_S16BE : return &S16BE_Float;
     case AE_FMT_S24LE4: return &S24LE4_Float;
     case AE_FMT_S24BE4: return &S24BE4_Float;
     case AE_FMT_S24LE3: return &S24LE3_Float;
     case AE_FMT_S24BE3: return &S24BE3_Float;
-#if defined(__ARM_NEON__)
-    case AE_FMT_S32LE : return &S32LE_Float_Neon;
-    case AE_FMT_S32BE : return &S32BE_Float_Neon;
-#else
     case AE_FMT_S32LE : return &S32LE_Float;
     case AE_FMT_S32BE : return &S32BE_Float;
-#endif
     case AE_FMT_DOUBLE: return &DOUBLE_Float;
     default:
       return NULL;
   }
 }
 
-CAEConvert::AEConvertFrFn CAEConvert::FrFloat(enum AEDataFormat dataFormat)
+CAEConvert::AEConvertFrFn CAEConvert::FrFloat(enum AEDataFormat dataFormat, bool allowSIMD /* = true */)
 {
+  /* the 24 bit formats can only be output in native byte order */
+  if (dataFormat == AE_FMT_S16NE || dataFormat == AE_FMT_S32NE)
+    dataFormat = ResolveNE(dataFormat);
+
+#if defined(__SSE__)
+  if (allowSIMD && (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2))
+  {
+    switch (dataFormat)
+    {
+      case AE_FMT_U8    : return &Float_U8_SSE;
+      case AE_FMT_S8    : return &Float_S8_SSE;
+      case AE_FMT_S16LE : return &Float_S16LE_SSE;
+      case AE_FMT_S16BE : return &Float_S16BE_SSE;
+      case AE_FMT_S24NE4: return &Float_S24NE4_SSE;
+      case AE_FMT_S24NE3: return &Float_S24NE3_SSE;
+      case AE_FMT_S32LE : return &Float_S32LE_SSE;
+      case AE_FMT_S32BE : return &Float_S32BE_SSE;
+      default:
+        break;
+    }
+  }
+#endif
+
+#if defined(__ARM_NEON__)
+  if (allowSIMD && (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_NEON))
+  {
+    switch (dataFormat)
+    {
+      case AE_FMT_U8    : return &Float_U8_Neon;
+      case AE_FMT_S8    : return &Float_S8_Neon;
+      case AE_FMT_S16LE : return &Float_S16LE_Neon;
+      case AE_FMT_S16BE : return &Float_S16BE_Neon;
+      case AE_FMT_S24NE4: return &Float_S24NE4_Neon;
+      case AE_FMT_S24NE3: return &Float_S24NE3_Neon;
+      case AE_FMT_S32LE : return &Float_S32LE_Neon;
+      case AE_FMT_S32BE : return &Float_S32BE_Neon;
+      default:
+        break;
+    }
+  }
+#endif
+
   switch (dataFormat)
   {
     case AE_FMT_U8    : return &Float_U8;
     case AE_FMT_S8    : return &Float_S8;
-#ifdef __BIG_ENDIAN__
-    case AE_FMT_S16NE : return &Float_S16BE;
-    case AE_FMT_S32NE : return &Float_S32BE;
-#else
-    case AE_FMT_S16NE : return &Float_S16LE;
-    case AE_FMT_S32NE : return &Float_S32LE;
-#endif
     case AE_FMT_S16LE : return &Float_S16LE;
     case AE_FMT_S16BE : return &Float_S16BE;
     case AE_FMT_S24NE4: return &Float_S24NE4;
     case AE_FMT_S24NE3: return &Float_S24NE3;
-#if defined(__ARM_NEON__)
-    case AE_FMT_S32LE : return &Float_S32LE_Neon;
-    case AE_FMT_S32BE : return &Float_S32BE_Neon;
-#else
     case AE_FMT_S32LE : return &Float_S32LE;
     case AE_FMT_S32BE : return &Float_S32BE;
-#endif
     case AE_FMT_DOUBLE: return &Float_DOUBLE;
     default:
       return NULL;
@@ -146,7 +227,7 @@ unsigned int CAEConvert::S8_Float(uint8_t *data, const unsigned int samples, flo
   const float mul = 1.0f / (INT8_MAX + 0.5f);
 
   for (unsigned int i = 0; i < samples; ++i)
-    *dest++ = *data++ * mul;
+    *dest++ = (int8_t)*data++ * mul;
 
   return samples;
 }
@@ -176,7 +257,7 @@ unsigned int CAEConvert::S16LE_Float(uint8_t* data, const unsigned int samples,
   }
 #else
   for (unsigned int i = 0; i < samples; ++i, data += 2)
-    *dest++ = Endian_SwapLE16(*(int16_t*)data) * mul;
+    *dest++ = (int16_t)Endian_SwapLE16(*(int16_t*)data) * mul;
 #endif
 
   return samples;
@@ -207,7 +288,7 @@ unsigned int CAEConvert::S16BE_Float(uint8_t* data, const unsigned int samples,
   }
 #else
   for (unsigned int i = 0; i < samples; ++i, data += 2)
-    *dest++ = Endian_SwapBE16(*(int16_t*)data) * mul;
+    *dest++ = (int16_t)Endian_SwapBE16(*(int16_t*)data) * mul;
 #endif
 
   return samples;
@@ -247,7 +328,7 @@ unsigned int CAEConvert::S24BE3_Float(uint8_t *data, const unsigned int samples,
 {
   for (unsigned int i = 0; i < samples; ++i, data += 3)
   {
-    int s = (data[1] << 24) | (data[2] << 16) | (data[3] << 8);
+    int s = (data[0] << 24) | (data[1] << 16) | (data[2] << 8);
     *dest++ = (float)s * INT32_SCALE;
   }
   return samples;
@@ -261,54 +342,16 @@ unsigned int CAEConvert::S32LE_Float(uint8_t *data, const unsigned int samples,
   /* do this in groups of 4 to give the compiler a better chance of optimizing this */
   for (float *end = dest + (samples & ~0x3); dest < end;)
   {
-    *dest++ = (float)Endian_SwapLE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapLE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapLE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapLE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapLE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapLE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapLE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapLE32(*src++) * factor;
   }
 
   /* process any remaining samples */
   for (float *end = dest + (samples & 0x3); dest < end;)
-    *dest++ = (float)Endian_SwapLE32(*src++) * factor;
-
-  return samples;
-}
-
-unsigned int CAEConvert::S32LE_Float_Neon(uint8_t *data, const unsigned int samples, float *dest)
-{
-#if defined(__ARM_NEON__)
-  static const float factor = 1.0f / (float)INT32_MAX;
-  int32_t *src = (int32_t*)data;
-
-  /* groups of 4 samples */
-  for (float *end = dest + (samples & ~0x3); dest < end; src += 4, dest += 4)
-  {
-    int32x4_t val = vld1q_s32(src);
-    #ifdef __BIG_ENDIAN__
-    val = vrev64q_s32(val);
-    #endif
-    float32x4_t ret = vmulq_n_f32(vcvtq_f32_s32(val), factor);
-    vst1q_f32((float32_t*)dest, ret);
-  }
-
-  /* if there are >= 2 remaining samples */
-  if (samples & 0x2)
-  {
-    int32x2_t val = vld1_s32(src);
-    #ifdef __BIG_ENDIAN__
-    val = vrev64_s32(val);
-    #endif
-    float32x2_t ret = vmul_n_f32(vcvt_f32_s32(val), factor);
-    vst1_f32((float32_t *)dest, ret);
-    src  += 2;
-    dest += 2;
-  }
+    *dest++ = (float)(int32_t)Endian_SwapLE32(*src++) * factor;
 
-  /* if there is one remaining sample */
-  if (samples & 0x1)
-    dest[0] = (float)src[0] * factor;
-
-#endif /* !defined(__ARM_NEON__) */
   return samples;
 }
 
@@ -320,54 +363,16 @@ unsigned int CAEConvert::S32BE_Float(uint8_t *data, const unsigned int samples,
   /* do this in groups of 4 to give the compiler a better chance of optimizing this */
   for (float *end = dest + (samples & ~0x3); dest < end;)
   {
-    *dest++ = (float)Endian_SwapBE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapBE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapBE32(*src++) * factor;
-    *dest++ = (float)Endian_SwapBE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapBE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapBE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapBE32(*src++) * factor;
+    *dest++ = (float)(int32_t)Endian_SwapBE32(*src++) * factor;
   }
 
   /* process any remaining samples */
   for (float *end = dest + (samples & 0x3); dest < end;)
-    *dest++ = (float)Endian_SwapBE32(*src++) * factor;
-
-  return samples;
-}
-
-unsigned int CAEConvert::S32BE_Float_Neon(uint8_t *data, const unsigned int samples, float *dest)
-{
-#if defined(__ARM_NEON__)
-  static const float factor = 1.0f / (float)INT32_MAX;
-  int32_t *src = (int32_t*)data;
-
-  /* groups of 4 samples */
-  for (float *end = dest + (samples & ~0x3); dest < end; src += 4, dest += 4)
-  {
-    int32x4_t val = vld1q_s32(src);
-    #ifndef __BIG_ENDIAN__
-    val = vrev64q_s32(val);
-    #endif
-    float32x4_t ret = vmulq_n_f32(vcvtq_f32_s32(val), factor);
-    vst1q_f32((float32_t *)dest, ret);
-  }
-
-  /* if there are >= 2 remaining samples */
-  if (samples & 0x2)
-  {
-    int32x2_t val = vld1_s32(src);
-    #ifndef __BIG_ENDIAN__
-    val = vrev64_s32(val);
-    #endif
-    float32x2_t ret = vmul_n_f32(vcvt_f32_s32(val), factor);
-    vst1_f32((float32_t *)dest, ret);
-    src  += 2;
-    dest += 2;
-  }
+    *dest++ = (float)(int32_t)Endian_SwapBE32(*src++) * factor;
 
-  /* if there is one remaining sample */
-  if (samples & 0x1)
-    dest[0] = (float)src[0] * factor;
-
-#endif /* !defined(__ARM_NEON__) */
   return samples;
 }
 
@@ -382,134 +387,18 @@ unsigned int CAEConvert::DOUBLE_Float(uint8_t *data, const unsigned int samples,
 
 unsigned int CAEConvert::Float_U8(float *data, const unsigned int samples, uint8_t *dest)
 {
-  #ifdef __SSE__
-  const __m128 mul = _mm_set_ps1((float)INT8_MAX+.5f);
-  const __m128 add = _mm_set_ps1(1.0f);
-  unsigned int count = samples;
-
-  /* work around invalid alignment */
-  while ((((uintptr_t)data & 0xF) || ((uintptr_t)dest & 0xF)) && count > 0)
-  {
-    dest[0] = safeRound((data[0] + 1.0f) * ((float)INT8_MAX+.5f));
-    ++data;
-    ++dest;
-    --count;
-  }
-
-  const uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i += 4, data += 4)
-  {
-    __m128 in  = _mm_mul_ps(_mm_add_ps(_mm_load_ps(data), add), mul);
-    __m64  con = _mm_cvtps_pi16(in);
-
-    int16_t temp[4];
-    memcpy(temp, &con, sizeof(temp));
-    *dest++ = (uint8_t)temp[0];
-    *dest++ = (uint8_t)temp[1];
-    *dest++ = (uint8_t)temp[2];
-    *dest++ = (uint8_t)temp[3];
-  }
-
-  if (count != even)
-  {
-    const uint32_t odd = count - even;
-    if (odd == 1)
-    {
-      _mm_empty();
-      dest[0] = safeRound((data[0] + 1.0f) * ((float)INT8_MAX+.5f));
-    }
-    else
-    {
-      __m128 in;
-      if (odd == 2)
-      {
-        in = _mm_setr_ps(data[0], data[1], 0, 0);
-        in = _mm_mul_ps(_mm_add_ps(_mm_load_ps(data), add), mul);
-        __m64 con = _mm_cvtps_pi16(in);
-
-        int16_t temp[2];
-        memcpy(temp, &con, sizeof(temp));
-        dest[0] = (uint8_t)temp[0];
-        dest[1] = (uint8_t)temp[1];
-      }
-      else
-      {
-        in = _mm_setr_ps(data[0], data[1], data[2], 0);
-        in = _mm_mul_ps(_mm_add_ps(_mm_load_ps(data), add), mul);
-        __m64 con = _mm_cvtps_pi16(in);
-
-        int16_t temp[3];
-        memcpy(temp, &con, sizeof(temp));
-        dest[0] = (uint8_t)temp[0];
-        dest[1] = (uint8_t)temp[1];
-        dest[2] = (uint8_t)temp[2];
-      }
-    }
-  }
-  _mm_empty();
-  #else /* no SSE */
+  /* saturate like the SIMD versions, full scale would otherwise wrap */
   for (uint32_t i = 0; i < samples; ++i)
-    *dest++ = safeRound((*data++ + 1.0f) * ((float)INT8_MAX+.5f));
-  #endif
+    *dest++ = std::min(std::max(safeRound((*data++ + 1.0f) * ((float)INT8_MAX+.5f)), 0), (int)UINT8_MAX);
 
   return samples;
 }
 
 unsigned int CAEConvert::Float_S8(float *data, const unsigned int samples, uint8_t *dest)
 {
-  #ifdef __SSE__
-  const __m128 mul = _mm_set_ps1((float)INT8_MAX+.5f);
-  unsigned int count = samples;
-
-  /* work around invalid alignment */
-  while ((((uintptr_t)data & 0xF) || ((uintptr_t)dest & 0xF)) && count > 0)
-  {
-    dest[0] = safeRound(data[0] * ((float)INT8_MAX+.5f));
-    ++data;
-    ++dest;
-    --count;
-  }
-
-  const uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i += 4, data += 4, dest += 4)
-  {
-    __m128 in  = _mm_mul_ps(_mm_load_ps(data), mul);
-    __m64  con = _mm_cvtps_pi8(in);
-    memcpy(dest, &con, 4);
-  }
-
-  if (count != even)
-  {
-    const uint32_t odd = count - even;
-    if (odd == 1)
-    {
-      _mm_empty();
-      dest[0] = safeRound(data[0] * ((float)INT8_MAX+.5f));
-    }
-    else
-    {
-      __m128 in;
-      if (odd == 2)
-      {
-        in = _mm_setr_ps(data[0], data[1], 0, 0);
-        in = _mm_mul_ps(_mm_load_ps(data), mul);
-        __m64 con = _mm_cvtps_pi8(in);
-        memcpy(dest, &con, 2);
-      }
-      else
-      {
-        in = _mm_setr_ps(data[0], data[1], data[2], 0);
-        in = _mm_mul_ps(_mm_load_ps(data), mul);
-        __m64 con = _mm_cvtps_pi8(in);
-        memcpy(dest, &con, 3);
-      }
-    }
-  }
-  _mm_empty();
-  #else /* no SSE */
+  /* saturate like the SIMD versions, 1.0 would otherwise wrap to INT8_MIN */
   for (uint32_t i = 0; i < samples; ++i)
-    *dest++ = safeRound(*data++ * ((float)INT8_MAX+.5f));
-  #endif
+    *dest++ = std::min(std::max(safeRound(*data++ * ((float)INT8_MAX+.5f)), (int)INT8_MIN), (int)INT8_MAX);
 
   return samples;
 }
@@ -517,114 +406,6 @@ unsigned int CAEConvert::Float_S8(float *data, const unsigned int samples, uint8
 unsigned int CAEConvert::Float_S16LE(float *data, const unsigned int samples, uint8_t *dest)
 {
   int16_t *dst = (int16_t*)dest;
-  #ifdef __SSE__
-
-  unsigned int count     = samples;
-  unsigned int unaligned = (0x10 - ((uintptr_t)data & 0xF)) >> 2;
-  if (unaligned == 4)
-    unaligned = 0;
-
-  /*
-    if we are only out by one, dont use SSE to correct it.
-    this must run before we do any SSE work so that the FPU
-    is in a working state without having to first call
-    _mm_empty()
-  */
-  if (unaligned == 1)
-    dst[0] = Endian_SwapLE16(safeRound(data[0] * ((float)INT16_MAX + CAEUtil::FloatRand1(-0.5f, 0.5f))));
-
-  MEMALIGN(16, static const __m128  mul) = _mm_set_ps1((float)INT16_MAX);
-  MEMALIGN(16, __m128  rand);
-  MEMALIGN(16, __m128  in  );
-  MEMALIGN(16, __m128i con );
-
-  /* if unaligned is greater then one, use SSE to correct it */
-  if (unaligned > 1)
-  {
-    switch (unaligned)
-    {
-      case 1: in = _mm_setr_ps(data[0], 0      , 0      , 0); break;
-      case 2: in = _mm_setr_ps(data[0], data[1], 0      , 0); break;
-      case 3: in = _mm_setr_ps(data[0], data[1], data[2], 0); break;
-    }
-
-    /* random round to dither */
-    CAEUtil::FloatRand4(-0.5f, 0.5f, NULL, &rand);
-    in  = _mm_mul_ps(in, _mm_add_ps(mul, rand));
-    con = _mm_cvtps_epi32(in);
-
-    #ifdef __BIG_ENDIAN__
-    con = _mm_or_si128(_mm_slli_epi16(con, 8), _mm_srli_epi16(con, 8));
-    #endif
-
-    dst[0] = _mm_extract_epi16(con, 0);
-    if (unaligned == 3)
-    {
-      dst[1] = _mm_extract_epi16(con, 2);
-      dst[2] = _mm_extract_epi16(con, 4);
-    }
-    else if (unaligned == 2)
-      dst[1] = _mm_extract_epi16(con, 2);
-  }
-
-  /* update our pointers and sample count */
-  data  += unaligned;
-  dst   += unaligned;
-  count -= unaligned;
-
-  const uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i += 4, data += 4, dst += 4)
-  {
-    /* random round to dither */
-    CAEUtil::FloatRand4(-0.5f, 0.5f, NULL, &rand);
-    in   = _mm_mul_ps(_mm_load_ps(data), _mm_add_ps(mul, rand));
-    con  = _mm_cvtps_epi32(in);
-
-    #ifdef __BIG_ENDIAN__
-    con = _mm_or_si128(_mm_slli_epi16(con, 8), _mm_srli_epi16(con, 8));
-    #endif
-
-    dst[0] = _mm_extract_epi16(con, 0);
-    dst[1] = _mm_extract_epi16(con, 2);
-    dst[2] = _mm_extract_epi16(con, 4);
-    dst[3] = _mm_extract_epi16(con, 6);
-  }
-
-  /* calculate the final unaligned samples if there is any */
-  if (samples != even)
-  {
-    unaligned = samples - even;
-    switch (unaligned)
-    {
-      case 1: in = _mm_setr_ps(data[0], 0      , 0      , 0); break;
-      case 2: in = _mm_setr_ps(data[0], data[1], 0      , 0); break;
-      case 3: in = _mm_setr_ps(data[0], data[1], data[2], 0); break;
-    }
-
-    /* random round to dither */
-    CAEUtil::FloatRand4(-0.5f, 0.5f, NULL, &rand);
-    in  = _mm_mul_ps(in, _mm_add_ps(mul, rand));
-    con = _mm_cvtps_epi32(in);
-
-    #ifdef __BIG_ENDIAN__
-    con = _mm_or_si128(_mm_slli_epi16(con, 8), _mm_srli_epi16(con, 8));
-    #endif
-
-    dst[0] = _mm_extract_epi16(con, 0);
-    if (unaligned == 3)
-    {
-      dst[1] = _mm_extract_epi16(con, 2);
-      dst[2] = _mm_extract_epi16(con, 4);
-    }
-    else if (unaligned == 2)
-      dst[1] = _mm_extract_epi16(con, 2);
-  }
-
-  /* cleanup */
-  _mm_empty();
-
-  #else /* no SSE */
-
   uint32_t i    = 0;
   uint32_t even = samples & ~0x3;
 
@@ -643,122 +424,12 @@ unsigned int CAEConvert::Float_S16LE(float *data, const unsigned int samples, ui
   for(; i < samples; ++i)
     *dst++ = Endian_SwapLE16(safeRound(*data++ * ((float)INT16_MAX + CAEUtil::FloatRand1(-0.5f, 0.5f))));
 
-  #endif
-
   return samples << 1;
 }
 
 unsigned int CAEConvert::Float_S16BE(float *data, const unsigned int samples, uint8_t *dest)
 {
   int16_t *dst = (int16_t*)dest;
-  #ifdef __SSE__
-
-  unsigned int count     = samples;
-  unsigned int unaligned = (0x10 - ((uintptr_t)data & 0xF)) >> 2;
-  if (unaligned == 4)
-    unaligned = 0;
-
-  /*
-    if we are only out by one, dont use SSE to correct it.
-    this must run before we do any SSE work so that the FPU
-    is in a working state without having to first call
-    _mm_empty()
-  */
-  if (unaligned == 1)
-     dst[0] = Endian_SwapBE16(safeRound(data[0] * ((float)INT16_MAX + CAEUtil::FloatRand1(-0.5f, 0.5f))));
-
-  MEMALIGN(16, static const __m128  mul) = _mm_set_ps1((float)INT16_MAX);
-  MEMALIGN(16, __m128  rand);
-  MEMALIGN(16, __m128  in  ) = _mm_setr_ps(0, 0, 0, 0);
-  MEMALIGN(16, __m128i con );
-
-  /* if unaligned is greater then one, use SSE to correct it */
-  if (unaligned > 1)
-  {
-    switch (unaligned)
-    {
-      case 1: in = _mm_setr_ps(data[0], 0      , 0      , 0); break;
-      case 2: in = _mm_setr_ps(data[0], data[1], 0      , 0); break;
-      case 3: in = _mm_setr_ps(data[0], data[1], data[2], 0); break;
-    }
-
-    /* random round to dither */
-    CAEUtil::FloatRand4(-0.5f, 0.5f, NULL, &rand);
-    in  = _mm_mul_ps(in, _mm_add_ps(mul, rand));
-    con = _mm_cvtps_epi32(in);
-
-    #ifndef __BIG_ENDIAN__
-    con = _mm_or_si128(_mm_slli_epi16(con, 8), _mm_srli_epi16(con, 8));
-    #endif
-
-    dst[0] = _mm_extract_epi16(con, 0);
-    if (unaligned == 3)
-    {
-      dst[1] = _mm_extract_epi16(con, 2);
-      dst[2] = _mm_extract_epi16(con, 4);
-    }
-    else if (unaligned == 2)
-      dst[1] = _mm_extract_epi16(con, 2);
-  }
-
-  /* update our pointers and sample count */
-  data  += unaligned;
-  dst   += unaligned;
-  count -= unaligned;
-
-  const uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i += 4, data += 4, dst += 4)
-  {
-    /* random round to dither */
-    CAEUtil::FloatRand4(-0.5f, 0.5f, NULL, &rand);
-    in   = _mm_mul_ps(_mm_load_ps(data), _mm_add_ps(mul, rand));
-    con  = _mm_cvtps_epi32(in);
-
-    #ifndef __BIG_ENDIAN__
-    con = _mm_or_si128(_mm_slli_epi16(con, 8), _mm_srli_epi16(con, 8));
-    #endif
-
-    dst[0] = _mm_extract_epi16(con, 0);
-    dst[1] = _mm_extract_epi16(con, 2);
-    dst[2] = _mm_extract_epi16(con, 4);
-    dst[3] = _mm_extract_epi16(con, 6);
-  }
-
-  /* calculate the final unaligned samples if there is any */
-  if (samples != even)
-  {
-    unaligned = samples - even;
-    switch (unaligned)
-    {
-      case 1: in = _mm_setr_ps(data[0], 0      , 0      , 0); break;
-      case 2: in = _mm_setr_ps(data[0], data[1], 0      , 0); break;
-      case 3: in = _mm_setr_ps(data[0], data[1], data[2], 0); break;
-    }
-
-    /* random round to dither */
-    CAEUtil::FloatRand4(-0.5f, 0.5f, NULL, &rand);
-    in  = _mm_mul_ps(in, _mm_add_ps(mul, rand));
-    con = _mm_cvtps_epi32(in);
-
-    #ifndef __BIG_ENDIAN__
-    con = _mm_or_si128(_mm_slli_epi16(con, 8), _mm_srli_epi16(con, 8));
-    #endif
-
-    dst[0] = _mm_extract_epi16(con, 0);
-    if (unaligned == 3)
-    {
-      dst[1] = _mm_extract_epi16(con, 2);
-      dst[2] = _mm_extract_epi16(con, 4);
-    }
-    else if (unaligned == 2)
-      dst[1] = _mm_extract_epi16(con, 2);
-  }
-
-  /* cleanup */
-  _mm_empty();
-
-  #else /* no SSE */
-
   uint32_t i    = 0;
   uint32_t even = samples & ~0x3;
 
@@ -774,71 +445,17 @@ unsigned int CAEConvert::Float_S16BE(float *data, const unsigned int samples, ui
     *dst++ = Endian_SwapBE16(safeRound(*data++ * ((float)INT16_MAX + rand[3])));
   }
 
-  for(; i < samples; ++i, data++, dst++)
+  for(; i < samples; ++i)
     *dst++ = Endian_SwapBE16(safeRound(*data++ * ((float)INT16_MAX + CAEUtil::FloatRand1(-0.5f, 0.5f))));
 
-  #endif
-
   return samples << 1;
 }
 
 unsigned int CAEConvert::Float_S24NE4(float *data, const unsigned int samples, uint8_t *dest)
 {
   int32_t *dst = (int32_t*)dest;
-  #ifdef __SSE__
-
-  const __m128 mul = _mm_set_ps1((float)INT24_MAX+.5f);
-  unsigned int count = samples;
-
-  /* work around invalid alignment */
-  while ((((uintptr_t)data & 0xF) || ((uintptr_t)dest & 0xF)) && count > 0)
-  {
-    dst[0] = safeRound(data[0] * ((float)INT24_MAX+.5f));
-    ++data;
-    ++dst;
-    --count;
-  }
-
-  const uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i += 4, data += 4, dst += 4)
-  {
-    __m128  in  = _mm_mul_ps(_mm_load_ps(data), mul);
-    __m128i con = _mm_cvtps_epi32(in);
-    con         = _mm_slli_epi32(con, 8);
-    memcpy(dst, &con, sizeof(int32_t) * 4);
-  }
-
-  if (samples != even)
-  {
-    const uint32_t odd = samples - even;
-    if (odd == 1)
-      dst[0] = safeRound(data[0] * ((float)INT24_MAX+.5f));
-    else
-    {
-      __m128 in;
-      if (odd == 2)
-      {
-        in = _mm_setr_ps(data[0], data[1], 0, 0);
-        in = _mm_mul_ps(in, mul);
-        __m64 con = _mm_cvtps_pi32(in);
-        con       = _mm_slli_pi32(con, 8);
-        memcpy(dst, &con, sizeof(int32_t) * 2);
-      }
-      else
-      {
-        in = _mm_setr_ps(data[0], data[1], data[2], 0);
-        in = _mm_mul_ps(in, mul);
-        __m128i con = _mm_cvtps_epi32(in);
-        con         = _mm_slli_epi32(con, 8);
-        memcpy(dst, &con, sizeof(int32_t) * 3);
-      }
-    }
-  }
-  _mm_empty();
-  #else /* no SSE */
   for (uint32_t i = 0; i < samples; ++i)
     *dst++ = (safeRound(*data++ * ((float)INT24_MAX+.5f)) & 0xFFFFFF) << 8;
-  #endif
 
   return samples << 2;
 }
@@ -854,70 +471,12 @@ unsigned int CAEConvert::Float_S24NE3(float *data, const unsigned int samples, u
     0;
 #endif
 
-  /* disabled as it does not currently work */
-  #if 0 && defined(__SSE__)
-  int32_t *dst = (int32_t*)dest;
-
-  const __m128 mul = _mm_set_ps1((float)INT24_MAX+.5f);
-  unsigned int count = samples;
-
-  /* work around invalid alignment */
-  while ((((uintptr_t)data & 0xF) || ((uintptr_t)dest & 0xF)) && count > 0)
-  {
-    *((uint32_t*)(dest)) = (safeRound(*data * ((float)INT24_MAX+.5f)) & 0xFFFFFF) << leftShift;
-    ++dest;
-    --count;
-  }
-
-  const uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < count; i += 4, data += 4, dest += 12)
-  {
-    __m128  in  = _mm_mul_ps(_mm_load_ps(data), mul);
-    __m128i con = _mm_cvtps_epi32(in);
-    con         = _mm_slli_epi32(con, 8);
-    memcpy(dst, &con, sizeof(int32_t) * 4);
-    *((uint32_t*)(dest + 0)) = (dst[0] & 0xFFFFFF) << leftShift;
-    *((uint32_t*)(dest + 3)) = (dst[1] & 0xFFFFFF) << leftShift;
-    *((uint32_t*)(dest + 6)) = (dst[2] & 0xFFFFFF) << leftShift;
-    *((uint32_t*)(dest + 9)) = (dst[3] & 0xFFFFFF) << leftShift;
-  }
-
-  if (samples != even)
+  /* only copy 3 bytes so the last sample does not write past the buffer */
+  for (uint32_t i = 0; i < samples; ++i, ++data, dest += 3)
   {
-    const uint32_t odd = samples - even;
-    if (odd == 1)
-      dst[0] = safeRound(data[0] * ((float)INT24_MAX+.5f)) & 0xFFFFFF;
-    else
-    {
-      __m128 in;
-      if (odd == 2)
-      {
-        in = _mm_setr_ps(data[0], data[1], 0, 0);
-        in = _mm_mul_ps(in, mul);
-        __m64 con = _mm_cvtps_pi32(in);
-        con       = _mm_slli_pi32(con, 8);
-        memcpy(dst, &con, sizeof(int32_t) * 2);
-        *((uint32_t*)(dest + 0)) = (dst[0] & 0xFFFFFF) << leftShift;
-        *((uint32_t*)(dest + 3)) = (dst[1] & 0xFFFFFF) << leftShift;
-      }
-      else
-      {
-        in = _mm_setr_ps(data[0], data[1], data[2], 0);
-        in = _mm_mul_ps(in, mul);
-        __m128i con = _mm_cvtps_epi32(in);
-        con         = _mm_slli_epi32(con, 8);
-        memcpy(dst, &con, sizeof(int32_t) * 3);
-        *((uint32_t*)(dest + 0)) = (dst[0] & 0xFFFFFF) << leftShift;
-        *((uint32_t*)(dest + 3)) = (dst[1] & 0xFFFFFF) << leftShift;
-        *((uint32_t*)(dest + 6)) = (dst[2] & 0xFFFFFF) << leftShift;
-      }
-    }
+    uint32_t val = (safeRound(*data * ((float)INT24_MAX+.5f)) & 0xFFFFFF) << leftShift;
+    memcpy(dest, &val, 3);
   }
-  _mm_empty();
-  #else /* no SSE */
-  for (uint32_t i = 0; i < samples; ++i, ++data, dest += 3)
-    *((uint32_t*)(dest)) = (safeRound(*data * ((float)INT24_MAX+.5f)) & 0xFFFFFF) << leftShift;
-  #endif
 
   return samples * 3;
 }
@@ -925,226 +484,732 @@ unsigned int CAEConvert::Float_S24NE3(float *data, const unsigned int samples, u
 unsigned int CAEConvert::Float_S32LE(float *data, const unsigned int samples, uint8_t *dest)
 {
   int32_t *dst = (int32_t*)dest;
-  #ifdef __SSE__
-  const __m128 mul = _mm_set_ps1((float)INT32_MAX);
-  unsigned int count = samples;
-
-  /* work around invalid alignment */
-  while ((((uintptr_t)data & 0xF) || ((uintptr_t)dest & 0xF)) && count > 0)
-  {
-    dst[0] = safeRound(data[0] * (float)INT32_MAX);
-    ++data;
-    ++dst;
-    --count;
-  }
-
-  const uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i += 4, data += 4, dst += 4)
-  {
-    __m128  in  = _mm_mul_ps(_mm_load_ps(data), mul);
-    __m128i con = _mm_cvtps_epi32(in);
-    memcpy(dst, &con, sizeof(int32_t) * 4);
-    dst[0] = Endian_SwapLE32(dst[0]);
-    dst[1] = Endian_SwapLE32(dst[1]);
-    dst[2] = Endian_SwapLE32(dst[2]);
-    dst[3] = Endian_SwapLE32(dst[3]);
-  }
-
-  if (samples != even)
-  {
-    const uint32_t odd = samples - even;
-    if (odd == 1)
-    {
-      dst[0] = safeRound(data[0] * (float)INT32_MAX);
-      dst[0] = Endian_SwapLE32(dst[0]);
-    }
-    else
-    {
-      __m128 in;
-      if (odd == 2)
-      {
-        in = _mm_setr_ps(data[0], data[1], 0, 0);
-        in = _mm_mul_ps(in, mul);
-        __m64 con = _mm_cvtps_pi32(in);
-        memcpy(dst, &con, sizeof(int32_t) * 2);
-        dst[0] = Endian_SwapLE32(dst[0]);
-        dst[1] = Endian_SwapLE32(dst[1]);
-      }
-      else
-      {
-        in = _mm_setr_ps(data[0], data[1], data[2], 0);
-        in = _mm_mul_ps(in, mul);
-        __m128i con = _mm_cvtps_epi32(in);
-        memcpy(dst, &con, sizeof(int32_t) * 3);
-        dst[0] = Endian_SwapLE32(dst[0]);
-        dst[1] = Endian_SwapLE32(dst[1]);
-        dst[2] = Endian_SwapLE32(dst[2]);
-      }
-    }
-  }
-  _mm_empty();
-  #else
-
-  /* no SIMD */
   for (uint32_t i = 0; i < samples; ++i, ++data, ++dst)
   {
     dst[0] = safeRound(data[0] * (float)INT32_MAX);
     dst[0] = Endian_SwapLE32(dst[0]);
   }
-  #endif
   return samples << 2;
 }
 
-
-unsigned int CAEConvert::Float_S32LE_Neon(float *data, const unsigned int samples, uint8_t *dest)
+unsigned int CAEConvert::Float_S32BE(float *data, const unsigned int samples, uint8_t *dest)
 {
-#if defined(__ARM_NEON__)
   int32_t *dst = (int32_t*)dest;
-  for (float *end = data + (samples & ~0x3); data < end; data += 4, dst += 4)
+  for (uint32_t i = 0; i < samples; ++i, ++data, ++dst)
   {
-    float32x4_t val = vmulq_n_f32(vld1q_f32((const float32_t *)data), INT32_MAX);
-    int32x4_t   ret = vcvtq_s32_f32(val);
-    #ifdef __BIG_ENDIAN__
-    ret = vrev64q_s32(ret);
-    #endif
-    vst1q_s32(dst, ret);
+    dst[0] = safeRound(data[0] * (float)INT32_MAX);
+    dst[0] = Endian_SwapBE32(dst[0]);
   }
 
-  if (samples & 0x2)
-  {
-    float32x2_t val = vmul_n_f32(vld1_f32((const float32_t *)data), INT32_MAX);
-    int32x2_t   ret = vcvt_s32_f32(val);
-    #ifdef __BIG_ENDIAN__
-    ret = vrev64_s32(ret);
-    #endif
-    vst1_s32(dst, ret);
-    data += 2;
-    dst  += 2;
-  }
+  return samples << 2;
+}
 
-  if (samples & 0x1)
-  {
-    dst[0] = safeRound(data[0] * (float)INT32_MAX);
-    dst[0] = Endian_SwapLE32(dst[0]);
+unsigned int CAEConvert::Float_DOUBLE(float *data, const unsigned int samples, uint8_t *dest)
+{
+  double *dst = (double*)dest;
+  for (unsigned int i = 0; i < samples; ++i)
+    *dst++ = *data++;
+
+  return samples * sizeof(double);
+}
+
+
+/*
+  SSE2 converters, these work on unaligned buffers and hand any remaining
+  samples to the plain C version. x86 is always little endian.
+*/
+#if defined(__SSE__)
+
+/* swap the byte order of every 16 bit lane */
+static inline __m128i bswap16_sse(__m128i x)
+{
+  return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+}
+
+/* swap the byte order of every 32 bit lane */
+static inline __m128i bswap32_sse(__m128i x)
+{
+  x = bswap16_sse(x);
+  return _mm_or_si128(_mm_slli_epi32(x, 16), _mm_srli_epi32(x, 16));
+}
+
+/*
+  _mm_cvtps_epi32 returns INT_MIN for positive overflow where safeRound clamps
+  to INT_MAX, flip those lanes so full scale input converts the same way
+*/
+static inline __m128i cvtps_epi32_sat(__m128 in)
+{
+  const __m128 limit = _mm_set_ps1(2147483648.0f);
+  return _mm_xor_si128(_mm_cvtps_epi32(in), _mm_castps_si128(_mm_cmpge_ps(in, limit)));
+}
+
+unsigned int CAEConvert::U8_Float_SSE(uint8_t *data, const unsigned int samples, float *dest)
+{
+  const __m128  mul  = _mm_set_ps1(2.0f / UINT8_MAX);
+  const __m128  one  = _mm_set_ps1(1.0f);
+  const __m128i zero = _mm_setzero_si128();
+
+  unsigned int i = 0;
+  for (; i + 16 <= samples; i += 16, data += 16, dest += 16)
+  {
+    __m128i in = _mm_loadu_si128((const __m128i*)data);
+    __m128i lo = _mm_unpacklo_epi8(in, zero);
+    __m128i hi = _mm_unpackhi_epi8(in, zero);
+    _mm_storeu_ps(dest     , _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), mul), one));
+    _mm_storeu_ps(dest +  4, _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), mul), one));
+    _mm_storeu_ps(dest +  8, _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), mul), one));
+    _mm_storeu_ps(dest + 12, _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), mul), one));
   }
-#endif
-  return samples << 2;
+
+  U8_Float(data, samples - i, dest);
+  return samples;
 }
 
-unsigned int CAEConvert::Float_S32BE(float *data, const unsigned int samples, uint8_t *dest)
+unsigned int CAEConvert::S8_Float_SSE(uint8_t *data, const unsigned int samples, float *dest)
 {
-  int32_t *dst = (int32_t*)dest;
-  #ifdef __SSE__
-  const __m128 mul = _mm_set_ps1((float)INT32_MAX);
-  unsigned int count = samples;
+  const __m128 mul = _mm_set_ps1(1.0f / (INT8_MAX + 0.5f));
 
-  /* work around invalid alignment */
-  while ((((uintptr_t)data & 0xF) || ((uintptr_t)dest & 0xF)) && count > 0)
+  unsigned int i = 0;
+  for (; i + 16 <= samples; i += 16, data += 16, dest += 16)
   {
-    dst[0] = safeRound(data[0] * (float)INT32_MAX);
-    ++data;
-    ++dst;
-    --count;
+    /* sign extend by unpacking into the high half and shifting back down */
+    __m128i in = _mm_loadu_si128((const __m128i*)data);
+    __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(in, in), 8);
+    __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(in, in), 8);
+    _mm_storeu_ps(dest     , _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16)), mul));
+    _mm_storeu_ps(dest +  4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16)), mul));
+    _mm_storeu_ps(dest +  8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16)), mul));
+    _mm_storeu_ps(dest + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16)), mul));
+  }
+
+  S8_Float(data, samples - i, dest);
+  return samples;
+}
+
+static inline void S16_Float_SSE(__m128i in, float *dest)
+{
+  const __m128 mul = _mm_set_ps1(1.0f / (INT16_MAX + 0.5f));
+  _mm_storeu_ps(dest    , _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16)), mul));
+  _mm_storeu_ps(dest + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16)), mul));
+}
+
+unsigned int CAEConvert::S16LE_Float_SSE(uint8_t *data, const unsigned int samples, float *dest)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 16, dest += 8)
+    S16_Float_SSE(_mm_loadu_si128((const __m128i*)data), dest);
+
+  S16LE_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S16BE_Float_SSE(uint8_t *data, const unsigned int samples, float *dest)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 16, dest += 8)
+    S16_Float_SSE(bswap16_sse(_mm_loadu_si128((const __m128i*)data)), dest);
+
+  S16BE_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S24LE4_Float_SSE(uint8_t *data, const unsigned int samples, float *dest)
+{
+  const __m128 mul = _mm_set_ps1(INT32_SCALE);
+
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 16, dest += 4)
+  {
+    __m128i in = _mm_slli_epi32(_mm_loadu_si128((const __m128i*)data), 8);
+    _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(in), mul));
   }
 
-  const uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i += 4, data += 4, dst += 4)
+  S24LE4_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S24BE4_Float_SSE(uint8_t *data, const unsigned int samples, float *dest)
+{
+  const __m128  mul  = _mm_set_ps1(INT32_SCALE);
+  const __m128i mask = _mm_set1_epi32(0xFFFFFF00);
+
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 16, dest += 4)
   {
-    __m128  in  = _mm_mul_ps(_mm_load_ps(data), mul);
-    __m128i con = _mm_cvtps_epi32(in);
-    memcpy(dst, &con, sizeof(int32_t) * 4);
-    dst[0] = Endian_SwapBE32(dst[0]);
-    dst[1] = Endian_SwapBE32(dst[1]);
-    dst[2] = Endian_SwapBE32(dst[2]);
-    dst[3] = Endian_SwapBE32(dst[3]);
+    __m128i in = _mm_and_si128(bswap32_sse(_mm_loadu_si128((const __m128i*)data)), mask);
+    _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(in), mul));
   }
 
-  if (samples != even)
+  S24BE4_Float(data, samples - i, dest);
+  return samples;
+}
+
+/*
+  SSE2 has no byte shuffle, so the packed 24 bit formats are assembled in
+  general purpose registers and only the conversion is vectorized
+*/
+unsigned int CAEConvert::S24LE3_Float_SSE(uint8_t *data, const unsigned int samples, float *dest)
+{
+  const __m128 mul = _mm_set_ps1(INT32_SCALE);
+
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 12, dest += 4)
   {
-    const uint32_t odd = samples - even;
-    if (odd == 1)
-    {
-      dst[0] = safeRound(data[0] * (float)INT32_MAX);
-      dst[0] = Endian_SwapBE32(dst[0]);
-    }
-    else
-    {
-      __m128 in;
-      if (odd == 2)
-      {
-        in = _mm_setr_ps(data[0], data[1], 0, 0);
-        in = _mm_mul_ps(in, mul);
-        __m64 con = _mm_cvtps_pi32(in);
-        memcpy(dst, &con, sizeof(int32_t) * 2);
-        dst[0] = Endian_SwapBE32(dst[0]);
-        dst[1] = Endian_SwapBE32(dst[1]);
-      }
-      else
-      {
-        in = _mm_setr_ps(data[0], data[1], data[2], 0);
-        in = _mm_mul_ps(in, mul);
-        __m128i con = _mm_cvtps_epi32(in);
-        memcpy(dst, &con, sizeof(int32_t) * 3);
-        dst[0] = Endian_SwapBE32(dst[0]);
-        dst[1] = Endian_SwapBE32(dst[1]);
-        dst[2] = Endian_SwapBE32(dst[2]);
-      }
-    }
+    __m128i in = _mm_setr_epi32(
+      (data[ 2] << 24) | (data[ 1] << 16) | (data[ 0] << 8),
+      (data[ 5] << 24) | (data[ 4] << 16) | (data[ 3] << 8),
+      (data[ 8] << 24) | (data[ 7] << 16) | (data[ 6] << 8),
+      (data[11] << 24) | (data[10] << 16) | (data[ 9] << 8));
+    _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(in), mul));
   }
-  _mm_empty();
-  #else
-  /* no SIMD */
-  for (uint32_t i = 0; i < samples; ++i, ++data, ++dst)
+
+  S24LE3_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S24BE3_Float_SSE(uint8_t *data, const unsigned int samples, float *dest)
+{
+  const __m128 mul = _mm_set_ps1(INT32_SCALE);
+
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 12, dest += 4)
   {
-    dst[0] = safeRound(data[0] * (float)INT32_MAX);
-    dst[0] = Endian_SwapBE32(dst[0]);
+    __m128i in = _mm_setr_epi32(
+      (data[ 0] << 24) | (data[ 1] << 16) | (data[ 2] << 8),
+      (data[ 3] << 24) | (data[ 4] << 16) | (data[ 5] << 8),
+      (data[ 6] << 24) | (data[ 7] << 16) | (data[ 8] << 8),
+      (data[ 9] << 24) | (data[10] << 16) | (data[11] << 8));
+    _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(in), mul));
   }
-  #endif
 
+  S24BE3_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S32LE_Float_SSE(uint8_t *data, const unsigned int samples, float *dest)
+{
+  const __m128 mul = _mm_set_ps1(1.0f / (float)INT32_MAX);
+
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 32, dest += 8)
+  {
+    __m128i a = _mm_loadu_si128((const __m128i*)data);
+    __m128i b = _mm_loadu_si128((const __m128i*)data + 1);
+    _mm_storeu_ps(dest    , _mm_mul_ps(_mm_cvtepi32_ps(a), mul));
+    _mm_storeu_ps(dest + 4, _mm_mul_ps(_mm_cvtepi32_ps(b), mul));
+  }
+
+  S32LE_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S32BE_Float_SSE(uint8_t *data, const unsigned int samples, float *dest)
+{
+  const __m128 mul = _mm_set_ps1(1.0f / (float)INT32_MAX);
+
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 16, dest += 4)
+  {
+    __m128i in = bswap32_sse(_mm_loadu_si128((const __m128i*)data));
+    _mm_storeu_ps(dest, _mm_mul_ps(_mm_cvtepi32_ps(in), mul));
+  }
+
+  S32BE_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::Float_U8_SSE(float *data, const unsigned int samples, uint8_t *dest)
+{
+  const __m128 mul = _mm_set_ps1((float)INT8_MAX+.5f);
+  const __m128 one = _mm_set_ps1(1.0f);
+
+  unsigned int i = 0;
+  for (; i + 16 <= samples; i += 16, data += 16, dest += 16)
+  {
+    __m128i a = _mm_cvtps_epi32(_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(data     ), one), mul));
+    __m128i b = _mm_cvtps_epi32(_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(data +  4), one), mul));
+    __m128i c = _mm_cvtps_epi32(_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(data +  8), one), mul));
+    __m128i d = _mm_cvtps_epi32(_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(data + 12), one), mul));
+    _mm_storeu_si128((__m128i*)dest, _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+  }
+
+  Float_U8(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::Float_S8_SSE(float *data, const unsigned int samples, uint8_t *dest)
+{
+  const __m128 mul = _mm_set_ps1((float)INT8_MAX+.5f);
+
+  unsigned int i = 0;
+  for (; i + 16 <= samples; i += 16, data += 16, dest += 16)
+  {
+    __m128i a = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(data     ), mul));
+    __m128i b = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(data +  4), mul));
+    __m128i c = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(data +  8), mul));
+    __m128i d = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(data + 12), mul));
+    _mm_storeu_si128((__m128i*)dest, _mm_packs_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+  }
+
+  Float_S8(data, samples - i, dest);
+  return samples;
+}
+
+static inline __m128i Float_S16_SSE(float *data)
+{
+  const __m128 mul = _mm_set_ps1((float)INT16_MAX);
+  __m128 rand;
+
+  /* random round to dither */
+  CAEUtil::FloatRand4(-0.5f, 0.5f, NULL, &rand);
+  __m128i a = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(data    ), _mm_add_ps(mul, rand)));
+  CAEUtil::FloatRand4(-0.5f, 0.5f, NULL, &rand);
+  __m128i b = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(data + 4), _mm_add_ps(mul, rand)));
+
+  return _mm_packs_epi32(a, b);
+}
+
+unsigned int CAEConvert::Float_S16LE_SSE(float *data, const unsigned int samples, uint8_t *dest)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 8, dest += 16)
+    _mm_storeu_si128((__m128i*)dest, Float_S16_SSE(data));
+
+  Float_S16LE(data, samples - i, dest);
+  return samples << 1;
+}
+
+unsigned int CAEConvert::Float_S16BE_SSE(float *data, const unsigned int samples, uint8_t *dest)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 8, dest += 16)
+    _mm_storeu_si128((__m128i*)dest, bswap16_sse(Float_S16_SSE(data)));
+
+  Float_S16BE(data, samples - i, dest);
+  return samples << 1;
+}
+
+unsigned int CAEConvert::Float_S24NE4_SSE(float *data, const unsigned int samples, uint8_t *dest)
+{
+  const __m128 mul = _mm_set_ps1((float)INT24_MAX+.5f);
+
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 4, dest += 16)
+  {
+    __m128i con = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(data), mul));
+    _mm_storeu_si128((__m128i*)dest, _mm_slli_epi32(con, 8));
+  }
+
+  Float_S24NE4(data, samples - i, dest);
   return samples << 2;
 }
 
-unsigned int CAEConvert::Float_S32BE_Neon(float *data, const unsigned int samples, uint8_t *dest)
+unsigned int CAEConvert::Float_S24NE3_SSE(float *data, const unsigned int samples, uint8_t *dest)
+{
+  const __m128 mul = _mm_set_ps1((float)INT24_MAX+.5f);
+  MEMALIGN(16, int32_t con[4]);
+
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 4, dest += 12)
+  {
+    _mm_store_si128((__m128i*)con, _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(data), mul)));
+    for (int j = 0; j < 4; ++j)
+    {
+      dest[j * 3    ] = con[j];
+      dest[j * 3 + 1] = con[j] >> 8;
+      dest[j * 3 + 2] = con[j] >> 16;
+    }
+  }
+
+  Float_S24NE3(data, samples - i, dest);
+  return samples * 3;
+}
+
+unsigned int CAEConvert::Float_S32LE_SSE(float *data, const unsigned int samples, uint8_t *dest)
+{
+  const __m128 mul = _mm_set_ps1((float)INT32_MAX);
+
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 4, dest += 16)
+    _mm_storeu_si128((__m128i*)dest, cvtps_epi32_sat(_mm_mul_ps(_mm_loadu_ps(data), mul)));
+
+  Float_S32LE(data, samples - i, dest);
+  return samples << 2;
+}
+
+unsigned int CAEConvert::Float_S32BE_SSE(float *data, const unsigned int samples, uint8_t *dest)
 {
+  const __m128 mul = _mm_set_ps1((float)INT32_MAX);
+
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 4, dest += 16)
+    _mm_storeu_si128((__m128i*)dest, bswap32_sse(cvtps_epi32_sat(_mm_mul_ps(_mm_loadu_ps(data), mul))));
+
+  Float_S32BE(data, samples - i, dest);
+  return samples << 2;
+}
+
+#endif /* defined(__SSE__) */
+
+/*
+  NEON converters, any remaining samples are handed to the plain C version
+*/
 #if defined(__ARM_NEON__)
-  int32_t *dst = (int32_t*)dest;
-  for (float *end = data + (samples & ~0x3); data < end; data += 4, dst += 4)
+
+/* vcvtq_s32_f32 truncates, round to nearest like safeRound does */
+static inline int32x4_t vcvtq_s32_f32_round(float32x4_t x)
+{
+  const uint32x4_t  sign = vandq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(0x80000000));
+  const float32x4_t half = vreinterpretq_f32_u32(vorrq_u32(sign, vreinterpretq_u32_f32(vdupq_n_f32(0.5f))));
+  return vcvtq_s32_f32(vaddq_f32(x, half));
+}
+
+static inline int16x8_t bswap16q_s16(int16x8_t x)
+{
+  return vreinterpretq_s16_u8(vrev16q_u8(vreinterpretq_u8_s16(x)));
+}
+
+static inline int32x4_t bswap32q_s32(int32x4_t x)
+{
+  return vreinterpretq_s32_u8(vrev32q_u8(vreinterpretq_u8_s32(x)));
+}
+
+unsigned int CAEConvert::U8_Float_Neon(uint8_t *data, const unsigned int samples, float *dest)
+{
+  const float       mul = 2.0f / UINT8_MAX;
+  const float32x4_t one = vdupq_n_f32(1.0f);
+
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 8, dest += 8)
+  {
+    uint16x8_t in = vmovl_u8(vld1_u8(data));
+    vst1q_f32(dest    , vsubq_f32(vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16 (in))), mul), one));
+    vst1q_f32(dest + 4, vsubq_f32(vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(in))), mul), one));
+  }
+
+  U8_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S8_Float_Neon(uint8_t *data, const unsigned int samples, float *dest)
+{
+  const float mul = 1.0f / (INT8_MAX + 0.5f);
+
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 8, dest += 8)
   {
-    float32x4_t val = vmulq_n_f32(vld1q_f32((const float32_t *)data), INT32_MAX);
-    int32x4_t   ret = vcvtq_s32_f32(val);
+    int16x8_t in = vmovl_s8(vld1_s8((const int8_t*)data));
+    vst1q_f32(dest    , vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16 (in))), mul));
+    vst1q_f32(dest + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(in))), mul));
+  }
+
+  S8_Float(data, samples - i, dest);
+  return samples;
+}
+
+static inline void S16_Float_Neon(int16x8_t in, float *dest)
+{
+  const float mul = 1.0f / (INT16_MAX + 0.5f);
+  vst1q_f32(dest    , vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16 (in))), mul));
+  vst1q_f32(dest + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(in))), mul));
+}
+
+unsigned int CAEConvert::S16LE_Float_Neon(uint8_t *data, const unsigned int samples, float *dest)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 16, dest += 8)
+  {
+    int16x8_t in = vld1q_s16((const int16_t*)data);
+    #ifdef __BIG_ENDIAN__
+    in = bswap16q_s16(in);
+    #endif
+    S16_Float_Neon(in, dest);
+  }
+
+  S16LE_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S16BE_Float_Neon(uint8_t *data, const unsigned int samples, float *dest)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 16, dest += 8)
+  {
+    int16x8_t in = vld1q_s16((const int16_t*)data);
     #ifndef __BIG_ENDIAN__
-    ret = vrev64q_s32(ret);
+    in = bswap16q_s16(in);
+    #endif
+    S16_Float_Neon(in, dest);
+  }
+
+  S16BE_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S24LE4_Float_Neon(uint8_t *data, const unsigned int samples, float *dest)
+{
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 16, dest += 4)
+  {
+    int32x4_t in = vld1q_s32((const int32_t*)data);
+    #ifdef __BIG_ENDIAN__
+    in = bswap32q_s32(in);
     #endif
-    vst1q_s32(dst, ret);
+    vst1q_f32(dest, vmulq_n_f32(vcvtq_f32_s32(vshlq_n_s32(in, 8)), INT32_SCALE));
   }
 
-  if (samples & 0x2)
+  S24LE4_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S24BE4_Float_Neon(uint8_t *data, const unsigned int samples, float *dest)
+{
+  const int32x4_t mask = vdupq_n_s32(0xFFFFFF00);
+
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 16, dest += 4)
   {
-    float32x2_t val = vmul_n_f32(vld1_f32((const float32_t *)data), INT32_MAX);
-    int32x2_t   ret = vcvt_s32_f32(val);
+    int32x4_t in = vld1q_s32((const int32_t*)data);
     #ifndef __BIG_ENDIAN__
-    ret = vrev64_s32(ret);
+    in = bswap32q_s32(in);
     #endif
-    vst1_s32(dst, ret);
-    data += 2;
-    dst  += 2;
+    vst1q_f32(dest, vmulq_n_f32(vcvtq_f32_s32(vandq_s32(in, mask)), INT32_SCALE));
   }
 
-  if (samples & 0x1)
+  S24BE4_Float(data, samples - i, dest);
+  return samples;
+}
+
+/* build (msb << 24) | (mid << 16) | (lsb << 8) for 8 samples and convert them */
+static inline void S24_Float_Neon(uint8x8_t msb, uint8x8_t mid, uint8x8_t lsb, float *dest)
+{
+  uint16x8_t hi = vorrq_u16(vshll_n_u8(msb, 8), vmovl_u8(mid));
+  uint16x8_t lo = vshll_n_u8(lsb, 8);
+
+  int32x4_t a = vreinterpretq_s32_u32(vorrq_u32(vshll_n_u16(vget_low_u16 (hi), 16), vmovl_u16(vget_low_u16 (lo))));
+  int32x4_t b = vreinterpretq_s32_u32(vorrq_u32(vshll_n_u16(vget_high_u16(hi), 16), vmovl_u16(vget_high_u16(lo))));
+
+  vst1q_f32(dest    , vmulq_n_f32(vcvtq_f32_s32(a), INT32_SCALE));
+  vst1q_f32(dest + 4, vmulq_n_f32(vcvtq_f32_s32(b), INT32_SCALE));
+}
+
+unsigned int CAEConvert::S24LE3_Float_Neon(uint8_t *data, const unsigned int samples, float *dest)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 24, dest += 8)
   {
-    dst[0] = safeRound(data[0] * (float)INT32_MAX);
-    dst[0] = Endian_SwapBE32(dst[0]);
+    /* de-interleave the 3 byte samples into one vector per byte */
+    uint8x8x3_t in = vld3_u8(data);
+    S24_Float_Neon(in.val[2], in.val[1], in.val[0], dest);
   }
-#endif
+
+  S24LE3_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S24BE3_Float_Neon(uint8_t *data, const unsigned int samples, float *dest)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 24, dest += 8)
+  {
+    uint8x8x3_t in = vld3_u8(data);
+    S24_Float_Neon(in.val[0], in.val[1], in.val[2], dest);
+  }
+
+  S24BE3_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S32LE_Float_Neon(uint8_t *data, const unsigned int samples, float *dest)
+{
+  static const float factor = 1.0f / (float)INT32_MAX;
+
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 16, dest += 4)
+  {
+    int32x4_t in = vld1q_s32((const int32_t*)data);
+    #ifdef __BIG_ENDIAN__
+    in = bswap32q_s32(in);
+    #endif
+    vst1q_f32(dest, vmulq_n_f32(vcvtq_f32_s32(in), factor));
+  }
+
+  S32LE_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::S32BE_Float_Neon(uint8_t *data, const unsigned int samples, float *dest)
+{
+  static const float factor = 1.0f / (float)INT32_MAX;
+
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 16, dest += 4)
+  {
+    int32x4_t in = vld1q_s32((const int32_t*)data);
+    #ifndef __BIG_ENDIAN__
+    in = bswap32q_s32(in);
+    #endif
+    vst1q_f32(dest, vmulq_n_f32(vcvtq_f32_s32(in), factor));
+  }
+
+  S32BE_Float(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::Float_U8_Neon(float *data, const unsigned int samples, uint8_t *dest)
+{
+  const float       mul = (float)INT8_MAX+.5f;
+  const float32x4_t one = vdupq_n_f32(1.0f);
+
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 8, dest += 8)
+  {
+    int32x4_t a = vcvtq_s32_f32_round(vmulq_n_f32(vaddq_f32(vld1q_f32(data    ), one), mul));
+    int32x4_t b = vcvtq_s32_f32_round(vmulq_n_f32(vaddq_f32(vld1q_f32(data + 4), one), mul));
+    vst1_u8(dest, vqmovun_s16(vcombine_s16(vqmovn_s32(a), vqmovn_s32(b))));
+  }
+
+  Float_U8(data, samples - i, dest);
+  return samples;
+}
+
+unsigned int CAEConvert::Float_S8_Neon(float *data, const unsigned int samples, uint8_t *dest)
+{
+  const float mul = (float)INT8_MAX+.5f;
+
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 8, dest += 8)
+  {
+    int32x4_t a = vcvtq_s32_f32_round(vmulq_n_f32(vld1q_f32(data    ), mul));
+    int32x4_t b = vcvtq_s32_f32_round(vmulq_n_f32(vld1q_f32(data + 4), mul));
+    vst1_s8((int8_t*)dest, vqmovn_s16(vcombine_s16(vqmovn_s32(a), vqmovn_s32(b))));
+  }
+
+  Float_S8(data, samples - i, dest);
+  return samples;
+}
+
+static inline int16x8_t Float_S16_Neon(float *data)
+{
+  const float32x4_t mul = vdupq_n_f32((float)INT16_MAX);
+  float rand[8];
+
+  /* random round to dither */
+  CAEUtil::FloatRand4(-0.5f, 0.5f, rand);
+  CAEUtil::FloatRand4(-0.5f, 0.5f, rand + 4);
+
+  int32x4_t a = vcvtq_s32_f32_round(vmulq_f32(vld1q_f32(data    ), vaddq_f32(mul, vld1q_f32(rand    ))));
+  int32x4_t b = vcvtq_s32_f32_round(vmulq_f32(vld1q_f32(data + 4), vaddq_f32(mul, vld1q_f32(rand + 4))));
+  return vcombine_s16(vqmovn_s32(a), vqmovn_s32(b));
+}
+
+unsigned int CAEConvert::Float_S16LE_Neon(float *data, const unsigned int samples, uint8_t *dest)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 8, dest += 16)
+  {
+    int16x8_t con = Float_S16_Neon(data);
+    #ifdef __BIG_ENDIAN__
+    con = bswap16q_s16(con);
+    #endif
+    vst1q_s16((int16_t*)dest, con);
+  }
+
+  Float_S16LE(data, samples - i, dest);
+  return samples << 1;
+}
+
+unsigned int CAEConvert::Float_S16BE_Neon(float *data, const unsigned int samples, uint8_t *dest)
+{
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 8, dest += 16)
+  {
+    int16x8_t con = Float_S16_Neon(data);
+    #ifndef __BIG_ENDIAN__
+    con = bswap16q_s16(con);
+    #endif
+    vst1q_s16((int16_t*)dest, con);
+  }
+
+  Float_S16BE(data, samples - i, dest);
+  return samples << 1;
+}
+
+unsigned int CAEConvert::Float_S24NE4_Neon(float *data, const unsigned int samples, uint8_t *dest)
+{
+  const float mul = (float)INT24_MAX+.5f;
+
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 4, dest += 16)
+  {
+    int32x4_t con = vcvtq_s32_f32_round(vmulq_n_f32(vld1q_f32(data), mul));
+    vst1q_s32((int32_t*)dest, vshlq_n_s32(con, 8));
+  }
+
+  Float_S24NE4(data, samples - i, dest);
   return samples << 2;
 }
 
-unsigned int CAEConvert::Float_DOUBLE(float *data, const unsigned int samples, uint8_t *dest)
+unsigned int CAEConvert::Float_S24NE3_Neon(float *data, const unsigned int samples, uint8_t *dest)
 {
-  double *dst = (double*)dest;
-  for (unsigned int i = 0; i < samples; ++i)
-    *dst++ = *data++;
+  const float mul = (float)INT24_MAX+.5f;
 
-  return samples * sizeof(double);
+  unsigned int i = 0;
+  for (; i + 8 <= samples; i += 8, data += 8, dest += 24)
+  {
+    uint32x4_t a = vreinterpretq_u32_s32(vcvtq_s32_f32_round(vmulq_n_f32(vld1q_f32(data    ), mul)));
+    uint32x4_t b = vreinterpretq_u32_s32(vcvtq_s32_f32_round(vmulq_n_f32(vld1q_f32(data + 4), mul)));
+
+    /* split into one vector per byte and interleave them on store */
+    uint16x8_t  lo = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+    uint8x8x3_t out;
+    #ifdef __BIG_ENDIAN__
+    out.val[2] = vmovn_u16(lo);
+    out.val[1] = vshrn_n_u16(lo, 8);
+    out.val[0] = vmovn_u16(vcombine_u16(vshrn_n_u32(a, 16), vshrn_n_u32(b, 16)));
+    #else
+    out.val[0] = vmovn_u16(lo);
+    out.val[1] = vshrn_n_u16(lo, 8);
+    out.val[2] = vmovn_u16(vcombine_u16(vshrn_n_u32(a, 16), vshrn_n_u32(b, 16)));
+    #endif
+    vst3_u8(dest, out);
+  }
+
+  Float_S24NE3(data, samples - i, dest);
+  return samples * 3;
+}
+
+unsigned int CAEConvert::Float_S32LE_Neon(float *data, const unsigned int samples, uint8_t *dest)
+{
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 4, dest += 16)
+  {
+    /* vcvtq saturates, so full scale input maps to INT32_MAX like safeRound */
+    int32x4_t con = vcvtq_s32_f32_round(vmulq_n_f32(vld1q_f32(data), (float)INT32_MAX));
+    #ifdef __BIG_ENDIAN__
+    con = bswap32q_s32(con);
+    #endif
+    vst1q_s32((int32_t*)dest, con);
+  }
+
+  Float_S32LE(data, samples - i, dest);
+  return samples << 2;
+}
+
+unsigned int CAEConvert::Float_S32BE_Neon(float *data, const unsigned int samples, uint8_t *dest)
+{
+  unsigned int i = 0;
+  for (; i + 4 <= samples; i += 4, data += 4, dest += 16)
+  {
+    int32x4_t con = vcvtq_s32_f32_round(vmulq_n_f32(vld1q_f32(data), (float)INT32_MAX));
+    #ifndef __BIG_ENDIAN__
+    con = bswap32q_s32(con);
+    #endif
+    vst1q_s32((int32_t*)dest, con);
+  }
+
+  Float_S32BE(data, samples - i, dest);
+  return samples << 2;
 }
 
+#endif /* defined(__ARM_NEON__) */
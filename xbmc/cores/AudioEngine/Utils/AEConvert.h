@@ -46,8 +46,43 @@ private:
   static unsigned int Float_S32BE (float   *data, const unsigned int samples, uint8_t *dest);
   static unsigned int Float_DOUBLE(float   *data, const unsigned int samples, uint8_t *dest);
 
+  static unsigned int U8_Float_SSE    (uint8_t *data, const unsigned int samples, float   *dest);
+  static unsigned int S8_Float_SSE    (uint8_t *data, const unsigned int samples, float   *dest);
+  static unsigned int S16LE_Float_SSE (uint8_t *data, const unsigned int samples, float   *dest);
+  static unsigned int S16BE_Float_SSE (uint8_t *data, const unsigned int samples, float   *dest);
+  static unsigned int S24LE4_Float_SSE(uint8_t *data, const unsigned int samples, float   *dest);
+  static unsigned int S24BE4_Float_SSE(uint8_t *data, const unsigned int samples, float   *dest);
+  static unsigned int S24LE3_Float_SSE(uint8_t *data, const unsigned int samples, float   *dest);
+  static unsigned int S24BE3_Float_SSE(uint8_t *data, const unsigned int samples, float   *dest);
+  static unsigned int S32LE_Float_SSE (uint8_t *data, const unsigned int samples, float   *dest);
+  static unsigned int S32BE_Float_SSE (uint8_t *data, const unsigned int samples, float   *dest);
+
+  static unsigned int Float_U8_SSE    (float   *data, const unsigned int samples, uint8_t *dest);
+  static unsigned int Float_S8_SSE    (float   *data, const unsigned int samples, uint8_t *dest);
+  static unsigned int Float_S16LE_SSE (float   *data, const unsigned int samples, uint8_t *dest);
+  static unsigned int Float_S16BE_SSE (float   *data, const unsigned int samples, uint8_t *dest);
+  static unsigned int Float_S24NE4_SSE(float   *data, const unsigned int samples, uint8_t *dest);
+  static unsigned int Float_S24NE3_SSE(float   *data, const unsigned int samples, uint8_t *dest);
+  static unsigned int Float_S32LE_SSE (float   *data, const unsigned int samples, uint8_t *dest);
+  static unsigned int Float_S32BE_SSE (float   *data, const unsigned int samples, uint8_t *dest);
+
+  static unsigned int U8_Float_Neon    (uint8_t *data, const unsigned int samples, float   *dest);
+  static unsigned int S8_Float_Neon    (uint8_t *data, const unsigned int samples, float   *dest);
+  static unsigned int S16LE_Float_Neon (uint8_t *data, const unsigned int samples, float   *dest);
+  static unsigned int S16BE_Float_Neon (uint8_t *data, const unsigned int samples, float   *dest);
+  static unsigned int S24LE4_Float_Neon(uint8_t *data, const unsigned int samples, float   *dest);
+  static unsigned int S24BE4_Float_Neon(uint8_t *data, const unsigned int samples, float   *dest);
+  static unsigned int S24LE3_Float_Neon(uint8_t *data, const unsigned int samples, float   *dest);
+  static unsigned int S24BE3_Float_Neon(uint8_t *data, const unsigned int samples, float   *dest);
   static unsigned int S32LE_Float_Neon (uint8_t *data, const unsigned int samples, float   *dest);
   static unsigned int S32BE_Float_Neon (uint8_t *data, const unsigned int samples, float   *dest);
+
+  static unsigned int Float_U8_Neon    (float   *data, const unsigned int samples, uint8_t *dest);
+  static unsigned int Float_S8_Neon    (float   *data, const unsigned int samples, uint8_t *dest);
+  static unsigned int Float_S16LE_Neon (float   *data, const unsigned int samples, uint8_t *dest);
+  static unsigned int Float_S16BE_Neon (float   *data, const unsigned int samples, uint8_t *dest);
+  static unsigned int Float_S24NE4_Neon(float   *data, const unsigned int samples, uint8_t *dest);
+  static unsigned int Float_S24NE3_Neon(float   *data, const unsigned int samples, uint8_t *dest);
   static unsigned int Float_S32LE_Neon (float   *data, const unsigned int samples, uint8_t *dest);
   static unsigned int Float_S32BE_Neon (float   *data, const unsigned int samples, uint8_t *dest);
 
@@ -55,7 +90,12 @@ public:
   typedef unsigned int (*AEConvertToFn)(uint8_t *data, const unsigned int samples, float   *dest);
   typedef unsigned int (*AEConvertFrFn)(float   *data, const unsigned int samples, uint8_t *dest);
 
-  static AEConvertToFn ToFloat(enum AEDataFormat dataFormat);
-  static AEConvertFrFn FrFloat(enum AEDataFormat dataFormat);
+  /*
+    Returns the converter for the given format. The SSE2/NEON version is
+    picked when the CPU supports it, allowSIMD = false forces the plain C
+    version (used to verify and benchmark the SIMD converters).
+  */
+  static AEConvertToFn ToFloat(enum AEDataFormat dataFormat, bool allowSIMD = true);
+  static AEConvertFrFn FrFloat(enum AEDataFormat dataFormat, bool allowSIMD = true);
 };
 
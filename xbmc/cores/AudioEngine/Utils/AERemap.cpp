@@ -24,11 +24,18 @@
 #include "cores/AudioEngine/AEFactory.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "utils/log.h"
+#include "utils/CPUInfo.h"
 #include "settings/GUISettings.h"
 
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 using namespace std;
 
-CAERemap::CAERemap() : m_inChannels(0), m_outChannels(0) 
+CAERemap::CAERemap() : m_inChannels(0), m_outChannels(0), m_useSIMD(false)
 {
   memset(m_mixInfo, 0, sizeof(m_mixInfo));
 }
@@ -87,7 +94,10 @@ bool CAERemap::Initialize(CAEChannelInfo input, CAEChannelInfo output, bool fina
 
   /* the final stage does not need any down/upmix */
   if (finalStage)
+  {
+    BuildPlan();
     return true;
+  }
 
   /* downmix from the specified channel to the specified list of channels */
   #define RM(from, ...) \
@@ -253,9 +263,39 @@ bool CAERemap::Initialize(CAEChannelInfo input, CAEChannelInfo output, bool fina
   CLog::Log(LOGINFO, "====================\n");
 #endif
 
+  BuildPlan();
   return true;
 }
 
+void CAERemap::BuildPlan()
+{
+  m_plan.resize(m_outChannels);
+  m_planIndex.clear();
+  m_planLevel.clear();
+
+  for (int o = 0; o < m_outChannels; ++o)
+  {
+    const AEMixInfo *info = &m_mixInfo[m_output[o]];
+    AEMixPlan       &plan = m_plan[o];
+
+    plan.first    = m_planIndex.size();
+    plan.srcCount = info->in_dst ? info->srcCount : 0;
+    for (int i = 0; i < plan.srcCount; ++i)
+    {
+      m_planIndex.push_back(info->srcIndex[i].index);
+      m_planLevel.push_back(info->srcIndex[i].level);
+    }
+  }
+
+#if defined(__SSE__)
+  m_useSIMD = (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE) != 0;
+#elif defined(__ARM_NEON__)
+  m_useSIMD = (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_NEON) != 0;
+#else
+  m_useSIMD = false;
+#endif
+}
+
 void CAERemap::ResolveMix(const AEChannel from, CAEChannelInfo to)
 {
   AEMixInfo *fromInfo = &m_mixInfo[from];
@@ -293,9 +333,154 @@ void CAERemap::ResolveMix(const AEChannel from, CAEChannelInfo to)
   fromInfo->in_src   = false;
 }
 
+#if defined(__SSE__)
+  typedef __m128 vec4;
+  #define VEC4_ZERO       _mm_setzero_ps()
+  #define VEC4_SET(x)     _mm_set_ps1(x)
+  #define VEC4_LOAD(p)    _mm_load_ps(p)
+  #define VEC4_STORE(p,v) _mm_store_ps(p, v)
+  #define VEC4_ADD(a,b)   _mm_add_ps(a, b)
+  #define VEC4_MUL(a,b)   _mm_mul_ps(a, b)
+  #define VEC4_LOADU(p)    _mm_loadu_ps(p)
+  #define VEC4_STOREU(p,v) _mm_storeu_ps(p, v)
+  #define VEC4_TRANSPOSE(a,b,c,d) _MM_TRANSPOSE4_PS(a, b, c, d)
+#elif defined(__ARM_NEON__)
+  typedef float32x4_t vec4;
+  #define VEC4_ZERO       vdupq_n_f32(0.0f)
+  #define VEC4_SET(x)     vdupq_n_f32(x)
+  #define VEC4_LOAD(p)    vld1q_f32(p)
+  #define VEC4_STORE(p,v) vst1q_f32(p, v)
+  #define VEC4_ADD(a,b)   vaddq_f32(a, b)
+  #define VEC4_MUL(a,b)   vmulq_f32(a, b)
+  #define VEC4_LOADU(p)    vld1q_f32(p)
+  #define VEC4_STOREU(p,v) vst1q_f32(p, v)
+  #define VEC4_TRANSPOSE(a,b,c,d) \
+  { \
+    float32x4x2_t ab = vtrnq_f32(a, b); \
+    float32x4x2_t cd = vtrnq_f32(c, d); \
+    a = vcombine_f32(vget_low_f32 (ab.val[0]), vget_low_f32 (cd.val[0])); \
+    b = vcombine_f32(vget_low_f32 (ab.val[1]), vget_low_f32 (cd.val[1])); \
+    c = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0])); \
+    d = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1])); \
+  }
+#endif
+
+/*
+  Mixes four frames at a time. The frames are transposed so each channel
+  becomes one vector, then every output channel runs the same sequence of
+  multiplies and adds as the plain C mixer does for a single frame, which
+  keeps the result bit identical.
+*/
+void CAERemap::RemapBlocks(float * const in, float * const out, const unsigned int blocks) const
+{
+#if defined(VEC4_ADD)
+  MEMALIGN(16, float src[AE_CH_MAX][4]);
+  MEMALIGN(16, float dst[AE_CH_MAX][4]);
+
+  const AEMixPlan * const plan  = &m_plan[0];
+  const int       * const index = m_planIndex.empty() ? NULL : &m_planIndex[0];
+  const float     * const level = m_planLevel.empty() ? NULL : &m_planLevel[0];
+
+  float *inFrame  = in;
+  float *outFrame = out;
+  for (unsigned int b = 0; b < blocks; ++b)
+  {
+    /* transpose the input, 4x4 at a time where possible */
+    int c = 0;
+    for (; c + 4 <= m_inChannels; c += 4)
+    {
+      vec4 r0 = VEC4_LOADU(inFrame                    + c);
+      vec4 r1 = VEC4_LOADU(inFrame +     m_inChannels + c);
+      vec4 r2 = VEC4_LOADU(inFrame + 2 * m_inChannels + c);
+      vec4 r3 = VEC4_LOADU(inFrame + 3 * m_inChannels + c);
+      VEC4_TRANSPOSE(r0, r1, r2, r3);
+      VEC4_STORE(src[c    ], r0);
+      VEC4_STORE(src[c + 1], r1);
+      VEC4_STORE(src[c + 2], r2);
+      VEC4_STORE(src[c + 3], r3);
+    }
+    for (; c < m_inChannels; ++c)
+      for (int f = 0; f < 4; ++f)
+        src[c][f] = inFrame[f * m_inChannels + c];
+    inFrame += 4 * m_inChannels;
+
+    for (int o = 0; o < m_outChannels; ++o)
+    {
+      const int srcCount = plan[o].srcCount;
+      if (srcCount == 0)
+      {
+        VEC4_STORE(dst[o], VEC4_ZERO);
+        continue;
+      }
+
+      const int   *idx = index + plan[o].first;
+      const float *lvl = level + plan[o].first;
+
+      /* if there is only 1 source, just copy it so we dont break DPL */
+      if (srcCount == 1)
+      {
+        VEC4_STORE(dst[o], VEC4_LOAD(src[idx[0]]));
+        continue;
+      }
+
+      const int srcBlocks = srcCount & ~0x3;
+      vec4 f1 = VEC4_ZERO, f2 = VEC4_ZERO, f3 = VEC4_ZERO, f4 = VEC4_ZERO;
+      int i = 0;
+      for (; i < srcBlocks; i += 4)
+      {
+        f1 = VEC4_ADD(f1, VEC4_MUL(VEC4_LOAD(src[idx[i  ]]), VEC4_SET(lvl[i  ])));
+        f2 = VEC4_ADD(f2, VEC4_MUL(VEC4_LOAD(src[idx[i+1]]), VEC4_SET(lvl[i+1])));
+        f3 = VEC4_ADD(f3, VEC4_MUL(VEC4_LOAD(src[idx[i+2]]), VEC4_SET(lvl[i+2])));
+        f4 = VEC4_ADD(f4, VEC4_MUL(VEC4_LOAD(src[idx[i+3]]), VEC4_SET(lvl[i+3])));
+      }
+
+      switch (srcCount & 0x3)
+      {
+        case 3: f3 = VEC4_ADD(f3, VEC4_MUL(VEC4_LOAD(src[idx[i+2]]), VEC4_SET(lvl[i+2])));
+        case 2: f2 = VEC4_ADD(f2, VEC4_MUL(VEC4_LOAD(src[idx[i+1]]), VEC4_SET(lvl[i+1])));
+        case 1: f1 = VEC4_ADD(f1, VEC4_MUL(VEC4_LOAD(src[idx[i  ]]), VEC4_SET(lvl[i  ])));
+      }
+
+      VEC4_STORE(dst[o], VEC4_ADD(VEC4_ZERO, VEC4_ADD(VEC4_ADD(VEC4_ADD(f1, f2), f3), f4)));
+    }
+
+    /* and transpose the result back */
+    int o = 0;
+    for (; o + 4 <= m_outChannels; o += 4)
+    {
+      vec4 r0 = VEC4_LOAD(dst[o    ]);
+      vec4 r1 = VEC4_LOAD(dst[o + 1]);
+      vec4 r2 = VEC4_LOAD(dst[o + 2]);
+      vec4 r3 = VEC4_LOAD(dst[o + 3]);
+      VEC4_TRANSPOSE(r0, r1, r2, r3);
+      VEC4_STOREU(outFrame                     + o, r0);
+      VEC4_STOREU(outFrame +     m_outChannels + o, r1);
+      VEC4_STOREU(outFrame + 2 * m_outChannels + o, r2);
+      VEC4_STOREU(outFrame + 3 * m_outChannels + o, r3);
+    }
+    for (; o < m_outChannels; ++o)
+      for (int f = 0; f < 4; ++f)
+        outFrame[f * m_outChannels + o] = dst[o][f];
+    outFrame += 4 * m_outChannels;
+  }
+#endif
+}
+
 /* This method has unrolled loop for higher performance */
-void CAERemap::Remap(float * const in, float * const out, const unsigned int frames) const
+void CAERemap::Remap(float * const in, float * const out, const unsigned int frames, bool allowSIMD/* = true */) const
 {
+  if (allowSIMD && m_useSIMD)
+  {
+    const unsigned int blocks = frames >> 2;
+    RemapBlocks(in, out, blocks);
+
+    /* mix the remaining frames with the plain C mixer */
+    const unsigned int done = blocks << 2;
+    if (done < frames)
+      Remap(in + done * m_inChannels, out + done * m_outChannels, frames - done, false);
+    return;
+  }
+
   const unsigned int frameBlocks = frames & ~0x3;
 
   for (int o = 0; o < m_outChannels; ++o)
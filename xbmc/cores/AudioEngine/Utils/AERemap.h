@@ -20,6 +20,7 @@
  */
 
 #include "cores/AudioEngine/AEAudioFormat.h"
+#include <vector>
 
 class CAERemap {
 public:
@@ -27,7 +28,11 @@ public:
   ~CAERemap();
 
   bool Initialize(CAEChannelInfo input, CAEChannelInfo output, bool finalStage, bool forceNormalize = false, enum AEStdChLayout stdChLayout = AE_CH_LAYOUT_INVALID);
-  void Remap(float * const in, float * const out, const unsigned int frames) const;
+  /*
+    allowSIMD = false forces the plain C mixer, the SSE/NEON mixer produces
+    bit identical output and is only exposed for testing
+  */
+  void Remap(float * const in, float * const out, const unsigned int frames, bool allowSIMD = true) const;
 
 private:
   typedef struct {
@@ -44,12 +49,25 @@ private:
     int               cpyCount; /* the number of times the channel has been cloned */
   } AEMixInfo;
 
+  /* the mix of one output channel, compiled from m_mixInfo */
+  typedef struct {
+    int               srcCount; /* 0 = silence, 1 = plain copy */
+    int               first;    /* offset of the first source in m_planIndex/m_planLevel */
+  } AEMixPlan;
+
   AEMixInfo      m_mixInfo[AE_CH_MAX+1];
   CAEChannelInfo m_output;
   int            m_inChannels;
   int            m_outChannels;
 
+  std::vector<AEMixPlan> m_plan;
+  std::vector<int>       m_planIndex;
+  std::vector<float>     m_planLevel;
+  bool                   m_useSIMD;
+
   void ResolveMix(const AEChannel from, CAEChannelInfo to);
   void BuildUpmixMatrix(const CAEChannelInfo& input, const CAEChannelInfo& output);
+  void BuildPlan();
+  void RemapBlocks(float * const in, float * const out, const unsigned int blocks) const;
 };
 
@@ -0,0 +1,334 @@
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+#include "AEResamplePolyphase.h"
+#include "utils/log.h"
+#include "utils/CPUInfo.h"
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.1415926535897932384626433832795028842
+#endif
+
+/* largest interpolation factor we build a table for, 44.1k <-> 48k needs 160 */
+#define POLYPHASE_MAX_PHASES 512
+
+static unsigned int GCD(unsigned int a, unsigned int b)
+{
+  while (b)
+  {
+    unsigned int t = a % b;
+    a = b;
+    b = t;
+  }
+  return a;
+}
+
+/* zeroth order modified bessel function of the first kind, for the kaiser window */
+static double BesselI0(double x)
+{
+  double sum  = 1.0;
+  double term = 1.0;
+  for (int k = 1; k < 50; ++k)
+  {
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum  += term;
+    if (term < sum * 1e-12)
+      break;
+  }
+  return sum;
+}
+
+static float DotC(const float *coefs, const float *samples, unsigned int taps)
+{
+  float sum = 0.0f;
+  for (unsigned int i = 0; i < taps; ++i)
+    sum += coefs[i] * samples[i];
+  return sum;
+}
+
+#if defined(__SSE__)
+/* taps must be a multiple of 8, coefs 16 byte aligned */
+static float DotSSE(const float *coefs, const float *samples, unsigned int taps)
+{
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  for (unsigned int i = 0; i < taps; i += 8)
+  {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_load_ps(coefs + i    ), _mm_loadu_ps(samples + i    )));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_load_ps(coefs + i + 4), _mm_loadu_ps(samples + i + 4)));
+  }
+  acc0 = _mm_add_ps(acc0, acc1);
+  acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+  acc0 = _mm_add_ss(acc0, _mm_shuffle_ps(acc0, acc0, _MM_SHUFFLE(1, 1, 1, 1)));
+
+  float sum;
+  _mm_store_ss(&sum, acc0);
+  return sum;
+}
+#elif defined(__ARM_NEON__)
+/* taps must be a multiple of 8 */
+static float DotNeon(const float *coefs, const float *samples, unsigned int taps)
+{
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  for (unsigned int i = 0; i < taps; i += 8)
+  {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(coefs + i    ), vld1q_f32(samples + i    ));
+    acc1 = vmlaq_f32(acc1, vld1q_f32(coefs + i + 4), vld1q_f32(samples + i + 4));
+  }
+  acc0 = vaddq_f32(acc0, acc1);
+  float32x2_t sum = vadd_f32(vget_low_f32(acc0), vget_high_f32(acc0));
+  sum = vpadd_f32(sum, sum);
+  return vget_lane_f32(sum, 0);
+}
+#endif
+
+CAEResamplePolyphase::CAEResamplePolyphase(enum AEResampleQuality quality, unsigned int inRate, unsigned int outRate, bool allowSIMD/* = true */) :
+  m_coefs   (NULL),
+  m_channels(0   ),
+  m_capacity(0   ),
+  m_fill    (0   ),
+  m_start   (0   ),
+  m_phase   (0   )
+{
+  unsigned int gcd = GCD(inRate, outRate);
+  m_upFactor   = outRate / gcd;
+  m_downFactor = inRate  / gcd;
+
+  /* taps per phase and stopband attenuation in dB, both tiers keep the taps a multiple of 8 for SIMD */
+  if (quality == AE_RESAMPLE_LOW)
+  {
+    m_taps        = 16;
+    m_attenuation = 60.0;
+  }
+  else
+  {
+    m_taps        = 32;
+    m_attenuation = 80.0;
+  }
+
+  m_dot = DotC;
+  if (allowSIMD)
+  {
+#if defined(__SSE__)
+    if (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE)
+      m_dot = DotSSE;
+#elif defined(__ARM_NEON__)
+    if (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_NEON)
+      m_dot = DotNeon;
+#endif
+  }
+}
+
+CAEResamplePolyphase::~CAEResamplePolyphase()
+{
+  _aligned_free(m_coefs);
+}
+
+bool CAEResamplePolyphase::IsSupported(unsigned int inRate, unsigned int outRate)
+{
+  if (!inRate || !outRate)
+    return false;
+
+  return outRate / GCD(inRate, outRate) <= POLYPHASE_MAX_PHASES;
+}
+
+bool CAEResamplePolyphase::Initialize(unsigned int channels, double ratio)
+{
+  if (!channels || m_upFactor > POLYPHASE_MAX_PHASES || !SetRatio(ratio))
+    return false;
+
+  m_channels = channels;
+  BuildFilter();
+  if (!m_coefs)
+    return false;
+
+  Reset();
+  return true;
+}
+
+bool CAEResamplePolyphase::SetRatio(double ratio)
+{
+  /* we can only do the exact ratio we were built for */
+  return fabs(ratio - GetRatio()) < 1e-9;
+}
+
+void CAEResamplePolyphase::BuildFilter()
+{
+  const unsigned int L      = m_upFactor;
+  const unsigned int length = L * m_taps;
+
+  /*
+    kaiser design, the transition width follows from the taps we can afford
+    and the attenuation we want. When decimating the band edge has to come
+    down to the output nyquist.
+  */
+  const double beta   = m_attenuation > 50.0 ? 0.1102 * (m_attenuation - 8.7) : 0.5842 * pow(m_attenuation - 21.0, 0.4) + 0.07886 * (m_attenuation - 21.0);
+  const double width  = (m_attenuation - 8.0) / (2.285 * 2.0 * M_PI * m_taps);
+  const double scale  = std::min(1.0, (double)m_upFactor / (double)m_downFactor);
+  const double cutoff = scale * (0.5 - width / 2.0);      /* relative to the input rate */
+  const double center = (length - 1) / 2.0;
+  const double i0beta = BesselI0(beta);
+
+  std::vector<double> proto(length);
+  double total = 0.0;
+  for (unsigned int n = 0; n < length; ++n)
+  {
+    double t    = (n - center) / L;                       /* in input samples */
+    double x    = 2.0 * cutoff * t;
+    double sinc = fabs(x) < 1e-12 ? 1.0 : sin(M_PI * x) / (M_PI * x);
+    double r    = (n - center) / center;
+    double win  = BesselI0(beta * sqrt(std::max(0.0, 1.0 - r * r))) / i0beta;
+    proto[n]    = 2.0 * cutoff * sinc * win;
+    total      += proto[n];
+  }
+
+  _aligned_free(m_coefs);
+  m_coefs = (float*)_aligned_malloc(length * sizeof(float), 16);
+  if (!m_coefs)
+    return;
+
+  /*
+    split into phases, each phase has unity gain at DC and is stored oldest
+    sample first so it can be run as a straight dot product over the history
+  */
+  for (unsigned int p = 0; p < L; ++p)
+    for (unsigned int j = 0; j < m_taps; ++j)
+      m_coefs[p * m_taps + j] = (float)(proto[p + (m_taps - 1 - j) * L] * L / total);
+
+  CLog::Log(LOGDEBUG, "CAEResamplePolyphase::BuildFilter - %u/%u, %u phases of %u taps, cutoff %f", m_upFactor, m_downFactor, L, m_taps, cutoff);
+}
+
+void CAEResamplePolyphase::Reserve(unsigned int frames)
+{
+  if (frames <= m_capacity)
+    return;
+
+  unsigned int capacity = std::max(frames, m_capacity * 2);
+  std::vector<float> buffer(capacity * m_channels);
+
+  /* nothing to carry over on the first call, m_buffer is still empty then */
+  if (m_fill && !m_buffer.empty())
+  {
+    for (unsigned int c = 0; c < m_channels; ++c)
+      memcpy(&buffer[c * capacity], &m_buffer[c * m_capacity], m_fill * sizeof(float));
+  }
+
+  m_buffer.swap(buffer);
+  m_capacity = capacity;
+}
+
+void CAEResamplePolyphase::Reset()
+{
+  /* prime the history with silence so the first output sample has a full window */
+  m_fill  = 0;
+  m_start = 0;
+  m_phase = 0;
+  Reserve(m_taps * 4);
+  m_fill  = m_taps - 1;
+  for (unsigned int c = 0; c < m_channels; ++c)
+    memset(&m_buffer[c * m_capacity], 0, m_fill * sizeof(float));
+}
+
+unsigned int CAEResamplePolyphase::GetHistory(std::vector<float> &out, double &lead)
+{
+  /* when decimating the next window may start beyond what we hold */
+  lead = 0.0;
+  if (m_start >= m_fill)
+  {
+    out.clear();
+    return 0;
+  }
+
+  unsigned int frames = m_fill - m_start;
+  out.resize(frames * m_channels);
+  for (unsigned int c = 0; c < m_channels; ++c)
+  {
+    const float *src = &m_buffer[c * m_capacity + m_start];
+    float       *dst = &out[c];
+    for (unsigned int f = 0; f < frames; ++f, dst += m_channels)
+      *dst = src[f];
+  }
+
+  /*
+    the next output sample sits at the center of the next window, offset by
+    the phase. Everything before it has already been played.
+  */
+  lead = std::min((double)frames, m_taps / 2.0 - 1.0 + (2.0 * m_phase + 1.0) / (2.0 * m_upFactor));
+  return frames;
+}
+
+int CAEResamplePolyphase::Resample(float *in, unsigned int inFrames, unsigned int &inUsed, float *out, unsigned int outFrames)
+{
+  inUsed = 0;
+  if (!m_coefs)
+    return -1;
+
+  /* append the new input to the planar history */
+  Reserve(m_fill + inFrames);
+  for (unsigned int c = 0; c < m_channels; ++c)
+  {
+    float *dst = &m_buffer[c * m_capacity + m_fill];
+    float *src = in + c;
+    for (unsigned int f = 0; f < inFrames; ++f, src += m_channels)
+      dst[f] = *src;
+  }
+  m_fill += inFrames;
+  inUsed  = inFrames;
+
+  /* run the filter while we have a full window of history */
+  unsigned int start    = m_start;
+  unsigned int produced = 0;
+  while (produced < outFrames && start + m_taps <= m_fill)
+  {
+    const float *coefs = m_coefs + m_phase * m_taps;
+    for (unsigned int c = 0; c < m_channels; ++c)
+      *out++ = m_dot(coefs, &m_buffer[c * m_capacity + start], m_taps);
+    ++produced;
+
+    m_phase += m_downFactor;
+    start   += m_phase / m_upFactor;
+    m_phase %= m_upFactor;
+  }
+
+  /*
+    drop what we have stepped past, keeping the rest as history for the next
+    call. When decimating the next window may start beyond what we have.
+  */
+  unsigned int drop = std::min(start, m_fill);
+  m_start = start - drop;
+  m_fill -= drop;
+  for (unsigned int c = 0; c < m_channels; ++c)
+    memmove(&m_buffer[c * m_capacity], &m_buffer[c * m_capacity + drop], m_fill * sizeof(float));
+
+  return produced;
+}
@@ -0,0 +1,73 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+
+#include "Interfaces/AEResample.h"
+
+/*
+  Fixed ratio polyphase FIR resampler.
+
+  The conversion inRate -> outRate is reduced to L/M, a Kaiser windowed sinc
+  is designed at L times the input rate and split into L phases of a few taps
+  each, so every output sample is a single short dot product. This is much
+  cheaper than libsamplerate for the common rates (44.1k <-> 48k, 48k -> 96k
+  and so on) but can not follow arbitrary ratio changes.
+*/
+class CAEResamplePolyphase : public IAEResample
+{
+public:
+  virtual const char *GetName() { return "polyphase"; }
+
+  CAEResamplePolyphase(enum AEResampleQuality quality, unsigned int inRate, unsigned int outRate, bool allowSIMD = true);
+  virtual ~CAEResamplePolyphase();
+
+  /* returns true if the inRate -> outRate conversion can be done by this resampler */
+  static bool IsSupported(unsigned int inRate, unsigned int outRate);
+
+  virtual bool   Initialize(unsigned int channels, double ratio);
+  virtual bool   SetRatio  (double ratio);
+  virtual double GetRatio  () { return (double)m_upFactor / (double)m_downFactor; }
+  virtual void   Reset     ();
+  virtual unsigned int GetHistory(std::vector<float> &out, double &lead);
+  virtual int    Resample  (float *in, unsigned int inFrames, unsigned int &inUsed, float *out, unsigned int outFrames);
+
+private:
+  typedef float (*DotFn)(const float *coefs, const float *samples, unsigned int taps);
+
+  void BuildFilter();
+  void Reserve(unsigned int frames);
+
+  unsigned int m_upFactor;   /* L */
+  unsigned int m_downFactor; /* M */
+  unsigned int m_taps;       /* taps per phase */
+  double       m_attenuation;
+  DotFn        m_dot;
+
+  float       *m_coefs;      /* L phases of m_taps coefficients, oldest sample first */
+  unsigned int m_channels;
+
+  std::vector<float> m_buffer; /* planar input history, m_capacity frames per channel */
+  unsigned int m_capacity;
+  unsigned int m_fill;       /* frames held per channel */
+  unsigned int m_start;      /* first history frame of the next window */
+  unsigned int m_phase;      /* phase of the next output sample */
+};
@@ -0,0 +1,146 @@
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <string.h>
+
+#include "AEResampleSRC.h"
+#include "utils/log.h"
+
+CAEResampleSRC::CAEResampleSRC(enum AEResampleQuality quality) :
+  m_state   (NULL),
+  m_ratio   (1.0 ),
+  m_channels(0   ),
+  m_discard (0   )
+{
+  switch (quality)
+  {
+    case AE_RESAMPLE_LOW : m_converter = SRC_SINC_FASTEST       ; break;
+    case AE_RESAMPLE_HIGH: m_converter = SRC_SINC_BEST_QUALITY  ; break;
+    default              : m_converter = SRC_SINC_MEDIUM_QUALITY; break;
+  }
+}
+
+CAEResampleSRC::~CAEResampleSRC()
+{
+  if (m_state)
+    src_delete(m_state);
+}
+
+bool CAEResampleSRC::Initialize(unsigned int channels, double ratio)
+{
+  if (m_state)
+    src_delete(m_state);
+
+  int err;
+  m_state = src_new(m_converter, channels, &err);
+  if (!m_state)
+  {
+    CLog::Log(LOGERROR, "CAEResampleSRC::Initialize - src_new failed: %s", src_strerror(err));
+    return false;
+  }
+
+  m_ratio    = ratio;
+  m_channels = channels;
+  m_history.clear();
+  m_discard  = 0;
+  return true;
+}
+
+bool CAEResampleSRC::SetRatio(double ratio)
+{
+  if (!m_state || src_set_ratio(m_state, ratio) != 0)
+    return false;
+
+  m_ratio = ratio;
+  return true;
+}
+
+void CAEResampleSRC::Reset()
+{
+  if (m_state)
+    src_reset(m_state);
+
+  m_history.clear();
+  m_discard = 0;
+}
+
+void CAEResampleSRC::SetHistory(const float *in, unsigned int frames, double lead)
+{
+  m_history.assign(in, in + frames * m_channels);
+  m_discard = (unsigned int)(lead * m_ratio + 0.5);
+}
+
+int CAEResampleSRC::Resample(float *in, unsigned int inFrames, unsigned int &inUsed, float *out, unsigned int outFrames)
+{
+  inUsed = 0;
+  if (!m_state)
+    return -1;
+
+  /* finish off what the previous resampler handed over before taking new input */
+  unsigned int produced = 0;
+  if (!m_history.empty())
+  {
+    unsigned int used;
+    int ret = Process(&m_history[0], m_history.size() / m_channels, used, out, outFrames);
+    if (ret < 0)
+      return -1;
+
+    m_history.erase(m_history.begin(), m_history.begin() + used * m_channels);
+    produced = ret;
+  }
+
+  if (m_history.empty())
+  {
+    int ret = Process(in, inFrames, inUsed, out + produced * m_channels, outFrames - produced);
+    if (ret < 0)
+      return -1;
+    produced += ret;
+  }
+
+  /* the previous resampler already played the start of its history */
+  if (m_discard)
+  {
+    unsigned int drop = std::min(m_discard, produced);
+    memmove(out, out + drop * m_channels, (produced - drop) * m_channels * sizeof(float));
+    produced  -= drop;
+    m_discard -= drop;
+  }
+
+  return produced;
+}
+
+int CAEResampleSRC::Process(float *in, unsigned int inFrames, unsigned int &inUsed, float *out, unsigned int outFrames)
+{
+  SRC_DATA data;
+  data.data_in       = in;
+  data.data_out      = out;
+  data.input_frames  = inFrames;
+  data.output_frames = outFrames;
+  data.end_of_input  = 0;
+  data.src_ratio     = m_ratio;
+
+  inUsed = 0;
+  if (!m_state || src_process(m_state, &data) != 0)
+    return -1;
+
+  inUsed = data.input_frames_used;
+  return data.output_frames_gen;
+}
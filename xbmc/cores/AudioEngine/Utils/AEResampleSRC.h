@@ -0,0 +1,55 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <samplerate.h>
+#include <vector>
+
+#include "Interfaces/AEResample.h"
+
+/*
+  libsamplerate backed resampler, handles any ratio and ratio changes.
+*/
+class CAEResampleSRC : public IAEResample
+{
+public:
+  virtual const char *GetName() { return "libsamplerate"; }
+
+  CAEResampleSRC(enum AEResampleQuality quality);
+  virtual ~CAEResampleSRC();
+
+  virtual bool   Initialize(unsigned int channels, double ratio);
+  virtual bool   SetRatio  (double ratio);
+  virtual double GetRatio  () { return m_ratio; }
+  virtual void   Reset     ();
+  virtual int    Resample  (float *in, unsigned int inFrames, unsigned int &inUsed, float *out, unsigned int outFrames);
+  virtual void   SetHistory(const float *in, unsigned int frames, double lead);
+
+private:
+  int Process(float *in, unsigned int inFrames, unsigned int &inUsed, float *out, unsigned int outFrames);
+
+  int          m_converter;
+  SRC_STATE   *m_state;
+  double       m_ratio;
+  unsigned int m_channels;
+
+  std::vector<float> m_history; /* handed over input still to be run, interleaved */
+  unsigned int       m_discard; /* output frames still to drop for the already played part of it */
+};
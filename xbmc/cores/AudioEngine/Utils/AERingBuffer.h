@@ -27,8 +27,15 @@
 //#define AE_RING_BUFFER_DEBUG
 
 #include "utils/log.h"  //CLog
+#include "threads/Atomics.h"
 #include <string.h>     //memset, memcpy
 
+/*
+ * Full memory barrier, used to order the data copies against the index
+ * updates so the reader never sees an index before the data it covers.
+ */
+#define AE_RING_BARRIER() AtomicMemoryBarrier()
+
 /**
  * This buffer can be used by one read and one write thread at any one time
  * without the risk of data corruption.
@@ -140,6 +147,7 @@ public:
     }
 
     //we can increase the write count now
+    AE_RING_BARRIER();
     m_iWritten+=size;
     return AE_RING_BUFFER_OK;
   }
@@ -154,6 +162,7 @@ public:
   int Read(unsigned char *dest, unsigned int size)
   {
     unsigned int space = GetReadSize();
+    AE_RING_BARRIER();
 
     //want to read more than we have written?
     if( space <= 0 )
@@ -195,6 +204,7 @@ public:
       m_iReadPos = second;
     }
     //we can increase the read count now
+    AE_RING_BARRIER();
     m_iRead+=size;
 
     return AE_RING_BUFFER_OK;
@@ -246,8 +256,114 @@ public:
 private:
   unsigned int m_iReadPos;
   unsigned int m_iWritePos;
-  unsigned int m_iRead;
-  unsigned int m_iWritten;
+  volatile unsigned int m_iRead;
+  volatile unsigned int m_iWritten;
   unsigned int m_iSize;
   unsigned char *m_Buffer;
 };
+
+/**
+ * Fixed capacity queue of items for exactly one producer and one consumer
+ * thread. Push and Pop never block or retry, each side only ever writes its
+ * own index. Intended for handing pointers to buffers between threads.
+ * Create() and Reset() are not thread-safe, hold off both sides while
+ * calling them.
+ */
+template <typename T>
+class AESPSCRing {
+
+public:
+  AESPSCRing() :
+    m_Items(NULL),
+    m_iMask(0),
+    m_iReadPos(0),
+    m_iWritePos(0)
+  {
+  }
+
+  ~AESPSCRing()
+  {
+    delete[] m_Items;
+  }
+
+  /**
+   * Allocates room for at least capacity items, rounded up to a power of two.
+   *
+   * @return true on success, false otherwise
+   */
+  bool Create(unsigned int capacity)
+  {
+    unsigned int size = 1;
+    while (size < capacity)
+      size <<= 1;
+
+    delete[] m_Items;
+    m_Items = new T[size];
+    if (!m_Items)
+    {
+      m_iMask = 0;
+      return false;
+    }
+
+    m_iMask = size - 1;
+    Reset();
+    return true;
+  }
+
+  /**
+   * Forgets all queued items, the caller owns anything that was still queued.
+   */
+  void Reset()
+  {
+    m_iReadPos  = 0;
+    m_iWritePos = 0;
+  }
+
+  /**
+   * Queues an item, producer side only.
+   *
+   * @return false if the queue is full
+   */
+  bool Push(const T &item)
+  {
+    unsigned int pos = m_iWritePos;
+    if (!m_Items || pos - m_iReadPos > m_iMask)
+      return false;
+
+    m_Items[pos & m_iMask] = item;
+    AE_RING_BARRIER();
+    m_iWritePos = pos + 1;
+    return true;
+  }
+
+  /**
+   * Dequeues the oldest item, consumer side only.
+   *
+   * @return false if the queue is empty
+   */
+  bool Pop(T &item)
+  {
+    unsigned int pos = m_iReadPos;
+    if (pos == m_iWritePos)
+      return false;
+
+    AE_RING_BARRIER();
+    item = m_Items[pos & m_iMask];
+    AE_RING_BARRIER();
+    m_iReadPos = pos + 1;
+    return true;
+  }
+
+  unsigned int Count   () const { return m_iWritePos - m_iReadPos; }
+  bool         IsEmpty () const { return m_iWritePos == m_iReadPos; }
+  unsigned int Capacity() const { return m_Items ? m_iMask + 1 : 0; }
+
+private:
+  T            *m_Items;
+  unsigned int  m_iMask;
+
+  /* keep the two indexes on separate cache lines, they are written by different threads */
+  volatile unsigned int m_iReadPos;
+  char                  m_pad[64 - sizeof(unsigned int)];
+  volatile unsigned int m_iWritePos;
+};
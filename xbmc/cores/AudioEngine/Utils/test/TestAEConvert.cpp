@@ -0,0 +1,159 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEConvert.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+/* not a multiple of any vector width so the scalar tail is exercised too */
+#define TEST_SAMPLES 4099
+
+static const enum AEDataFormat toFloatFormats[] =
+{
+  AE_FMT_U8, AE_FMT_S8, AE_FMT_S16LE, AE_FMT_S16BE, AE_FMT_S24LE4, AE_FMT_S24BE4,
+  AE_FMT_S24LE3, AE_FMT_S24BE3, AE_FMT_S32LE, AE_FMT_S32BE
+};
+
+static const enum AEDataFormat frFloatFormats[] =
+{
+  AE_FMT_U8, AE_FMT_S8, AE_FMT_S16LE, AE_FMT_S16BE, AE_FMT_S24NE4, AE_FMT_S24NE3,
+  AE_FMT_S32LE, AE_FMT_S32BE
+};
+
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
+
+/* value of sample i in the integer output of a FrFloat converter */
+static int64_t ReadSample(enum AEDataFormat format, const uint8_t *data, unsigned int i)
+{
+  switch (format)
+  {
+    case AE_FMT_U8   : return data[i];
+    case AE_FMT_S8   : return (int8_t)data[i];
+    case AE_FMT_S16LE: return (int16_t)(data[i * 2] | (data[i * 2 + 1] << 8));
+    case AE_FMT_S16BE: return (int16_t)(data[i * 2 + 1] | (data[i * 2] << 8));
+    case AE_FMT_S24NE4:
+    {
+      int32_t v;
+      memcpy(&v, data + i * 4, 4);
+      return v >> 8;
+    }
+    case AE_FMT_S24NE3:
+    {
+      uint32_t v = 0;
+      memcpy(&v, data + i * 3, 3);
+#ifdef __BIG_ENDIAN__
+      v >>= 8;
+#endif
+      return (int32_t)(v << 8) >> 8;
+    }
+    case AE_FMT_S32LE: return (int32_t)(data[i * 4] | (data[i * 4 + 1] << 8) | (data[i * 4 + 2] << 16) | ((uint32_t)data[i * 4 + 3] << 24));
+    case AE_FMT_S32BE: return (int32_t)(data[i * 4 + 3] | (data[i * 4 + 2] << 8) | (data[i * 4 + 1] << 16) | ((uint32_t)data[i * 4] << 24));
+    default:
+      return 0;
+  }
+}
+
+TEST(TestAEConvert, ToFloatMatchesScalar)
+{
+  std::vector<uint8_t> in(TEST_SAMPLES * 8);
+  std::vector<float>   simd(TEST_SAMPLES), scalar(TEST_SAMPLES);
+
+  srand(1);
+  for (unsigned int i = 0; i < in.size(); ++i)
+    in[i] = rand() & 0xFF;
+
+  for (unsigned int f = 0; f < ARRAY_SIZE(toFloatFormats); ++f)
+  {
+    CAEConvert::AEConvertToFn simdFn   = CAEConvert::ToFloat(toFloatFormats[f]);
+    CAEConvert::AEConvertToFn scalarFn = CAEConvert::ToFloat(toFloatFormats[f], false);
+    ASSERT_TRUE(simdFn   != NULL);
+    ASSERT_TRUE(scalarFn != NULL);
+
+    EXPECT_EQ(TEST_SAMPLES, simdFn  (&in[0], TEST_SAMPLES, &simd  [0]));
+    EXPECT_EQ(TEST_SAMPLES, scalarFn(&in[0], TEST_SAMPLES, &scalar[0]));
+    for (unsigned int i = 0; i < TEST_SAMPLES; ++i)
+      EXPECT_FLOAT_EQ(scalar[i], simd[i]) << CAEUtil::DataFormatToStr(toFloatFormats[f]) << " sample " << i;
+  }
+}
+
+TEST(TestAEConvert, FrFloatMatchesScalar)
+{
+  std::vector<float>   in(TEST_SAMPLES);
+  std::vector<uint8_t> simd(TEST_SAMPLES * 4), scalar(TEST_SAMPLES * 4);
+
+  srand(1);
+  for (unsigned int i = 0; i < TEST_SAMPLES; ++i)
+    in[i] = (rand() / (float)RAND_MAX) * 2.0f - 1.0f;
+  in[0] =  1.0f;
+  in[1] = -1.0f;
+  in[2] =  0.0f;
+
+  for (unsigned int f = 0; f < ARRAY_SIZE(frFloatFormats); ++f)
+  {
+    enum AEDataFormat format = frFloatFormats[f];
+    CAEConvert::AEConvertFrFn simdFn   = CAEConvert::FrFloat(format);
+    CAEConvert::AEConvertFrFn scalarFn = CAEConvert::FrFloat(format, false);
+    ASSERT_TRUE(simdFn   != NULL);
+    ASSERT_TRUE(scalarFn != NULL);
+
+    EXPECT_EQ(simdFn  (&in[0], TEST_SAMPLES, &simd  [0]),
+              scalarFn(&in[0], TEST_SAMPLES, &scalar[0]));
+
+    /*
+      rounding modes differ by at most one step, the 16 bit formats are
+      dithered with different random values and 32 bit goes through float
+    */
+    int64_t tolerance = 1;
+    if (format == AE_FMT_S16LE || format == AE_FMT_S16BE)
+      tolerance = 2;
+    else if (format == AE_FMT_S32LE || format == AE_FMT_S32BE)
+      tolerance = 128;
+
+    for (unsigned int i = 0; i < TEST_SAMPLES; ++i)
+    {
+      int64_t diff = ReadSample(format, &simd[0], i) - ReadSample(format, &scalar[0], i);
+      EXPECT_LE(llabs(diff), tolerance) << CAEUtil::DataFormatToStr(format) << " sample " << i;
+    }
+  }
+}
+
+/* full scale has to saturate, not wrap around */
+TEST(TestAEConvert, FrFloat8BitFullScale)
+{
+  float in[3] = { 1.0f, -1.0f, 0.0f };
+  uint8_t out[3];
+
+  for (int simd = 0; simd < 2; ++simd)
+  {
+    CAEConvert::FrFloat(AE_FMT_S8, simd != 0)(in, 3, out);
+    EXPECT_EQ(INT8_MAX, (int8_t)out[0]);
+    EXPECT_EQ(INT8_MIN, (int8_t)out[1]);
+    EXPECT_EQ(0       , (int8_t)out[2]);
+
+    CAEConvert::FrFloat(AE_FMT_U8, simd != 0)(in, 3, out);
+    EXPECT_EQ(UINT8_MAX, out[0]);
+    EXPECT_EQ(0        , out[1]);
+  }
+}
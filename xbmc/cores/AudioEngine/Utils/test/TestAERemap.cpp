@@ -0,0 +1,76 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AERemap.h"
+#include "settings/GUISettings.h"
+
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+/* not a multiple of 4 so the plain C tail is exercised too */
+#define TEST_FRAMES 1027
+
+static void CheckLayouts(bool finalStage)
+{
+  std::vector<float> in(TEST_FRAMES * AE_CH_MAX);
+  std::vector<float> simd(TEST_FRAMES * AE_CH_MAX), scalar(TEST_FRAMES * AE_CH_MAX);
+
+  srand(1);
+  for (unsigned int i = 0; i < in.size(); ++i)
+    in[i] = (rand() / (float)RAND_MAX) * 2.0f - 1.0f;
+
+  for (int i = AE_CH_LAYOUT_1_0; i < AE_CH_LAYOUT_MAX; ++i)
+  {
+    for (int o = AE_CH_LAYOUT_1_0; o < AE_CH_LAYOUT_MAX; ++o)
+    {
+      CAEChannelInfo input  = (enum AEStdChLayout)i;
+      CAEChannelInfo output = (enum AEStdChLayout)o;
+
+      CAERemap remap;
+      if (!remap.Initialize(input, output, finalStage, true))
+        continue;
+
+      memset(&simd  [0], 0, simd  .size() * sizeof(float));
+      memset(&scalar[0], 0, scalar.size() * sizeof(float));
+      remap.Remap(&in[0], &simd  [0], TEST_FRAMES);
+      remap.Remap(&in[0], &scalar[0], TEST_FRAMES, false);
+
+      EXPECT_EQ(0, memcmp(&simd[0], &scalar[0], TEST_FRAMES * output.Count() * sizeof(float)))
+        << "layout " << i << " -> " << o << (finalStage ? " (final stage)" : "");
+    }
+  }
+}
+
+TEST(TestAERemap, BitExact)
+{
+  bool upmix = g_guiSettings.GetBool("audiooutput.stereoupmix");
+
+  g_guiSettings.SetBool("audiooutput.stereoupmix", false);
+  CheckLayouts(false);
+  CheckLayouts(true);
+
+  g_guiSettings.SetBool("audiooutput.stereoupmix", true);
+  CheckLayouts(false);
+
+  g_guiSettings.SetBool("audiooutput.stereoupmix", upmix);
+}
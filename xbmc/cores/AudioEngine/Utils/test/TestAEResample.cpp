@@ -0,0 +1,196 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEResamplePolyphase.h"
+#include "cores/AudioEngine/Utils/AEResampleSRC.h"
+
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+
+#define TEST_CHANNELS 2
+#define TEST_FRAMES   8000
+
+static const unsigned int testRates[][2] =
+{
+  {44100, 48000}, {48000, 44100}, {48000, 96000}, {32000, 48000}, {96000, 44100}
+};
+
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
+
+/* stereo sine, a different frequency per channel */
+static void MakeSine(std::vector<float> &buffer, unsigned int frames, unsigned int rate)
+{
+  buffer.resize(frames * TEST_CHANNELS);
+  for (unsigned int f = 0; f < frames; ++f)
+    for (unsigned int c = 0; c < TEST_CHANNELS; ++c)
+      buffer[f * TEST_CHANNELS + c] = 0.5f * sinf(2.0f * (float)M_PI * (1000.0f + 500.0f * c) * f / rate);
+}
+
+/* resample in chunks of chunk frames, returns the output frame count */
+static unsigned int ResampleAll(IAEResample &resampler, std::vector<float> &in, std::vector<float> &out, unsigned int chunk)
+{
+  unsigned int inFrames = in.size() / TEST_CHANNELS;
+  unsigned int outMax   = (unsigned int)(inFrames * resampler.GetRatio()) + 64;
+  out.resize(outMax * TEST_CHANNELS);
+
+  unsigned int pos = 0, produced = 0;
+  while (pos < inFrames)
+  {
+    unsigned int used;
+    unsigned int frames = std::min(chunk, inFrames - pos);
+    int ret = resampler.Resample(&in[pos * TEST_CHANNELS], frames, used, &out[produced * TEST_CHANNELS], outMax - produced);
+    EXPECT_GE(ret, 0);
+    if (ret < 0)
+      break;
+    pos      += used;
+    produced += ret;
+  }
+  out.resize(produced * TEST_CHANNELS);
+  return produced;
+}
+
+TEST(TestAEResamplePolyphase, Supported)
+{
+  EXPECT_TRUE (CAEResamplePolyphase::IsSupported(44100, 48000));
+  EXPECT_TRUE (CAEResamplePolyphase::IsSupported(48000, 96000));
+  EXPECT_FALSE(CAEResamplePolyphase::IsSupported(44100, 48001));
+
+  CAEResamplePolyphase resampler(AE_RESAMPLE_MEDIUM, 44100, 48000);
+  EXPECT_TRUE (resampler.Initialize(TEST_CHANNELS, 48000.0 / 44100.0));
+  EXPECT_TRUE (resampler.SetRatio(48000.0 / 44100.0));
+  EXPECT_FALSE(resampler.SetRatio(48000.0 / 44100.0 * 1.001));
+}
+
+TEST(TestAEResamplePolyphase, Sine)
+{
+  for (unsigned int r = 0; r < ARRAY_SIZE(testRates); ++r)
+  {
+    unsigned int inRate  = testRates[r][0];
+    unsigned int outRate = testRates[r][1];
+
+    std::vector<float> in, out;
+    MakeSine(in, TEST_FRAMES, inRate);
+
+    CAEResamplePolyphase resampler(AE_RESAMPLE_MEDIUM, inRate, outRate);
+    ASSERT_TRUE(resampler.Initialize(TEST_CHANNELS, (double)outRate / inRate));
+    unsigned int frames = ResampleAll(resampler, in, out, TEST_FRAMES);
+    EXPECT_NEAR((double)TEST_FRAMES * outRate / inRate, frames, 64.0);
+
+    /* the filter is linear phase, compare against the ideal sine delayed by half its length */
+    unsigned int up = outRate;
+    for (unsigned int a = inRate, b = outRate; b; ) { unsigned int t = a % b; a = b; b = t; up = outRate / a; }
+    double delay = (up * 32 - 1) / (2.0 * up);
+    double worst = 0.0;
+    for (unsigned int f = 64; f + 64 < frames; ++f)
+    {
+      double t = (double)f * inRate / outRate - delay;
+      for (unsigned int c = 0; c < TEST_CHANNELS; ++c)
+      {
+        double expected = 0.5 * sin(2.0 * M_PI * (1000.0 + 500.0 * c) * t / inRate);
+        worst = std::max(worst, fabs(expected - out[f * TEST_CHANNELS + c]));
+      }
+    }
+    EXPECT_LT(worst, 1e-3) << inRate << " -> " << outRate;
+  }
+}
+
+TEST(TestAEResamplePolyphase, Chunked)
+{
+  std::vector<float> in, whole, chunked;
+  MakeSine(in, TEST_FRAMES, 44100);
+
+  for (unsigned int r = 0; r < ARRAY_SIZE(testRates); ++r)
+  {
+    CAEResamplePolyphase a(AE_RESAMPLE_LOW, testRates[r][0], testRates[r][1]);
+    CAEResamplePolyphase b(AE_RESAMPLE_LOW, testRates[r][0], testRates[r][1]);
+    ASSERT_TRUE(a.Initialize(TEST_CHANNELS, (double)testRates[r][1] / testRates[r][0]));
+    ASSERT_TRUE(b.Initialize(TEST_CHANNELS, (double)testRates[r][1] / testRates[r][0]));
+
+    /* odd chunk sizes must give exactly the same result as one big call */
+    ResampleAll(a, in, whole  , TEST_FRAMES);
+    ResampleAll(b, in, chunked, 37);
+    ASSERT_EQ(whole.size(), chunked.size());
+    EXPECT_TRUE(whole == chunked) << testRates[r][0] << " -> " << testRates[r][1];
+  }
+}
+
+TEST(TestAEResamplePolyphase, MatchesScalar)
+{
+  std::vector<float> in, simd, scalar;
+  MakeSine(in, TEST_FRAMES, 44100);
+
+  CAEResamplePolyphase a(AE_RESAMPLE_MEDIUM, 44100, 48000);
+  CAEResamplePolyphase b(AE_RESAMPLE_MEDIUM, 44100, 48000, false);
+  ASSERT_TRUE(a.Initialize(TEST_CHANNELS, 48000.0 / 44100.0));
+  ASSERT_TRUE(b.Initialize(TEST_CHANNELS, 48000.0 / 44100.0));
+  ResampleAll(a, in, simd  , 512);
+  ResampleAll(b, in, scalar, 512);
+
+  ASSERT_EQ(simd.size(), scalar.size());
+  for (unsigned int i = 0; i < simd.size(); ++i)
+    ASSERT_NEAR(scalar[i], simd[i], 1e-5) << "sample " << i;
+}
+
+/* switching to libsamplerate part way through must neither drop nor repeat input */
+TEST(TestAEResample, Handover)
+{
+  const unsigned int inRate  = 44100;
+  const unsigned int outRate = 48000;
+  const double       ratio   = (double)outRate / inRate;
+
+  /* a slow sine, so the sub frame offset of the hand over stays well below the tolerance */
+  std::vector<float> first, second;
+  const unsigned int half = TEST_FRAMES / 2;
+  for (unsigned int f = 0; f < TEST_FRAMES; ++f)
+    for (unsigned int c = 0; c < TEST_CHANNELS; ++c)
+      (f < half ? first : second).push_back(0.5f * sinf(2.0f * (float)M_PI * 50.0f * f / inRate));
+
+  CAEResamplePolyphase polyphase(AE_RESAMPLE_LOW, inRate, outRate);
+  CAEResampleSRC       src      (AE_RESAMPLE_MEDIUM);
+  ASSERT_TRUE(polyphase.Initialize(TEST_CHANNELS, ratio));
+  ASSERT_TRUE(src      .Initialize(TEST_CHANNELS, ratio));
+
+  std::vector<float> out, rest, history;
+  ResampleAll(polyphase, first, out, 512);
+
+  double lead;
+  unsigned int frames = polyphase.GetHistory(history, lead);
+  ASSERT_GT(frames, 0u);
+  EXPECT_LE(lead, (double)frames);
+  src.SetHistory(&history[0], frames, lead);
+  ResampleAll(src, second, rest, 512);
+  out.insert(out.end(), rest.begin(), rest.end());
+
+  /* both halves have to line up with the polyphase delay, a gap shows up as a phase jump */
+  const unsigned int up    = 160; /* 44100 -> 48000 reduces to 160/147 */
+  const double       delay = (up * 16 - 1) / (2.0 * up);
+  const unsigned int total = out.size() / TEST_CHANNELS;
+  double worst = 0.0;
+  for (unsigned int f = 64; f + 64 < total; ++f)
+  {
+    double expected = 0.5 * sin(2.0 * M_PI * 50.0 * ((double)f / ratio - delay) / inRate);
+    for (unsigned int c = 0; c < TEST_CHANNELS; ++c)
+      worst = std::max(worst, fabs(expected - out[f * TEST_CHANNELS + c]));
+  }
+  EXPECT_LT(worst, 1e-2);
+}
@@ -0,0 +1,106 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "cores/AudioEngine/Utils/AERingBuffer.h"
+#include "threads/test/TestHelpers.h"
+
+#include "gtest/gtest.h"
+
+#define TEST_ITEMS 100000
+
+TEST(TestAESPSCRing, Capacity)
+{
+  AESPSCRing<int> ring;
+  EXPECT_TRUE(ring.Create(5));
+  EXPECT_EQ(8U, ring.Capacity());
+
+  for (int i = 0; i < 8; ++i)
+    EXPECT_TRUE(ring.Push(i));
+  EXPECT_FALSE(ring.Push(8));
+  EXPECT_EQ(8U, ring.Count());
+
+  int item;
+  for (int i = 0; i < 8; ++i)
+  {
+    EXPECT_TRUE(ring.Pop(item));
+    EXPECT_EQ(i, item);
+  }
+  EXPECT_FALSE(ring.Pop(item));
+  EXPECT_TRUE(ring.IsEmpty());
+}
+
+class RingProducer : public IRunnable
+{
+  AESPSCRing<unsigned int> &m_ring;
+public:
+  RingProducer(AESPSCRing<unsigned int> &ring) : m_ring(ring) {}
+
+  void Run()
+  {
+    for (unsigned int i = 0; i < TEST_ITEMS; ++i)
+    {
+      while (!m_ring.Push(i))
+        SleepMillis(0);
+    }
+  }
+};
+
+TEST(TestAESPSCRing, Threaded)
+{
+  AESPSCRing<unsigned int> ring;
+  ASSERT_TRUE(ring.Create(64));
+
+  RingProducer producer(ring);
+  thread t(producer);
+
+  unsigned int expected = 0, item;
+  while (expected < TEST_ITEMS)
+  {
+    if (!ring.Pop(item))
+    {
+      SleepMillis(0);
+      continue;
+    }
+    ASSERT_EQ(expected, item);
+    ++expected;
+  }
+
+  EXPECT_TRUE(t.timed_join(MILLIS(10000)));
+  EXPECT_TRUE(ring.IsEmpty());
+}
+
+TEST(TestAERingBuffer, WrapAround)
+{
+  AERingBuffer buffer(16);
+  unsigned char in[10], out[10];
+  for (int pass = 0; pass < 5; ++pass)
+  {
+    for (int i = 0; i < 10; ++i)
+      in[i] = pass * 10 + i;
+
+    int ret = buffer.Write(in, sizeof(in));
+    EXPECT_EQ(0, ret);
+    ret = buffer.Read(out, sizeof(out));
+    EXPECT_EQ(0, ret);
+    EXPECT_EQ(0, memcmp(in, out, sizeof(in)));
+  }
+  EXPECT_EQ(0U, buffer.GetReadSize());
+}
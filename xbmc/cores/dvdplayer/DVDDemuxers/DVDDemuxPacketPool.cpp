@@ -0,0 +1,232 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#if (defined HAVE_CONFIG_H) && (!defined WIN32)
+  #include "config.h"
+#endif
+#include "system.h"
+#include "DVDDemuxPacketPool.h"
+#include "DVDClock.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+extern "C" {
+#if (defined USE_EXTERNAL_FFMPEG)
+  #if (defined HAVE_LIBAVCODEC_AVCODEC_H)
+    #include <libavcodec/avcodec.h>
+  #else
+    #include <ffmpeg/avcodec.h>
+  #endif
+#else
+  #include "libavcodec/avcodec.h"
+#endif
+}
+
+// smallest pooled payload buffer is 1 << POOL_MIN_SHIFT bytes, the largest
+// 1 << POOL_MAX_SHIFT. Anything bigger is allocated and freed directly.
+#define POOL_MIN_SHIFT        8
+#define POOL_MAX_SHIFT        22
+#define POOL_CLASSES          (POOL_MAX_SHIFT - POOL_MIN_SHIFT + 2) // + class 0 for packets without payload
+#define POOL_CLASS_OVERSIZED  -1
+
+// upper bound of payload memory kept around on the free lists
+#define POOL_MAX_CACHED_BYTES (16 * 1024 * 1024)
+
+// the DemuxPacket must stay the first member, FreeDemuxPacket only gets that pointer back
+struct CDVDDemuxPacketPool::PooledPacket
+{
+  DemuxPacket packet;
+  BYTE*       buffer;
+  int         bufferSize;
+  int         sizeClass;
+};
+
+CDVDDemuxPacketPool &CDVDDemuxPacketPool::GetInstance()
+{
+  static CDVDDemuxPacketPool pool;
+  return pool;
+}
+
+CDVDDemuxPacketPool::CDVDDemuxPacketPool()
+  : m_freeLists(POOL_CLASSES)
+{
+  m_cachedBytes = 0;
+  m_hits        = 0;
+  m_misses      = 0;
+  m_oversized   = 0;
+}
+
+CDVDDemuxPacketPool::~CDVDDemuxPacketPool()
+{
+  Flush();
+}
+
+int CDVDDemuxPacketPool::GetSizeClass(int iBufferSize)
+{
+  if (iBufferSize <= 0)
+    return 0;
+
+  int shift = POOL_MIN_SHIFT;
+  while ((1 << shift) < iBufferSize)
+  {
+    if (++shift > POOL_MAX_SHIFT)
+      return POOL_CLASS_OVERSIZED;
+  }
+  return shift - POOL_MIN_SHIFT + 1;
+}
+
+void CDVDDemuxPacketPool::Destroy(PooledPacket* pPooled)
+{
+  if (pPooled->buffer)
+    _aligned_free(pPooled->buffer);
+  delete pPooled;
+}
+
+DemuxPacket* CDVDDemuxPacketPool::Allocate(int iDataSize)
+{
+  // need to allocate a few bytes more.
+  // From avcodec.h (ffmpeg)
+  /**
+    * Required number of additionally allocated bytes at the end of the input bitstream for decoding.
+    * this is mainly needed because some optimized bitstream readers read
+    * 32 or 64 bit at once and could read over the end<br>
+    * Note, if the first 23 bits of the additional bytes are not 0 then damaged
+    * MPEG bitstreams could cause overread and segfault
+    */
+  int bufferSize = iDataSize > 0 ? iDataSize + FF_INPUT_BUFFER_PADDING_SIZE : 0;
+  int sizeClass  = GetSizeClass(bufferSize);
+
+  PooledPacket* pPooled = NULL;
+  if (sizeClass != POOL_CLASS_OVERSIZED)
+  {
+    CSingleLock lock(m_section);
+    FreeList &list = m_freeLists[sizeClass];
+    if (!list.empty())
+    {
+      pPooled = list.back();
+      list.pop_back();
+      m_cachedBytes -= pPooled->bufferSize;
+      m_hits++;
+    }
+    else
+      m_misses++;
+  }
+  else
+  {
+    CSingleLock lock(m_section);
+    m_oversized++;
+  }
+
+  if (!pPooled)
+  {
+    pPooled = new PooledPacket;
+    if (!pPooled)
+      return NULL;
+
+    pPooled->sizeClass  = sizeClass;
+    pPooled->bufferSize = 0;
+    pPooled->buffer     = NULL;
+    if (bufferSize > 0)
+    {
+      // round pooled buffers up to the full class size so they can be reused
+      // by any packet of the same class
+      if (sizeClass != POOL_CLASS_OVERSIZED)
+        pPooled->bufferSize = 1 << (sizeClass + POOL_MIN_SHIFT - 1);
+      else
+        pPooled->bufferSize = bufferSize;
+
+      pPooled->buffer = (BYTE*)_aligned_malloc(pPooled->bufferSize, 16);
+      if (!pPooled->buffer)
+      {
+        CLog::Log(LOGERROR, "%s - failed to allocate %d bytes", __FUNCTION__, pPooled->bufferSize);
+        delete pPooled;
+        return NULL;
+      }
+    }
+  }
+
+  DemuxPacket* pPacket = &pPooled->packet;
+  memset(pPacket, 0, sizeof(DemuxPacket));
+  if (iDataSize > 0)
+  {
+    pPacket->pData = pPooled->buffer;
+    // reset the padding bytes to 0
+    memset(pPacket->pData + iDataSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
+  }
+
+  // setup defaults
+  pPacket->dts       = DVD_NOPTS_VALUE;
+  pPacket->pts       = DVD_NOPTS_VALUE;
+  pPacket->iStreamId = -1;
+
+  return pPacket;
+}
+
+void CDVDDemuxPacketPool::Free(DemuxPacket* pPacket)
+{
+  if (!pPacket)
+    return;
+
+  PooledPacket* pPooled = (PooledPacket*)pPacket;
+  if (pPooled->sizeClass != POOL_CLASS_OVERSIZED)
+  {
+    CSingleLock lock(m_section);
+    if (m_cachedBytes + pPooled->bufferSize <= POOL_MAX_CACHED_BYTES)
+    {
+      m_freeLists[pPooled->sizeClass].push_back(pPooled);
+      m_cachedBytes += pPooled->bufferSize;
+      return;
+    }
+  }
+
+  Destroy(pPooled);
+}
+
+void CDVDDemuxPacketPool::Flush()
+{
+  std::vector<FreeList> lists(POOL_CLASSES);
+  {
+    CSingleLock lock(m_section);
+    m_freeLists.swap(lists);
+    m_cachedBytes = 0;
+  }
+
+  for (std::vector<FreeList>::iterator it = lists.begin(); it != lists.end(); ++it)
+  {
+    for (FreeList::iterator pit = it->begin(); pit != it->end(); ++pit)
+      Destroy(*pit);
+  }
+}
+
+void CDVDDemuxPacketPool::GetStats(Stats &stats) const
+{
+  CSingleLock lock(m_section);
+  stats.hits        = m_hits;
+  stats.misses      = m_misses;
+  stats.oversized   = m_oversized;
+  stats.cachedBytes = m_cachedBytes;
+}
+
+void CDVDDemuxPacketPool::ResetStats()
+{
+  CSingleLock lock(m_section);
+  m_hits      = 0;
+  m_misses    = 0;
+  m_oversized = 0;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDemuxPacket.h"
+#include "threads/CriticalSection.h"
+#include <vector>
+
+/*!
+ \brief Recycling allocator for DemuxPacket objects and their payload buffers.
+
+ Packets are grouped in power-of-two size classes. Freed packets are kept on a
+ per-class free list (up to a total byte budget) and handed out again on the
+ next allocation of the same class, so steady-state playback does not touch
+ the system allocator for every demuxed packet.
+
+ All packets handed out by the pool must be returned with Free(), which is
+ what CDVDDemuxUtils::FreeDemuxPacket does.
+ */
+class CDVDDemuxPacketPool
+{
+public:
+  struct Stats
+  {
+    long hits;        // allocations served from a free list
+    long misses;      // allocations that had to go to the system allocator
+    long oversized;   // allocations too large to be pooled
+    long cachedBytes; // payload bytes currently held on the free lists
+  };
+
+  static CDVDDemuxPacketPool &GetInstance();
+
+  /*!
+   \brief Allocate a packet with room for iDataSize bytes of payload.
+   The payload is followed by FF_INPUT_BUFFER_PADDING_SIZE zeroed bytes.
+   \return the packet or NULL on allocation failure
+   */
+  DemuxPacket* Allocate(int iDataSize);
+
+  /*!
+   \brief Return a packet obtained from Allocate() to the pool.
+   */
+  void Free(DemuxPacket* pPacket);
+
+  /*!
+   \brief Release all cached packets back to the system allocator.
+   Packets currently in use are not affected.
+   */
+  void Flush();
+
+  void GetStats(Stats &stats) const;
+  void ResetStats();
+
+private:
+  CDVDDemuxPacketPool();
+  ~CDVDDemuxPacketPool();
+  CDVDDemuxPacketPool(const CDVDDemuxPacketPool&);
+  CDVDDemuxPacketPool const& operator=(CDVDDemuxPacketPool const&);
+
+  struct PooledPacket;
+
+  static int  GetSizeClass(int iBufferSize);
+  static void Destroy(PooledPacket* pPooled);
+
+  typedef std::vector<PooledPacket*> FreeList;
+
+  std::vector<FreeList> m_freeLists;
+  long                  m_cachedBytes;
+  long                  m_hits;
+  long                  m_misses;
+  long                  m_oversized;
+  mutable CCriticalSection m_section;
+};
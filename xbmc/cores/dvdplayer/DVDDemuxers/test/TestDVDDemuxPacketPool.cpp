@@ -0,0 +1,146 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "cores/dvdplayer/DVDClock.h"
+#include "cores/dvdplayer/DVDDemuxers/DVDDemuxPacketPool.h"
+#include "cores/dvdplayer/DVDDemuxers/DVDDemuxUtils.h"
+extern "C" {
+#if (defined USE_EXTERNAL_FFMPEG)
+  #if (defined HAVE_LIBAVCODEC_AVCODEC_H)
+    #include <libavcodec/avcodec.h>
+  #else
+    #include <ffmpeg/avcodec.h>
+  #endif
+#else
+  #include "libavcodec/avcodec.h"
+#endif
+}
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+// the pool is shared, start every test with empty free lists and counters
+class TestDVDDemuxPacketPool : public testing::Test
+{
+protected:
+  TestDVDDemuxPacketPool()
+  {
+    CDVDDemuxPacketPool::GetInstance().Flush();
+    CDVDDemuxPacketPool::GetInstance().ResetStats();
+  }
+
+  ~TestDVDDemuxPacketPool()
+  {
+    CDVDDemuxPacketPool::GetInstance().Flush();
+  }
+
+  static CDVDDemuxPacketPool::Stats GetStats()
+  {
+    CDVDDemuxPacketPool::Stats stats;
+    CDVDDemuxPacketPool::GetInstance().GetStats(stats);
+    return stats;
+  }
+};
+
+TEST_F(TestDVDDemuxPacketPool, Defaults)
+{
+  DemuxPacket *packet = CDVDDemuxUtils::AllocateDemuxPacket(1000);
+  ASSERT_TRUE(packet != NULL);
+  ASSERT_TRUE(packet->pData != NULL);
+  EXPECT_EQ(0u, (uintptr_t)packet->pData % 16);
+  EXPECT_EQ(0, packet->iSize);
+  EXPECT_EQ(-1, packet->iStreamId);
+  EXPECT_EQ(DVD_NOPTS_VALUE, packet->dts);
+  EXPECT_EQ(DVD_NOPTS_VALUE, packet->pts);
+  for (int i = 0; i < FF_INPUT_BUFFER_PADDING_SIZE; i++)
+    EXPECT_EQ(0, packet->pData[1000 + i]) << "padding byte " << i;
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+
+  // packets without payload have no buffer
+  packet = CDVDDemuxUtils::AllocateDemuxPacket();
+  ASSERT_TRUE(packet != NULL);
+  EXPECT_TRUE(packet->pData == NULL);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+
+  CDVDDemuxUtils::FreeDemuxPacket(NULL);
+}
+
+TEST_F(TestDVDDemuxPacketPool, Reuse)
+{
+  DemuxPacket *packet = CDVDDemuxUtils::AllocateDemuxPacket(1000);
+  ASSERT_TRUE(packet != NULL);
+  memset(packet->pData, 0xff, 1000 + FF_INPUT_BUFFER_PADDING_SIZE);
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+  EXPECT_LT(0, GetStats().cachedBytes);
+
+  // the same size class hands the packet out again, cleared and padded
+  DemuxPacket *again = CDVDDemuxUtils::AllocateDemuxPacket(900);
+  EXPECT_EQ(packet, again);
+  EXPECT_EQ(-1, again->iStreamId);
+  EXPECT_EQ(DVD_NOPTS_VALUE, again->dts);
+  for (int i = 0; i < FF_INPUT_BUFFER_PADDING_SIZE; i++)
+    EXPECT_EQ(0, again->pData[900 + i]) << "padding byte " << i;
+
+  // another class doesn't
+  DemuxPacket *other = CDVDDemuxUtils::AllocateDemuxPacket(100000);
+  EXPECT_NE(again, other);
+  CDVDDemuxUtils::FreeDemuxPacket(again);
+  CDVDDemuxUtils::FreeDemuxPacket(other);
+
+  CDVDDemuxPacketPool::Stats stats = GetStats();
+  EXPECT_EQ(1, stats.hits);
+  EXPECT_EQ(2, stats.misses);
+  EXPECT_EQ(0, stats.oversized);
+
+  CDVDDemuxPacketPool::GetInstance().Flush();
+  EXPECT_EQ(0, GetStats().cachedBytes);
+}
+
+TEST_F(TestDVDDemuxPacketPool, Oversized)
+{
+  DemuxPacket *packet = CDVDDemuxUtils::AllocateDemuxPacket(8 * 1024 * 1024);
+  ASSERT_TRUE(packet != NULL);
+  packet->pData[8 * 1024 * 1024 - 1] = 1;
+  CDVDDemuxUtils::FreeDemuxPacket(packet);
+
+  // too large to keep around
+  CDVDDemuxPacketPool::Stats stats = GetStats();
+  EXPECT_EQ(1, stats.oversized);
+  EXPECT_EQ(0, stats.cachedBytes);
+}
+
+TEST_F(TestDVDDemuxPacketPool, Budget)
+{
+  // 64 packets of 1MB are more than the pool keeps
+  DemuxPacket *packets[64];
+  for (int i = 0; i < 64; i++)
+  {
+    packets[i] = CDVDDemuxUtils::AllocateDemuxPacket(1000 * 1000);
+    ASSERT_TRUE(packets[i] != NULL);
+  }
+  for (int i = 0; i < 64; i++)
+    CDVDDemuxUtils::FreeDemuxPacket(packets[i]);
+
+  CDVDDemuxPacketPool::Stats stats = GetStats();
+  EXPECT_LT(0, stats.cachedBytes);
+  EXPECT_GE(16 * 1024 * 1024, stats.cachedBytes);
+}
@@ -510,7 +510,7 @@ void CDVDPlayerAudio::Process()
 
     if( result & DECODE_FLAG_ERROR )
     {
-      CLog::Log(LOGDEBUG, "CDVDPlayerAudio::Process - Decode Error");
+      CLOG(LOGDEBUG, "CDVDPlayerAudio::Process - Decode Error");
       continue;
     }
 
@@ -654,7 +654,7 @@ void CDVDPlayerAudio::HandleSyncError(double duration)
   {
     m_pClock->Discontinuity(clock+error);
     if(m_speed == DVD_PLAYSPEED_NORMAL)
-      CLog::Log(LOGDEBUG, "CDVDPlayerAudio:: Discontinuity1 - was:%f, should be:%f, error:%f", clock, clock+error, error);
+      CLOG(LOGDEBUG, "CDVDPlayerAudio:: Discontinuity1 - was:%f, should be:%f, error:%f", clock, clock+error, error);
 
     m_errorbuff = 0;
     m_errorcount = 0;
@@ -715,7 +715,7 @@ void CDVDPlayerAudio::HandleSyncError(double duration)
       {
         m_pClock->Discontinuity(clock+error);
         if(m_speed == DVD_PLAYSPEED_NORMAL)
-          CLog::Log(LOGDEBUG, "CDVDPlayerAudio:: Discontinuity2 - was:%f, should be:%f, error:%f", clock, clock+error, error);
+          CLOG(LOGDEBUG, "CDVDPlayerAudio:: Discontinuity2 - was:%f, should be:%f, error:%f", clock, clock+error, error);
       }
     }
     else if (m_synctype == SYNC_SKIPDUP && m_skipdupcount == 0 && fabs(m_error) > DVD_MSEC_TO_TIME(10))
@@ -727,10 +727,10 @@ void CDVDPlayerAudio::HandleSyncError(double duration)
         m_skipdupcount = (int)(m_error / (duration / 3 * 2));
 
       if (m_skipdupcount > 0)
-        CLog::Log(LOGDEBUG, "CDVDPlayerAudio:: Duplicating %i packet(s) of %.2f ms duration",
+        CLOG(LOGDEBUG, "CDVDPlayerAudio:: Duplicating %i packet(s) of %.2f ms duration",
                   m_skipdupcount, duration / DVD_TIME_BASE * 1000.0);
       else if (m_skipdupcount < 0)
-        CLog::Log(LOGDEBUG, "CDVDPlayerAudio:: Skipping %i packet(s) of %.2f ms duration ",
+        CLOG(LOGDEBUG, "CDVDPlayerAudio:: Skipping %i packet(s) of %.2f ms duration ",
                   m_skipdupcount * -1,  duration / DVD_TIME_BASE * 1000.0);
     }
     else if (m_synctype == SYNC_RESAMPLE)
@@ -594,7 +594,7 @@ void CDVDPlayerVideo::Process()
         // if decoder had an error, tell it to reset to avoid more problems
         if (iDecoderState & VC_ERROR)
         {
-          CLog::Log(LOGDEBUG, "CDVDPlayerVideo - video decoder returned error");
+          CLOG(LOGDEBUG, "CDVDPlayerVideo - video decoder returned error");
           break;
         }
 
@@ -1620,7 +1620,7 @@ void CDVDPlayerVideo::CalcFrameRate()
       //store the calculated framerate if it differs too much from m_fFrameRate
       if (fabs(m_fFrameRate - (m_fStableFrameRate / m_iFrameRateCount)) > MAXFRAMERATEDIFF || m_bFpsInvalid)
       {
-        CLog::Log(LOGDEBUG,"%s framerate was:%f calculated:%f", __FUNCTION__, m_fFrameRate, m_fStableFrameRate / m_iFrameRateCount);
+        CLOG(LOGDEBUG,"%s framerate was:%f calculated:%f", __FUNCTION__, m_fFrameRate, m_fStableFrameRate / m_iFrameRateCount);
         m_fFrameRate = m_fStableFrameRate / m_iFrameRateCount;
         m_bFpsInvalid = false;
       }
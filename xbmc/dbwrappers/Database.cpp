@@ -22,6 +22,7 @@
 #include "settings/Settings.h"
 #include "settings/AdvancedSettings.h"
 #include "utils/Crc32.h"
+#include "threads/SingleLock.h"
 #include "filesystem/SpecialProtocol.h"
 #include "filesystem/File.h"
 #include "utils/AutoPtrHandle.h"
@@ -41,6 +42,10 @@ using namespace dbiplus;
 
 #define MAX_COMPRESS_COUNT 20
 
+// change counters by base database name, entries are never removed so pointers to them stay valid
+static std::map<std::string, long> changeCounters;
+static CCriticalSection changeCountersSection;
+
 void CDatabase::Filter::AppendField(const std::string &strField)
 {
   if (strField.empty())
@@ -308,6 +313,42 @@ bool CDatabase::CommitInsertQueries()
   return bReturn;
 }
 
+Statement *CDatabase::GetStatement(const char *sql)
+{
+  if (NULL == m_pDB.get()) return NULL;
+
+  StatementCache::iterator it = m_statements.find(sql);
+  if (it != m_statements.end())
+  {
+    it->second->reset();
+    return it->second;
+  }
+
+  Statement *stmt = m_pDB->prepareStatement(sql);
+  m_statements.insert(std::make_pair(std::string(sql), stmt));
+  return stmt;
+}
+
+void CDatabase::ClearStatements()
+{
+  for (StatementCache::iterator it = m_statements.begin(); it != m_statements.end(); ++it)
+    delete it->second;
+  m_statements.clear();
+}
+
+long CDatabase::GetChangeCount(const std::string &baseDBName)
+{
+  CSingleLock lock(changeCountersSection);
+  std::map<std::string, long>::const_iterator it = changeCounters.find(baseDBName);
+  return it != changeCounters.end() ? it->second : 0;
+}
+
+volatile long *CDatabase::GetChangeCounter(const std::string &baseDBName)
+{
+  CSingleLock lock(changeCountersSection);
+  return &changeCounters[baseDBName];
+}
+
 bool CDatabase::Open()
 {
   DatabaseSettings db_fallback;
@@ -433,6 +474,9 @@ bool CDatabase::Update(const DatabaseSettings &settings)
 
 bool CDatabase::Connect(const CStdString &dbName, const DatabaseSettings &dbSettings, bool create)
 {
+  // statements are bound to the connection we're about to replace
+  ClearStatements();
+
   // create the appropriate database structure
   if (dbSettings.type.Equals("sqlite3"))
   {
@@ -464,6 +508,7 @@ bool CDatabase::Connect(const CStdString &dbName, const DatabaseSettings &dbSett
 
   // database name is always required
   m_pDB->setDatabase(dbName.c_str());
+  m_pDB->setChangeCounter(GetChangeCounter(GetBaseDBName()));
 
   // create the datasets
   m_pDS.reset(m_pDB->CreateDataset());
@@ -578,6 +623,7 @@ void CDatabase::Close()
 
   if (NULL == m_pDB.get() ) return ;
   if (NULL != m_pDS.get()) m_pDS->close();
+  ClearStatements();
   m_pDB->disconnect();
   m_pDB.reset();
   m_pDS.reset();
@@ -643,7 +689,11 @@ bool CDatabase::CommitTransaction()
   try
   {
     if (NULL != m_pDB.get())
+    {
       m_pDB->commit_transaction();
+      // the changes only become visible to other connections now
+      m_pDB->committed();
+    }
   }
   catch (...)
   {
@@ -25,8 +25,10 @@
 namespace dbiplus {
   class Database;
   class Dataset;
+  class Statement;
 }
 
+#include <map>
 #include <memory>
 
 class DatabaseSettings; // forward
@@ -136,6 +138,26 @@ public:
    */
   bool CommitInsertQueries();
 
+  /*!
+   * @brief Get a compiled statement for a query with positional '?' parameters.
+   * @remarks Statements are cached by their SQL text for as long as the connection is open, so the
+   * query should be a constant and all values bound with Statement::bind() rather than formatted in.
+   * The statement is handed out reset; hold a dbiplus::StatementReset on it while it's in use so it's reset
+   * when done, even if an exception is thrown, and doesn't hold any locks.
+   * @param sql The query to compile.
+   * @return The statement, or NULL if the database isn't open. Throws DbErrors if the query is invalid.
+   */
+  dbiplus::Statement *GetStatement(const char *sql);
+
+  /*!
+   * @brief Get the number of changes made to a database through any connection of this process.
+   * @remarks Lets caches notice changes that aren't announced. The count only ever increases, it is
+   * bumped by statements that changed rows and again by the commit of a transaction that did.
+   * @param baseDBName The base name of the database, e.g. "MyVideos".
+   * @return The current count, 0 if nothing was changed yet.
+   */
+  static long GetChangeCount(const std::string &baseDBName);
+
   virtual bool GetFilter(CDbUrl &dbUrl, Filter &filter, SortDescription &sorting) { return true; }
   virtual bool BuildSQL(const CStdString &strBaseDir, const CStdString &strQuery, Filter &filter, CStdString &strSQL, CDbUrl &dbUrl);
   virtual bool BuildSQL(const CStdString &strBaseDir, const CStdString &strQuery, Filter &filter, CStdString &strSQL, CDbUrl &dbUrl, SortDescription &sorting);
@@ -170,6 +192,11 @@ private:
   void InitSettings(DatabaseSettings &dbSettings);
   bool Connect(const CStdString &dbName, const DatabaseSettings &db, bool create);
   bool UpdateVersionNumber();
+  void ClearStatements();
+  static volatile long *GetChangeCounter(const std::string &baseDBName);
+
+  typedef std::map<std::string, dbiplus::Statement*> StatementCache;
+  StatementCache m_statements; ///< \brief compiled statements by SQL text, owned by us
 
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
   unsigned int m_openCount;
@@ -27,8 +27,11 @@
  **********************************************************************/
 
 #include "dataset.h"
+#include "threads/Atomics.h"
 #include "utils/log.h"
 #include <cstring>
+#include <cctype>
+#include <memory>
 
 #ifndef __GNUC__
 #pragma warning (disable:4800)
@@ -48,6 +51,8 @@ Database::Database() {
   login = "";
   passwd = "";
   sequence_table = "db_sequence";
+  changes = NULL;
+  uncommitted = false;
 }
 
 Database::~Database() {
@@ -75,6 +80,193 @@ string Database::prepare(const char *format, ...)
   return result;
 }
 
+//************* DatasetStatement implementation ***************
+
+/* Statement fallback for backends without native prepared statements:
+   the SQL is split at its parameters once, each execution glues the
+   escaped values back in and runs the result through a Dataset. */
+class DatasetStatement : public Statement {
+public:
+  DatasetStatement(Database *newDb, const char *sql);
+
+  virtual const string &getSql() const { return m_sql; }
+
+  virtual void bind(int n, int value);
+  virtual void bind(int n, int64_t value);
+  virtual void bind(int n, double value);
+  virtual void bind(int n, const string &value);
+  virtual void bindNull(int n);
+
+  virtual bool step();
+  virtual void reset();
+
+  virtual int columnCount();
+  virtual bool isNull(int col) { return value(col).get_isNull(); }
+  virtual int getInt(int col) { return value(col).get_asInt(); }
+  virtual int64_t getInt64(int col) { return value(col).get_asInt64(); }
+  virtual double getDouble(int col) { return value(col).get_asDouble(); }
+  virtual string getString(int col) { return value(col).get_asString(); }
+
+private:
+  void setParam(int n, const string &literal);
+  const field_value value(int col);
+
+  Database *m_db;
+  auto_ptr<Dataset> m_ds;
+  string m_sql;
+  vector<string> m_parts;   // SQL text between the parameters
+  vector<string> m_params;  // bound values as SQL literals
+  bool m_select;
+  bool m_executed;
+  bool m_fetched;
+};
+
+DatasetStatement::DatasetStatement(Database *newDb, const char *sql)
+  : m_db(newDb), m_ds(newDb->CreateDataset()), m_sql(sql)
+{
+  m_select = false;
+  m_executed = false;
+  m_fetched = false;
+
+  // split at every '?' that isn't inside a quoted literal or identifier
+  string part;
+  char quote = 0;
+  for (const char *p = sql; *p; p++)
+  {
+    if (quote)
+    {
+      if (*p == quote)
+        quote = 0;
+    }
+    else if (*p == '\'' || *p == '"' || *p == '`')
+      quote = *p;
+    else if (*p == '?')
+    {
+      m_parts.push_back(part);
+      part.clear();
+      continue;
+    }
+    part += *p;
+  }
+  m_parts.push_back(part);
+  m_params.resize(m_parts.size() - 1, "NULL");
+
+  size_t start = m_sql.find_first_not_of(" \t\r\n(");
+  if (start != string::npos)
+  {
+    string verb = m_sql.substr(start, 6);
+    for (size_t i = 0; i < verb.size(); i++)
+      verb[i] = tolower(verb[i]);
+    m_select = verb == "select";
+  }
+}
+
+void DatasetStatement::setParam(int n, const string &literal)
+{
+  if (n < 1 || n > (int)m_params.size())
+    throw DbErrors("Parameter %d out of range for '%s'", n, m_sql.c_str());
+  m_params[n - 1] = literal;
+}
+
+void DatasetStatement::bind(int n, int value)
+{
+  char buf[16];
+  sprintf(buf, "%d", value);
+  setParam(n, buf);
+}
+
+void DatasetStatement::bind(int n, int64_t value)
+{
+  char buf[32];
+  sprintf(buf, "%lld", (long long)value);
+  setParam(n, buf);
+}
+
+void DatasetStatement::bind(int n, double value)
+{
+  char buf[32];
+  sprintf(buf, "%.17g", value);
+  setParam(n, buf);
+}
+
+void DatasetStatement::bind(int n, const string &value)
+{
+  setParam(n, m_db->prepare("'%s'", value.c_str()));
+}
+
+void DatasetStatement::bindNull(int n)
+{
+  setParam(n, "NULL");
+}
+
+bool DatasetStatement::step()
+{
+  if (!m_executed)
+  {
+    string sql = m_parts[0];
+    for (size_t i = 0; i < m_params.size(); i++)
+    {
+      sql += m_params[i];
+      sql += m_parts[i + 1];
+    }
+
+    m_executed = true;
+    if (!m_select)
+    {
+      m_ds->exec(sql);
+      return false;
+    }
+    m_ds->query(sql.c_str());
+  }
+  else if (!m_select)
+    return false;
+
+  if (m_fetched && !m_ds->eof())
+    m_ds->next();
+  m_fetched = true;
+  return !m_ds->eof();
+}
+
+void DatasetStatement::reset()
+{
+  m_ds->close();
+  m_params.assign(m_params.size(), "NULL");
+  m_executed = false;
+  m_fetched = false;
+}
+
+int DatasetStatement::columnCount()
+{
+  return m_executed ? m_ds->fieldCount() : 0;
+}
+
+const field_value DatasetStatement::value(int col)
+{
+  if (!m_executed || !m_select || m_ds->eof())
+    throw DbErrors("No current row for '%s'", m_sql.c_str());
+  return m_ds->fv(col);
+}
+
+void Database::changed(void) {
+  if (changes)
+    AtomicIncrement(changes);
+  if (in_transaction())
+    uncommitted = true;
+}
+
+void Database::committed(void) {
+  if (!uncommitted)
+    return;
+  uncommitted = false;
+  if (changes)
+    AtomicIncrement(changes);
+}
+
+Statement *Database::prepareStatement(const char *sql)
+{
+  return new DatasetStatement(this, sql);
+}
+
 //************* Dataset implementation ***************
 
 Dataset::Dataset() {
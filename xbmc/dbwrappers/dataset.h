@@ -42,6 +42,7 @@
 
 namespace dbiplus {
 class Dataset;		// forward declaration of class Dataset
+class Statement;	// forward declaration of class Statement
 
 
 #define S_NO_CONNECTION "No active connection";
@@ -72,6 +73,8 @@ protected:
     host, port, db, login, passwd, //Login info
     sequence_table, //Sequence table for nextid
     default_charset; //Default character set
+  volatile long *changes; //Counter of the changes made, may be NULL
+  bool uncommitted; //Something was changed in the current transaction
 
 public:
 /* constructor */
@@ -107,6 +110,12 @@ public:
   const char *getSequenceTable(void) { return sequence_table.c_str(); }
 /* Get the default character set */
   const char *getDefaultCharset(void) { return default_charset.c_str(); }
+/* Set the counter to bump whenever something is changed through the connection */
+  void setChangeCounter(volatile long *counter) { changes = counter; }
+/* Note that rows were changed through the connection */
+  void changed(void);
+/* Note that the current transaction was committed, its changes are counted again now others can see them */
+  void committed(void);
 
 /* virtual methods that must be overloaded in derived classes */
 
@@ -153,6 +162,82 @@ public:
 
   virtual bool in_transaction() {return false;};
 
+/* precompiled statements */
+
+  /*! \brief Compile a SQL statement with positional '?' parameters for repeated execution.
+   The default implementation substitutes the bound values into the SQL text and runs it
+   through a Dataset, backends with native support override it.
+   \param sql - SQL text, parameters are given as '?' outside of quoted literals.
+   \return a new statement owned by the caller, throws DbErrors if the SQL can't be compiled.
+   */
+  virtual Statement *prepareStatement(const char *sql);
+
+};
+
+
+
+/******************* Class Statement definition *******************
+
+   a compiled SQL statement with typed parameter binding;
+   parameters are numbered from 1, result columns from 0
+
+******************************************************************/
+class Statement {
+public:
+  virtual ~Statement() {}
+
+/* returns the SQL text the statement was compiled from */
+  virtual const std::string &getSql() const = 0;
+
+/* bind values to the n-th '?' parameter, they stay bound until reset() */
+  virtual void bind(int n, int value) = 0;
+  virtual void bind(int n, int64_t value) = 0;
+  virtual void bind(int n, double value) = 0;
+  virtual void bind(int n, const std::string &value) = 0;
+  virtual void bindNull(int n) = 0;
+
+/* executes the statement on first call, then advances to the next row;
+   returns false when there are no (more) rows */
+  virtual bool step() = 0;
+/* executes a statement which does not return rows */
+  virtual void exec() { step(); }
+/* ends the current execution and clears all bindings */
+  virtual void reset() = 0;
+
+/* typed access to the columns of the current row */
+  virtual int columnCount() = 0;
+  virtual bool isNull(int col) = 0;
+  virtual int getInt(int col) = 0;
+  virtual int64_t getInt64(int col) = 0;
+  virtual double getDouble(int col) = 0;
+  virtual std::string getString(int col) = 0;
+};
+
+
+
+/****************** Class StatementReset definition *****************
+
+   resets a statement when it goes out of scope, so a statement left
+   half way through by an exception doesn't keep holding its locks
+
+******************************************************************/
+class StatementReset {
+public:
+  StatementReset(Statement *newStmt) : stmt(newStmt) {}
+  ~StatementReset()
+  {
+    try
+    {
+      if (stmt) stmt->reset();
+    }
+    catch (...) {}
+  }
+
+private:
+  StatementReset(const StatementReset &);
+  StatementReset &operator=(const StatementReset &);
+
+  Statement *stmt;
 };
 
 
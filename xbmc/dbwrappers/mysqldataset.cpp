@@ -319,14 +319,14 @@ int MysqlDatabase::query_with_reconnect(const char* query) {
 }
 
 long MysqlDatabase::nextid(const char* sname) {
-  CLog::Log(LOGDEBUG,"MysqlDatabase::nextid for %s",sname);
+  CLog::Log(LOGDEBUG | LOGDATABASE, "MysqlDatabase::nextid for %s",sname);
   if (!active) return DB_UNEXPECTED_RESULT;
   const char* seq_table = "sys_seq";
   int id;/*,nrow,ncol;*/
   MYSQL_RES* res;
   char sqlcmd[512];
   sprintf(sqlcmd,"select nextid from %s where seq_name = '%s'",seq_table, sname);
-  CLog::Log(LOGDEBUG,"MysqlDatabase::nextid will request");
+  CLog::Log(LOGDEBUG | LOGDATABASE, "MysqlDatabase::nextid will request");
   if ((last_err = query_with_reconnect(sqlcmd)) != 0)
   {
     return DB_UNEXPECTED_RESULT;
@@ -361,7 +361,7 @@ long MysqlDatabase::nextid(const char* sname) {
 void MysqlDatabase::start_transaction() {
   if (active)
   {
-    CLog::Log(LOGDEBUG,"Mysql Start transaction");
+    CLog::Log(LOGDEBUG | LOGDATABASE, "Mysql Start transaction");
     _in_transaction = true;
   }
 }
@@ -370,7 +370,7 @@ void MysqlDatabase::commit_transaction() {
   if (active)
   {
     mysql_commit(conn);
-    CLog::Log(LOGDEBUG,"Mysql commit transaction");
+    CLog::Log(LOGDEBUG | LOGDATABASE, "Mysql commit transaction");
     _in_transaction = false;
   }
 }
@@ -379,7 +379,7 @@ void MysqlDatabase::rollback_transaction() {
   if (active)
   {
     mysql_rollback(conn);
-    CLog::Log(LOGDEBUG,"Mysql rollback transaction");
+    CLog::Log(LOGDEBUG | LOGDATABASE, "Mysql rollback transaction");
     _in_transaction = false;
   }
 }
@@ -1299,7 +1299,7 @@ void MysqlDataset::fill_fields() {
       const unsigned int ncols = row->size();
       fields_object->resize(ncols);
       for (unsigned int i = 0; i < ncols; i++)
-        (*fields_object)[i].val = row->at(i);
+        row->at(i).get((*fields_object)[i].val);
       return;
     }
   }
@@ -1368,7 +1368,7 @@ int MysqlDataset::exec(const string &sql) {
     qry += " CHARACTER SET utf8 COLLATE utf8_general_ci";
   }
 
-  CLog::Log(LOGDEBUG,"Mysql execute: %s", qry.c_str());
+  CLog::Log(LOGDEBUG | LOGDATABASE, "Mysql execute: %s", qry.c_str());
 
   if (db->setErr( static_cast<MysqlDatabase *>(db)->query_with_reconnect(qry.c_str()), qry.c_str()) != MYSQL_OK)
   {
@@ -1376,6 +1376,10 @@ int MysqlDataset::exec(const string &sql) {
   }
   else
   {
+    // only count statements that changed rows, (my_ulonglong)-1 is returned for errors
+    my_ulonglong rows = mysql_affected_rows(static_cast<MysqlDatabase *>(db)->getHandle());
+    if (rows != 0 && rows != (my_ulonglong)-1)
+      db->changed();
     // TODO: collect results and store in exec_res
     return res;
   }
@@ -1417,13 +1421,13 @@ bool MysqlDataset::query(const char *query) {
     result.record_header[i].name = fields[i].name;
 
   // returned rows
+  query_data &rows = result.records;
   while ((row = mysql_fetch_row(stmt)))
   { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
+    unsigned long *lengths = mysql_fetch_lengths(stmt);
+    rows.add_row(numColumns);
     for (unsigned int i = 0; i < numColumns; i++)
     {
-      field_value &v = res->at(i);
       switch (fields[i].type)
       {
         case MYSQL_TYPE_LONGLONG:
@@ -1435,44 +1439,42 @@ bool MysqlDataset::query(const char *query) {
         case MYSQL_TYPE_LONG:
           if (row[i] != NULL)
           {
-            v.set_asInt(atoi(row[i]));
+            rows.set_int(i, atoi(row[i]));
           }
           else
           {
-            v.set_asInt(0);
+            rows.set_int(i, 0);
           }
           break;
         case MYSQL_TYPE_FLOAT:
         case MYSQL_TYPE_DOUBLE:
           if (row[i] != NULL)
           {
-            v.set_asDouble(atof(row[i]));
+            rows.set_double(i, atof(row[i]));
           }
           else
           {
-            v.set_asDouble(0);
+            rows.set_double(i, 0);
           }
           break;
         case MYSQL_TYPE_STRING:
         case MYSQL_TYPE_VAR_STRING:
         case MYSQL_TYPE_VARCHAR:
-          if (row[i] != NULL) v.set_asString((const char *)row[i] );
+          if (row[i] != NULL) rows.set_string(i, (const char *)row[i], lengths[i]);
           break;
         case MYSQL_TYPE_TINY_BLOB:
         case MYSQL_TYPE_MEDIUM_BLOB:
         case MYSQL_TYPE_LONG_BLOB:
         case MYSQL_TYPE_BLOB:
-          if (row[i] != NULL) v.set_asString((const char *)row[i]);
+          if (row[i] != NULL) rows.set_string(i, (const char *)row[i]);
           break;
         case MYSQL_TYPE_NULL:
         default:
-          CLog::Log(LOGDEBUG,"MYSQL: Unknown field type: %u", fields[i].type);
-          v.set_asString("");
-          v.set_isNull();
+          CLog::Log(LOGDEBUG | LOGDATABASE, "MYSQL: Unknown field type: %u", fields[i].type);
+          rows.set_null(i);
           break;
       }
     }
-    result.records.push_back(res);
   }
   mysql_free_result(stmt);
   active = true;
@@ -1560,15 +1562,7 @@ void MysqlDataset::next(void) {
 
 void MysqlDataset::free_row(void)
 {
-  if (frecno < 0 || (unsigned int)frecno >= result.records.size())
-    return;
-
-  sql_record *row = result.records[frecno];
-  if (row)
-  {
-    delete row;
-    result.records[frecno] = NULL;
-  }
+  // rows are stored together in the result set and released with it
 }
 
 bool MysqlDataset::seek(int pos) {
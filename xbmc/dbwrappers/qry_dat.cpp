@@ -35,6 +35,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdexcept>
 
 #ifndef __GNUC__
 #pragma warning (disable:4800)
@@ -115,7 +117,7 @@ field_value::field_value(const int64_t i) {
 field_value::field_value (const field_value & fv) {
   switch (fv.get_fType()) {
     case ft_String: {
-      set_asString(fv.get_asString());
+      set_asString(fv.str_value);
       break;
     }
     case ft_Boolean:{
@@ -594,7 +596,7 @@ field_value& field_value::operator= (const field_value & fv) {
 
   switch (fv.get_fType()) {
     case ft_String: {
-      set_asString(fv.get_asString());
+      set_asString(fv.str_value);
       return *this;
       break;
     }
@@ -655,6 +657,10 @@ void field_value::set_asString(const char *s) {
   str_value = s;
   field_type = ft_String;}
 
+void field_value::set_asString(const char *s, size_t len) {
+  str_value.assign(s, len);
+  field_type = ft_String;}
+
 void field_value::set_asString(const string & s) {
   str_value = s;
   field_type = ft_String;}
@@ -744,4 +750,235 @@ string field_value::gft() {
   return tmp;
   }
 
+
+//************* sql_field implementation ***************
+
+field_value sql_field::number() const {
+  switch (cell->type) {
+    case ft_Int:
+      return field_value(cell->int_value);
+    case ft_Int64:
+      return field_value(cell->int64_value);
+    case ft_Double:
+      return field_value(cell->double_value);
+    default:
+      return field_value();
+  }
+}
+
+string sql_field::get_asString() const {
+  if (cell->type == ft_String)
+    return string(cell->str_value, cell->str_len);
+  return number().get_asString();
+}
+
+bool sql_field::get_asBool() const {
+  if (cell->type == ft_String)
+    return strcmp(cell->str_value, "True") == 0 || strcmp(cell->str_value, "true") == 0 || strcmp(cell->str_value, "1") == 0;
+  return number().get_asBool();
+}
+
+char sql_field::get_asChar() const {
+  if (cell->type == ft_String)
+    return cell->str_value[0];
+  return number().get_asChar();
+}
+
+short sql_field::get_asShort() const {
+  if (cell->type == ft_String)
+    return (short)atoi(cell->str_value);
+  return number().get_asShort();
+}
+
+unsigned short sql_field::get_asUShort() const {
+  if (cell->type == ft_String)
+    return (unsigned short)atoi(cell->str_value);
+  return number().get_asUShort();
+}
+
+int sql_field::get_asInt() const {
+  if (cell->type == ft_String)
+    return (int)atoi(cell->str_value);
+  return number().get_asInt();
+}
+
+unsigned int sql_field::get_asUInt() const {
+  if (cell->type == ft_String)
+    return (unsigned int)atoi(cell->str_value);
+  return number().get_asUInt();
+}
+
+float sql_field::get_asFloat() const {
+  if (cell->type == ft_String)
+    return (float)atof(cell->str_value);
+  return number().get_asFloat();
+}
+
+double sql_field::get_asDouble() const {
+  if (cell->type == ft_String)
+    return atof(cell->str_value);
+  return number().get_asDouble();
+}
+
+int64_t sql_field::get_asInt64() const {
+  if (cell->type == ft_String)
+    return _atoi64(cell->str_value);
+  return number().get_asInt64();
+}
+
+void sql_field::get(field_value &v) const {
+  switch (cell->type) {
+    case ft_Int:
+      v.set_asInt(cell->int_value);
+      break;
+    case ft_Int64:
+      v.set_asInt64(cell->int64_value);
+      break;
+    case ft_Double:
+      v.set_asDouble(cell->double_value);
+      break;
+    default:
+      v.set_asString(cell->str_value, cell->str_len);
+      break;
+  }
+  v.set_isNull(cell->is_null);
+}
+
+sql_field::operator field_value() const {
+  field_value v;
+  get(v);
+  return v;
+}
+
+
+//************* sql_record implementation ***************
+
+const sql_field sql_record::at(unsigned int col) const {
+  if (col >= count)
+    throw std::out_of_range("sql_record::at");
+  return sql_field(&data->cells[first + col]);
+}
+
+const sql_field sql_record::operator[](unsigned int col) const {
+  return sql_field(&data->cells[first + col]);
+}
+
+
+//************* query_data implementation ***************
+
+// strings are packed into blocks of this size, longer ones get their own
+#define ARENA_BLOCK_SIZE (64 * 1024)
+
+query_data::query_data() {
+  block_next = NULL;
+  block_free = 0;
+  arena_size = 0;
+}
+
+query_data::~query_data() {
+  clear();
+}
+
+void query_data::clear() {
+  for (unsigned int i = 0; i < blocks.size(); i++)
+    delete[] blocks[i];
+
+  // give the memory back, a dataset may sit idle for a long time after a big query
+  std::vector<char*>().swap(blocks);
+  std::vector<sql_record>().swap(rows);
+  std::vector<sql_cell>().swap(cells);
+  block_next = NULL;
+  block_free = 0;
+  arena_size = 0;
+}
+
+void query_data::add_row(unsigned int ncols) {
+  sql_cell empty;
+  empty.str_value = "";
+  empty.str_len = 0;
+  empty.type = ft_String;
+  empty.is_null = false;
+
+  rows.push_back(sql_record(this, cells.size(), ncols));
+  cells.insert(cells.end(), ncols, empty);
+}
+
+sql_cell &query_data::last_cell(unsigned int col) {
+  return cells[rows.back().first + col];
+}
+
+const char *query_data::store(const char *s, unsigned int len) {
+  if (len == 0)
+    return "";
+
+  char *dest;
+  if (len + 1 > ARENA_BLOCK_SIZE / 4)
+  {
+    // big strings get a block of their own, the current one stays open
+    dest = new char[len + 1];
+    blocks.push_back(dest);
+    arena_size += len + 1;
+  }
+  else
+  {
+    if (len + 1 > block_free)
+    {
+      block_next = new char[ARENA_BLOCK_SIZE];
+      blocks.push_back(block_next);
+      block_free = ARENA_BLOCK_SIZE;
+      arena_size += ARENA_BLOCK_SIZE;
+    }
+    dest = block_next;
+    block_next += len + 1;
+    block_free -= len + 1;
+  }
+
+  memcpy(dest, s, len);
+  dest[len] = '\0';
+  return dest;
+}
+
+void query_data::set_null(unsigned int col) {
+  sql_cell &c = last_cell(col);
+  c.str_value = "";
+  c.str_len = 0;
+  c.type = ft_String;
+  c.is_null = true;
+}
+
+void query_data::set_string(unsigned int col, const char *s) {
+  set_string(col, s, strlen(s));
+}
+
+void query_data::set_string(unsigned int col, const char *s, unsigned int len) {
+  sql_cell &c = last_cell(col);
+  c.str_value = store(s, len);
+  c.str_len = len;
+  c.type = ft_String;
+}
+
+void query_data::set_int(unsigned int col, int i) {
+  sql_cell &c = last_cell(col);
+  c.int_value = i;
+  c.type = ft_Int;
+}
+
+void query_data::set_int64(unsigned int col, int64_t i) {
+  sql_cell &c = last_cell(col);
+  c.int64_value = i;
+  c.type = ft_Int64;
+}
+
+void query_data::set_double(unsigned int col, double d) {
+  sql_cell &c = last_cell(col);
+  c.double_value = d;
+  c.type = ft_Double;
+}
+
+size_t query_data::memory_used() const {
+  return rows.capacity() * sizeof(sql_record) +
+         cells.capacity() * sizeof(sql_cell) +
+         arena_size;
+}
+
 } //namespace 
@@ -175,8 +175,9 @@ public:
   }
   }
 
-  void set_isNull(){is_null=true;}
+  void set_isNull(bool null = true){is_null=null;}
   void set_asString(const char *s);
+  void set_asString(const char *s, size_t len);
   void set_asString(const std::string & s);
   void set_asBool(const bool b);
   void set_asChar(const char c);
@@ -209,15 +210,118 @@ struct field {
 
 
 typedef std::vector<field> Fields;
-typedef std::vector<field_value> sql_record;
 typedef std::vector<field_prop> record_prop;
-typedef std::vector<sql_record*> query_data;
 typedef field_value variant;
 
 //typedef Fields::iterator fld_itor;
-typedef sql_record::iterator rec_itor;
 typedef record_prop::iterator recprop_itor;
-typedef query_data::iterator qry_itor;
+
+class query_data;
+
+/* one field of a stored row: typed value, strings point into the
+   string arena of the owning query_data */
+struct sql_cell {
+  union {
+    int     int_value;
+    int64_t int64_value;
+    double  double_value;
+    const char *str_value;
+  };
+  unsigned int str_len;
+  unsigned char type;		// fType of the value
+  bool is_null;
+};
+
+/* one field of a stored row, read in place with the same conversions
+   as field_value; strings are only copied out when asked for */
+class sql_field {
+public:
+  fType get_fType() const { return (fType)cell->type; }
+  bool get_isNull() const { return cell->is_null; }
+  std::string get_asString() const;
+  bool get_asBool() const;
+  char get_asChar() const;
+  short get_asShort() const;
+  unsigned short get_asUShort() const;
+  int get_asInt() const;
+  unsigned int get_asUInt() const;
+  float get_asFloat() const;
+  double get_asDouble() const;
+  int64_t get_asInt64() const;
+
+/* copies the value into v, reusing its string buffer */
+  void get(field_value &v) const;
+  operator field_value() const;
+
+private:
+  friend class sql_record;
+  explicit sql_field(const sql_cell *newCell) : cell(newCell) {}
+/* a non-string value as field_value, for its conversions */
+  field_value number() const;
+
+  const sql_cell *cell;
+};
+
+/* read-only view of one row in a query_data */
+class sql_record {
+public:
+  unsigned int size() const { return count; }
+  bool empty() const { return count == 0; }
+/* throws std::out_of_range like the vector this used to be */
+  const sql_field at(unsigned int col) const;
+  const sql_field operator[](unsigned int col) const;
+
+private:
+  friend class query_data;
+  sql_record(const query_data *newData, unsigned int newFirst, unsigned int newCount)
+    : data(newData), first(newFirst), count(newCount) {}
+
+  const query_data *data;
+  unsigned int first;		// index of the first cell of the row
+  unsigned int count;
+};
+
+/* all rows of a result in one contiguous cell array, string values
+   copied into a few large blocks instead of one allocation each */
+class query_data {
+public:
+  query_data();
+  ~query_data();
+
+  unsigned int size() const { return rows.size(); }
+  bool empty() const { return rows.empty(); }
+  const sql_record *operator[](unsigned int row) const { return &rows[row]; }
+  const sql_record *at(unsigned int row) const { return &rows.at(row); }
+  void clear();
+
+/* appends a row of ncols empty strings, the set_* functions then fill in
+   the fields of this last row */
+  void add_row(unsigned int ncols);
+  void set_null(unsigned int col);
+  void set_string(unsigned int col, const char *s);
+  void set_string(unsigned int col, const char *s, unsigned int len);
+  void set_int(unsigned int col, int i);
+  void set_int64(unsigned int col, int64_t i);
+  void set_double(unsigned int col, double d);
+
+/* memory held by the stored rows, for diagnostics */
+  size_t memory_used() const;
+
+private:
+  friend class sql_record;
+  query_data(const query_data &);
+  query_data &operator=(const query_data &);
+
+  sql_cell &last_cell(unsigned int col);
+  const char *store(const char *s, unsigned int len);
+
+  std::vector<sql_record> rows;
+  std::vector<sql_cell> cells;
+  std::vector<char*> blocks;	// string arena
+  char *block_next;		// next free byte in the current block
+  size_t block_free;		// bytes left in the current block
+  size_t arena_size;
+};
 
 class result_set
 {
@@ -231,9 +335,6 @@ public:
   };
   void clear()
   {
-    for (unsigned int i = 0; i < records.size(); i++)
-      if (records[i])
-        delete records[i];
     records.clear();
     record_header.clear();
   };
@@ -59,22 +59,14 @@ int callback(void* res_ptr,int ncol, char** reslt,char** cols)
 
   if (reslt != NULL)
   {
-    sql_record *rec = new sql_record;
-    rec->resize(ncol);
+    r->records.add_row(ncol);
     for (int i=0; i<ncol; i++)
     { 
-      field_value &v = rec->at(i);
       if (reslt[i] == NULL)
-      {
-        v.set_asString("");
-        v.set_isNull();
-      }
+        r->records.set_null(i);
       else
-      {
-        v.set_asString(reslt[i]);
-      }
+        r->records.set_string(i, reslt[i]);
     }
-    r->records.push_back(rec);
   }
   return 0;  
 }
@@ -405,6 +397,123 @@ string SqliteDatabase::vprepare(const char *format, va_list args)
 }
 
 
+Statement *SqliteDatabase::prepareStatement(const char *sql)
+{
+  if (!active) throw DbErrors("No Database Connection");
+  return new SqliteStatement(this, sql);
+}
+
+
+//************* SqliteStatement implementation ***************
+
+SqliteStatement::SqliteStatement(SqliteDatabase *newDb, const char *newSql)
+  : db(newDb), stmt(NULL), sql(newSql), done(false)
+{
+  if (db->setErr(sqlite3_prepare_v2(db->getHandle(), newSql, -1, &stmt, NULL), newSql) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+}
+
+SqliteStatement::~SqliteStatement()
+{
+  sqlite3_finalize(stmt);
+}
+
+void SqliteStatement::check(int rc)
+{
+  if (rc != SQLITE_OK)
+  {
+    db->setErr(rc, sql.c_str());
+    throw DbErrors(db->getErrorMsg());
+  }
+}
+
+void SqliteStatement::bind(int n, int value)
+{
+  check(sqlite3_bind_int(stmt, n, value));
+}
+
+void SqliteStatement::bind(int n, int64_t value)
+{
+  check(sqlite3_bind_int64(stmt, n, value));
+}
+
+void SqliteStatement::bind(int n, double value)
+{
+  check(sqlite3_bind_double(stmt, n, value));
+}
+
+void SqliteStatement::bind(int n, const string &value)
+{
+  check(sqlite3_bind_text(stmt, n, value.c_str(), value.size(), SQLITE_TRANSIENT));
+}
+
+void SqliteStatement::bindNull(int n)
+{
+  check(sqlite3_bind_null(stmt, n));
+}
+
+bool SqliteStatement::step()
+{
+  if (done)
+    return false;
+
+  int changes = sqlite3_total_changes(db->getHandle());
+  int rc = sqlite3_step(stmt);
+  if (rc == SQLITE_ROW)
+    return true;
+
+  done = true;
+  if (rc != SQLITE_DONE)
+  {
+    // the real error code is only returned by reset for legacy statements
+    sqlite3_reset(stmt);
+    check(rc);
+  }
+  if (sqlite3_total_changes(db->getHandle()) != changes)
+    db->changed();
+  return false;
+}
+
+void SqliteStatement::reset()
+{
+  // errors of the last execution were already reported by step()
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  done = false;
+}
+
+int SqliteStatement::columnCount()
+{
+  return sqlite3_data_count(stmt);
+}
+
+bool SqliteStatement::isNull(int col)
+{
+  return sqlite3_column_type(stmt, col) == SQLITE_NULL;
+}
+
+int SqliteStatement::getInt(int col)
+{
+  return sqlite3_column_int(stmt, col);
+}
+
+int64_t SqliteStatement::getInt64(int col)
+{
+  return sqlite3_column_int64(stmt, col);
+}
+
+double SqliteStatement::getDouble(int col)
+{
+  return sqlite3_column_double(stmt, col);
+}
+
+string SqliteStatement::getString(int col)
+{
+  const char *text = (const char *)sqlite3_column_text(stmt, col);
+  return text ? string(text, sqlite3_column_bytes(stmt, col)) : string();
+}
+
+
 //************* SqliteDataset implementation ***************
 
 SqliteDataset::SqliteDataset():Dataset() {
@@ -514,7 +623,7 @@ void SqliteDataset::fill_fields() {
       const unsigned int ncols = row->size();
       fields_object->resize(ncols);
       for (unsigned int i = 0; i < ncols; i++)
-        (*fields_object)[i].val = row->at(i);
+        row->at(i).get((*fields_object)[i].val);
       return;
     }
   }
@@ -580,8 +689,14 @@ int SqliteDataset::exec(const string &sql) {
       qry = qry.substr(0, pos);
   }
 
+  // only count statements that changed rows, the pragmas run on every connect don't
+  int changes = sqlite3_total_changes(handle());
   if((res = db->setErr(sqlite3_exec(handle(),qry.c_str(),&callback,&exec_res,&errmsg),qry.c_str())) == SQLITE_OK)
+  {
+    if (sqlite3_total_changes(handle()) != changes)
+      db->changed();
     return res;
+  }
   else
     {
       throw DbErrors(db->getErrorMsg());
@@ -618,35 +733,40 @@ bool SqliteDataset::query(const char *query) {
     result.record_header[i].name = sqlite3_column_name(stmt, i);
 
   // returned rows
+  query_data &rows = result.records;
   while (sqlite3_step(stmt) == SQLITE_ROW)
   { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
+    rows.add_row(numColumns);
     for (unsigned int i = 0; i < numColumns; i++)
     {
-      field_value &v = res->at(i);
       switch (sqlite3_column_type(stmt, i))
       {
       case SQLITE_INTEGER:
-        v.set_asInt64(sqlite3_column_int64(stmt, i));
+        rows.set_int64(i, sqlite3_column_int64(stmt, i));
         break;
       case SQLITE_FLOAT:
-        v.set_asDouble(sqlite3_column_double(stmt, i));
+        rows.set_double(i, sqlite3_column_double(stmt, i));
         break;
       case SQLITE_TEXT:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
+        {
+          const char *text = (const char *)sqlite3_column_text(stmt, i);
+          if (text)
+            rows.set_string(i, text, sqlite3_column_bytes(stmt, i));
+        }
         break;
       case SQLITE_BLOB:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
+        {
+          const char *text = (const char *)sqlite3_column_text(stmt, i);
+          if (text)
+            rows.set_string(i, text);
+        }
         break;
       case SQLITE_NULL:
       default:
-        v.set_asString("");
-        v.set_isNull();
+        rows.set_null(i);
         break;
       }
     }
-    result.records.push_back(res);
   }
   if (db->setErr(sqlite3_finalize(stmt),query) == SQLITE_OK)
   {
@@ -738,15 +858,7 @@ void SqliteDataset::next(void) {
 
 void SqliteDataset::free_row(void)
 {
-  if (frecno < 0 || (unsigned int)frecno >= result.records.size())
-    return;
-
-  sql_record *row = result.records[frecno];
-  if (row)
-  {
-    delete row;
-    result.records[frecno] = NULL;
-  }
+  // rows are stored together in the result set and released with it
 }
 
 bool SqliteDataset::seek(int pos) {
@@ -94,6 +94,51 @@ public:
 
   bool in_transaction() {return _in_transaction;}; 	
 
+/* compiles the statement with sqlite3_prepare_v2 */
+  virtual Statement *prepareStatement(const char *sql);
+
+};
+
+
+
+/***************** Class SqliteStatement definition *****************
+
+       class 'SqliteStatement' wraps a native sqlite3_stmt;
+       it must be destroyed before its database is disconnected
+
+******************************************************************/
+
+class SqliteStatement : public Statement {
+protected:
+  SqliteDatabase *db;
+  sqlite3_stmt *stmt;
+  std::string sql;
+  bool done;		// last step returned SQLITE_DONE
+
+/* throws DbErrors if the sqlite result code is an error */
+  void check(int rc);
+
+public:
+  SqliteStatement(SqliteDatabase *newDb, const char *newSql);
+  ~SqliteStatement();
+
+  virtual const std::string &getSql() const { return sql; }
+
+  virtual void bind(int n, int value);
+  virtual void bind(int n, int64_t value);
+  virtual void bind(int n, double value);
+  virtual void bind(int n, const std::string &value);
+  virtual void bindNull(int n);
+
+  virtual bool step();
+  virtual void reset();
+
+  virtual int columnCount();
+  virtual bool isNull(int col);
+  virtual int getInt(int col);
+  virtual int64_t getInt64(int col);
+  virtual double getDouble(int col);
+  virtual std::string getString(int col);
 };
 
 
@@ -0,0 +1,88 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/qry_dat.h"
+
+#include <stdio.h>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+using namespace dbiplus;
+
+TEST(TestQueryData, TypedCells)
+{
+  query_data data;
+  data.add_row(5);
+  data.set_int(0, 42);
+  data.set_int64(1, 1LL << 40);
+  data.set_double(2, 0.5);
+  data.set_string(3, "text");
+  data.set_null(4);
+  data.add_row(2);
+
+  ASSERT_EQ(2U, data.size());
+  const sql_record *row = data[0];
+  ASSERT_EQ(5U, row->size());
+  EXPECT_EQ(ft_Int, row->at(0).get_fType());
+  EXPECT_EQ(42, row->at(0).get_asInt());
+  EXPECT_EQ(ft_Int64, row->at(1).get_fType());
+  EXPECT_EQ(1LL << 40, row->at(1).get_asInt64());
+  EXPECT_EQ(0.5, row->at(2).get_asDouble());
+  EXPECT_EQ("text", row->at(3).get_asString());
+  EXPECT_FALSE(row->at(3).get_isNull());
+  EXPECT_TRUE(row->at(4).get_isNull());
+  EXPECT_EQ("", row->at(4).get_asString());
+  EXPECT_THROW(row->at(5), std::out_of_range);
+
+  // unset fields are empty strings, like a default field_value
+  row = data.at(1);
+  EXPECT_EQ(ft_String, row->at(1).get_fType());
+  EXPECT_EQ("", row->at(1).get_asString());
+  EXPECT_FALSE(row->at(1).get_isNull());
+  EXPECT_THROW(data.at(2), std::out_of_range);
+
+  data.clear();
+  EXPECT_TRUE(data.empty());
+}
+
+TEST(TestQueryData, StringArena)
+{
+  query_data data;
+  std::string big(100000, 'x');
+  for (int i = 0; i < 10000; i++)
+  {
+    char value[32];
+    sprintf(value, "row %d", i);
+    data.add_row(2);
+    data.set_string(0, value);
+    if (i % 1000 == 0)
+      data.set_string(1, big.c_str(), big.size());
+  }
+
+  for (int i = 0; i < 10000; i++)
+  {
+    char value[32];
+    sprintf(value, "row %d", i);
+    EXPECT_EQ(value, data[i]->at(0).get_asString());
+    EXPECT_EQ(i % 1000 ? 0U : big.size(), data[i]->at(1).get_asString().size());
+  }
+  EXPECT_GT(data.memory_used(), 10 * big.size());
+}
@@ -0,0 +1,194 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+using namespace dbiplus;
+
+/* Runs each test against the native sqlite statement and the text
+ * substitution fallback (DatasetStatement) other backends use. */
+class TestStatement : public testing::TestWithParam<bool>
+{
+protected:
+  TestStatement() : m_name("TestStatement.db")
+  {
+    m_host = CSpecialProtocol::TranslatePath("special://temp/");
+    XFILE::CFile::Delete(m_host + m_name);
+  }
+
+  virtual void SetUp()
+  {
+    m_db.setHostName(m_host.c_str());
+    m_db.setDatabase(m_name);
+    ASSERT_EQ(DB_CONNECTION_OK, m_db.connect(true));
+    std::auto_ptr<Dataset> ds(m_db.CreateDataset());
+    ds->exec("CREATE TABLE item ( idItem integer primary key, strName text, fValue double, iBig integer )");
+  }
+
+  virtual void TearDown()
+  {
+    m_db.disconnect();
+    XFILE::CFile::Delete(m_host + m_name);
+  }
+
+  Statement *Prepare(const char *sql)
+  {
+    if (GetParam())
+      return m_db.prepareStatement(sql);
+    return m_db.Database::prepareStatement(sql);
+  }
+
+  void Insert(const std::string &name, double value, int64_t big)
+  {
+    std::auto_ptr<Statement> stmt(Prepare("INSERT INTO item (idItem, strName, fValue, iBig) VALUES (NULL, ?, ?, ?)"));
+    stmt->bind(1, name);
+    stmt->bind(2, value);
+    stmt->bind(3, big);
+    stmt->exec();
+  }
+
+  SqliteDatabase m_db;
+  CStdString m_host;
+  const char *m_name;
+};
+
+TEST_P(TestStatement, BindTypes)
+{
+  Insert("first", 0.25, 1LL << 40);
+  {
+    std::auto_ptr<Statement> stmt(Prepare("INSERT INTO item (idItem, strName, fValue, iBig) VALUES (?, ?, ?, ?)"));
+    stmt->bind(1, 7);
+    stmt->bindNull(2);
+    stmt->bind(3, -1.5);
+    stmt->bind(4, (int64_t)-3);
+    stmt->exec();
+  }
+
+  std::auto_ptr<Statement> stmt(Prepare("SELECT idItem, strName, fValue, iBig FROM item ORDER BY idItem"));
+  ASSERT_TRUE(stmt->step());
+  EXPECT_EQ(4, stmt->columnCount());
+  EXPECT_EQ(1, stmt->getInt(0));
+  EXPECT_EQ("first", stmt->getString(1));
+  EXPECT_FALSE(stmt->isNull(1));
+  EXPECT_EQ(0.25, stmt->getDouble(2));
+  EXPECT_EQ(1LL << 40, stmt->getInt64(3));
+
+  ASSERT_TRUE(stmt->step());
+  EXPECT_EQ(7, stmt->getInt(0));
+  EXPECT_TRUE(stmt->isNull(1));
+  EXPECT_EQ("", stmt->getString(1));
+  EXPECT_EQ(-1.5, stmt->getDouble(2));
+  EXPECT_EQ(-3, stmt->getInt64(3));
+
+  EXPECT_FALSE(stmt->step());
+  EXPECT_FALSE(stmt->step());
+}
+
+TEST_P(TestStatement, Escaping)
+{
+  const char *names[] = { "it's", "''", "100%", "%s %d", "\"quoted\"", "'); DROP TABLE item; --", "?" };
+  const unsigned int count = sizeof(names) / sizeof(names[0]);
+  for (unsigned int i = 0; i < count; i++)
+    Insert(names[i], i, i);
+
+  std::auto_ptr<Statement> stmt(Prepare("SELECT fValue FROM item WHERE strName = ?"));
+  for (unsigned int i = 0; i < count; i++)
+  {
+    stmt->reset();
+    stmt->bind(1, std::string(names[i]));
+    ASSERT_TRUE(stmt->step()) << names[i];
+    EXPECT_EQ((double)i, stmt->getDouble(0)) << names[i];
+    EXPECT_FALSE(stmt->step());
+  }
+
+  stmt.reset(Prepare("SELECT strName FROM item ORDER BY idItem"));
+  for (unsigned int i = 0; i < count; i++)
+  {
+    ASSERT_TRUE(stmt->step());
+    EXPECT_EQ(names[i], stmt->getString(0));
+  }
+}
+
+TEST_P(TestStatement, Placeholders)
+{
+  Insert("?", 1, 1);
+  Insert("a ? b", 2, 2);
+
+  // a '?' in a literal or a quoted identifier is not a parameter
+  std::auto_ptr<Statement> stmt(Prepare("SELECT '?', \"strName\", fValue FROM item WHERE strName != 'x?y' AND iBig = ?"));
+  stmt->bind(1, 2);
+  ASSERT_TRUE(stmt->step());
+  EXPECT_EQ("?", stmt->getString(0));
+  EXPECT_EQ("a ? b", stmt->getString(1));
+  EXPECT_EQ(2.0, stmt->getDouble(2));
+  EXPECT_FALSE(stmt->step());
+
+  EXPECT_THROW(stmt->bind(0, 1), DbErrors);
+  EXPECT_THROW(stmt->bind(2, 1), DbErrors);
+
+  stmt.reset(Prepare("SELECT count(*) FROM item WHERE strName IN ('?', ?) OR fValue = ?"));
+  stmt->bind(1, std::string("a ? b"));
+  stmt->bind(2, 3.0);
+  ASSERT_TRUE(stmt->step());
+  EXPECT_EQ(2, stmt->getInt(0));
+}
+
+TEST_P(TestStatement, Reset)
+{
+  Insert("first", 1, 1);
+  Insert("second", 2, 2);
+
+  std::auto_ptr<Statement> stmt(Prepare("SELECT strName FROM item WHERE iBig >= ? ORDER BY idItem"));
+  stmt->bind(1, 1);
+  ASSERT_TRUE(stmt->step());
+  EXPECT_EQ("first", stmt->getString(0));
+
+  // reset starts over and clears the bindings, NULL matches nothing
+  stmt->reset();
+  EXPECT_FALSE(stmt->step());
+
+  stmt->reset();
+  stmt->bind(1, 2);
+  ASSERT_TRUE(stmt->step());
+  EXPECT_EQ("second", stmt->getString(0));
+
+  // the guard resets a statement left half way through, as by an exception
+  stmt->reset();
+  stmt->bind(1, 1);
+  try
+  {
+    StatementReset resetStmt(stmt.get());
+    ASSERT_TRUE(stmt->step());
+    throw DbErrors("abort");
+  }
+  catch (DbErrors&) { }
+  stmt->bind(1, 1);
+  ASSERT_TRUE(stmt->step());
+  EXPECT_EQ("first", stmt->getString(0));
+}
+
+INSTANTIATE_TEST_CASE_P(Native, TestStatement, testing::Values(true));
+INSTANTIATE_TEST_CASE_P(Fallback, TestStatement, testing::Values(false));
@@ -22,6 +22,7 @@
 #ifndef XFILECACHESTRATEGY_H
 #define XFILECACHESTRATEGY_H
 
+#include <stddef.h>
 #include <stdint.h>
 #ifdef _LINUX
 #include "PlatformDefs.h"
@@ -30,6 +31,7 @@
 #endif
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
+#include "IFileTypes.h"
 
 namespace XFILE {
 
@@ -53,6 +55,40 @@ public:
   virtual int64_t Seek(int64_t iFilePosition) = 0;
   virtual void Reset(int64_t iSourcePosition) = 0;
 
+  /**
+   * Zero copy access for strategies that keep their data in memory.
+   * GetWriteBlock hands out the largest contiguous free block, the data is
+   * made visible to the reader by CommitWrite. Every block handed out must
+   * be committed, with a size of 0 if nothing was written to it, so it is
+   * handed back. GetReadBlock hands out a
+   * read-only view of the largest contiguous block of cached data, which
+   * stays valid until CommitRead. Both return the block size, or the same
+   * codes as ReadFromCache/WriteToCache. The default implementation returns
+   * CACHE_RC_ERROR meaning not supported.
+   */
+  virtual int GetWriteBlock(char *&pBuffer) { pBuffer = NULL; return CACHE_RC_ERROR; }
+  virtual void CommitWrite(size_t iSize) {}
+  virtual int GetReadBlock(const char *&pBuffer) { pBuffer = NULL; return CACHE_RC_ERROR; }
+  virtual void CommitRead(size_t iSize) {}
+
+  /**
+   * Strategies that keep several cached ranges may want the source to
+   * continue somewhere else than where the writer currently is, for
+   * instance at the end of a range the reader seeked back into.
+   * GetRefillPosition returns that position, or -1 to carry on as is.
+   * RefillFrom tells the strategy the next write starts at that position.
+   * CanRefill returns true if GetRefillPosition can ever return a position,
+   * only then does the writer have to poll for one after the end of input.
+   */
+  virtual bool CanRefill() { return false; }
+  virtual int64_t GetRefillPosition() { return -1; }
+  virtual void RefillFrom(int64_t iSourcePosition) {}
+
+  /**
+   * Fill in per range statistics, returns false if not supported.
+   */
+  virtual bool GetRangeStatus(SCacheRangeStatus &status) { return false; }
+
   virtual void EndOfInput(); // mark the end of the input stream so that Read will know when to return EOF
   virtual bool IsEndOfInput();
   virtual void ClearEndOfInput();
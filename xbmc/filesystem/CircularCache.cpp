@@ -22,21 +22,34 @@
 #include "system.h"
 #include "utils/log.h"
 #include "threads/SingleLock.h"
+#include "threads/Atomics.h"
 #include "utils/TimeUtils.h"
 #include "CircularCache.h"
+#include "SpecialProtocol.h"
+#include "Util.h"
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 using namespace XFILE;
 
-CCircularCache::CCircularCache(size_t front, size_t back)
+CCircularCache::CCircularCache(size_t front, size_t back, bool fileBacked)
  : CCacheStrategy()
  , m_beg(0)
  , m_end(0)
  , m_cur(0)
+ , m_reserved(0)
+ , m_endPos(0)
+ , m_curPos(0)
  , m_buf(NULL)
  , m_size(front + back)
  , m_size_back(back)
+ , m_fileBacked(fileBacked)
 #ifdef _WIN32
  , m_handle(INVALID_HANDLE_VALUE)
+ , m_file(INVALID_HANDLE_VALUE)
 #endif
 {
 }
@@ -48,19 +61,45 @@ CCircularCache::~CCircularCache()
 
 int CCircularCache::Open()
 {
+  CStdString path;
+  if(m_fileBacked)
+    path = CSpecialProtocol::TranslatePath(CUtil::GetNextFilename("special://temp/filecache%03d.mmap", 999));
+
 #ifdef _WIN32
-  m_handle = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, m_size, NULL);
+  if(m_fileBacked && !path.IsEmpty())
+  {
+    m_file = CreateFile(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS
+                      , FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+    if(m_file == INVALID_HANDLE_VALUE)
+      CLog::Log(LOGWARNING, "CCircularCache::Open - unable to create %s, using memory", path.c_str());
+  }
+  m_handle = CreateFileMapping(m_file, NULL, PAGE_READWRITE, 0, m_size, NULL);
   if(m_handle == NULL)
     return CACHE_RC_ERROR;
   m_buf = (uint8_t*)MapViewOfFile(m_handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
 #else
-  m_buf = new uint8_t[m_size];
+  void *buf = MAP_FAILED;
+  if(m_fileBacked && !path.IsEmpty())
+  {
+    // the file is unlinked right away, the mapping keeps it alive until Close()
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if(fd >= 0)
+    {
+      unlink(path.c_str());
+      if(ftruncate(fd, m_size) == 0)
+        buf = mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      close(fd);
+    }
+    if(buf == MAP_FAILED)
+      CLog::Log(LOGWARNING, "CCircularCache::Open - unable to map %s, using memory", path.c_str());
+  }
+  if(buf == MAP_FAILED)
+    buf = mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  m_buf = buf == MAP_FAILED ? NULL : (uint8_t*)buf;
 #endif
   if(m_buf == 0)
     return CACHE_RC_ERROR;
-  m_beg = 0;
-  m_end = 0;
-  m_cur = 0;
+  Reset(0);
   return CACHE_RC_OK;
 }
 
@@ -70,16 +109,33 @@ void CCircularCache::Close()
   UnmapViewOfFile(m_buf);
   CloseHandle(m_handle);
   m_handle = INVALID_HANDLE_VALUE;
+  if(m_file != INVALID_HANDLE_VALUE)
+    CloseHandle(m_file);
+  m_file = INVALID_HANDLE_VALUE;
 #else
-  delete[] m_buf;
+  if(m_buf)
+    munmap(m_buf, m_size);
 #endif
   m_buf = NULL;
 }
 
 /**
- * Function will write to m_buf at m_end % m_size location
- * it will write at maximum m_size, but it will only write
- * as much it can without wrapping around in the buffer
+ * Space that can be written in front of m_end without
+ * touching unread data or the guaranteed back buffer.
+ * Only to be called from the writing thread.
+ */
+size_t CCircularCache::GetWriteLimit() const
+{
+  uint64_t cur   = m_end - (uint32_t)((uint32_t)m_end - m_curPos);
+  size_t   back  = (size_t)(cur - m_beg);
+  size_t   front = (size_t)(m_end - cur);
+
+  return m_size - std::min(back, m_size_back) - front;
+}
+
+/**
+ * Hands out the writable region at m_end % m_size. It is
+ * at most m_size long, and will not wrap around in the buffer.
  *
  * It will always leave m_size_back of the backbuffer intact
  * but if the back buffer is less than that, that space is
@@ -87,89 +143,136 @@ void CCircularCache::Close()
  *
  * If back buffer is filled to an larger extent than
  * m_size_back, it will allow it to be overwritten
- * until only m_size_back data remains.
+ * until only m_size_back data remains. Seek() is kept out
+ * of that history while the block is handed out, so it can
+ * not land in data that is being overwritten. The history
+ * is only dropped by CommitWrite() once data was written.
  *
  * The following always apply:
- *  * m_end <= m_cur <= m_end
+ *  * m_beg <= m_cur <= m_end
  *  * m_end - m_beg <= m_size
- *
- * Multiple calls may be needed to fill buffer completely.
  */
-int CCircularCache::WriteToCache(const char *buf, size_t len)
+int CCircularCache::GetWriteBlock(char *&buf)
 {
-  CSingleLock lock(m_sync);
+  size_t pos  = (size_t)(m_end % m_size);
+  size_t wrap = m_size - pos;
+  size_t len  = std::min(GetWriteLimit(), wrap);
 
-  // where are we in the buffer
-  size_t pos   = m_end % m_size;
-  size_t back  = (size_t)(m_cur - m_beg);
-  size_t front = (size_t)(m_end - m_cur);
-
-  size_t limit = m_size - std::min(back, m_size_back) - front;
-  size_t wrap  = m_size - pos;
+  if(len == 0)
+    return 0;
 
-  // limit by max forward size
-  if(len > limit)
-    len = limit;
+  if(m_end + len - m_beg > m_size)
+  {
+    // reader may have seeked back since, redo the math where it can't
+    CSingleLock lock(m_sync);
+    len = std::min(GetWriteLimit(), wrap);
+    m_reserved = std::max(m_beg, m_end + len - m_size);
+  }
 
-  // limit to wrap point
-  if(len > wrap)
-    len = wrap;
+  // don't let writes to the block move ahead of the position check
+  AtomicMemoryBarrier();
 
-  if(len == 0)
-    return 0;
+  buf = (char*)m_buf + pos;
+  return len;
+}
 
-  // write the data
-  memcpy(m_buf + pos, buf, len);
-  m_end += len;
+void CCircularCache::CommitWrite(size_t len)
+{
+  if(m_reserved > m_beg)
+  {
+    // drop the history that was written over, and hand back the rest
+    CSingleLock lock(m_sync);
+    if(m_end + len - m_beg > m_size)
+      m_beg = m_end + len - m_size;
+    m_reserved = m_beg;
+  }
 
-  // drop history that was overwritten
-  if(m_end - m_beg > m_size)
-    m_beg = m_end - m_size;
+  // data must be visible before the reader sees the new end
+  AtomicMemoryBarrier();
+  m_end   += len;
+  m_endPos = (uint32_t)m_end;
 
   m_written.Set();
-
-  return len;
 }
 
 /**
- * Reads data from cache. Will only read up till
- * the buffer wrap point. So multiple calls
- * may be needed to empty the whole cache
+ * Hands out the readable region at m_cur % m_size. Will
+ * only go up till the buffer wrap point, so multiple calls
+ * may be needed to empty the whole cache.
  */
-int CCircularCache::ReadFromCache(char *buf, size_t len)
+int CCircularCache::GetReadBlock(const char *&buf)
 {
-  CSingleLock lock(m_sync);
+  size_t   pos   = (size_t)(m_cur % m_size);
+  uint32_t front = m_endPos - (uint32_t)m_cur;
 
-  size_t pos   = m_cur % m_size;
-  size_t front = (size_t)(m_end - m_cur);
-  size_t avail = std::min(m_size - pos, front);
-
-  if(avail == 0)
+  if(front == 0)
   {
-    if(IsEndOfInput())
-      return 0;
-    else
+    if(!IsEndOfInput())
       return CACHE_RC_WOULD_BLOCK;
+
+    // the last block may have been committed right before end of input was flagged
+    AtomicMemoryBarrier();
+    front = m_endPos - (uint32_t)m_cur;
+    if(front == 0)
+      return 0;
   }
 
-  if(len > avail)
+  AtomicMemoryBarrier();
+
+  buf = (const char*)m_buf + pos;
+  return std::min(m_size - pos, (size_t)front);
+}
+
+void CCircularCache::CommitRead(size_t len)
+{
+  // done with the data before the writer may reuse the space
+  AtomicMemoryBarrier();
+  m_cur   += len;
+  m_curPos = (uint32_t)m_cur;
+
+  m_space.Set();
+}
+
+int CCircularCache::WriteToCache(const char *buf, size_t len)
+{
+  char *block;
+  int   avail = GetWriteBlock(block);
+  if(avail <= 0)
+    return avail;
+
+  if(len > (size_t)avail)
+    len = avail;
+
+  memcpy(block, buf, len);
+  CommitWrite(len);
+
+  return len;
+}
+
+int CCircularCache::ReadFromCache(char *buf, size_t len)
+{
+  const char *block;
+  int         avail = GetReadBlock(block);
+  if(avail <= 0)
+    return avail;
+
+  if(len > (size_t)avail)
     len = avail;
 
   if(len == 0)
     return 0;
 
-  memcpy(buf, m_buf + pos, len);
-  m_cur += len;
-
-  m_space.Set();
+  memcpy(buf, block, len);
+  CommitRead(len);
 
   return len;
 }
 
 int64_t CCircularCache::WaitForData(unsigned int minumum, unsigned int millis)
 {
-  CSingleLock lock(m_sync);
-  uint64_t avail = m_end - m_cur;
+  // read the reader position first, so avail can only be under estimated
+  uint32_t cur   = m_curPos;
+  uint64_t avail = (uint32_t)(m_endPos - cur);
 
   if(millis == 0 || IsEndOfInput())
     return avail;
@@ -180,10 +283,9 @@ int64_t CCircularCache::WaitForData(unsigned int minumum, unsigned int millis)
   XbmcThreads::EndTime endtime(millis);
   while (!IsEndOfInput() && avail < minumum && !endtime.IsTimePast() )
   {
-    lock.Leave();
     m_written.WaitMSec(50); // may miss the deadline. shouldn't be a problem.
-    lock.Enter();
-    avail = m_end - m_cur;
+    cur   = m_curPos;
+    avail = (uint32_t)(m_endPos - cur);
   }
 
   return avail;
@@ -193,29 +295,41 @@ int64_t CCircularCache::Seek(int64_t pos)
 {
   CSingleLock lock(m_sync);
 
+  uint64_t end = m_cur + (uint32_t)(m_endPos - (uint32_t)m_cur);
+
   // if seek is a bit over what we have, try to wait a few seconds for the data to be available.
   // we try to avoid a (heavy) seek on the source
-  if ((uint64_t)pos >= m_end && (uint64_t)pos < m_end + 100000)
+  if ((uint64_t)pos >= end && (uint64_t)pos < end + 100000)
   {
     lock.Leave();
     WaitForData((size_t)(pos - m_cur), 5000);
     lock.Enter();
+    end = m_cur + (uint32_t)(m_endPos - (uint32_t)m_cur);
   }
 
-  if((uint64_t)pos >= m_beg && (uint64_t)pos <= m_end)
+  if((uint64_t)pos >= m_reserved && (uint64_t)pos <= end)
   {
-    m_cur = pos;
+    m_cur    = pos;
+    m_curPos = (uint32_t)m_cur;
+    m_space.Set();
     return pos;
   }
 
   return CACHE_RC_ERROR;
 }
 
+/**
+ * Called by the writing thread while the reader is
+ * waiting for the seek to finish.
+ */
 void CCircularCache::Reset(int64_t pos)
 {
   CSingleLock lock(m_sync);
-  m_end = pos;
-  m_beg = pos;
-  m_cur = pos;
+  m_end    = pos;
+  m_beg    = pos;
+  m_cur    = pos;
+  m_reserved = pos;
+  m_endPos = (uint32_t)pos;
+  m_curPos = (uint32_t)pos;
+  AtomicMemoryBarrier();
 }
-
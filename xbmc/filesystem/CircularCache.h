@@ -27,10 +27,17 @@
 
 namespace XFILE {
 
+/**
+ * Ring buffer cache for a single reader and a single writer thread.
+ *
+ * Reads and writes do not take any lock, each side only publishes its own
+ * position. The writer synchronises with Seek() only when it is about to
+ * overwrite history the reader could still seek back into.
+ */
 class CCircularCache : public CCacheStrategy
 {
 public:
-    CCircularCache(size_t front, size_t back);
+    CCircularCache(size_t front, size_t back, bool fileBacked = false);
     virtual ~CCircularCache();
 
     virtual int Open() ;
@@ -43,17 +50,29 @@ public:
     virtual int64_t Seek(int64_t pos) ;
     virtual void Reset(int64_t pos) ;
 
+    virtual int GetWriteBlock(char *&buf);
+    virtual void CommitWrite(size_t len);
+    virtual int GetReadBlock(const char *&buf);
+    virtual void CommitRead(size_t len);
+
 protected:
-    uint64_t          m_beg;       /**< index in file (not buffer) of beginning of valid data */
-    uint64_t          m_end;       /**< index in file (not buffer) of end of valid data */
-    uint64_t          m_cur;       /**< current reading index in file */
+    size_t GetWriteLimit() const;
+
+    uint64_t          m_beg;       /**< index in file (not buffer) of beginning of valid data, owned by the writer */
+    uint64_t          m_end;       /**< index in file (not buffer) of end of valid data, owned by the writer */
+    uint64_t          m_cur;       /**< current reading index in file, owned by the reader */
+    uint64_t          m_reserved;  /**< lowest index Seek() may go to while a write block is handed out, set by the writer under m_sync */
+    volatile uint32_t m_endPos;    /**< low bits of m_end as published to the reader */
+    volatile uint32_t m_curPos;    /**< low bits of m_cur as published to the writer */
     uint8_t          *m_buf;       /**< buffer holding data */
     size_t            m_size;      /**< size of data buffer used (m_buf) */
     size_t            m_size_back; /**< guaranteed size of back buffer (actual size can be smaller, or larger if front buffer doesn't need it) */
+    bool              m_fileBacked;/**< map a temporary file rather than anonymous memory */
     CCriticalSection  m_sync;
     CEvent            m_written;
 #ifdef _WIN32
     HANDLE            m_handle;
+    HANDLE            m_file;
 #endif
 };
 
@@ -26,6 +26,7 @@
 #include "URL.h"
 
 #include "CircularCache.h"
+#include "MultiRangeCache.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
@@ -87,9 +88,14 @@ CFileCache::CFileCache() : CThread("CFileCache")
    m_writePos = 0;
    if (g_advancedSettings.m_cacheMemBufferSize == 0)
      m_pCache = new CSimpleFileCache();
+   else if (g_advancedSettings.m_cacheMemBufferRanges > 1)
+     m_pCache = new CMultiRangeCache(g_advancedSettings.m_cacheMemBufferSize
+                                   , std::max<unsigned int>( g_advancedSettings.m_cacheMemBufferSize / 4, 1024 * 1024)
+                                   , g_advancedSettings.m_cacheMemBufferRanges);
    else
      m_pCache = new CCircularCache(g_advancedSettings.m_cacheMemBufferSize
-                                 , std::max<unsigned int>( g_advancedSettings.m_cacheMemBufferSize / 4, 1024 * 1024));
+                                 , std::max<unsigned int>( g_advancedSettings.m_cacheMemBufferSize / 4, 1024 * 1024)
+                                 , g_advancedSettings.m_cacheMemBufferFileBacked);
    m_seekPossible = 0;
    m_cacheFull = false;
 }
@@ -198,6 +204,7 @@ void CFileCache::Process()
 
   CWriteRate limiter;
   CWriteRate average;
+  int64_t    failedRefill = -1;
 
   while (!m_bStop)
   {
@@ -225,6 +232,31 @@ void CFileCache::Process()
       m_seekEnded.Set();
     }
 
+    // the reader moved to a cached range that should keep growing
+    int64_t refill = m_seekPossible != 0 ? m_pCache->GetRefillPosition() : -1;
+    if (refill >= 0 && refill != failedRefill)
+    {
+      CLog::Log(LOGDEBUG,"%s, refill from %"PRId64, __FUNCTION__, refill);
+      if (m_source.Seek(refill, SEEK_SET) == refill)
+      {
+        m_pCache->RefillFrom(refill);
+        m_pCache->ClearEndOfInput();
+        average.Reset(refill);
+        limiter.Reset(refill);
+        m_writePos = refill;
+        m_cacheFull = false;
+      }
+      else
+      {
+        // carry on wherever the source ended up
+        CLog::Log(LOGERROR,"%s, error %d seeking to %"PRId64, __FUNCTION__, (int)GetLastError(), refill);
+        failedRefill = refill;
+        m_writePos = m_source.GetPosition();
+        m_pCache->RefillFrom(m_writePos);
+        m_seekPossible = m_source.IoControl(IOCTRL_SEEK_POSSIBLE, NULL);
+      }
+    }
+
     while (m_writeRate)
     {
       if (m_writePos - m_readPos < m_writeRate)
@@ -243,18 +275,41 @@ void CFileCache::Process()
       }
     }
 
-    int iRead = m_source.Read(buffer.get(), m_chunkSize);
+    // if the cache can take a whole chunk, read straight into it
+    char *block = NULL;
+    int avail = m_pCache->GetWriteBlock(block);
+    bool direct = avail >= (int)m_chunkSize;
+    if (avail > 0 && !direct)
+      m_pCache->CommitWrite(0); // too small, hand it back
+
+    int iRead = m_source.Read(direct ? block : buffer.get(), m_chunkSize);
+    if (direct && iRead <= 0)
+      m_pCache->CommitWrite(0); // hand the block back, no history is dropped
     if (iRead == 0)
     {
       CLog::Log(LOGINFO, "CFileCache::Process - Hit eof.");
       m_pCache->EndOfInput();
 
       // The thread event will now also cause the wait of an event to return a false.
-      if (AbortableWait(m_seekEvent) == WAIT_SIGNALED)
+      // Strategies that can ask for a refill are polled now and then in case the
+      // reader moved to a range that needs one, everything else just sleeps.
+      WaitResponse wait;
+      if (m_seekPossible != 0 && m_pCache->CanRefill())
+      {
+        while ((wait = AbortableWait(m_seekEvent, 100)) == WAIT_TIMEDOUT
+            && m_pCache->GetRefillPosition() < 0)
+          ;
+      }
+      else
+        wait = AbortableWait(m_seekEvent);
+
+      if (wait == WAIT_SIGNALED)
       {
         m_pCache->ClearEndOfInput();
         m_seekEvent.Set(); // hack so that later we realize seek is needed
       }
+      else if (wait == WAIT_TIMEDOUT)
+        continue;
       else
         break;
     }
@@ -262,6 +317,13 @@ void CFileCache::Process()
       m_bStop = true;
 
     int iTotalWrite=0;
+    if (direct && iRead > 0)
+    {
+      m_pCache->CommitWrite(iRead);
+      m_cacheFull = false;
+      iTotalWrite = iRead;
+    }
+
     while (!m_bStop && (iTotalWrite < iRead))
     {
       int iWrite = 0;
@@ -277,6 +339,10 @@ void CFileCache::Process()
       }
       else if (iWrite == 0)
       {
+        // reader moved to another range, no point waiting for room in this one
+        if (m_seekPossible != 0 && m_pCache->GetRefillPosition() >= 0)
+          break;
+
         m_cacheFull = true;
         average.Pause();
         m_pCache->m_space.WaitMSec(5);
@@ -429,7 +495,13 @@ void CFileCache::Close()
 
   CSingleLock lock(m_sync);
   if (m_pCache)
+  {
+    SCacheRangeStatus status;
+    if (m_pCache->GetRangeStatus(status) && status.seekHits + status.seekMisses > 0)
+      CLog::Log(LOGDEBUG, "%s - %u seeks served from cache, %u from source, %"PRIu64" bytes not fetched again"
+              , __FUNCTION__, status.seekHits, status.seekMisses, status.savedBytes);
     m_pCache->Close();
+  }
 
   m_source.Close();
 }
@@ -472,6 +544,9 @@ int CFileCache::IoControl(EIoControl request, void* param)
     return 0;
   }
 
+  if (request == IOCTRL_CACHE_RANGES)
+    return m_pCache->GetRangeStatus(*(SCacheRangeStatus*)param) ? 0 : -1;
+
   if (request == IOCTRL_CACHE_SETRATE)
   {
     m_writeRate = *(unsigned*)param;
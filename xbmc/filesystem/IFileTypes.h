@@ -20,6 +20,8 @@
  */
 #pragma once
 
+#include <vector>
+
 namespace XFILE
 {
 
@@ -37,12 +39,29 @@ struct SCacheStatus
   bool     full;     /**< is the cache full */
 };
 
+struct SCacheRange
+{
+  int64_t  start;    /**< file position of first cached byte */
+  int64_t  end;      /**< file position after last cached byte */
+  unsigned hits;     /**< number of seeks that were served from this range */
+  uint64_t hitBytes; /**< bytes read from this range that were already cached when seeking into it */
+};
+
+struct SCacheRangeStatus
+{
+  unsigned seekHits;   /**< seeks served from cached data */
+  unsigned seekMisses; /**< seeks that needed a seek on the source */
+  uint64_t savedBytes; /**< bytes that would otherwise have been fetched again */
+  std::vector<SCacheRange> ranges;
+};
+
 typedef enum {
   IOCTRL_NATIVE        = 1, /**< SNativeIoControl structure, containing what should be passed to native ioctrl */
   IOCTRL_SEEK_POSSIBLE = 2, /**< return 0 if known not to work, 1 if it should work */
   IOCTRL_CACHE_STATUS  = 3, /**< SCacheStatus structure */
   IOCTRL_CACHE_SETRATE = 4, /**< unsigned int with speed limit for caching in bytes per second */
   IOCTRL_SET_CACHE    = 8, /** <CFileCache */
+  IOCTRL_CACHE_RANGES  = 9, /**< SCacheRangeStatus structure */
 } EIoControl;
 
 }
@@ -0,0 +1,508 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "threads/SystemClock.h"
+#include "system.h"
+#include "utils/log.h"
+#include "threads/SingleLock.h"
+#include "MultiRangeCache.h"
+
+#include <algorithm>
+
+using namespace XFILE;
+
+#define MULTIRANGE_BLOCK_SIZE (64 * 1024)
+
+static bool CompareRangeStart(const SCacheRange &a, const SCacheRange &b)
+{
+  return a.start < b.start;
+}
+
+CMultiRangeCache::CMultiRangeCache(size_t front, size_t back, unsigned int maxRanges)
+ : CCacheStrategy()
+ , m_blockSize(MULTIRANGE_BLOCK_SIZE)
+ , m_blocks(0)
+ , m_maxBlocks(std::max<size_t>((front + back) / MULTIRANGE_BLOCK_SIZE, 4))
+ , m_size_back(back)
+ , m_maxRanges(std::max(maxRanges, 2U))
+ , m_read(NULL)
+ , m_write(NULL)
+ , m_cur(0)
+ , m_writePos(0)
+ , m_hitEnd(0)
+ , m_eof(-1)
+ , m_clock(0)
+ , m_seekHits(0)
+ , m_seekMisses(0)
+ , m_savedBytes(0)
+{
+}
+
+CMultiRangeCache::~CMultiRangeCache()
+{
+  Close();
+}
+
+int CMultiRangeCache::Open()
+{
+  Close();
+
+  CSingleLock lock(m_sync);
+  m_seekHits   = 0;
+  m_seekMisses = 0;
+  m_savedBytes = 0;
+  m_eof        = -1;
+  Reset(0);
+  return CACHE_RC_OK;
+}
+
+void CMultiRangeCache::Close()
+{
+  CSingleLock lock(m_sync);
+  m_read  = NULL;
+  m_write = NULL;
+  while (!m_ranges.empty())
+    DeleteRange(m_ranges.back());
+
+  for (std::vector<uint8_t*>::iterator it = m_free.begin(); it != m_free.end(); ++it)
+    delete[] *it;
+  m_free.clear();
+  m_blocks = 0;
+}
+
+/**
+ * Range holding data at pos. Ranges ending at pos are
+ * only returned if no range has data at pos.
+ */
+CMultiRangeCache::CRange* CMultiRangeCache::FindRange(int64_t pos) const
+{
+  CRange *touching = NULL;
+  for (Ranges::const_iterator it = m_ranges.begin(); it != m_ranges.end(); ++it)
+  {
+    if ((*it)->start <= pos && pos < (*it)->end)
+      return *it;
+    if ((*it)->end == pos)
+      touching = *it;
+  }
+  return touching;
+}
+
+CMultiRangeCache::CRange* CMultiRangeCache::NewRange(int64_t pos)
+{
+  // make room by dropping the least recently used range
+  while (m_ranges.size() >= m_maxRanges)
+  {
+    CRange *lru = NULL;
+    for (Ranges::iterator it = m_ranges.begin(); it != m_ranges.end(); ++it)
+    {
+      if (*it != m_read && *it != m_write && (!lru || (*it)->lastUsed < lru->lastUsed))
+        lru = *it;
+    }
+    if (!lru)
+      break;
+    DeleteRange(lru);
+  }
+
+  CRange *range   = new CRange;
+  range->start    = pos;
+  range->end      = pos;
+  range->lastUsed = 0;
+  range->hits     = 0;
+  range->hitBytes = 0;
+  m_ranges.push_back(range);
+  Touch(range);
+  return range;
+}
+
+/**
+ * Closest range starting at or after the end of range.
+ */
+CMultiRangeCache::CRange* CMultiRangeCache::NextRange(CRange *range) const
+{
+  CRange *next = NULL;
+  for (Ranges::const_iterator it = m_ranges.begin(); it != m_ranges.end(); ++it)
+  {
+    if (*it != range && (*it)->start >= range->end && (!next || (*it)->start < next->start))
+      next = *it;
+  }
+  return next;
+}
+
+void CMultiRangeCache::DeleteRange(CRange *range)
+{
+  m_free.insert(m_free.end(), range->blocks.begin(), range->blocks.end());
+  m_ranges.erase(std::find(m_ranges.begin(), m_ranges.end(), range));
+  delete range;
+}
+
+/**
+ * Forget ranges without data that are no longer read or written.
+ */
+void CMultiRangeCache::DropEmpty()
+{
+  for (size_t i = m_ranges.size(); i > 0; --i)
+  {
+    CRange *range = m_ranges[i - 1];
+    if (range->start == range->end && range != m_read && range != m_write)
+      DeleteRange(range);
+  }
+}
+
+void CMultiRangeCache::DropBlock(CRange *range)
+{
+  m_free.push_back(range->blocks.front());
+  range->blocks.pop_front();
+  range->start = (range->start / m_blockSize + 1) * m_blockSize;
+  if (range->end < range->start)
+    range->end = range->start;
+}
+
+/**
+ * Start writing at pos, reusing the range that holds
+ * that position. Anything cached after pos is dropped.
+ */
+CMultiRangeCache::CRange* CMultiRangeCache::StartWriteAt(int64_t pos)
+{
+  CRange *range = FindRange(pos);
+  if (!range)
+    return NewRange(pos);
+
+  // keep the block pos is in, unless pos starts it
+  while (!range->blocks.empty()
+     && (int64_t)((range->start / m_blockSize + range->blocks.size() - 1) * m_blockSize) >= pos)
+  {
+    m_free.push_back(range->blocks.back());
+    range->blocks.pop_back();
+  }
+  range->end = pos;
+  return range;
+}
+
+/**
+ * Join the range starting where range ends into it. If both
+ * share a block, the head of the next range is copied over.
+ */
+void CMultiRangeCache::MergeNext(CRange *range, CRange *next)
+{
+  if (range->blocks.empty())
+  {
+    range->start = next->start;
+    range->blocks.swap(next->blocks);
+  }
+  else
+  {
+    if (next->start % m_blockSize)
+    {
+      size_t offset = (size_t)(next->start % m_blockSize);
+      size_t len    = (size_t)std::min<int64_t>(next->end - next->start, m_blockSize - offset);
+      memcpy(range->blocks.back() + offset, next->blocks.front() + offset, len);
+      m_free.push_back(next->blocks.front());
+      next->blocks.pop_front();
+    }
+    range->blocks.insert(range->blocks.end(), next->blocks.begin(), next->blocks.end());
+    next->blocks.clear();
+  }
+  range->end       = next->end;
+  range->hits     += next->hits;
+  range->hitBytes += next->hitBytes;
+
+  if (m_read == next)
+    m_read = range;
+  DeleteRange(next);
+}
+
+uint8_t* CMultiRangeCache::AllocBlock()
+{
+  if (m_free.empty() && m_blocks < m_maxBlocks)
+  {
+    m_free.push_back(new uint8_t[m_blockSize]);
+    m_blocks++;
+  }
+
+  if (m_free.empty())
+  {
+    // drop the least recently used range nobody is using
+    CRange *lru = NULL;
+    for (Ranges::iterator it = m_ranges.begin(); it != m_ranges.end(); ++it)
+    {
+      if (*it != m_read && *it != m_write && !(*it)->blocks.empty()
+      && (!lru || (*it)->lastUsed < lru->lastUsed))
+        lru = *it;
+    }
+    if (lru)
+      DeleteRange(lru);
+  }
+
+  if (m_free.empty() && m_read && !m_read->blocks.empty())
+  {
+    // then history of the range being read, beyond the back buffer
+    int64_t blockEnd = (m_read->start / m_blockSize + 1) * m_blockSize;
+    if (blockEnd + (int64_t)m_size_back <= m_cur)
+      DropBlock(m_read);
+  }
+
+  if (m_free.empty())
+    return NULL;
+
+  uint8_t *block = m_free.back();
+  m_free.pop_back();
+  return block;
+}
+
+void CMultiRangeCache::Touch(CRange *range)
+{
+  range->lastUsed = ++m_clock;
+}
+
+bool CMultiRangeCache::IsEndOfRead()
+{
+  if (!IsEndOfInput())
+    return false;
+  return m_eof < 0 || !m_read || m_read->end >= m_eof;
+}
+
+int CMultiRangeCache::WriteToCache(const char *buf, size_t len)
+{
+  CSingleLock lock(m_sync);
+  if (!m_write)
+    return CACHE_RC_ERROR;
+
+  // already cached after merging with the next range, just skip it
+  if (m_writePos < m_write->end)
+  {
+    len = (size_t)std::min<int64_t>(len, m_write->end - m_writePos);
+    m_writePos += len;
+    return len;
+  }
+
+  // ran into the next range, continue after it
+  CRange *next = NextRange(m_write);
+  if (next && next->start == m_write->end)
+  {
+    MergeNext(m_write, next);
+    len = (size_t)std::min<int64_t>(len, m_write->end - m_writePos);
+    m_writePos += len;
+    m_written.Set();
+    return len;
+  }
+
+  if ((size_t)(m_write->end / m_blockSize - m_write->start / m_blockSize) >= m_write->blocks.size())
+  {
+    uint8_t *block = AllocBlock();
+    if (!block)
+      return 0;
+    m_write->blocks.push_back(block);
+    next = NextRange(m_write); // may have been dropped for the block
+  }
+
+  size_t index  = (size_t)(m_write->end / m_blockSize - m_write->start / m_blockSize);
+  size_t offset = (size_t)(m_write->end % m_blockSize);
+
+  len = std::min(len, m_blockSize - offset);
+  if (next)
+    len = (size_t)std::min<int64_t>(len, next->start - m_write->end);
+
+  memcpy(m_write->blocks[index] + offset, buf, len);
+  m_write->end += len;
+  m_writePos   += len;
+
+  // the source has grown since end of input was seen
+  if (m_eof >= 0 && m_writePos > m_eof)
+    m_eof = -1;
+
+  m_written.Set();
+
+  return len;
+}
+
+int CMultiRangeCache::ReadFromCache(char *buf, size_t len)
+{
+  CSingleLock lock(m_sync);
+  if (!m_read)
+    return CACHE_RC_ERROR;
+
+  int64_t avail = m_read->end - m_cur;
+  if (avail <= 0)
+  {
+    if (IsEndOfRead())
+      return 0;
+    else
+      return CACHE_RC_WOULD_BLOCK;
+  }
+
+  size_t index  = (size_t)(m_cur / m_blockSize - m_read->start / m_blockSize);
+  size_t offset = (size_t)(m_cur % m_blockSize);
+
+  len = std::min(len, m_blockSize - offset);
+  len = (size_t)std::min<int64_t>(len, avail);
+  if (len == 0)
+    return 0;
+
+  memcpy(buf, m_read->blocks[index] + offset, len);
+
+  if (m_cur < m_hitEnd)
+  {
+    int64_t saved = std::min<int64_t>(len, m_hitEnd - m_cur);
+    m_read->hitBytes += saved;
+    m_savedBytes     += saved;
+  }
+
+  m_cur += len;
+  Touch(m_read);
+
+  m_space.Set();
+
+  return len;
+}
+
+int64_t CMultiRangeCache::WaitForData(unsigned int minumum, unsigned int millis)
+{
+  CSingleLock lock(m_sync);
+  int64_t avail = m_read ? m_read->end - m_cur : 0;
+
+  if (millis == 0 || IsEndOfRead())
+    return avail;
+
+  size_t limit = m_maxBlocks * m_blockSize - m_size_back;
+  if (minumum > limit)
+    minumum = limit;
+
+  XbmcThreads::EndTime endtime(millis);
+  while (!IsEndOfRead() && avail < minumum && !endtime.IsTimePast() )
+  {
+    lock.Leave();
+    m_written.WaitMSec(50); // may miss the deadline. shouldn't be a problem.
+    lock.Enter();
+    avail = m_read ? m_read->end - m_cur : 0;
+  }
+
+  return avail;
+}
+
+int64_t CMultiRangeCache::Seek(int64_t pos)
+{
+  CSingleLock lock(m_sync);
+  if (!m_read)
+    return CACHE_RC_ERROR;
+
+  CRange *range = FindRange(pos);
+
+  // if seek is a bit over what we are reading, try to wait a few seconds for the data to be available.
+  // we try to avoid a (heavy) seek on the source
+  if (!range && m_read == m_write && pos >= m_read->end && pos < m_read->end + 100000)
+  {
+    lock.Leave();
+    WaitForData((size_t)(pos - m_cur), 5000);
+    lock.Enter();
+    if (!m_read)
+      return CACHE_RC_ERROR;
+    range = FindRange(pos);
+  }
+
+  if (!range)
+  {
+    m_seekMisses++;
+    return CACHE_RC_ERROR;
+  }
+
+  m_seekHits++;
+  range->hits++;
+  if (range != m_read)
+    m_hitEnd = range->end;
+
+  m_read = range;
+  m_cur  = pos;
+  Touch(range);
+  m_space.Set();
+
+  return pos;
+}
+
+void CMultiRangeCache::Reset(int64_t pos)
+{
+  CSingleLock lock(m_sync);
+  m_read     = NULL;
+  m_write    = NULL;
+  m_write    = StartWriteAt(pos);
+  m_read     = m_write;
+  m_cur      = pos;
+  m_writePos = pos;
+  m_hitEnd   = pos;
+  DropEmpty();
+}
+
+/**
+ * The range being read should grow, unless the
+ * writer is already there or it reaches end of input.
+ */
+int64_t CMultiRangeCache::GetRefillPosition()
+{
+  CSingleLock lock(m_sync);
+  if (!m_read || m_read->end == m_writePos)
+    return -1;
+
+  if (m_eof >= 0 && m_read->end >= m_eof)
+    return -1;
+
+  return m_read->end;
+}
+
+void CMultiRangeCache::RefillFrom(int64_t pos)
+{
+  CSingleLock lock(m_sync);
+  if (m_read && m_read->end == pos)
+    m_write = m_read;
+  else
+    m_write = StartWriteAt(pos);
+  m_writePos = pos;
+
+  // reader may be in the range that was just truncated
+  if (m_read && m_cur > m_read->end)
+    m_cur = m_read->end;
+  DropEmpty();
+}
+
+bool CMultiRangeCache::GetRangeStatus(SCacheRangeStatus &status)
+{
+  CSingleLock lock(m_sync);
+  status.seekHits   = m_seekHits;
+  status.seekMisses = m_seekMisses;
+  status.savedBytes = m_savedBytes;
+  status.ranges.clear();
+  for (Ranges::iterator it = m_ranges.begin(); it != m_ranges.end(); ++it)
+  {
+    SCacheRange range;
+    range.start    = (*it)->start;
+    range.end      = (*it)->end;
+    range.hits     = (*it)->hits;
+    range.hitBytes = (*it)->hitBytes;
+    status.ranges.push_back(range);
+  }
+  std::sort(status.ranges.begin(), status.ranges.end(), CompareRangeStart);
+  return true;
+}
+
+void CMultiRangeCache::EndOfInput()
+{
+  CSingleLock lock(m_sync);
+  m_eof = m_writePos;
+  CCacheStrategy::EndOfInput();
+}
@@ -0,0 +1,114 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef CACHEMULTIRANGE_H
+#define CACHEMULTIRANGE_H
+
+#include "CacheStrategy.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <deque>
+#include <vector>
+
+namespace XFILE {
+
+/**
+ * Memory cache keeping several independent ranges of the source, so seeks
+ * between e.g. the head of the file, the index at its tail and the current
+ * playback position don't throw away what was already fetched.
+ *
+ * Memory is handed out in fixed size blocks aligned to file offsets. The
+ * range being written grows at its end, and merges with a following range
+ * once it reaches it. When out of blocks, the least recently used range that
+ * is neither read nor written is dropped first, then history of the range
+ * being read beyond the back buffer.
+ */
+class CMultiRangeCache : public CCacheStrategy
+{
+public:
+    CMultiRangeCache(size_t front, size_t back, unsigned int maxRanges);
+    virtual ~CMultiRangeCache();
+
+    virtual int Open() ;
+    virtual void Close();
+
+    virtual int WriteToCache(const char *buf, size_t len) ;
+    virtual int ReadFromCache(char *buf, size_t len) ;
+    virtual int64_t WaitForData(unsigned int minimum, unsigned int iMillis) ;
+
+    virtual int64_t Seek(int64_t pos) ;
+    virtual void Reset(int64_t pos) ;
+
+    virtual bool CanRefill() { return true; }
+    virtual int64_t GetRefillPosition();
+    virtual void RefillFrom(int64_t pos);
+    virtual bool GetRangeStatus(SCacheRangeStatus &status);
+
+    virtual void EndOfInput();
+
+protected:
+    struct CRange
+    {
+      int64_t              start;    /**< file position of first valid byte */
+      int64_t              end;      /**< file position after last valid byte */
+      std::deque<uint8_t*> blocks;   /**< blocks[0] holds file block start / block size */
+      unsigned int         lastUsed; /**< LRU stamp */
+      unsigned int         hits;
+      uint64_t             hitBytes;
+    };
+    typedef std::vector<CRange*> Ranges;
+
+    CRange*  FindRange(int64_t pos) const;
+    CRange*  NewRange(int64_t pos);
+    CRange*  StartWriteAt(int64_t pos);
+    CRange*  NextRange(CRange *range) const;
+    void     DeleteRange(CRange *range);
+    void     DropBlock(CRange *range);
+    void     DropEmpty();
+    void     MergeNext(CRange *range, CRange *next);
+    uint8_t* AllocBlock();
+    void     Touch(CRange *range);
+    bool     IsEndOfRead();
+
+    Ranges               m_ranges;
+    std::vector<uint8_t*> m_free;      /**< blocks not used by any range */
+    size_t               m_blockSize;
+    size_t               m_blocks;     /**< blocks allocated so far */
+    size_t               m_maxBlocks;
+    size_t               m_size_back;  /**< history kept behind the reader when short on memory */
+    unsigned int         m_maxRanges;
+    CRange              *m_read;       /**< range holding the read position */
+    CRange              *m_write;      /**< range being appended to */
+    int64_t              m_cur;        /**< read position */
+    int64_t              m_writePos;   /**< source position of the next write */
+    int64_t              m_hitEnd;     /**< end of data that was cached when the reader seeked into m_read */
+    int64_t              m_eof;        /**< position end of input was seen at, or -1 */
+    unsigned int         m_clock;
+    unsigned int         m_seekHits;
+    unsigned int         m_seekMisses;
+    uint64_t             m_savedBytes;
+    CCriticalSection     m_sync;
+    CEvent               m_written;
+};
+
+} // namespace XFILE
+#endif
@@ -0,0 +1,190 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "filesystem/CircularCache.h"
+#include "threads/test/TestHelpers.h"
+
+#include "gtest/gtest.h"
+
+#define CACHE_FRONT (64 * 1024)
+#define CACHE_BACK  (16 * 1024)
+#define TEST_BYTES  (4 * 1024 * 1024)
+
+using namespace XFILE;
+
+// byte at a given position in the test stream
+static char StreamByte(uint64_t pos)
+{
+  return (char)((pos * 7) ^ (pos >> 8));
+}
+
+TEST(TestCircularCache, WriteReadSeek)
+{
+  CCircularCache cache(CACHE_FRONT, CACHE_BACK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  // a single range never asks for a refill, the writer may sleep at eof
+  EXPECT_FALSE(cache.CanRefill());
+
+  char buf[1000];
+  for (int i = 0; i < 1000; ++i)
+    buf[i] = StreamByte(i);
+  EXPECT_EQ(1000, cache.WriteToCache(buf, sizeof(buf)));
+  EXPECT_EQ(1000, cache.WaitForData(0, 0));
+
+  char out[1000];
+  EXPECT_EQ(600, cache.ReadFromCache(out, 600));
+  EXPECT_EQ(0, memcmp(buf, out, 600));
+
+  // back into history and forward again
+  EXPECT_EQ(100, cache.Seek(100));
+  EXPECT_EQ(900, cache.ReadFromCache(out, sizeof(out)));
+  EXPECT_EQ(0, memcmp(buf + 100, out, 900));
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.ReadFromCache(out, sizeof(out)));
+
+  cache.EndOfInput();
+  EXPECT_EQ(0, cache.ReadFromCache(out, sizeof(out)));
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(200000));
+
+  cache.Close();
+}
+
+TEST(TestCircularCache, Blocks)
+{
+  CCircularCache cache(CACHE_FRONT, CACHE_BACK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  char *block;
+  EXPECT_EQ(CACHE_FRONT + CACHE_BACK, cache.GetWriteBlock(block));
+  memset(block, 'x', 10);
+  cache.CommitWrite(10);
+
+  const char *view;
+  EXPECT_EQ(10, cache.GetReadBlock(view));
+  EXPECT_EQ('x', view[9]);
+  cache.CommitRead(10);
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.GetReadBlock(view));
+
+  // the back buffer is kept even when the reader is done with it
+  EXPECT_EQ(CACHE_FRONT + CACHE_BACK - 10, cache.GetWriteBlock(block));
+
+  cache.Close();
+}
+
+TEST(TestCircularCache, History)
+{
+  CCircularCache cache(CACHE_FRONT, CACHE_BACK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  char *block;
+  const char *view;
+  ASSERT_EQ(CACHE_FRONT + CACHE_BACK, cache.GetWriteBlock(block));
+  cache.CommitWrite(CACHE_FRONT + CACHE_BACK);
+  ASSERT_EQ(CACHE_FRONT + CACHE_BACK, cache.GetReadBlock(view));
+  cache.CommitRead(CACHE_FRONT + CACHE_BACK);
+
+  // a block over the history keeps the reader out of it while handed out
+  EXPECT_EQ(CACHE_FRONT, cache.GetWriteBlock(block));
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(0));
+  EXPECT_EQ(CACHE_FRONT, cache.Seek(CACHE_FRONT));
+
+  // handed back without data, nothing is dropped
+  cache.CommitWrite(0);
+  EXPECT_EQ(0, cache.Seek(0));
+
+  // only what was written over is dropped
+  EXPECT_EQ(CACHE_FRONT + CACHE_BACK - 1, cache.Seek(CACHE_FRONT + CACHE_BACK - 1));
+  EXPECT_EQ(CACHE_FRONT - 1, cache.GetWriteBlock(block));
+  cache.CommitWrite(100);
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(99));
+  EXPECT_EQ(100, cache.Seek(100));
+
+  cache.Close();
+}
+
+class CacheProducer : public IRunnable
+{
+  CCircularCache &m_cache;
+public:
+  CacheProducer(CCircularCache &cache) : m_cache(cache) {}
+
+  void Run()
+  {
+    uint64_t pos = 0;
+    while (pos < TEST_BYTES)
+    {
+      char *block;
+      int len = m_cache.GetWriteBlock(block);
+      if (len <= 0)
+      {
+        m_cache.m_space.WaitMSec(5);
+        continue;
+      }
+      len = std::min<uint64_t>(len, std::min<uint64_t>(TEST_BYTES - pos, 3000));
+      for (int i = 0; i < len; ++i)
+        block[i] = StreamByte(pos + i);
+      m_cache.CommitWrite(len);
+      pos += len;
+    }
+    m_cache.EndOfInput();
+  }
+};
+
+TEST(TestCircularCache, Threaded)
+{
+  CCircularCache cache(CACHE_FRONT, CACHE_BACK);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  CacheProducer producer(cache);
+  thread t(producer);
+
+  uint64_t pos = 0, hop = 5000;
+  bool ok = true;
+  char buf[4096];
+  while (ok)
+  {
+    int len = cache.ReadFromCache(buf, sizeof(buf));
+    if (len == CACHE_RC_WOULD_BLOCK)
+    {
+      cache.WaitForData(1, 100);
+      continue;
+    }
+    if (len <= 0)
+      break;
+
+    for (int i = 0; i < len && ok; ++i)
+      ok = buf[i] == StreamByte(pos + i);
+    pos += len;
+
+    // hop back into history now and then, it must still be intact
+    if (pos >= hop)
+    {
+      EXPECT_EQ((int64_t)(pos - 1000), cache.Seek(pos - 1000));
+      pos -= 1000;
+      hop += 50000;
+    }
+  }
+
+  EXPECT_TRUE(ok);
+  EXPECT_EQ((uint64_t)TEST_BYTES, pos);
+  EXPECT_TRUE(t.timed_join(10000));
+  cache.Close();
+}
@@ -0,0 +1,196 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "filesystem/MultiRangeCache.h"
+
+#include "gtest/gtest.h"
+
+#define CACHE_FRONT (512 * 1024)
+#define CACHE_BACK  (128 * 1024)
+
+using namespace XFILE;
+
+// byte at a given position in the test stream
+static char StreamByte(int64_t pos)
+{
+  return (char)((pos * 7) ^ (pos >> 8));
+}
+
+// write [pos, pos + len) of the test stream as the source would
+static int64_t Fill(CMultiRangeCache &cache, int64_t pos, int64_t len)
+{
+  char buf[10000];
+  int64_t done = 0;
+  while (done < len)
+  {
+    int chunk = (int)std::min<int64_t>(sizeof(buf), len - done);
+    for (int i = 0; i < chunk; ++i)
+      buf[i] = StreamByte(pos + done + i);
+
+    int total = 0;
+    while (total < chunk)
+    {
+      int written = cache.WriteToCache(buf + total, chunk - total);
+      if (written <= 0)
+        return done + total;
+      total += written;
+    }
+    done += chunk;
+  }
+  return done;
+}
+
+// read len bytes and check them against the test stream
+static bool Check(CMultiRangeCache &cache, int64_t pos, int64_t len)
+{
+  char buf[10000];
+  while (len > 0)
+  {
+    int read = cache.ReadFromCache(buf, (size_t)std::min<int64_t>(sizeof(buf), len));
+    if (read <= 0)
+      return false;
+    for (int i = 0; i < read; ++i)
+    {
+      if (buf[i] != StreamByte(pos + i))
+        return false;
+    }
+    pos += read;
+    len -= read;
+  }
+  return true;
+}
+
+TEST(TestMultiRangeCache, KeepsRanges)
+{
+  CMultiRangeCache cache(CACHE_FRONT, CACHE_BACK, 4);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  // head of the file
+  EXPECT_EQ(100000, Fill(cache, 0, 100000));
+  EXPECT_TRUE(Check(cache, 0, 50000));
+
+  // jump to the index at the tail, the source has to seek
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(10000000));
+  cache.Reset(10000000);
+  EXPECT_EQ(30000, Fill(cache, 10000000, 30000));
+  EXPECT_TRUE(Check(cache, 10000000, 30000));
+
+  // and back to the head, which is still there
+  EXPECT_EQ(20000, cache.Seek(20000));
+  EXPECT_TRUE(Check(cache, 20000, 80000));
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.ReadFromCache(NULL, 1));
+
+  // the writer should continue the head now
+  EXPECT_TRUE(cache.CanRefill());
+  EXPECT_EQ(100000, cache.GetRefillPosition());
+  cache.RefillFrom(100000);
+  EXPECT_EQ(-1, cache.GetRefillPosition());
+  EXPECT_EQ(1000, Fill(cache, 100000, 1000));
+  EXPECT_TRUE(Check(cache, 100000, 1000));
+
+  SCacheRangeStatus status;
+  EXPECT_TRUE(cache.GetRangeStatus(status));
+  EXPECT_EQ(1U, status.seekHits);
+  EXPECT_EQ(1U, status.seekMisses);
+  EXPECT_EQ(80000U, status.savedBytes);
+  ASSERT_EQ(2U, status.ranges.size());
+  EXPECT_EQ(0, status.ranges[0].start);
+  EXPECT_EQ(101000, status.ranges[0].end);
+  EXPECT_EQ(1U, status.ranges[0].hits);
+  EXPECT_EQ(10000000, status.ranges[1].start);
+  EXPECT_EQ(10030000, status.ranges[1].end);
+
+  cache.Close();
+}
+
+TEST(TestMultiRangeCache, Merge)
+{
+  CMultiRangeCache cache(CACHE_FRONT, CACHE_BACK, 4);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  cache.Reset(70000);
+  EXPECT_EQ(50000, Fill(cache, 70000, 50000));
+
+  // grow a range into the next one, the shared block is joined
+  cache.Reset(1000);
+  EXPECT_EQ(69000, Fill(cache, 1000, 69000));
+  EXPECT_EQ(20000, Fill(cache, 70000, 20000)); // already cached, skipped
+  EXPECT_TRUE(Check(cache, 1000, 119000));
+
+  SCacheRangeStatus status;
+  EXPECT_TRUE(cache.GetRangeStatus(status));
+  ASSERT_EQ(1U, status.ranges.size());
+  EXPECT_EQ(1000, status.ranges[0].start);
+  EXPECT_EQ(120000, status.ranges[0].end);
+
+  // writer should move on to the end of the merged range
+  EXPECT_EQ(120000, cache.GetRefillPosition());
+
+  cache.Close();
+}
+
+TEST(TestMultiRangeCache, EvictsLeastRecentlyUsed)
+{
+  CMultiRangeCache cache(CACHE_FRONT, CACHE_BACK, 8);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  // three ranges of 256k, fighting over 640k
+  Fill(cache, 0, 256 * 1024);
+  cache.Reset(10000000);
+  Fill(cache, 10000000, 256 * 1024);
+
+  // touch the first one again
+  EXPECT_EQ(0, cache.Seek(0));
+  EXPECT_TRUE(Check(cache, 0, 1000));
+
+  cache.Reset(20000000);
+  EXPECT_EQ(256 * 1024, Fill(cache, 20000000, 256 * 1024));
+
+  EXPECT_EQ(5000, cache.Seek(5000));
+  EXPECT_EQ(CACHE_RC_ERROR, cache.Seek(10000000 + 5000));
+
+  cache.Close();
+}
+
+TEST(TestMultiRangeCache, EndOfInput)
+{
+  CMultiRangeCache cache(CACHE_FRONT, CACHE_BACK, 4);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  Fill(cache, 0, 10000);
+  cache.Reset(50000);
+  Fill(cache, 50000, 10000);
+  cache.EndOfInput();
+
+  // end of input only applies at the end of the file
+  char buf[100];
+  EXPECT_EQ(5000, cache.Seek(5000));
+  EXPECT_TRUE(Check(cache, 5000, 5000));
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, cache.ReadFromCache(buf, sizeof(buf)));
+  EXPECT_EQ(10000, cache.GetRefillPosition());
+
+  EXPECT_EQ(55000, cache.Seek(55000));
+  EXPECT_TRUE(Check(cache, 55000, 5000));
+  EXPECT_EQ(0, cache.ReadFromCache(buf, sizeof(buf)));
+  EXPECT_EQ(-1, cache.GetRefillPosition());
+
+  cache.Close();
+}
@@ -22,6 +22,9 @@
 #include "GraphicContext.h"
 #include <stdio.h>
 
+// weight of the older frames in the cost fit of the adaptive solver
+#define ADAPTIVE_COST_DECAY 0.98
+
 void CUnionDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
 {
   CDirtyRegion unifiedRegion;
@@ -50,6 +53,12 @@ CGreedyDirtyRegionSolver::CGreedyDirtyRegionSolver()
   m_costPerArea   = 0.01f;
 }
 
+void CGreedyDirtyRegionSolver::SetCost(float costNewRegion, float costPerArea)
+{
+  m_costNewRegion = costNewRegion;
+  m_costPerArea   = costPerArea;
+}
+
 void CGreedyDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
 {
   for (unsigned int i = 0; i < input.size(); i++)
@@ -81,3 +90,60 @@ void CGreedyDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegion
       output.push_back(currentRegion);
   }
 }
+
+CAdaptiveDirtyRegionSolver::CAdaptiveDirtyRegionSolver()
+{
+  m_costNewRegion = 10.0f;
+  m_costPerArea   = 0.01f;
+  m_greedy.SetCost(m_costNewRegion, m_costPerArea);
+
+  m_sumPassesPasses = 0.0;
+  m_sumPassesArea   = 0.0;
+  m_sumAreaArea     = 0.0;
+  m_sumPassesTime   = 0.0;
+  m_sumAreaTime     = 0.0;
+}
+
+void CAdaptiveDirtyRegionSolver::Solve(const CDirtyRegionList &input, CDirtyRegionList &output)
+{
+  m_greedy.Solve(input, output);
+  if (output.size() <= 1)
+    return;
+
+  CDirtyRegion unifiedRegion;
+  float cost = 0.0f;
+  for (unsigned int i = 0; i < output.size(); i++)
+  {
+    unifiedRegion.Union(output[i]);
+    cost += m_costNewRegion + m_costPerArea * output[i].Area();
+  }
+
+  if (m_costNewRegion + m_costPerArea * unifiedRegion.Area() <= cost)
+    output.assign(1, unifiedRegion);
+}
+
+void CAdaptiveDirtyRegionSolver::UpdateCost(unsigned int passes, float area, float renderTime)
+{
+  if (passes == 0)
+    return;
+
+  m_sumPassesPasses = m_sumPassesPasses * ADAPTIVE_COST_DECAY + (double)passes * passes;
+  m_sumPassesArea   = m_sumPassesArea   * ADAPTIVE_COST_DECAY + (double)passes * area;
+  m_sumAreaArea     = m_sumAreaArea     * ADAPTIVE_COST_DECAY + (double)area * area;
+  m_sumPassesTime   = m_sumPassesTime   * ADAPTIVE_COST_DECAY + (double)passes * renderTime;
+  m_sumAreaTime     = m_sumAreaTime     * ADAPTIVE_COST_DECAY + (double)area * renderTime;
+
+  // the costs can only be separated once the frames differ in passes or area
+  double det = m_sumPassesPasses * m_sumAreaArea - m_sumPassesArea * m_sumPassesArea;
+  if (det <= 1e-6 * m_sumPassesPasses * m_sumAreaArea)
+    return;
+
+  double costNewRegion = (m_sumAreaArea * m_sumPassesTime - m_sumPassesArea * m_sumAreaTime) / det;
+  double costPerArea   = (m_sumPassesPasses * m_sumAreaTime - m_sumPassesArea * m_sumPassesTime) / det;
+  if (costNewRegion <= 0.0 || costPerArea <= 0.0)
+    return;
+
+  m_costNewRegion = (float)costNewRegion;
+  m_costPerArea   = (float)costPerArea;
+  m_greedy.SetCost(m_costNewRegion, m_costPerArea);
+}
@@ -44,7 +44,39 @@ class CGreedyDirtyRegionSolver : public IDirtyRegionSolver
 public:
   CGreedyDirtyRegionSolver();
   virtual void Solve(const CDirtyRegionList &input, CDirtyRegionList &output);
+  void SetCost(float costNewRegion, float costPerArea);
 private:
   float m_costNewRegion;
   float m_costPerArea;
 };
+
+/*!
+ \brief Greedy solver using costs measured from the rendered frames.
+
+ The render time of a frame is modelled as passes * costNewRegion + area * costPerArea
+ and both costs are fitted by least squares over the recent frames. A greedy solution
+ that is estimated to be slower than a single pass of its union is replaced by the union.
+
+ The times fed in are CPU time spent submitting the passes, the GPU works asynchronously
+ and its fill cost only shows up when the driver blocks. costPerArea is therefore
+ underestimated on fill rate bound hardware, which leans towards the union. That is
+ never worse than the plain union solver.
+ */
+class CAdaptiveDirtyRegionSolver : public IDirtyRegionSolver
+{
+public:
+  CAdaptiveDirtyRegionSolver();
+  virtual void Solve(const CDirtyRegionList &input, CDirtyRegionList &output);
+  virtual void UpdateCost(unsigned int passes, float area, float renderTime);
+private:
+  CGreedyDirtyRegionSolver m_greedy;
+  float m_costNewRegion;
+  float m_costPerArea;
+
+  // exponentially decayed sums for the least squares fit
+  double m_sumPassesPasses;
+  double m_sumPassesArea;
+  double m_sumAreaArea;
+  double m_sumPassesTime;
+  double m_sumAreaTime;
+};
@@ -19,14 +19,26 @@
  */
 
 #include "DirtyRegionTracker.h"
+#include "GraphicContext.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 #include <stdio.h>
 
+#define STATISTICS_PERIOD 10000
+
 CDirtyRegionTracker::CDirtyRegionTracker(int buffering)
 {
   m_buffering = buffering;
+  m_bufferAge = -1;
   m_solver = NULL;
+
+  m_statStart = 0;
+  m_statFrames = 0;
+  m_statPasses = 0;
+  m_statArea = 0.0f;
+  m_statRenderTime = 0.0f;
+  m_statMaxRenderTime = 0.0f;
 }
 
 CDirtyRegionTracker::~CDirtyRegionTracker()
@@ -52,6 +64,10 @@ void CDirtyRegionTracker::SelectAlgorithm()
       m_solver = new CUnionDirtyRegionSolver();
       CLog::Log(LOGDEBUG, "guilib: Union as algorithm for solving rendering passes");
       break;
+    case DIRTYREGION_SOLVER_ADAPTIVE:
+      CLog::Log(LOGDEBUG, "guilib: Measured cost reduction as algorithm for solving rendering passes");
+      m_solver = new CAdaptiveDirtyRegionSolver();
+      break;
     case DIRTYREGION_SOLVER_FILL_VIEWPORT_ALWAYS:
     default:
       CLog::Log(LOGDEBUG, "guilib: Fill viewport always for solving rendering passes");
@@ -71,12 +87,37 @@ const CDirtyRegionList &CDirtyRegionTracker::GetMarkedRegions() const
   return m_markedRegions;
 }
 
+void CDirtyRegionTracker::SetBufferAge(int age)
+{
+  m_bufferAge = age;
+}
+
 CDirtyRegionList CDirtyRegionTracker::GetDirtyRegions()
 {
   CDirtyRegionList output;
 
-  if (m_solver)
+  if (!m_solver)
+    return output;
+
+  if (m_bufferAge < 0 || g_advancedSettings.m_guiVisualizeDirtyRegions)
     m_solver->Solve(m_markedRegions, output);
+  else if (m_bufferAge == 0 || m_bufferAge > m_buffering)
+  {
+    // the back buffer is undefined or older than the regions we keep
+    if (!m_markedRegions.empty())
+      output.push_back(CDirtyRegion(g_graphicsContext.GetViewWindow()));
+  }
+  else
+  {
+    // the back buffer already holds everything but the changes of the last m_bufferAge frames
+    CDirtyRegionList regions;
+    for (unsigned int i = 0; i < m_markedRegions.size(); i++)
+    {
+      if (m_markedRegions[i].GetAge() < m_bufferAge)
+        regions.push_back(m_markedRegions[i]);
+    }
+    m_solver->Solve(regions, output);
+  }
 
   return output;
 }
@@ -93,3 +134,51 @@ void CDirtyRegionTracker::CleanMarkedRegions()
     i--;
   }
 }
+
+void CDirtyRegionTracker::UpdateRenderCost(const CDirtyRegionList &regions, float renderTime)
+{
+  unsigned int passes = 0;
+  float area = 0.0f;
+  for (CDirtyRegionList::const_iterator i = regions.begin(); i != regions.end(); i++)
+  {
+    if (i->IsEmpty())
+      continue;
+    passes++;
+    area += i->Area();
+  }
+
+  if (m_solver)
+    m_solver->UpdateCost(passes, area, renderTime);
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  if (m_statFrames == 0)
+    m_statStart = now;
+
+  m_statFrames++;
+  m_statPasses += passes;
+  m_statArea += area;
+  m_statRenderTime += renderTime;
+  if (renderTime > m_statMaxRenderTime)
+    m_statMaxRenderTime = renderTime;
+
+  if (now - m_statStart >= STATISTICS_PERIOD)
+    LogStatistics(now);
+}
+
+void CDirtyRegionTracker::LogStatistics(unsigned int now)
+{
+  float screenArea = (float)g_graphicsContext.GetWidth() * g_graphicsContext.GetHeight();
+  if (screenArea > 0.0f)
+  {
+    CLog::Log(LOGDEBUG, "guilib: %u frames in %.1fs, render cpu time avg %.2fms max %.2fms, %.2f passes and %.1f%% of the screen per frame",
+              m_statFrames, (now - m_statStart) / 1000.0f,
+              m_statRenderTime / m_statFrames, m_statMaxRenderTime,
+              (float)m_statPasses / m_statFrames, 100.0f * m_statArea / (screenArea * m_statFrames));
+  }
+
+  m_statFrames = 0;
+  m_statPasses = 0;
+  m_statArea = 0.0f;
+  m_statRenderTime = 0.0f;
+  m_statMaxRenderTime = 0.0f;
+}
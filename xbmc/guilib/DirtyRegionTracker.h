@@ -36,12 +36,37 @@ public:
   void SelectAlgorithm();
   void MarkDirtyRegion(const CDirtyRegion &region);
 
+  /*!
+   \brief Set the age of the back buffer the next frame is rendered to.
+   \param age number of frames the back buffer is old, 0 if its content is undefined or -1 if unknown.
+   With a known age only the regions marked within that many frames are redrawn.
+   */
+  void SetBufferAge(int age);
+
   const CDirtyRegionList &GetMarkedRegions() const;
   CDirtyRegionList GetDirtyRegions();
   void CleanMarkedRegions();
 
+  /*!
+   \brief Report how long rendering the given regions took.
+   Feeds the adaptive solver and the frame statistics logged in debug mode.
+   \param regions the regions that were rendered.
+   \param renderTime CPU time spent rendering them in milliseconds, see CAdaptiveDirtyRegionSolver.
+   */
+  void UpdateRenderCost(const CDirtyRegionList &regions, float renderTime);
+
 private:
+  void LogStatistics(unsigned int now);
+
   CDirtyRegionList m_markedRegions;
   int m_buffering;
+  int m_bufferAge;
   IDirtyRegionSolver *m_solver;
+
+  unsigned int m_statStart;
+  unsigned int m_statFrames;
+  unsigned int m_statPasses;
+  float m_statArea;
+  float m_statRenderTime;
+  float m_statMaxRenderTime;
 };
@@ -1110,12 +1110,17 @@ bool CGUIBaseContainer::InsideLayout(const CGUIListItemLayout *layout, const CPo
 void CGUIBaseContainer::DumpTextureUse()
 {
   CLog::Log(LOGDEBUG, "%s for container %u", __FUNCTION__, GetID());
+  size_t memory = 0;
   for (unsigned int i = 0; i < m_items.size(); ++i)
   {
     CGUIListItemPtr item = m_items[i];
     if (item->GetFocusedLayout()) item->GetFocusedLayout()->DumpTextureUse();
     if (item->GetLayout()) item->GetLayout()->DumpTextureUse();
+    memory += item->GetMemoryUsage();
   }
+  if (!m_items.empty())
+    CLog::Log(LOGDEBUG, "%s: %u items use %u KB (%u bytes per item)", __FUNCTION__,
+              (unsigned int)m_items.size(), (unsigned int)(memory / 1024), (unsigned int)(memory / m_items.size()));
 }
 #endif
 
@@ -97,6 +97,8 @@ void CGUIFont::DrawText( float x, float y, const vecColors &colors, color_t shad
   for (unsigned int i = 0; i < colors.size(); i++)
     renderColors.push_back(g_graphicsContext.MergeAlpha(colors[i] ? colors[i] : m_textColor));
   if (!shadowColor) shadowColor = m_shadowColor;
+  // the shadow and the text go out in the same batch
+  m_font->Begin();
   if (shadowColor)
   {
     shadowColor = g_graphicsContext.MergeAlpha(shadowColor);
@@ -106,6 +108,7 @@ void CGUIFont::DrawText( float x, float y, const vecColors &colors, color_t shad
     m_font->DrawTextInternal(x + 1, y + 1, shadowColors, text, alignment, maxPixelWidth, false);
   }
   m_font->DrawTextInternal( x, y, renderColors, text, alignment, maxPixelWidth, false);
+  m_font->End();
 
   if (clip)
     g_graphicsContext.RestoreClipRegion();
@@ -214,6 +217,7 @@ void CGUIFont::DrawScrollingText(float x, float y, const vecColors &colors, colo
     renderColors.push_back(g_graphicsContext.MergeAlpha(colors[i] ? colors[i] : m_textColor));
 
   bool scroll =  !scrollInfo.waitTime && scrollInfo.pixelSpeed;
+  m_font->Begin();
   if (shadowColor)
   {
     shadowColor = g_graphicsContext.MergeAlpha(shadowColor);
@@ -223,6 +227,7 @@ void CGUIFont::DrawScrollingText(float x, float y, const vecColors &colors, colo
     m_font->DrawTextInternal(x - offset + 1, y + 1, shadowColors, renderText, alignment, maxWidth + scrollInfo.pixelPos + m_font->GetLineHeight(2.0f), scroll);
   }
   m_font->DrawTextInternal(x - offset, y, renderColors, renderText, alignment, maxWidth + scrollInfo.pixelPos + m_font->GetLineHeight(2.0f), scroll);
+  m_font->End();
 
   g_graphicsContext.RestoreClipRegion();
 }
@@ -23,7 +23,10 @@
 #include "GUIFontManager.h"
 #include "Texture.h"
 #include "GraphicContext.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
 #include "filesystem/SpecialProtocol.h"
+#include "utils/Crc32.h"
 #include "utils/MathUtils.h"
 #include "utils/log.h"
 #include "windowing/WindowingFactory.h"
@@ -49,6 +52,32 @@ using namespace std;
 #define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
 #define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
 
+#define GLYPH_CACHE_PATH     "special://temp/glyphs/"
+#define GLYPH_CACHE_VERSION  1
+#define GLYPH_CACHE_MAX_SIZE (1024 * 1024) // per font size
+
+struct GlyphCacheHeader
+{
+  char     magic[4];
+  uint32_t version;
+  int64_t  fontSize;
+  int64_t  fontTime;
+  float    height;
+  float    aspect;
+  uint32_t border;
+  uint32_t reserved;
+};
+
+struct GlyphCacheRecord
+{
+  uint32_t letterAndStyle;
+  int16_t  left;
+  int16_t  top;
+  uint16_t width;
+  uint16_t rows;
+  float    advance;
+};
+
 int CGUIFontTTFBase::justification_word_weight = 6;   // weight of word spacing over letter spacing when justifying.
                                                   // A larger number means more of the "dead space" is placed between
                                                   // words rather than between letters.
@@ -157,6 +186,10 @@ CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
   m_color = 0;
   m_vertex_count = 0;
   m_nTexture = 0;
+  m_textureFull = false;
+  m_renderStamp = 0;
+  m_glyphCacheDirty = false;
+  m_glyphsRasterised = m_glyphsFromCache = m_linesEvicted = 0;
 }
 
 CGUIFontTTFBase::~CGUIFontTTFBase(void)
@@ -194,10 +227,19 @@ void CGUIFontTTFBase::ClearCharacterCache()
   m_posX = m_textureWidth;
   m_posY = -(int)GetTextureLineHeight();
   m_textureHeight = 0;
+  m_textureFull = false;
+  m_lineStamps.clear();
 }
 
 void CGUIFontTTFBase::Clear()
 {
+  if (m_face)
+    CLog::Log(LOGDEBUG, "%s: %s (%.1f) rasterised %u glyphs, %u from the glyph cache, %u texture lines evicted", __FUNCTION__,
+              m_strFilename.c_str(), m_height, m_glyphsRasterised, m_glyphsFromCache, m_linesEvicted);
+  SaveGlyphCache();
+  m_glyphCache.clear();
+  m_glyphCacheIndex.clear();
+
   delete(m_texture);
   m_texture = NULL;
   delete[] m_char;
@@ -207,6 +249,8 @@ void CGUIFontTTFBase::Clear()
   m_numChars = 0;
   m_posX = 0;
   m_posY = 0;
+  m_textureFull = false;
+  m_lineStamps.clear();
   m_nestedBeginCount = 0;
 
   if (m_face)
@@ -300,6 +344,10 @@ bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float as
   // set the posX and posY so that our texture will be created on first character write.
   m_posX = m_textureWidth;
   m_posY = -(int)GetTextureLineHeight();
+  m_textureFull = false;
+  m_lineStamps.clear();
+
+  LoadGlyphCache(aspect, border);
 
   // cache the ellipses width
   Character *ellipse = GetCharacter(L'.');
@@ -315,6 +363,7 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
   // save the origin, which is scaled separately
   m_originX = x;
   m_originY = y;
+  m_renderStamp++;
 
   // Check if we will really need to truncate or justify the text
   if ( alignment & XBFONT_TRUNCATED )
@@ -496,7 +545,37 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
     else
       return &m_char[mid];
   }
-  // if we get to here, then low is where we should insert the new character
+  // render the character to our texture
+  // must End() as we can't render text to our texture during a Begin(), End() block
+  Character newChar;
+  unsigned int nestedBeginCount = m_nestedBeginCount;
+  m_nestedBeginCount = 1;
+  if (nestedBeginCount) End();
+  bool cached = CacheCharacter(letter, style, &newChar);
+  if (!cached)
+  { // unable to cache character - try clearing them all out and starting over
+    CLog::Log(LOGDEBUG, "GUIFontTTF::GetCharacter: Unable to cache character.  Clearing character cache of %i characters", m_numChars);
+    ClearCharacterCache();
+    cached = CacheCharacter(letter, style, &newChar);
+    if (!cached)
+      CLog::Log(LOGERROR, "GUIFontTTF::GetCharacter: Unable to cache character (out of memory?)");
+  }
+  if (nestedBeginCount) Begin();
+  m_nestedBeginCount = nestedBeginCount;
+  if (!cached)
+    return NULL;
+
+  // caching may have evicted characters, so find where to insert the new one again
+  low = 0;
+  high = m_numChars - 1;
+  while (low <= high)
+  {
+    mid = (low + high) >> 1;
+    if (ch > m_char[mid].letterAndStyle)
+      low = mid + 1;
+    else
+      high = mid - 1;
+  }
 
   // increase the size of the buffer if we need it
   if (m_numChars >= m_maxChars)
@@ -516,26 +595,8 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   { // just move the data along as necessary
     memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
   }
-  // render the character to our texture
-  // must End() as we can't render text to our texture during a Begin(), End() block
-  unsigned int nestedBeginCount = m_nestedBeginCount;
-  m_nestedBeginCount = 1;
-  if (nestedBeginCount) End();
-  if (!CacheCharacter(letter, style, m_char + low))
-  { // unable to cache character - try clearing them all out and starting over
-    CLog::Log(LOGDEBUG, "GUIFontTTF::GetCharacter: Unable to cache character.  Clearing character cache of %i characters", m_numChars);
-    ClearCharacterCache();
-    low = 0;
-    if (!CacheCharacter(letter, style, m_char + low))
-    {
-      CLog::Log(LOGERROR, "GUIFontTTF::GetCharacter: Unable to cache character (out of memory?)");
-      if (nestedBeginCount) Begin();
-      m_nestedBeginCount = nestedBeginCount;
-      return NULL;
-    }
-  }
-  if (nestedBeginCount) Begin();
-  m_nestedBeginCount = nestedBeginCount;
+  m_char[low] = newChar;
+  m_numChars++;
 
   // fixup quick access
   memset(m_charquick, 0, sizeof(m_charquick));
@@ -553,109 +614,305 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
 
 bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
 {
-  int glyph_index = FT_Get_Char_Index( m_face, letter );
+  character_t letterAndStyle = (style << 16) | letter;
+  FT_Glyph ftGlyph = NULL;
+  Glyph glyph;
 
-  FT_Glyph glyph = NULL;
-  if (FT_Load_Glyph( m_face, glyph_index, FT_LOAD_TARGET_LIGHT ))
+  if (GetCachedGlyph(letterAndStyle, glyph))
+    m_glyphsFromCache++;
+  else
   {
-    CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, letter);
-    return false;
+    int glyph_index = FT_Get_Char_Index( m_face, letter );
+
+    if (FT_Load_Glyph( m_face, glyph_index, FT_LOAD_TARGET_LIGHT ))
+    {
+      CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, letter);
+      return false;
+    }
+    // make bold if applicable
+    if (style & FONT_STYLE_BOLD)
+      EmboldenGlyph(m_face->glyph);
+    // and italics if applicable
+    if (style & FONT_STYLE_ITALICS)
+      ObliqueGlyph(m_face->glyph);
+    // grab the glyph
+    if (FT_Get_Glyph(m_face->glyph, &ftGlyph))
+    {
+      CLog::Log(LOGDEBUG, "%s Failed to get glyph %x", __FUNCTION__, letter);
+      return false;
+    }
+    if (m_stroker)
+      FT_Glyph_StrokeBorder(&ftGlyph, m_stroker, 0, 1);
+    // render the glyph
+    if (FT_Glyph_To_Bitmap(&ftGlyph, FT_RENDER_MODE_NORMAL, NULL, 1))
+    {
+      CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, letter);
+      FT_Done_Glyph(ftGlyph);
+      return false;
+    }
+    FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)ftGlyph;
+    glyph.left    = bitGlyph->left;
+    glyph.top     = bitGlyph->top;
+    glyph.width   = bitGlyph->bitmap.width;
+    glyph.rows    = bitGlyph->bitmap.rows;
+    glyph.pitch   = bitGlyph->bitmap.pitch;
+    glyph.pixels  = bitGlyph->bitmap.buffer;
+    glyph.advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+
+    m_glyphsRasterised++;
+    AddCachedGlyph(letterAndStyle, glyph);
+  }
+
+  if (glyph.left < 0)
+    m_posX += -glyph.left;
+
+  // check we have enough room for the character
+  if (m_posX + glyph.left + (int)glyph.width > (int)m_textureWidth)
+  { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
+    if (!StartTextureLine())
+    {
+      if (ftGlyph)
+        FT_Done_Glyph(ftGlyph);
+      return false;
+    }
+    if (glyph.left < 0)
+      m_posX += -glyph.left;
   }
-  // make bold if applicable
-  if (style & FONT_STYLE_BOLD)
-    EmboldenGlyph(m_face->glyph);
-  // and italics if applicable
-  if (style & FONT_STYLE_ITALICS)
-    ObliqueGlyph(m_face->glyph);
-  // grab the glyph
-  if (FT_Get_Glyph(m_face->glyph, &glyph))
+
+  if(m_texture == NULL)
   {
-    CLog::Log(LOGDEBUG, "%s Failed to get glyph %x", __FUNCTION__, letter);
+    CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: no texture to cache character to");
+    if (ftGlyph)
+      FT_Done_Glyph(ftGlyph);
     return false;
   }
-  if (m_stroker)
-    FT_Glyph_StrokeBorder(&glyph, m_stroker, 0, 1);
-  // render the glyph
-  if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, NULL, 1))
+
+  // set the character in our table
+  ch->letterAndStyle = letterAndStyle;
+  ch->offsetX = (short)glyph.left;
+  ch->offsetY = (short)m_cellBaseLine - glyph.top;
+  ch->left = (float)m_posX + ch->offsetX;
+  ch->top = (float)m_posY + ch->offsetY;
+  ch->right = ch->left + glyph.width;
+  ch->bottom = ch->top + glyph.rows;
+  ch->advance = glyph.advance;
+  ch->row = (unsigned short)(m_posY / GetTextureLineHeight());
+
+  // we need only render if we actually have some pixels
+  if (glyph.width * glyph.rows)
   {
-    CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, letter);
-    return false;
+    // ensure our rect will stay inside the texture (it *should* but we need to be certain)
+    unsigned int x1 = max(m_posX + ch->offsetX, 0);
+    unsigned int y1 = max(m_posY + ch->offsetY, 0);
+    unsigned int x2 = min(x1 + glyph.width, m_textureWidth);
+    unsigned int y2 = min(y1 + glyph.rows, m_textureHeight);
+    CopyCharToTexture(glyph.pixels, glyph.pitch, x1, y1, x2, y2);
   }
-  FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-  if (bitGlyph->left < 0)
-    m_posX += -bitGlyph->left;
+  m_posX += spacing_between_characters_in_texture + (unsigned short)max(ch->right - ch->left + ch->offsetX, ch->advance);
 
-  // check we have enough room for the character
-  if (m_posX + bitGlyph->left + bitmap.width > (int)m_textureWidth)
-  { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
-    m_posX = 0;
-    m_posY += GetTextureLineHeight();
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
+  m_textureScaleX = 1.0f / m_textureWidth;
+  m_textureScaleY = 1.0f / m_textureHeight;
+
+  // free the glyph
+  if (ftGlyph)
+    FT_Done_Glyph(ftGlyph);
+
+  return true;
+}
+
+bool CGUIFontTTFBase::StartTextureLine()
+{
+  unsigned int lineHeight = GetTextureLineHeight();
+  m_posX = 0;
 
-    if(m_posY + GetTextureLineHeight() >= m_textureHeight)
+  if (!m_textureFull)
+  {
+    int posY = m_posY + lineHeight;
+    if (posY + lineHeight >= m_textureHeight)
     {
       // create the new larger texture
-      unsigned int newHeight = m_posY + GetTextureLineHeight();
+      unsigned int newHeight = posY + lineHeight;
       // check for max height
       if (newHeight > g_Windowing.GetMaxTextureSize())
       {
-        CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: New cache texture is too large (%u > %u pixels long)", newHeight, g_Windowing.GetMaxTextureSize());
-        FT_Done_Glyph(glyph);
-        return false;
+        if (!m_texture || m_lineStamps.size() < 2)
+        {
+          CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: New cache texture is too large (%u > %u pixels long)", newHeight, g_Windowing.GetMaxTextureSize());
+          return false;
+        }
+        // from now on lines are recycled rather than the texture growing
+        CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: Cache texture for %s (%.1f) is full, reusing the least recently rendered lines", m_strFilename.c_str(), m_height);
+        m_textureFull = true;
+        return EvictTextureLine();
       }
 
-      CBaseTexture* newTexture = NULL;
-      newTexture = ReallocTexture(newHeight);
+      CBaseTexture* newTexture = ReallocTexture(newHeight);
       if(newTexture == NULL)
       {
-        FT_Done_Glyph(glyph);
         CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: Failed to allocate new texture of height %u", newHeight);
         return false;
       }
       m_texture = newTexture;
     }
+    m_posY = posY;
+    m_lineStamps.push_back(m_renderStamp);
+    return true;
   }
+  return EvictTextureLine();
+}
 
-  if(m_texture == NULL)
-  {
-    CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: no texture to cache character to");
+bool CGUIFontTTFBase::EvictTextureLine()
+{
+  unsigned int lineHeight = GetTextureLineHeight();
+  unsigned int current = m_posY / lineHeight;
+  if (m_lineStamps.size() < 2 || current >= m_lineStamps.size())
     return false;
+
+  // the line we just filled is the most recent, so never pick it
+  unsigned int oldest = current ? 0 : 1;
+  for (unsigned int i = 0; i < m_lineStamps.size(); i++)
+  {
+    if (i != current && m_lineStamps[i] < m_lineStamps[oldest])
+      oldest = i;
   }
 
-  // set the character in our table
-  ch->letterAndStyle = (style << 16) | letter;
-  ch->offsetX = (short)bitGlyph->left;
-  ch->offsetY = (short)m_cellBaseLine - bitGlyph->top;
-  ch->left = (float)m_posX + ch->offsetX;
-  ch->top = (float)m_posY + ch->offsetY;
-  ch->right = ch->left + bitmap.width;
-  ch->bottom = ch->top + bitmap.rows;
-  ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  // drop the characters that live in it. Any vertices referencing them have
+  // already been flushed, as GetCharacter() ends the current batch first.
+  int kept = 0;
+  for (int i = 0; i < m_numChars; i++)
+  {
+    if (m_char[i].row != oldest)
+      m_char[kept++] = m_char[i];
+  }
+  m_numChars = kept;
+  memset(m_charquick, 0, sizeof(m_charquick));
 
-  // we need only render if we actually have some pixels
-  if (bitmap.width * bitmap.rows)
+  // and blank it so that nothing bleeds into the glyphs that replace them
+  m_posY = oldest * lineHeight;
+  unsigned int bottom = min(m_posY + lineHeight, m_textureHeight);
+  std::vector<unsigned char> blank(m_textureWidth * lineHeight, 0);
+  CopyCharToTexture(&blank[0], m_textureWidth, 0, m_posY, m_textureWidth, bottom);
+
+  m_lineStamps[oldest] = m_renderStamp;
+  m_linesEvicted++;
+  return true;
+}
+
+void CGUIFontTTFBase::LoadGlyphCache(float aspect, bool border)
+{
+  m_glyphCache.clear();
+  m_glyphCacheIndex.clear();
+  m_glyphCacheDirty = false;
+  m_glyphCachePath.clear();
+
+  GlyphCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, "XBGC", 4);
+  header.version = GLYPH_CACHE_VERSION;
+  header.height  = m_height;
+  header.aspect  = aspect;
+  header.border  = border ? 1 : 0;
+  m_glyphCache.assign((unsigned char *)&header, (unsigned char *)&header + sizeof(header));
+
+  // glyphs are only written to disk if we can tell when the font changes
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(m_strFilename, &st) != 0)
+    return;
+  header.fontSize = st.st_size;
+  header.fontTime = st.st_mtime;
+  memcpy(&m_glyphCache[0], &header, sizeof(header));
+
+  CStdString key;
+  key.Format("%s|%f|%f|%d", m_strFilename.c_str(), m_height, aspect, header.border);
+  Crc32 crc;
+  crc.Compute(key);
+  m_glyphCachePath.Format(GLYPH_CACHE_PATH "%08x.glyphs", (uint32_t)crc);
+
+  XFILE::CFile file;
+  if (!file.Open(m_glyphCachePath))
+    return;
+
+  int64_t length = file.GetLength();
+  if (length > (int64_t)sizeof(header) && length <= GLYPH_CACHE_MAX_SIZE)
   {
-    // ensure our rect will stay inside the texture (it *should* but we need to be certain)
-    unsigned int x1 = max(m_posX + ch->offsetX, 0);
-    unsigned int y1 = max(m_posY + ch->offsetY, 0);
-    unsigned int x2 = min(x1 + bitmap.width, m_textureWidth);
-    unsigned int y2 = min(y1 + bitmap.rows, m_textureHeight);
-    CopyCharToTexture(bitGlyph, x1, y1, x2, y2);
+    std::vector<unsigned char> data((size_t)length);
+    if (file.Read(&data[0], length) == length && memcmp(&data[0], &header, sizeof(header)) == 0)
+    {
+      // index the records, ignoring anything truncated
+      size_t offset = sizeof(header);
+      while (offset + sizeof(GlyphCacheRecord) <= data.size())
+      {
+        GlyphCacheRecord record;
+        memcpy(&record, &data[offset], sizeof(record));
+        size_t size = sizeof(record) + record.width * record.rows;
+        if (offset + size > data.size())
+          break;
+        m_glyphCacheIndex[record.letterAndStyle] = offset;
+        offset += size;
+      }
+      data.resize(offset);
+      m_glyphCache.swap(data);
+    }
   }
-  m_posX += spacing_between_characters_in_texture + (unsigned short)max(ch->right - ch->left + ch->offsetX, ch->advance);
-  m_numChars++;
+  file.Close();
+}
 
-  m_textureScaleX = 1.0f / m_textureWidth;
-  m_textureScaleY = 1.0f / m_textureHeight;
+void CGUIFontTTFBase::SaveGlyphCache()
+{
+  if (!m_glyphCacheDirty || m_glyphCachePath.IsEmpty())
+    return;
+  m_glyphCacheDirty = false;
+
+  XFILE::CDirectory::Create(GLYPH_CACHE_PATH);
+  XFILE::CFile file;
+  if (!file.OpenForWrite(m_glyphCachePath, true) ||
+      file.Write(&m_glyphCache[0], m_glyphCache.size()) != (int)m_glyphCache.size())
+    CLog::Log(LOGWARNING, "%s: Unable to write glyph cache %s", __FUNCTION__, m_glyphCachePath.c_str());
+  file.Close();
+}
 
-  // free the glyph
-  FT_Done_Glyph(glyph);
+bool CGUIFontTTFBase::GetCachedGlyph(character_t letterAndStyle, Glyph &glyph) const
+{
+  std::map<character_t, size_t>::const_iterator i = m_glyphCacheIndex.find(letterAndStyle);
+  if (i == m_glyphCacheIndex.end())
+    return false;
 
+  GlyphCacheRecord record;
+  memcpy(&record, &m_glyphCache[i->second], sizeof(record));
+  glyph.left    = record.left;
+  glyph.top     = record.top;
+  glyph.width   = record.width;
+  glyph.rows    = record.rows;
+  glyph.pitch   = record.width;
+  glyph.pixels  = &m_glyphCache[i->second + sizeof(record)];
+  glyph.advance = record.advance;
   return true;
 }
 
+void CGUIFontTTFBase::AddCachedGlyph(character_t letterAndStyle, const Glyph &glyph)
+{
+  size_t offset = m_glyphCache.size();
+  if (offset + sizeof(GlyphCacheRecord) + glyph.width * glyph.rows > GLYPH_CACHE_MAX_SIZE)
+    return;
+
+  GlyphCacheRecord record;
+  record.letterAndStyle = letterAndStyle;
+  record.left    = (int16_t)glyph.left;
+  record.top     = (int16_t)glyph.top;
+  record.width   = (uint16_t)glyph.width;
+  record.rows    = (uint16_t)glyph.rows;
+  record.advance = glyph.advance;
+
+  m_glyphCache.resize(offset + sizeof(record) + glyph.width * glyph.rows);
+  memcpy(&m_glyphCache[offset], &record, sizeof(record));
+  unsigned char *dst = &m_glyphCache[offset + sizeof(record)];
+  for (unsigned int y = 0; y < glyph.rows; y++)
+    memcpy(dst + y * glyph.width, glyph.pixels + y * glyph.pitch, glyph.width);
+
+  m_glyphCacheIndex[letterAndStyle] = offset;
+  m_glyphCacheDirty = true;
+}
+
 void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX)
 {
   // actual image width isn't same as the character width as that is
@@ -663,6 +920,8 @@ void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *c
   const float width = ch->right - ch->left;
   const float height = ch->bottom - ch->top;
 
+  m_lineStamps[ch->row] = m_renderStamp;
+
   // posX and posY are relative to our origin, and the textcell is offset
   // from our (posX, posY).  Plus, these are unscaled quantities compared to the underlying GUI resolution
   CRect vertex((posX + ch->offsetX) * g_graphicsContext.GetGUIScaleX(),
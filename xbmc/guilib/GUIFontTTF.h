@@ -27,6 +27,8 @@
  *
  */
 
+#include <map>
+
 // forward definition
 class CBaseTexture;
 
@@ -89,6 +91,17 @@ protected:
     float left, top, right, bottom;
     float advance;
     character_t letterAndStyle;
+    unsigned short row;              // line of the texture the glyph lives in
+  };
+
+  /*! \brief A rasterised glyph, either straight from freetype or from the disk cache.
+   */
+  struct Glyph
+  {
+    int left, top;                   // bitmap offset from the pen position (freetype convention)
+    unsigned int width, rows, pitch;
+    const unsigned char *pixels;
+    float advance;
   };
   void AddReference();
   void RemoveReference();
@@ -109,11 +122,25 @@ protected:
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
+  bool StartTextureLine();
+  bool EvictTextureLine();
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX);
   void ClearCharacterCache();
 
+  /*! \brief Glyphs rasterised in previous sessions, keyed by font file, size, aspect and border.
+   The cache lives in special://temp/glyphs/ and is rewritten when the font is unloaded if
+   new glyphs were rasterised, so that startup skips the freetype work for the common glyphs.
+   */
+  void LoadGlyphCache(float aspect, bool border);
+  void SaveGlyphCache();
+  bool GetCachedGlyph(character_t letterAndStyle, Glyph &glyph) const;
+  void AddCachedGlyph(character_t letterAndStyle, const Glyph &glyph);
+
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight) = 0;
-  virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
+  /*! \brief Copy an 8 bit alpha bitmap into the (x1,y1)-(x2,y2) rectangle of the glyph texture.
+   Only the changed rectangle needs to reach the hardware texture.
+   */
+  virtual bool CopyCharToTexture(const unsigned char *pixels, unsigned int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
   virtual void DeleteHardwareTexture() = 0;
 
   // modifying glyphs
@@ -126,6 +153,9 @@ protected:
   unsigned int m_textureHeight;      // heigth of our texture
   int m_posX;                        // current position in the texture
   int m_posY;
+  bool m_textureFull;                // texture is at the maximum size, new lines evict old ones
+  std::vector<unsigned int> m_lineStamps; // last render stamp of each texture line, for LRU eviction
+  unsigned int m_renderStamp;        // incremented on each DrawTextInternal(), stamps the lines it uses
 
   /*! \brief the height of each line in the texture.
    Accounts for spacing between lines to avoid characters overlapping.
@@ -168,6 +198,16 @@ protected:
 
   CStdString m_strFileName;
 
+  CStdString m_glyphCachePath;
+  std::vector<unsigned char> m_glyphCache;             // glyph records, loaded and newly rasterised
+  std::map<character_t, size_t> m_glyphCacheIndex;     // offset of each glyph record in m_glyphCache
+  bool m_glyphCacheDirty;
+
+  // statistics, logged when the font is unloaded
+  unsigned int m_glyphsRasterised;
+  unsigned int m_glyphsFromCache;
+  unsigned int m_linesEvicted;
+
 private:
   int m_referenceCount;
 };
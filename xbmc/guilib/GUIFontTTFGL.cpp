@@ -42,10 +42,35 @@ using namespace std;
 
 #if defined(HAS_GL) || defined(HAS_GLES)
 
+#ifndef HAS_GL
+#define MAX_QUADS_PER_DRAW 16384 // keeps the vertex indices within a GLushort
+
+static const GLushort *GetQuadIndices()
+{
+  static std::vector<GLushort> indices;
+  if (indices.empty())
+  {
+    // quads are stored as triangle strips (top left, bottom left, top right, bottom right)
+    indices.reserve(MAX_QUADS_PER_DRAW * 6);
+    for (GLushort i = 0; i < MAX_QUADS_PER_DRAW; i++)
+    {
+      GLushort v = i * 4;
+      indices.push_back(v);
+      indices.push_back(v + 1);
+      indices.push_back(v + 2);
+      indices.push_back(v + 1);
+      indices.push_back(v + 3);
+      indices.push_back(v + 2);
+    }
+  }
+  return &indices[0];
+}
+#endif
 
 CGUIFontTTFGL::CGUIFontTTFGL(const CStdString& strFileName)
 : CGUIFontTTFBase(strFileName)
 {
+  m_updateY1 = m_updateY2 = 0;
 }
 
 CGUIFontTTFGL::~CGUIFontTTFGL(void)
@@ -76,6 +101,17 @@ void CGUIFontTTFGL::Begin()
 
       VerifyGLState();
       m_bTextureLoaded = true;
+      m_updateY1 = m_updateY2 = 0;
+    }
+    else if (m_updateY2 > m_updateY1)
+    {
+      // upload only the lines that new characters were cached into
+      glBindTexture(GL_TEXTURE_2D, m_nTexture);
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, m_updateY1, m_texture->GetWidth(), m_updateY2 - m_updateY1,
+                      GL_ALPHA, GL_UNSIGNED_BYTE, m_texture->GetPixels() + m_updateY1 * m_texture->GetPitch());
+
+      VerifyGLState();
+      m_updateY1 = m_updateY2 = 0;
     }
 
     // Turn Blending On
@@ -128,42 +164,36 @@ void CGUIFontTTFGL::End()
   glDrawArrays(GL_QUADS, 0, m_vertex_count);
   glPopClientAttrib();
 #else
-  // GLES 2.0 version. Cannot draw quads. Convert to triangles.
-  GLint posLoc  = g_Windowing.GUIShaderGetPos();
-  GLint colLoc  = g_Windowing.GUIShaderGetCol();
-  GLint tex0Loc = g_Windowing.GUIShaderGetCoord0();
-
-  // stack object until VBOs will be used
-  std::vector<SVertex> vecVertices( 6 * (m_vertex_count / 4) );
-  SVertex *vertices = &vecVertices[0];
-
-  for (int i=0; i<m_vertex_count; i+=4)
+  // GLES 2.0 version. Cannot draw quads, so each one is drawn as two triangles
+  // indexing the vertices we already have, in as few draw calls as possible.
+  if (m_vertex_count > 0)
   {
-    *vertices++ = m_vertex[i];
-    *vertices++ = m_vertex[i+1];
-    *vertices++ = m_vertex[i+2];
-
-    *vertices++ = m_vertex[i+1];
-    *vertices++ = m_vertex[i+3];
-    *vertices++ = m_vertex[i+2];
-  }
+    GLint posLoc  = g_Windowing.GUIShaderGetPos();
+    GLint colLoc  = g_Windowing.GUIShaderGetCol();
+    GLint tex0Loc = g_Windowing.GUIShaderGetCoord0();
+    const GLushort *indices = GetQuadIndices();
 
-  vertices = &vecVertices[0];
+    glEnableVertexAttribArray(posLoc);
+    glEnableVertexAttribArray(colLoc);
+    glEnableVertexAttribArray(tex0Loc);
 
-  glVertexAttribPointer(posLoc,  3, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, x));
-  // Normalize color values. Does not affect Performance at all.
-  glVertexAttribPointer(colLoc,  4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, r));
-  glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, u));
+    for (int start = 0; start < m_vertex_count; start += MAX_QUADS_PER_DRAW * 4)
+    {
+      SVertex *vertices = m_vertex + start;
+      int quads = std::min(m_vertex_count - start, MAX_QUADS_PER_DRAW * 4) / 4;
 
-  glEnableVertexAttribArray(posLoc);
-  glEnableVertexAttribArray(colLoc);
-  glEnableVertexAttribArray(tex0Loc);
+      glVertexAttribPointer(posLoc,  3, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, x));
+      // Normalize color values. Does not affect Performance at all.
+      glVertexAttribPointer(colLoc,  4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, r));
+      glVertexAttribPointer(tex0Loc, 2, GL_FLOAT,         GL_FALSE, sizeof(SVertex), (char*)vertices + offsetof(SVertex, u));
 
-  glDrawArrays(GL_TRIANGLES, 0, vecVertices.size());
+      glDrawElements(GL_TRIANGLES, quads * 6, GL_UNSIGNED_SHORT, indices);
+    }
 
-  glDisableVertexAttribArray(posLoc);
-  glDisableVertexAttribArray(colLoc);
-  glDisableVertexAttribArray(tex0Loc);
+    glDisableVertexAttribArray(posLoc);
+    glDisableVertexAttribArray(colLoc);
+    glDisableVertexAttribArray(tex0Loc);
+  }
 
   g_Windowing.DisableGUIShader();
 #endif
@@ -198,32 +228,39 @@ CBaseTexture* CGUIFontTTFGL::ReallocTexture(unsigned int& newHeight)
     delete m_texture;
   }
 
+  // the hardware texture has to be recreated at the new size
+  if (m_bTextureLoaded)
+  {
+    g_graphicsContext.BeginPaint();  //FIXME
+    DeleteHardwareTexture();
+    g_graphicsContext.EndPaint();
+  }
+
   return newTexture;
 }
 
-bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
+bool CGUIFontTTFGL::CopyCharToTexture(const unsigned char *pixels, unsigned int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
 {
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-
-  unsigned char* source = (unsigned char*) bitmap.buffer;
   unsigned char* target = (unsigned char*) m_texture->GetPixels() + y1 * m_texture->GetPitch() + x1;
 
   for (unsigned int y = y1; y < y2; y++)
   {
-    memcpy(target, source, x2-x1);
-    source += bitmap.width;
+    memcpy(target, pixels, x2-x1);
+    pixels += pitch;
     target += m_texture->GetPitch();
   }
-  // THE SOURCE VALUES ARE THE SAME IN BOTH SITUATIONS.
 
-  // Since we have a new texture, we need to delete the old one
-  // the Begin(); End(); stuff is handled by whoever called us
-  if (m_bTextureLoaded)
+  // the changed lines are uploaded on the next Begin(), which is
+  // handled by whoever called us
+  if (m_updateY2 > m_updateY1)
   {
-    g_graphicsContext.BeginPaint();  //FIXME
-    DeleteHardwareTexture();
-    g_graphicsContext.EndPaint();
-    m_bTextureLoaded = false;
+    m_updateY1 = std::min(m_updateY1, y1);
+    m_updateY2 = std::max(m_updateY2, y2);
+  }
+  else
+  {
+    m_updateY1 = y1;
+    m_updateY2 = y2;
   }
 
   return TRUE;
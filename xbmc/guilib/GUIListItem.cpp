@@ -20,6 +20,7 @@
 
 #include "GUIListItem.h"
 #include "GUIListItemLayout.h"
+#include "PropertyAtoms.h"
 #include "utils/Archive.h"
 #include "utils/CharsetConverter.h"
 #include "utils/Variant.h"
@@ -245,7 +246,8 @@ const CGUIListItem& CGUIListItem::operator =(const CGUIListItem& item)
   m_strIcon = item.m_strIcon;
   m_overlayIcon = item.m_overlayIcon;
   m_bIsFolder = item.m_bIsFolder;
-  m_mapProperties = item.m_mapProperties;
+  m_properties = item.m_properties;
+  m_namedProperties = item.m_namedProperties;
   m_art = item.m_art;
   m_artFallbacks = item.m_artFallbacks;
   SetInvalid();
@@ -263,8 +265,13 @@ void CGUIListItem::Archive(CArchive &ar)
     ar << m_strIcon;
     ar << m_bSelected;
     ar << m_overlayIcon;
-    ar << (int)m_mapProperties.size();
-    for (PropertyMap::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); it++)
+    ar << (int)(m_properties.size() + m_namedProperties.size());
+    for (PropertyList::const_iterator it = m_properties.begin(); it != m_properties.end(); it++)
+    {
+      ar << CPropertyAtoms::Get().GetName(it->name);
+      ar << it->value;
+    }
+    for (NamedPropertyList::const_iterator it = m_namedProperties.begin(); it != m_namedProperties.end(); it++)
     {
       ar << it->first;
       ar << it->second;
@@ -311,7 +318,7 @@ void CGUIListItem::Archive(CArchive &ar)
       std::string key, value;
       ar >> key;
       ar >> value;
-      m_art.insert(make_pair(key, value));
+      SetArt(key, value);
     }
     ar >> mapSize;
     for (int i = 0; i < mapSize; i++)
@@ -319,7 +326,7 @@ void CGUIListItem::Archive(CArchive &ar)
       std::string key, value;
       ar >> key;
       ar >> value;
-      m_artFallbacks.insert(make_pair(key, value));
+      SetArtFallback(key, value);
     }
   }
 }
@@ -332,10 +339,12 @@ void CGUIListItem::Serialize(CVariant &value)
   value["strIcon"] = m_strIcon;
   value["selected"] = m_bSelected;
 
-  for (PropertyMap::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); it++)
+  for (PropertyList::const_iterator it = m_properties.begin(); it != m_properties.end(); it++)
   {
-    value["properties"][it->first] = it->second;
+    value["properties"][CPropertyAtoms::Get().GetName(it->name)] = it->value;
   }
+  for (NamedPropertyList::const_iterator it = m_namedProperties.begin(); it != m_namedProperties.end(); it++)
+    value["properties"][it->first] = it->second;
   for (ArtMap::const_iterator it = m_art.begin(); it != m_art.end(); it++)
     value["art"][it->first] = it->second;
 }
@@ -394,37 +403,116 @@ void CGUIListItem::SetInvalid()
 
 void CGUIListItem::SetProperty(const CStdString &strKey, const CVariant &value)
 {
-  m_mapProperties[strKey] = value;
+  unsigned int key;
+  unsigned int name = CPropertyAtoms::Get().Intern(strKey, key);
+  if (key != CPropertyAtoms::NONE)
+  {
+    SetProperty(key, name, value);
+    return;
+  }
+
+  // the atom table is full, keep the name with the property
+  for (NamedPropertyList::iterator it = m_namedProperties.begin(); it != m_namedProperties.end(); ++it)
+  {
+    if (stricmp(it->first.c_str(), strKey.c_str()) == 0)
+    {
+      it->second = value;
+      return;
+    }
+  }
+  m_namedProperties.push_back(make_pair(strKey, value));
+}
+
+void CGUIListItem::SetProperty(unsigned int key, unsigned int name, const CVariant &value)
+{
+  for (PropertyList::iterator it = m_properties.begin(); it != m_properties.end(); ++it)
+  {
+    if (it->key == key)
+    {
+      it->value = value;
+      return;
+    }
+  }
+
+  Property property;
+  property.key = key;
+  property.name = name;
+  property.value = value;
+  m_properties.push_back(property);
+}
+
+const CVariant *CGUIListItem::FindProperty(const CStdString &strKey) const
+{
+  if (!HasProperties())
+    return NULL;
+
+  unsigned int key;
+  if (CPropertyAtoms::Get().Find(strKey, key))
+  {
+    for (PropertyList::const_iterator it = m_properties.begin(); it != m_properties.end(); ++it)
+    {
+      if (it->key == key)
+        return &it->value;
+    }
+    return NULL;
+  }
+
+  // names that are not in the table can only have been set once it was full
+  for (NamedPropertyList::const_iterator it = m_namedProperties.begin(); it != m_namedProperties.end(); ++it)
+  {
+    if (stricmp(it->first.c_str(), strKey.c_str()) == 0)
+      return &it->second;
+  }
+  return NULL;
 }
 
 CVariant CGUIListItem::GetProperty(const CStdString &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
+  const CVariant *value = FindProperty(strKey);
+  if (value == NULL)
     return CVariant(CVariant::VariantTypeNull);
 
-  return iter->second;
+  return *value;
 }
 
 bool CGUIListItem::HasProperty(const CStdString &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
-    return false;
-
-  return true;
+  return FindProperty(strKey) != NULL;
 }
 
 void CGUIListItem::ClearProperty(const CStdString &strKey)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
-  if (iter != m_mapProperties.end())
-    m_mapProperties.erase(iter);
+  if (!HasProperties())
+    return;
+
+  unsigned int key;
+  if (CPropertyAtoms::Get().Find(strKey, key))
+  {
+    for (PropertyList::iterator it = m_properties.begin(); it != m_properties.end(); ++it)
+    {
+      if (it->key == key)
+      {
+        m_properties.erase(it);
+        return;
+      }
+    }
+    return;
+  }
+
+  for (NamedPropertyList::iterator it = m_namedProperties.begin(); it != m_namedProperties.end(); ++it)
+  {
+    if (stricmp(it->first.c_str(), strKey.c_str()) == 0)
+    {
+      m_namedProperties.erase(it);
+      return;
+    }
+  }
 }
 
 void CGUIListItem::ClearProperties()
 {
-  m_mapProperties.clear();
+  m_properties.clear();
+  m_namedProperties.clear();
 }
 
 void CGUIListItem::IncrementProperty(const CStdString &strKey, int nVal)
@@ -443,6 +531,31 @@ void CGUIListItem::IncrementProperty(const CStdString &strKey, double dVal)
 
 void CGUIListItem::AppendProperties(const CGUIListItem &item)
 {
-  for (PropertyMap::const_iterator i = item.m_mapProperties.begin(); i != item.m_mapProperties.end(); ++i)
+  for (PropertyList::const_iterator i = item.m_properties.begin(); i != item.m_properties.end(); ++i)
+    SetProperty(i->key, i->name, i->value);
+  for (NamedPropertyList::const_iterator i = item.m_namedProperties.begin(); i != item.m_namedProperties.end(); ++i)
     SetProperty(i->first, i->second);
 }
+
+size_t CGUIListItem::GetMemoryUsage() const
+{
+  size_t size = sizeof(CGUIListItem);
+  size += m_strLabel.capacity() + m_strLabel2.capacity() + m_strIcon.capacity();
+  size += m_sortLabel.capacity() * sizeof(wchar_t);
+
+  size += m_properties.capacity() * sizeof(Property);
+  for (PropertyList::const_iterator i = m_properties.begin(); i != m_properties.end(); ++i)
+    size += i->value.size() * (i->value.isString() ? 1 : sizeof(CVariant));
+  size += m_namedProperties.capacity() * sizeof(NamedPropertyList::value_type);
+  for (NamedPropertyList::const_iterator i = m_namedProperties.begin(); i != m_namedProperties.end(); ++i)
+    size += i->first.capacity() + i->second.size() * (i->second.isString() ? 1 : sizeof(CVariant));
+
+  // each map node holds its pair plus the tree links and colour
+  size += (m_art.size() + m_artFallbacks.size()) * (sizeof(ArtMap::value_type) + 4 * sizeof(void *));
+  for (ArtMap::const_iterator i = m_art.begin(); i != m_art.end(); ++i)
+    size += i->first.capacity() + i->second.capacity();
+  for (ArtMap::const_iterator i = m_artFallbacks.begin(); i != m_artFallbacks.end(); ++i)
+    size += i->first.capacity() + i->second.capacity();
+
+  return size;
+}
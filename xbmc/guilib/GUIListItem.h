@@ -29,14 +29,15 @@
  */
 
 #include "utils/StdString.h"
+#include "utils/Variant.h"
 
 #include <map>
 #include <string>
+#include <vector>
 
 //  Forward
 class CGUIListItemLayout;
 class CArchive;
-class CVariant;
 
 /*!
  \ingroup controls
@@ -128,6 +129,12 @@ public:
    */
   bool HasArt(const std::string &type) const;
 
+  /*! \brief Check whether an item has any art
+   Equivalent to !GetArt().empty()
+   \return true if the item has art set, false otherwise.
+   */
+  bool HasArt() const { return !m_art.empty(); };
+
   void SetSortLabel(const CStdString &label);
   void SetSortLabel(const CStdStringW &label);
   const CStdStringW &GetSortLabel() const;
@@ -169,11 +176,17 @@ public:
   void Serialize(CVariant& value);
 
   bool       HasProperty(const CStdString &strKey) const;
-  bool       HasProperties() const { return m_mapProperties.size() > 0; };
+  bool       HasProperties() const { return !m_properties.empty() || !m_namedProperties.empty(); };
   void       ClearProperty(const CStdString &strKey);
 
   CVariant   GetProperty(const CStdString &strKey) const;
 
+  /*! \brief Estimate the memory used by this item
+   Counts the item itself and the heap memory of its labels, properties and art.
+   \return the approximate size of the item in bytes
+   */
+  virtual size_t GetMemoryUsage() const;
+
 protected:
   CStdString m_strLabel2;     // text of column2
   CStdString m_strIcon;      // filename of icon
@@ -183,17 +196,30 @@ protected:
   CGUIListItemLayout *m_focusedLayout;
   bool m_bSelected;     // item is selected or not
 
-  struct icompare
+  /*! \brief A property of the item.
+   Property names are interned process wide, so an item only keeps the atom of
+   the name as it was set and the atom of its lower cased form, which is what
+   the (case insensitive) lookups compare. Items rarely carry more than a few
+   dozen properties, so they are kept in a flat vector.
+   \sa CPropertyAtoms
+   */
+  struct Property
   {
-    bool operator()(const CStdString &s1, const CStdString &s2) const
-    {
-      return s1.CompareNoCase(s2) < 0;
-    }
+    unsigned int key;   ///< atom of the lower cased name
+    unsigned int name;  ///< atom of the name as it was first set
+    CVariant value;
   };
 
-  typedef std::map<CStdString, CVariant, icompare> PropertyMap;
-  PropertyMap m_mapProperties;
+  typedef std::vector<Property> PropertyList;
+  PropertyList m_properties;
+
+  /*! \brief Properties whose names were first set once the atom table was full */
+  typedef std::vector< std::pair<std::string, CVariant> > NamedPropertyList;
+  NamedPropertyList m_namedProperties;
 private:
+  void SetProperty(unsigned int key, unsigned int name, const CVariant &value);
+  const CVariant *FindProperty(const CStdString &strKey) const;
+
   CStdStringW m_sortLabel;    // text for sorting. Need to be UTF16 for proper sorting
   CStdString m_strLabel;      // text of column1
 
@@ -248,6 +248,7 @@ void CGUITextureBase::Render(float left, float top, float right, float bottom, f
 
   int orientation = GetOrientation();
   OrientateTexture(texture, u3, v3, orientation);
+  texture += m_atlasOffset;
 
   if (m_diffuse.size())
   {
@@ -257,6 +258,7 @@ void CGUITextureBase::Render(float left, float top, float right, float bottom, f
     diffuse.y1 *= m_diffuseScaleV / v3; diffuse.y2 *= m_diffuseScaleV / v3;
     diffuse += m_diffuseOffset;
     OrientateTexture(diffuse, m_diffuseU, m_diffuseV, m_info.orientation);
+    diffuse += m_diffuseAtlasOffset;
   }
 
   float x[4], y[4], z[4];
@@ -365,6 +367,10 @@ bool CGUITextureBase::CalculateSize()
 
   m_texCoordsScaleU = 1.0f / m_texture.m_texWidth;
   m_texCoordsScaleV = 1.0f / m_texture.m_texHeight;
+  if (m_texture.m_texCoordsArePixels)
+    m_atlasOffset = CPoint((float)m_texture.m_atlasX, (float)m_texture.m_atlasY);
+  else
+    m_atlasOffset = CPoint(m_texture.m_atlasX * m_texCoordsScaleU, m_texture.m_atlasY * m_texCoordsScaleV);
 
   if (m_width == 0)
     m_width = m_frameWidth;
@@ -424,11 +430,13 @@ bool CGUITextureBase::CalculateSize()
     {
       m_diffuseU = float(m_diffuse.m_width);
       m_diffuseV = float(m_diffuse.m_height);
+      m_diffuseAtlasOffset = CPoint((float)m_diffuse.m_atlasX, (float)m_diffuse.m_atlasY);
     }
     else
     {
       m_diffuseU = float(m_diffuse.m_width) / float(m_diffuse.m_texWidth);
       m_diffuseV = float(m_diffuse.m_height) / float(m_diffuse.m_texHeight);
+      m_diffuseAtlasOffset = CPoint(float(m_diffuse.m_atlasX) / float(m_diffuse.m_texWidth), float(m_diffuse.m_atlasY) / float(m_diffuse.m_texHeight));
     }
 
     if (m_aspect.scaleDiffuse)
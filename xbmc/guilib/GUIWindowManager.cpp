@@ -34,6 +34,7 @@
 #include "GUITexture.h"
 #include "windowing/WindowingFactory.h"
 #include "utils/Variant.h"
+#include "utils/TimeUtils.h"
 
 using namespace std;
 
@@ -525,6 +526,11 @@ void CGUIWindowManager::MarkDirty(const CRect& rect)
   m_tracker.MarkDirtyRegion(rect);
 }
 
+void CGUIWindowManager::SetBufferAge(int age)
+{
+  m_tracker.SetBufferAge(age);
+}
+
 void CGUIWindowManager::RenderPass()
 {
   CGUIWindow* pWindow = GetWindow(GetActiveWindow());
@@ -551,12 +557,19 @@ bool CGUIWindowManager::Render()
   CSingleLock lock(g_graphicsContext);
 
   CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions();
+  CDirtyRegionList renderedRegions;
+
+  // CPU submit time only, the GPU catches up asynchronously. Reading back timer
+  // queries would need the regions kept until the result arrives a frame or two
+  // later, the adaptive solver copes with the underestimate by leaning to the union.
+  int64_t start = CurrentHostCounter();
 
   bool hasRendered = false;
   // If we visualize the regions we will always render the entire viewport
   if (g_advancedSettings.m_guiVisualizeDirtyRegions || g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_FILL_VIEWPORT_ALWAYS)
   {
     RenderPass();
+    renderedRegions.push_back(g_graphicsContext.GetViewWindow());
     hasRendered = true;
   }
   else if (g_advancedSettings.m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_FILL_VIEWPORT_ON_CHANGE)
@@ -564,6 +577,7 @@ bool CGUIWindowManager::Render()
     if (dirtyRegions.size() > 0)
     {
       RenderPass();
+      renderedRegions.push_back(g_graphicsContext.GetViewWindow());
       hasRendered = true;
     }
   }
@@ -576,11 +590,14 @@ bool CGUIWindowManager::Render()
 
       g_graphicsContext.SetScissors(*i);
       RenderPass();
+      renderedRegions.push_back(*i);
       hasRendered = true;
     }
     g_graphicsContext.ResetScissors();
   }
 
+  m_tracker.UpdateRenderCost(renderedRegions, 1000.0f * (CurrentHostCounter() - start) / CurrentHostFrequency());
+
   if (g_advancedSettings.m_guiVisualizeDirtyRegions)
   {
     g_graphicsContext.SetRenderingResolution(g_graphicsContext.GetResInfo(), false);
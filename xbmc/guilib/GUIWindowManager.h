@@ -80,6 +80,12 @@ public:
    */
   void MarkDirty(const CRect& rect);
 
+  /*! \brief Set the age of the back buffer the next frame is rendered to
+   \param age number of frames the back buffer is old, 0 if undefined or -1 if unknown
+   \sa CRenderSystemBase::GetBufferAge
+   */
+  void SetBufferAge(int age);
+
   /*! \brief Get the current dirty region
    */
   CDirtyRegionList GetDirty() { return m_tracker.GetDirtyRegions(); }
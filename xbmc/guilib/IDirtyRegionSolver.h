@@ -25,6 +25,7 @@
 #define DIRTYREGION_SOLVER_UNION 1
 #define DIRTYREGION_SOLVER_COST_REDUCTION 2
 #define DIRTYREGION_SOLVER_FILL_VIEWPORT_ON_CHANGE 3
+#define DIRTYREGION_SOLVER_ADAPTIVE 4
 
 class IDirtyRegionSolver
 {
@@ -33,4 +34,7 @@ public:
 
   // Takes a number of dirty regions which will become a number of needed rendering passes.
   virtual void Solve(const CDirtyRegionList &input, CDirtyRegionList &output) = 0;
+
+  // Feedback on how long the last solution took to render, solvers that model the cost may use it.
+  virtual void UpdateCost(unsigned int passes, float area, float renderTime) { }
 };
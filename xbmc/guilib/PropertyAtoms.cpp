@@ -0,0 +1,150 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "PropertyAtoms.h"
+#include "threads/Atomics.h"
+#include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+
+#include <ctype.h>
+#include <string.h>
+
+using namespace std;
+
+CPropertyAtoms::CPropertyAtoms(unsigned int capacity)
+{
+  m_capacity = capacity;
+  m_size = 0;
+
+  // keep the hash at most half full, so that probes are short and always end
+  unsigned int slots = 2;
+  while (slots < 2 * capacity)
+    slots <<= 1;
+  m_mask = slots - 1;
+  m_slots = new unsigned int[slots];
+  memset((void *)m_slots, 0, slots * sizeof(unsigned int));
+  m_atoms = new Atom[capacity];
+}
+
+CPropertyAtoms::~CPropertyAtoms()
+{
+  delete[] m_slots;
+  delete[] m_atoms;
+}
+
+CPropertyAtoms &CPropertyAtoms::Get()
+{
+  static CPropertyAtoms atoms;
+  return atoms;
+}
+
+unsigned int CPropertyAtoms::Hash(const std::string &name)
+{
+  // FNV-1a of the lower cased name, so that all spellings share a probe sequence
+  unsigned int hash = 2166136261U;
+  for (string::const_iterator i = name.begin(); i != name.end(); ++i)
+  {
+    hash ^= (unsigned char)tolower((unsigned char)*i);
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+unsigned int CPropertyAtoms::Probe(const std::string &name, bool exact, unsigned int &slot) const
+{
+  for (slot = Hash(name) & m_mask; ; slot = (slot + 1) & m_mask)
+  {
+    unsigned int entry = m_slots[slot];
+    if (!entry)
+      return NONE;
+
+    // the atom is only read through the published slot, so the loads are ordered after it
+    const Atom &atom = m_atoms[entry - 1];
+    if (exact ? atom.name == name : stricmp(atom.name.c_str(), name.c_str()) == 0)
+      return entry - 1;
+  }
+}
+
+unsigned int CPropertyAtoms::Add(const std::string &name, unsigned int key)
+{
+  if (m_size >= m_capacity)
+    return NONE;
+
+  unsigned int slot;
+  Probe(name, true, slot);
+
+  unsigned int atom = m_size;
+  m_atoms[atom].name = name;
+  m_atoms[atom].key = key == NONE ? atom : key;
+
+  // make the atom visible before the slot that leads to it
+  AtomicMemoryBarrier();
+  m_slots[slot] = atom + 1;
+  m_size = atom + 1;
+  return atom;
+}
+
+unsigned int CPropertyAtoms::Intern(const std::string &name, unsigned int &key)
+{
+  unsigned int slot;
+  unsigned int atom = Probe(name, true, slot);
+  if (atom != NONE)
+  {
+    key = m_atoms[atom].key;
+    return atom;
+  }
+
+  CSingleLock lock(m_section);
+  if ((atom = Probe(name, true, slot)) != NONE)
+  { // added while we waited for the lock
+    key = m_atoms[atom].key;
+    return atom;
+  }
+
+  if ((atom = Probe(name, false, slot)) != NONE)
+    key = m_atoms[atom].key;
+  else
+  {
+    string lower(name);
+    StringUtils::ToLower(lower);
+    if ((key = Add(lower, NONE)) == NONE || lower == name)
+      return key;
+  }
+
+  // a new spelling of a known name, fall back to the key if it doesn't fit
+  atom = Add(name, key);
+  return atom != NONE ? atom : key;
+}
+
+bool CPropertyAtoms::Find(const std::string &name, unsigned int &key) const
+{
+  unsigned int slot;
+  unsigned int atom = Probe(name, false, slot);
+  if (atom == NONE)
+    return false;
+  key = m_atoms[atom].key;
+  return true;
+}
+
+const std::string &CPropertyAtoms::GetName(unsigned int atom) const
+{
+  static const std::string empty;
+  return atom < m_capacity ? m_atoms[atom].name : empty;
+}
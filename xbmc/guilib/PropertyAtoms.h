@@ -0,0 +1,90 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+
+#include <string>
+
+/*!
+ \ingroup controls
+ \brief Process wide table of list item property names.
+
+ Every spelling of a name gets an atom, which maps to the atom of its lower cased
+ spelling (its key) for the case insensitive lookups. Skins and list fillers use a
+ small set of names over and over, so items only need to keep the atoms.
+
+ Lookups neither lock nor allocate. Adding a name takes a lock and publishes the
+ new atom with a memory barrier, so readers see either no atom or a complete one.
+ The table has a fixed capacity and atoms are never removed, so an atom and its
+ name stay valid for the life of the table. Once it is full, Intern() returns NONE
+ and callers have to keep the name themselves.
+ */
+class CPropertyAtoms
+{
+public:
+  static const unsigned int NONE = (unsigned int)-1;
+
+  CPropertyAtoms(unsigned int capacity = 4096);
+  ~CPropertyAtoms();
+
+  /*! \brief The table shared by all list items */
+  static CPropertyAtoms &Get();
+
+  /*! \brief Retrieve the atoms of a name, adding them if needed
+   \param name the name to intern
+   \param key [out] the atom of the lower cased name, NONE if the table is full
+   \return the atom of the name as spelled, the key if only the spelling didn't fit, NONE if the table is full
+   */
+  unsigned int Intern(const std::string &name, unsigned int &key);
+
+  /*! \brief Retrieve the key of a name without adding it
+   \param name the name to look up, in any case
+   \param key [out] the atom of the lower cased name
+   \return true if the name is in the table, false otherwise
+   */
+  bool Find(const std::string &name, unsigned int &key) const;
+
+  /*! \brief Retrieve the name of an atom
+   \return the name, or an empty string for NONE
+   */
+  const std::string &GetName(unsigned int atom) const;
+
+  unsigned int Size() const { return m_size; };
+  unsigned int Capacity() const { return m_capacity; };
+
+private:
+  struct Atom
+  {
+    std::string name;
+    unsigned int key;
+  };
+
+  static unsigned int Hash(const std::string &name);
+  unsigned int Probe(const std::string &name, bool exact, unsigned int &slot) const;
+  unsigned int Add(const std::string &name, unsigned int key);
+
+  CCriticalSection m_section; ///< serialises Add()
+  Atom *m_atoms;
+  volatile unsigned int *m_slots; ///< open addressed hash of the names, atom + 1 or 0 if empty
+  unsigned int m_mask;
+  unsigned int m_capacity;
+  volatile unsigned int m_size;
+};
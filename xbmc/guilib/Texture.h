@@ -79,6 +79,12 @@ public:
   virtual void CreateTextureObject() = 0;
   virtual void DestroyTextureObject() = 0;
   virtual void LoadToGPU() = 0;
+  /*! \brief Upload part of the texture to the GPU
+   Uploads at most the next maxRows rows, allowing a large texture to be uploaded over several frames.
+   \param maxRows the maximum number of rows to upload.
+   \return true once the texture is completely uploaded and ready to be rendered.
+   */
+  virtual bool LoadToGPUPartial(unsigned int maxRows) { LoadToGPU(); return true; }
   virtual void BindToUnit(unsigned int unit) = 0;
 
   unsigned char* GetPixels() const { return m_pixels; }
@@ -103,6 +103,13 @@ int CTextureBundle::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextu
   }
 }
 
+bool CTextureBundle::GetAtlas(const CStdString& Filename, CStdString &page, int &x, int &y, int &width, int &height)
+{
+  if (m_useXBT)
+    return m_tbXBT.GetAtlas(Filename, page, x, y, width, height);
+  return false; // XPR bundles have no atlas pages
+}
+
 void CTextureBundle::Cleanup()
 {
   m_tbXBT.Cleanup();
@@ -41,6 +41,8 @@ public:
 
   int LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextures, int &width, int &height, int& nLoops, int** ppDelays);
 
+  bool GetAtlas(const CStdString& Filename, CStdString &page, int &x, int &y, int &width, int &height);
+
 private:
   CTextureBundleXPR m_tbXPR;
   CTextureBundleXBT m_tbXBT;
@@ -145,6 +145,11 @@ bool CTextureBundleXBT::LoadTexture(const CStdString& Filename, CBaseTexture** p
     return false;
 
   CXBTFFrame& frame = file->GetFrames().at(0);
+  if (frame.GetAtlas() != XBTF_NO_ATLAS)
+  {
+    CLog::Log(LOGERROR, "Texture %s is packed in an atlas and can't be loaded on its own", Filename.c_str());
+    return false;
+  }
   if (!ConvertFrameToTexture(Filename, frame, ppTexture))
   {
     return false;
@@ -191,6 +196,27 @@ int CTextureBundleXBT::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTe
   return nTextures;
 }
 
+bool CTextureBundleXBT::GetAtlas(const CStdString& Filename, CStdString &page, int &x, int &y, int &width, int &height)
+{
+  CStdString name = Normalize(Filename);
+
+  CXBTFFile* file = m_XBTFReader.Find(name);
+  if (!file || file->GetFrames().size() != 1)
+    return false;
+
+  CXBTFFrame& frame = file->GetFrames().at(0);
+  CXBTFFile* atlas = m_XBTFReader.FindAtlasPage(frame);
+  if (!atlas)
+    return false;
+
+  page = atlas->GetPath();
+  x = frame.GetAtlasX();
+  y = frame.GetAtlasY();
+  width = frame.GetWidth();
+  height = frame.GetHeight();
+  return true;
+}
+
 bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
 {
   // found texture - allocate the necessary buffers
@@ -44,6 +44,17 @@ public:
   int LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextures,
                 int &width, int &height, int& nLoops, int** ppDelays);
 
+  /*! \brief Find where a texture was packed into an atlas page.
+   \param Filename the texture to look up.
+   \param page [out] name of the bundled page holding the texture.
+   \param x [out] left edge of the texture within the page, in pixels.
+   \param y [out] top edge of the texture within the page, in pixels.
+   \param width [out] width of the texture, in pixels.
+   \param height [out] height of the texture, in pixels.
+   \return true if the texture lives in an atlas page, false if it is stored on its own.
+   */
+  bool GetAtlas(const CStdString& Filename, CStdString &page, int &x, int &y, int &width, int &height);
+
 private:
   bool OpenBundle();
   bool ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture);
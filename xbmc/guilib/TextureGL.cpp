@@ -23,6 +23,7 @@
 #include "windowing/WindowingFactory.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
+#include <algorithm>
 
 #if defined(HAS_GL) || defined(HAS_GLES)
 
@@ -35,6 +36,13 @@ CGLTexture::CGLTexture(unsigned int width, unsigned int height, unsigned int for
 : CBaseTexture(width, height, format)
 {
   m_texture = 0;
+  m_uploadedRows = 0;
+#ifdef HAS_GL
+  m_pbo = 0;
+#ifdef GL_ARB_sync
+  m_fence = 0;
+#endif
+#endif
 }
 
 CGLTexture::~CGLTexture()
@@ -51,6 +59,20 @@ void CGLTexture::DestroyTextureObject()
 {
   if (m_texture)
     glDeleteTextures(1, (GLuint*) &m_texture);
+#ifdef HAS_GL
+  if (m_pbo)
+  {
+    glDeleteBuffersARB(1, &m_pbo);
+    m_pbo = 0;
+  }
+#ifdef GL_ARB_sync
+  if (m_fence)
+  {
+    glDeleteSync(m_fence);
+    m_fence = 0;
+  }
+#endif
+#endif
 }
 
 void CGLTexture::LoadToGPU()
@@ -90,37 +112,30 @@ void CGLTexture::LoadToGPU()
     m_textureWidth = maxSize;
   }
 
-  GLenum format = GL_BGRA;
-  GLint numcomponents = GL_RGBA;
-
-  switch (m_format)
-  {
-  case XB_FMT_DXT1:
-    format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
-    break;
-  case XB_FMT_DXT3:
-    format = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
-    break;
-  case XB_FMT_DXT5:
-  case XB_FMT_DXT5_YCoCg:
-    format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
-    break;
-  case XB_FMT_RGB8:
-    format = GL_RGB;
-    numcomponents = GL_RGB;
-    break;
-  case XB_FMT_A8R8G8B8:
-  default:
-    break;
-  }
-
   if ((m_format & XB_FMT_DXT_MASK) == 0)
   {
-    glTexImage2D(GL_TEXTURE_2D, 0, numcomponents, m_textureWidth, m_textureHeight, 0,
-      format, GL_UNSIGNED_BYTE, m_pixels);
+    GLint internalformat;
+    GLenum pixelformat;
+    GetUploadFormat(internalformat, pixelformat, true);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalformat, m_textureWidth, m_textureHeight, 0,
+      pixelformat, GL_UNSIGNED_BYTE, m_pixels);
   }
   else
   {
+    GLenum format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+    switch (m_format)
+    {
+    case XB_FMT_DXT1:
+      format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+      break;
+    case XB_FMT_DXT3:
+      format = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+      break;
+    case XB_FMT_DXT5:
+    case XB_FMT_DXT5_YCoCg:
+    default:
+      break;
+    }
     // changed from glCompressedTexImage2D to support GL < 1.3
     glCompressedTexImage2DARB(GL_TEXTURE_2D, 0, format,
       m_textureWidth, m_textureHeight, 0, GetPitch() * GetRows(), m_pixels);
@@ -131,6 +146,94 @@ void CGLTexture::LoadToGPU()
     m_textureWidth = maxSize;
   }
 
+  GLint internalformat;
+  GLenum pixelformat;
+  GetUploadFormat(internalformat, pixelformat, true);
+  glTexImage2D(GL_TEXTURE_2D, 0, internalformat, m_textureWidth, m_textureHeight, 0,
+    pixelformat, GL_UNSIGNED_BYTE, m_pixels);
+
+#endif
+  VerifyGLState();
+
+  delete [] m_pixels;
+  m_pixels = NULL;
+
+  m_loadedToGPU = true;
+}
+
+bool CGLTexture::LoadToGPUPartial(unsigned int maxRows)
+{
+  if (!m_pixels)
+    return IsUploadComplete();
+
+  // compressed and oversized textures are not split
+  unsigned int maxSize = g_Windowing.GetMaxTextureSize();
+  if ((m_format & XB_FMT_DXT_MASK) || m_textureWidth > maxSize || m_textureHeight > maxSize)
+  {
+    LoadToGPU();
+    return true;
+  }
+
+  GLint internalformat;
+  GLenum pixelformat;
+  if (m_uploadedRows == 0)
+  {
+    if (m_texture == 0)
+      CreateTextureObject();
+
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // allocate the storage, the pixels follow in the subsequent calls
+    GetUploadFormat(internalformat, pixelformat, true);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalformat, m_textureWidth, m_textureHeight, 0,
+      pixelformat, GL_UNSIGNED_BYTE, NULL);
+  }
+  else
+  {
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    GetUploadFormat(internalformat, pixelformat, false);
+  }
+
+  unsigned int rows = std::min(std::max(maxRows, 1U), m_textureHeight - m_uploadedRows);
+  UploadRows(m_uploadedRows, rows, pixelformat);
+  m_uploadedRows += rows;
+  VerifyGLState();
+
+  if (m_uploadedRows < m_textureHeight)
+    return false;
+
+  delete [] m_pixels;
+  m_pixels = NULL;
+  m_uploadedRows = 0;
+  m_loadedToGPU = true;
+
+#ifdef HAS_GL
+  if (m_pbo)
+  {
+    glDeleteBuffersARB(1, &m_pbo);
+    m_pbo = 0;
+  }
+#ifdef GL_ARB_sync
+  // gate the first use of the texture on the GPU having consumed the upload
+  if (GLEW_ARB_sync)
+    m_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
+#endif
+  return IsUploadComplete();
+}
+
+void CGLTexture::GetUploadFormat(GLint &internalformat, GLenum &pixelformat, bool convert)
+{
+#ifndef HAS_GLES
+  internalformat = GL_RGBA;
+  pixelformat = GL_BGRA;
+  if (m_format == XB_FMT_RGB8)
+    internalformat = pixelformat = GL_RGB;
+#else
   // All incoming textures are BGRA, which GLES does not necessarily support.
   // Some (most?) hardware supports BGRA textures via an extension.
   // If not, we convert to RGBA first to avoid having to swizzle in shaders.
@@ -140,9 +243,6 @@ void CGLTexture::LoadToGPU()
 #define GL_BGRA_EXT 0x80E1
 #endif
 
-  GLint internalformat;
-  GLenum pixelformat;
-
   switch (m_format)
   {
     default:
@@ -166,21 +266,56 @@ void CGLTexture::LoadToGPU()
       }
       else
       {
-        SwapBlueRed(m_pixels, m_textureHeight, GetPitch());
+        if (convert)
+          SwapBlueRed(m_pixels, m_textureHeight, GetPitch());
         internalformat = pixelformat = GL_RGBA;
       }
       break;
   }
-  glTexImage2D(GL_TEXTURE_2D, 0, internalformat, m_textureWidth, m_textureHeight, 0,
-    pixelformat, GL_UNSIGNED_BYTE, m_pixels);
-
 #endif
-  VerifyGLState();
+}
 
-  delete [] m_pixels;
-  m_pixels = NULL;
+void CGLTexture::UploadRows(unsigned int row, unsigned int rows, GLenum pixelformat)
+{
+  const unsigned char *pixels = m_pixels + row * GetPitch();
+#ifdef HAS_GL
+  // stream through a pixel buffer object so the driver copies asynchronously
+  if (GLEW_ARB_pixel_buffer_object)
+  {
+    if (!m_pbo)
+      glGenBuffersARB(1, &m_pbo);
 
-  m_loadedToGPU = true;
+    unsigned int size = rows * GetPitch();
+    glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, m_pbo);
+    glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, size, NULL, GL_STREAM_DRAW_ARB);
+    void *pboPtr = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+    if (pboPtr)
+    {
+      memcpy(pboPtr, pixels, size);
+      glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, row, m_textureWidth, rows, pixelformat, GL_UNSIGNED_BYTE, NULL);
+      glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+      return;
+    }
+    glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+  }
+#endif
+  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, row, m_textureWidth, rows, pixelformat, GL_UNSIGNED_BYTE, pixels);
+}
+
+bool CGLTexture::IsUploadComplete()
+{
+#if defined(HAS_GL) && defined(GL_ARB_sync)
+  if (m_fence)
+  {
+    GLenum result = glClientWaitSync(m_fence, 0, 0);
+    if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+      return false;
+    glDeleteSync(m_fence);
+    m_fence = 0;
+  }
+#endif
+  return m_loadedToGPU;
 }
 
 void CGLTexture::BindToUnit(unsigned int unit)
@@ -38,10 +38,22 @@ public:
   void CreateTextureObject();
   virtual void DestroyTextureObject();
   void LoadToGPU();
+  bool LoadToGPUPartial(unsigned int maxRows);
   void BindToUnit(unsigned int unit);
 
 private:
+  void GetUploadFormat(GLint &internalformat, GLenum &pixelformat, bool convert);
+  void UploadRows(unsigned int row, unsigned int rows, GLenum pixelformat);
+  bool IsUploadComplete();
+
   GLuint m_texture;
+  unsigned int m_uploadedRows; ///< rows already uploaded by LoadToGPUPartial()
+#ifdef HAS_GL
+  GLuint m_pbo;
+#ifdef GL_ARB_sync
+  GLsync m_fence;
+#endif
+#endif
 };
 
 #endif
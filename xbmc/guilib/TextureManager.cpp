@@ -49,6 +49,8 @@ CTextureArray::CTextureArray(int width, int height, int loops,  bool texCoordsAr
   m_orientation = 0;
   m_texWidth = 0;
   m_texHeight = 0;
+  m_atlasX = 0;
+  m_atlasY = 0;
   m_texCoordsArePixels = false;
 }
 
@@ -78,6 +80,8 @@ void CTextureArray::Reset()
   m_orientation = 0;
   m_texWidth = 0;
   m_texHeight = 0;
+  m_atlasX = 0;
+  m_atlasY = 0;
   m_texCoordsArePixels = false;
 }
 
@@ -192,7 +196,10 @@ void CTextureMap::Flush()
 
 void CTextureMap::FreeTexture()
 {
-  m_texture.Free();
+  if (m_atlasPage.IsEmpty())
+    m_texture.Free();
+  else
+    m_texture.Reset(); // the texture belongs to the page's map
 }
 
 bool CTextureMap::IsEmpty() const
@@ -208,6 +215,19 @@ void CTextureMap::Add(CBaseTexture* texture, int delay)
     m_memUsage += sizeof(CTexture) + (texture->GetTextureWidth() * texture->GetTextureHeight() * 4);
 }
 
+void CTextureMap::SetAtlas(const CStdString& pageName, const CTextureArray& page, int x, int y)
+{
+  assert(!m_texture.m_textures.size() && page.m_textures.size() == 1);
+  m_atlasPage = pageName;
+  m_texture.m_textures = page.m_textures;
+  m_texture.m_delays = page.m_delays;
+  m_texture.m_texWidth = page.m_texWidth;
+  m_texture.m_texHeight = page.m_texHeight;
+  m_texture.m_texCoordsArePixels = page.m_texCoordsArePixels;
+  m_texture.m_atlasX = x;
+  m_texture.m_atlasY = y;
+}
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -392,6 +412,42 @@ int CGUITextureManager::Load(const CStdString& strTextureName, bool checkBundleO
 
   CBaseTexture *pTexture = NULL;
   int width = 0, height = 0;
+  CStdString atlasPage;
+  int atlasX = 0, atlasY = 0;
+  if (bundle >= 0 && m_TexBundle[bundle].GetAtlas(strTextureName, atlasPage, atlasX, atlasY, width, height))
+  {
+    // packed into an atlas page - share the page's texture rather than loading our own
+    CStdString pageName;
+    pageName.Format("%d:%s", bundle, atlasPage.c_str());
+    CTextureMap* pPage = NULL;
+    for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+    {
+      if (m_vecTextures[i]->GetName() == pageName)
+      {
+        pPage = m_vecTextures[i];
+        break;
+      }
+    }
+    if (!pPage)
+    {
+      int pageWidth = 0, pageHeight = 0;
+      if (!m_TexBundle[bundle].LoadTexture(atlasPage, &pTexture, pageWidth, pageHeight) || !pTexture)
+      {
+        CLog::Log(LOGERROR, "Texture manager unable to load atlas page %s for %s", atlasPage.c_str(), strTextureName.c_str());
+        return 0;
+      }
+      pPage = new CTextureMap(pageName, pageWidth, pageHeight, 0);
+      pPage->Add(pTexture, 100);
+      m_vecTextures.push_back(pPage);
+    }
+
+    // the image holds a reference to its page until it is released itself
+    CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
+    pMap->SetAtlas(pageName, pPage->GetTexture(), atlasX, atlasY);
+    m_vecTextures.push_back(pMap);
+    return 1;
+  }
+
   if (bundle >= 0)
   {
     if (!m_TexBundle[bundle].LoadTexture(strTextureName, &pTexture, width, height))
@@ -445,6 +501,9 @@ void CGUITextureManager::ReleaseTexture(const CStdString& strTextureName)
         // add to our textures to free
         m_unusedTextures.push_back(pMap);
         i = m_vecTextures.erase(i);
+        // and drop our hold on the atlas page we were sharing
+        if (!pMap->GetAtlasPage().IsEmpty())
+          ReleaseTexture(pMap->GetAtlasPage());
       }
       return;
     }
@@ -510,6 +569,7 @@ void CGUITextureManager::Flush()
 {
   CSingleLock lock(g_graphicsContext);
 
+  vector<CStdString> atlasPages;
   ivecTextures i;
   i = m_vecTextures.begin();
   while (i != m_vecTextures.end())
@@ -518,6 +578,8 @@ void CGUITextureManager::Flush()
     pMap->Flush();
     if (pMap->IsEmpty() )
     {
+      if (!pMap->GetAtlasPage().IsEmpty())
+        atlasPages.push_back(pMap->GetAtlasPage());
       delete pMap;
       i = m_vecTextures.erase(i);
     }
@@ -526,6 +588,9 @@ void CGUITextureManager::Flush()
       ++i;
     }
   }
+  // pages are released once the loop is done so we aren't erasing under our own iterator
+  for (unsigned int j = 0; j < atlasPages.size(); j++)
+    ReleaseTexture(atlasPages[j]);
 }
 
 unsigned int CGUITextureManager::GetMemoryUsage() const
@@ -58,6 +58,8 @@ public:
   int m_loops;
   int m_texWidth;
   int m_texHeight;
+  int m_atlasX;   ///< left edge of the image within its atlas page (0 when not atlased)
+  int m_atlasY;   ///< top edge of the image within its atlas page (0 when not atlased)
   bool m_texCoordsArePixels;
 };
 
@@ -76,6 +78,17 @@ public:
   virtual ~CTextureMap();
 
   void Add(CBaseTexture* texture, int delay);
+
+  /*! \brief Make this map a window onto part of an atlas page.
+   The page's texture is shared, not owned, so the page map must be kept referenced
+   for as long as this map is alive.
+   \param pageName name of the texture map holding the atlas page.
+   \param page the page's texture array.
+   \param x left edge of the image within the page, in pixels.
+   \param y top edge of the image within the page, in pixels.
+   */
+  void SetAtlas(const CStdString& pageName, const CTextureArray& page, int x, int y);
+  const CStdString& GetAtlasPage() const { return m_atlasPage; };
   bool Release();
 
   const CStdString& GetName() const;
@@ -88,6 +101,7 @@ protected:
   void FreeTexture();
 
   CStdString m_textureName;
+  CStdString m_atlasPage;
   CTextureArray m_texture;
   unsigned int m_referenceCount;
   uint32_t m_memUsage;
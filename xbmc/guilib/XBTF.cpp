@@ -29,6 +29,9 @@ CXBTFFrame::CXBTFFrame()
   m_offset = 0;
   m_format = XB_FMT_UNKNOWN;
   m_duration = 0;
+  m_atlas = XBTF_NO_ATLAS;
+  m_atlasX = 0;
+  m_atlasY = 0;
 }
 
 uint32_t CXBTFFrame::GetWidth() const
@@ -111,7 +114,29 @@ void CXBTFFrame::SetDuration(uint32_t duration)
   m_duration = duration;
 }
 
-uint64_t CXBTFFrame::GetHeaderSize() const
+uint32_t CXBTFFrame::GetAtlas() const
+{
+  return m_atlas;
+}
+
+uint32_t CXBTFFrame::GetAtlasX() const
+{
+  return m_atlasX;
+}
+
+uint32_t CXBTFFrame::GetAtlasY() const
+{
+  return m_atlasY;
+}
+
+void CXBTFFrame::SetAtlas(uint32_t atlas, uint32_t x, uint32_t y)
+{
+  m_atlas = atlas;
+  m_atlasX = x;
+  m_atlasY = y;
+}
+
+uint64_t CXBTFFrame::GetHeaderSize(char version) const
 {
   uint64_t result =
     sizeof(m_width) +
@@ -122,6 +147,9 @@ uint64_t CXBTFFrame::GetHeaderSize() const
     sizeof(m_offset) +
     sizeof(m_duration);
 
+  if (version >= '3')
+    result += sizeof(m_atlas) + sizeof(m_atlasX) + sizeof(m_atlasY);
+
   return result;
 }
 
@@ -164,7 +192,7 @@ std::vector<CXBTFFrame>& CXBTFFile::GetFrames()
   return m_frames;
 }
 
-uint64_t CXBTFFile::GetHeaderSize() const
+uint64_t CXBTFFile::GetHeaderSize(char version) const
 {
   uint64_t result =
     sizeof(m_path) +
@@ -173,7 +201,7 @@ uint64_t CXBTFFile::GetHeaderSize() const
 
   for (size_t i = 0; i < m_frames.size(); i++)
   {
-    result += m_frames[i].GetHeaderSize();
+    result += m_frames[i].GetHeaderSize(version);
   }
 
   return result;
@@ -181,6 +209,7 @@ uint64_t CXBTFFile::GetHeaderSize() const
 
 CXBTF::CXBTF()
 {
+  m_version = XBTF_VERSION[0];
 }
 
 uint64_t CXBTF::GetHeaderSize() const
@@ -192,7 +221,7 @@ uint64_t CXBTF::GetHeaderSize() const
 
   for (size_t i = 0; i < m_files.size(); i++)
   {
-    result += m_files[i].GetHeaderSize();
+    result += m_files[i].GetHeaderSize(m_version);
   }
 
   return result;
@@ -202,3 +231,13 @@ std::vector<CXBTFFile>& CXBTF::GetFiles()
 {
   return m_files;
 }
+
+char CXBTF::GetVersion() const
+{
+  return m_version;
+}
+
+void CXBTF::SetVersion(char version)
+{
+  m_version = version;
+}
@@ -25,7 +25,11 @@
 #include <stdint.h>
 
 #define XBTF_MAGIC "XBTF"
-#define XBTF_VERSION "2"
+#define XBTF_VERSION "3"
+#define XBTF_VERSION_MIN "2" ///< oldest version we can read (no atlas information)
+
+#define XBTF_NO_ATLAS      0xffffffff
+#define XBTF_ATLAS_PREFIX  ".atlas/" ///< path prefix of the files holding atlas pages
 
 #define XB_FMT_MASK   0xffff ///< mask for format info - other flags are outside this
 #define XB_FMT_DXT_MASK   15
@@ -56,12 +60,20 @@ public:
   void SetPackedSize(uint64_t size);
   uint64_t GetOffset() const;
   void SetOffset(uint64_t offset);
-  uint64_t GetHeaderSize() const;
+  uint64_t GetHeaderSize(char version = XBTF_VERSION[0]) const;
   uint32_t GetDuration() const;
   void SetDuration(uint32_t duration);
   bool IsPacked() const;
   bool HasAlpha() const;
 
+  /*! \brief Index of the file whose first frame is the atlas page holding this frame, or XBTF_NO_ATLAS.
+   Frames packed into an atlas have no data of their own, only their position within the page.
+   */
+  uint32_t GetAtlas() const;
+  uint32_t GetAtlasX() const;
+  uint32_t GetAtlasY() const;
+  void SetAtlas(uint32_t atlas, uint32_t x, uint32_t y);
+
 private:
   uint32_t m_width;
   uint32_t m_height;
@@ -70,6 +82,9 @@ private:
   uint64_t m_unpackedSize;
   uint64_t m_offset;
   uint32_t m_duration;
+  uint32_t m_atlas;
+  uint32_t m_atlasX;
+  uint32_t m_atlasY;
 };
 
 class CXBTFFile
@@ -82,7 +97,7 @@ public:
   uint32_t GetLoop() const;
   void SetLoop(uint32_t loop);
   std::vector<CXBTFFrame>& GetFrames();
-  uint64_t GetHeaderSize() const;
+  uint64_t GetHeaderSize(char version = XBTF_VERSION[0]) const;
 
 private:
   char         m_path[256];
@@ -96,9 +111,12 @@ public:
   CXBTF();
   uint64_t GetHeaderSize() const;
   std::vector<CXBTFFile>& GetFiles();
+  char GetVersion() const;
+  void SetVersion(char version);
 
 private:
   std::vector<CXBTFFile> m_files;
+  char m_version;
 };
 
 #endif
@@ -80,10 +80,11 @@ bool CXBTFReader::Open(const CStdString& fileName)
   char version[1];
   READ_STR(version, 1, m_file);
 
-  if (strncmp(version, XBTF_VERSION, sizeof(version)) != 0)
+  if (version[0] < XBTF_VERSION_MIN[0] || version[0] > XBTF_VERSION[0])
   {
     return false;
   }
+  m_xbtf.SetVersion(version[0]);
 
   unsigned int nofFiles;
   READ_U32(nofFiles, m_file);
@@ -119,6 +120,15 @@ bool CXBTFReader::Open(const CStdString& fileName)
       READ_U64(u64, m_file);
       frame.SetOffset(u64);
 
+      if (version[0] >= '3')
+      {
+        unsigned int atlas, x, y;
+        READ_U32(atlas, m_file);
+        READ_U32(x, m_file);
+        READ_U32(y, m_file);
+        frame.SetAtlas(atlas, x, y);
+      }
+
       file.GetFrames().push_back(frame);
     }
 
@@ -182,6 +192,23 @@ CXBTFFile* CXBTFReader::Find(const CStdString& name)
   return &(iter->second);
 }
 
+CXBTFFile* CXBTFReader::FindAtlasPage(const CXBTFFrame& frame)
+{
+  std::vector<CXBTFFile>& files = m_xbtf.GetFiles();
+  if (frame.GetAtlas() >= files.size())
+  {
+    return NULL;
+  }
+
+  CXBTFFile& page = files[frame.GetAtlas()];
+  if (page.GetFrames().empty())
+  {
+    return NULL;
+  }
+
+  return &page;
+}
+
 bool CXBTFReader::Load(const CXBTFFrame& frame, unsigned char* buffer)
 {
   if (!m_file)
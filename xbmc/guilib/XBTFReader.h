@@ -36,6 +36,8 @@ public:
   time_t GetLastModificationTimestamp();
   bool Exists(const CStdString& name);
   CXBTFFile* Find(const CStdString& name);
+  /*! \brief The file whose first frame is the atlas page holding frame, NULL if frame is stored on its own. */
+  CXBTFFile* FindAtlasPage(const CXBTFFrame& frame);
   bool Load(const CXBTFFrame& frame, unsigned char* buffer);
   std::vector<CXBTFFile>&  GetFiles();
 
@@ -0,0 +1,227 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUIListItem.h"
+#include "guilib/PropertyAtoms.h"
+#include "threads/Thread.h"
+#include "utils/StdString.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestPropertyAtoms, Intern)
+{
+  CPropertyAtoms atoms(16);
+  unsigned int key, lowerKey;
+
+  unsigned int name = atoms.Intern("TotalSeasons", key);
+  EXPECT_NE(CPropertyAtoms::NONE, name);
+  EXPECT_NE(name, key);
+  EXPECT_EQ("TotalSeasons", atoms.GetName(name));
+  EXPECT_EQ("totalseasons", atoms.GetName(key));
+  EXPECT_EQ(2U, atoms.Size());
+
+  // the lower cased spelling is the key itself
+  EXPECT_EQ(key, atoms.Intern("totalseasons", lowerKey));
+  EXPECT_EQ(key, lowerKey);
+
+  // interning again doesn't add anything
+  EXPECT_EQ(name, atoms.Intern("TotalSeasons", lowerKey));
+  EXPECT_EQ(key, lowerKey);
+  EXPECT_EQ(2U, atoms.Size());
+
+  // another spelling gets its own atom, but shares the key
+  unsigned int other = atoms.Intern("TOTALSEASONS", lowerKey);
+  EXPECT_NE(name, other);
+  EXPECT_EQ(key, lowerKey);
+  EXPECT_EQ("TOTALSEASONS", atoms.GetName(other));
+  EXPECT_EQ(3U, atoms.Size());
+
+  EXPECT_EQ("", atoms.GetName(CPropertyAtoms::NONE));
+}
+
+TEST(TestPropertyAtoms, Find)
+{
+  CPropertyAtoms atoms(16);
+  unsigned int key, found;
+  atoms.Intern("Fanart", key);
+
+  EXPECT_TRUE(atoms.Find("fanart", found));
+  EXPECT_EQ(key, found);
+  EXPECT_TRUE(atoms.Find("FANART", found));
+  EXPECT_EQ(key, found);
+
+  // a miss doesn't add the name
+  EXPECT_FALSE(atoms.Find("Banner", found));
+  EXPECT_EQ(2U, atoms.Size());
+}
+
+TEST(TestPropertyAtoms, Full)
+{
+  CPropertyAtoms atoms(3);
+  unsigned int key, found;
+
+  EXPECT_EQ(0U, atoms.Intern("a", key));
+  EXPECT_EQ(0U, key);
+
+  // room for the key, but not for the spelling
+  unsigned int name = atoms.Intern("Bb", key);
+  EXPECT_EQ(2U, name);
+  name = atoms.Intern("BB", key);
+  EXPECT_EQ(key, name);
+  EXPECT_EQ("bb", atoms.GetName(name));
+  EXPECT_EQ(3U, atoms.Size());
+
+  EXPECT_EQ(CPropertyAtoms::NONE, atoms.Intern("c", key));
+  EXPECT_EQ(CPropertyAtoms::NONE, key);
+  EXPECT_FALSE(atoms.Find("c", found));
+  EXPECT_EQ(3U, atoms.Size());
+
+  // names that made it in are still found
+  EXPECT_TRUE(atoms.Find("A", found));
+  EXPECT_EQ(0U, found);
+  EXPECT_TRUE(atoms.Find("bB", found));
+}
+
+class CAtomReader : public IRunnable
+{
+public:
+  CAtomReader(const CPropertyAtoms &atoms) : m_atoms(atoms), m_misses(0), m_stop(false) { }
+
+  virtual void Run()
+  {
+    while (!m_stop)
+    {
+      // every name the writer has published must be found with its key
+      unsigned int size = m_atoms.Size();
+      for (unsigned int i = 0; i < size; i++)
+      {
+        unsigned int key;
+        const std::string &name = m_atoms.GetName(i);
+        if (name.empty() || !m_atoms.Find(name, key) || m_atoms.GetName(key).empty())
+          m_misses++;
+      }
+    }
+  }
+
+  const CPropertyAtoms &m_atoms;
+  unsigned int m_misses;
+  volatile bool m_stop;
+};
+
+TEST(TestPropertyAtoms, ConcurrentFind)
+{
+  CPropertyAtoms atoms(2048);
+  CAtomReader reader(atoms);
+  CThread thread(&reader, "TestPropertyAtoms");
+  thread.Create();
+
+  for (unsigned int i = 0; i < 1000; i++)
+  {
+    CStdString name;
+    name.Format("Property.%u", i);
+    unsigned int key;
+    EXPECT_NE(CPropertyAtoms::NONE, atoms.Intern(name, key));
+  }
+
+  reader.m_stop = true;
+  thread.StopThread();
+  EXPECT_EQ(0U, reader.m_misses);
+  EXPECT_EQ(2000U, atoms.Size());
+}
+
+TEST(TestGUIListItem, Property)
+{
+  CGUIListItem item;
+  EXPECT_FALSE(item.HasProperties());
+  EXPECT_TRUE(item.GetProperty("TestGUIListItem.Missing").isNull());
+
+  item.SetProperty("TestGUIListItem.Rating", 7);
+  EXPECT_TRUE(item.HasProperties());
+  EXPECT_TRUE(item.HasProperty("testguilistitem.rating"));
+  EXPECT_EQ(7, item.GetProperty("TESTGUILISTITEM.RATING").asInteger());
+
+  // setting another spelling replaces the value
+  item.SetProperty("testguilistitem.RATING", "8.5");
+  EXPECT_STREQ("8.5", item.GetProperty("TestGUIListItem.Rating").asString().c_str());
+
+  item.IncrementProperty("TestGUIListItem.Count", 2);
+  item.IncrementProperty("TestGUIListItem.Count", 3);
+  EXPECT_EQ(5, item.GetProperty("TestGUIListItem.Count").asInteger());
+
+  item.ClearProperty("TESTGUILISTITEM.RATING");
+  EXPECT_FALSE(item.HasProperty("TestGUIListItem.Rating"));
+  EXPECT_TRUE(item.HasProperty("TestGUIListItem.Count"));
+
+  item.ClearProperties();
+  EXPECT_FALSE(item.HasProperties());
+}
+
+TEST(TestGUIListItem, PropertySpelling)
+{
+  CGUIListItem item;
+  item.SetProperty("TestGUIListItem.Spelling", true);
+  item.SetProperty("TESTGUILISTITEM.SPELLING", false);
+
+  // the name is serialized as it was first set
+  CVariant value;
+  item.Serialize(value);
+  ASSERT_TRUE(value["properties"].isMember("TestGUIListItem.Spelling"));
+  EXPECT_FALSE(value["properties"]["TestGUIListItem.Spelling"].asBoolean());
+  EXPECT_EQ(1U, value["properties"].size());
+}
+
+TEST(TestGUIListItem, AppendProperties)
+{
+  CGUIListItem item, other;
+  item.SetProperty("TestGUIListItem.Kept", 1);
+  item.SetProperty("TestGUIListItem.Replaced", 1);
+  other.SetProperty("testguilistitem.replaced", 2);
+  other.SetProperty("TestGUIListItem.Added", 3);
+
+  item.AppendProperties(other);
+  EXPECT_EQ(1, item.GetProperty("TestGUIListItem.Kept").asInteger());
+  EXPECT_EQ(2, item.GetProperty("TestGUIListItem.Replaced").asInteger());
+  EXPECT_EQ(3, item.GetProperty("TestGUIListItem.Added").asInteger());
+
+  CGUIListItem copy(item);
+  EXPECT_EQ(2, copy.GetProperty("TESTGUILISTITEM.REPLACED").asInteger());
+}
+
+TEST(TestGUIListItem, Art)
+{
+  CGUIListItem item;
+  EXPECT_FALSE(item.HasArt());
+
+  item.SetArt("thumb", "thumb.jpg");
+  item.SetArtFallback("poster", "thumb");
+  EXPECT_TRUE(item.HasArt("thumb"));
+  EXPECT_EQ("thumb.jpg", item.GetArt("poster"));
+  EXPECT_FALSE(item.HasArt("fanart"));
+
+  const CGUIListItem::ArtMap &art = item.GetArt();
+  EXPECT_EQ(1U, art.size());
+  item.SetArt("fanart", "fanart.jpg");
+  EXPECT_EQ(2U, art.size()); // a reference to the item's own art
+
+  item.ClearArt();
+  EXPECT_FALSE(item.HasArt());
+  EXPECT_EQ("", item.GetArt("poster"));
+}
@@ -0,0 +1,190 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/XBTF.h"
+#include "guilib/XBTFReader.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/EndianSwap.h"
+
+#include "gtest/gtest.h"
+
+#define WRITE_U32(i, file) { uint32_t _n = Endian_SwapLE32(i); fwrite(&_n, 4, 1, file); }
+#define WRITE_U64(i, file) { uint64_t _n = Endian_SwapLE64(i); fwrite(&_n, 8, 1, file); }
+
+// writes a bundle the way TexturePacker does, every frame gets 4 bytes of data
+// holding its file index
+static bool WriteBundle(const CStdString &path, char version, CXBTF &xbtf)
+{
+  FILE *file = fopen(path.c_str(), "wb");
+  if (!file)
+    return false;
+
+  xbtf.SetVersion(version);
+  uint64_t offset = xbtf.GetHeaderSize();
+
+  fwrite(XBTF_MAGIC, 4, 1, file);
+  fwrite(&version, 1, 1, file);
+  std::vector<CXBTFFile> &files = xbtf.GetFiles();
+  WRITE_U32(files.size(), file);
+  for (size_t i = 0; i < files.size(); i++)
+  {
+    fwrite(files[i].GetPath(), 256, 1, file);
+    WRITE_U32(files[i].GetLoop(), file);
+    std::vector<CXBTFFrame> &frames = files[i].GetFrames();
+    WRITE_U32(frames.size(), file);
+    for (size_t j = 0; j < frames.size(); j++)
+    {
+      CXBTFFrame &frame = frames[j];
+      frame.SetPackedSize(4);
+      frame.SetUnpackedSize(4);
+      frame.SetOffset(offset);
+      offset += 4;
+      WRITE_U32(frame.GetWidth(), file);
+      WRITE_U32(frame.GetHeight(), file);
+      WRITE_U32(frame.GetFormat(true), file);
+      WRITE_U64(frame.GetPackedSize(), file);
+      WRITE_U64(frame.GetUnpackedSize(), file);
+      WRITE_U32(frame.GetDuration(), file);
+      WRITE_U64(frame.GetOffset(), file);
+      if (version >= '3')
+      {
+        WRITE_U32(frame.GetAtlas(), file);
+        WRITE_U32(frame.GetAtlasX(), file);
+        WRITE_U32(frame.GetAtlasY(), file);
+      }
+    }
+  }
+  for (size_t i = 0; i < files.size(); i++)
+  {
+    for (size_t j = 0; j < files[i].GetFrames().size(); j++)
+      WRITE_U32(i, file);
+  }
+  fclose(file);
+  return true;
+}
+
+static void AddFile(CXBTF &xbtf, const std::string &path, uint32_t width, uint32_t height)
+{
+  CXBTFFrame frame;
+  frame.SetWidth(width);
+  frame.SetHeight(height);
+  frame.SetFormat(XB_FMT_A8R8G8B8);
+
+  CXBTFFile file;
+  file.SetPath(path);
+  file.GetFrames().push_back(frame);
+  xbtf.GetFiles().push_back(file);
+}
+
+class TestXBTFReader : public testing::Test
+{
+protected:
+  TestXBTFReader()
+  {
+    m_path = CSpecialProtocol::TranslatePath("special://temp/testxbtfreader.xbt");
+  }
+
+  ~TestXBTFReader()
+  {
+    m_reader.Close();
+    XFILE::CFile::Delete(m_path);
+  }
+
+  CStdString m_path;
+  CXBTFReader m_reader;
+};
+
+TEST_F(TestXBTFReader, Version2)
+{
+  CXBTF xbtf;
+  AddFile(xbtf, "button.png", 32, 16);
+  ASSERT_TRUE(WriteBundle(m_path, '2', xbtf));
+
+  // version 2 frames have no atlas fields
+  ASSERT_TRUE(m_reader.Open(m_path));
+  CXBTFFile *file = m_reader.Find("button.png");
+  ASSERT_TRUE(file != NULL);
+  ASSERT_EQ(1U, file->GetFrames().size());
+  CXBTFFrame &frame = file->GetFrames()[0];
+  EXPECT_EQ(32U, frame.GetWidth());
+  EXPECT_EQ(16U, frame.GetHeight());
+  EXPECT_EQ((uint32_t)XBTF_NO_ATLAS, frame.GetAtlas());
+  EXPECT_TRUE(m_reader.FindAtlasPage(frame) == NULL);
+
+  uint32_t data = 0xffffffff;
+  EXPECT_TRUE(m_reader.Load(frame, (unsigned char *)&data));
+  EXPECT_EQ(0U, Endian_SwapLE32(data));
+}
+
+TEST_F(TestXBTFReader, Version3)
+{
+  CXBTF xbtf;
+  AddFile(xbtf, XBTF_ATLAS_PREFIX "0", 256, 256);
+  AddFile(xbtf, "button.png", 32, 16);
+  AddFile(xbtf, "arrow.png", 8, 8);
+  xbtf.GetFiles()[1].GetFrames()[0].SetAtlas(0, 4, 40);
+  ASSERT_TRUE(WriteBundle(m_path, '3', xbtf));
+
+  ASSERT_TRUE(m_reader.Open(m_path));
+  ASSERT_EQ(3U, m_reader.GetFiles().size());
+
+  CXBTFFile *file = m_reader.Find("button.png");
+  ASSERT_TRUE(file != NULL);
+  CXBTFFrame &frame = file->GetFrames()[0];
+  EXPECT_EQ(0U, frame.GetAtlas());
+  EXPECT_EQ(4U, frame.GetAtlasX());
+  EXPECT_EQ(40U, frame.GetAtlasY());
+
+  // the atlas lookup finds the page, and the page's data is loaded
+  CXBTFFile *page = m_reader.FindAtlasPage(frame);
+  ASSERT_TRUE(page != NULL);
+  EXPECT_STREQ(XBTF_ATLAS_PREFIX "0", page->GetPath());
+  EXPECT_EQ(256U, page->GetFrames()[0].GetWidth());
+  uint32_t data = 0xffffffff;
+  EXPECT_TRUE(m_reader.Load(page->GetFrames()[0], (unsigned char *)&data));
+  EXPECT_EQ(0U, Endian_SwapLE32(data));
+
+  // images stored on their own have no page
+  file = m_reader.Find("arrow.png");
+  ASSERT_TRUE(file != NULL);
+  EXPECT_TRUE(m_reader.FindAtlasPage(file->GetFrames()[0]) == NULL);
+}
+
+TEST_F(TestXBTFReader, BadAtlas)
+{
+  CXBTF xbtf;
+  AddFile(xbtf, "button.png", 32, 16);
+  xbtf.GetFiles()[0].GetFrames()[0].SetAtlas(5, 0, 0);
+  ASSERT_TRUE(WriteBundle(m_path, '3', xbtf));
+
+  ASSERT_TRUE(m_reader.Open(m_path));
+  CXBTFFile *file = m_reader.Find("button.png");
+  ASSERT_TRUE(file != NULL);
+  EXPECT_TRUE(m_reader.FindAtlasPage(file->GetFrames()[0]) == NULL);
+}
+
+TEST_F(TestXBTFReader, UnknownVersion)
+{
+  CXBTF xbtf;
+  AddFile(xbtf, "button.png", 32, 16);
+  ASSERT_TRUE(WriteBundle(m_path, '4', xbtf));
+  EXPECT_FALSE(m_reader.Open(m_path));
+}
@@ -30,6 +30,7 @@ InfoSingle::InfoSingle(const CStdString &expression, int context)
 : InfoBool(expression, context)
 {
   m_condition = g_infoManager.TranslateSingleString(expression);
+  m_dependencies = g_infoManager.GetConditionDependencies(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -45,7 +46,7 @@ InfoExpression::InfoExpression(const CStdString &expression, int context)
 
 void InfoExpression::Update(const CGUIListItem *item)
 {
-  Evaluate(item, m_value);
+  m_value = Evaluate(item);
 }
 
 #define OPERATOR_LB   5
@@ -54,6 +55,12 @@ void InfoExpression::Update(const CGUIListItem *item)
 #define OPERATOR_AND  2
 #define OPERATOR_OR   1
 
+#define OPCODE_LOAD           0
+#define OPCODE_NOT            1
+#define OPCODE_JUMP_IF_FALSE  2
+#define OPCODE_JUMP_IF_TRUE   3
+#define OPCODE_BITS           2
+
 short InfoExpression::GetOperator(const char ch) const
 {
   if (ch == '[')
@@ -72,6 +79,7 @@ short InfoExpression::GetOperator(const char ch) const
 
 void InfoExpression::Parse(const CStdString &expression)
 {
+  std::vector<short> postfix; // operators (negative) and operand indices
   stack<char> operators;
   CStdString operand;
   for (unsigned int i = 0; i < expression.size(); i++)
@@ -84,7 +92,7 @@ void InfoExpression::Parse(const CStdString &expression)
         unsigned int info = g_infoManager.Register(operand, m_context);
         if (info)
         {
-          m_postfix.push_back(m_operands.size());
+          postfix.push_back(m_operands.size());
           m_operands.push_back(info);
         }
         operand.clear();
@@ -100,7 +108,7 @@ void InfoExpression::Parse(const CStdString &expression)
           if (oper == '[')
             break;
 
-          m_postfix.push_back(-GetOperator(oper)); // negative denotes operator
+          postfix.push_back(-GetOperator(oper)); // negative denotes operator
         }
       }
       else
@@ -113,7 +121,7 @@ void InfoExpression::Parse(const CStdString &expression)
           if (operators.top() == '[' && expression[i] != ']')
             break;
 
-          m_postfix.push_back(-GetOperator(operators.top()));  // negative denotes operator
+          postfix.push_back(-GetOperator(operators.top()));  // negative denotes operator
           operators.pop();
         }
         operators.push(expression[i]);
@@ -130,7 +138,7 @@ void InfoExpression::Parse(const CStdString &expression)
     unsigned int info = g_infoManager.Register(operand, m_context);
     if (info)
     {
-      m_postfix.push_back(m_operands.size());
+      postfix.push_back(m_operands.size());
       m_operands.push_back(info);
     }
   }
@@ -138,49 +146,100 @@ void InfoExpression::Parse(const CStdString &expression)
   // finish up by adding any operators
   while (!operators.empty())
   {
-    m_postfix.push_back(-GetOperator(operators.top()));  // negative denotes operator
+    postfix.push_back(-GetOperator(operators.top()));  // negative denotes operator
     operators.pop();
   }
 
-  // test evaluate
-  bool test;
-  if (!Evaluate(NULL, test))
+  if (!Compile(postfix))
+  {
     CLog::Log(LOGERROR, "Error evaluating boolean expression %s", expression.c_str());
+    m_program.clear();
+  }
+
+  // we need updating whenever one of our operands does
+  m_dependencies = 0;
+  for (vector<unsigned int>::const_iterator it = m_operands.begin(); it != m_operands.end(); ++it)
+    m_dependencies |= g_infoManager.GetDependencies(*it);
 }
 
-bool InfoExpression::Evaluate(const CGUIListItem *item, bool &result)
+bool InfoExpression::Compile(const std::vector<short> &postfix)
 {
-  stack<bool> save;
-  for (vector<short>::const_iterator it = m_postfix.begin(); it != m_postfix.end(); ++it)
+  // in postfix form the right hand side of an operator ends just before it,
+  // so only the left hand sides need to be found
+  vector<int> left(postfix.size(), -1);
+  stack<int> nodes;
+  for (unsigned int i = 0; i < postfix.size(); i++)
   {
-    short expr = *it;
+    short expr = postfix[i];
     if (expr == -OPERATOR_NOT)
-    { // NOT the top item on the stack
-      if (save.size() < 1) return false;
-      bool expr = save.top();
-      save.pop();
-      save.push(!expr);
-    }
-    else if (expr == -OPERATOR_AND)
-    { // AND the top two items on the stack
-      if (save.size() < 2) return false;
-      bool right = save.top(); save.pop();
-      bool left = save.top(); save.pop();
-      save.push(left && right);
+    {
+      if (nodes.size() < 1) return false;
+      nodes.pop();
     }
-    else if (expr == -OPERATOR_OR)
-    { // OR the top two items on the stack
-      if (save.size() < 2) return false;
-      bool right = save.top(); save.pop();
-      bool left = save.top(); save.pop();
-      save.push(left || right);
+    else if (expr == -OPERATOR_AND || expr == -OPERATOR_OR)
+    {
+      if (nodes.size() < 2) return false;
+      nodes.pop();
+      left[i] = nodes.top();
+      nodes.pop();
     }
-    else  // operand
-      save.push(g_infoManager.GetBoolValue(m_operands[expr], item));
+    else if (expr < 0) // parenthesis left over
+      return false;
+    nodes.push(i);
   }
-  if (save.size() != 1)
+  if (nodes.size() != 1)
     return false;
-  result = save.top();
+
+  m_program.clear();
+  Emit(postfix, left, nodes.top());
   return true;
 }
 
+void InfoExpression::Emit(const std::vector<short> &postfix, const std::vector<int> &left, int node)
+{
+  short expr = postfix[node];
+  if (expr == -OPERATOR_NOT)
+  {
+    Emit(postfix, left, node - 1);
+    m_program.push_back(OPCODE_NOT);
+  }
+  else if (expr == -OPERATOR_AND || expr == -OPERATOR_OR)
+  {
+    Emit(postfix, left, left[node]);
+    unsigned int jump = m_program.size();
+    m_program.push_back(expr == -OPERATOR_AND ? OPCODE_JUMP_IF_FALSE : OPCODE_JUMP_IF_TRUE);
+    Emit(postfix, left, node - 1);
+    m_program[jump] |= m_program.size() << OPCODE_BITS;
+  }
+  else
+    m_program.push_back(OPCODE_LOAD | (expr << OPCODE_BITS));
+}
+
+bool InfoExpression::Evaluate(const CGUIListItem *item) const
+{
+  bool value = false;
+  unsigned int pc = 0;
+  while (pc < m_program.size())
+  {
+    unsigned int instruction = m_program[pc++];
+    unsigned int argument = instruction >> OPCODE_BITS;
+    switch (instruction & ((1 << OPCODE_BITS) - 1))
+    {
+    case OPCODE_LOAD:
+      value = g_infoManager.GetBoolValue(m_operands[argument], item);
+      break;
+    case OPCODE_NOT:
+      value = !value;
+      break;
+    case OPCODE_JUMP_IF_FALSE:
+      if (!value)
+        pc = argument;
+      break;
+    case OPCODE_JUMP_IF_TRUE:
+      if (value)
+        pc = argument;
+      break;
+    }
+  }
+  return value;
+}
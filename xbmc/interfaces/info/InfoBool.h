@@ -28,6 +28,19 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*! \brief What can change the value of a condition.
+ A condition is only re-evaluated once the stamp of its dependencies changes,
+ conditions without any dependencies are evaluated once.
+ \sa CGUIInfoManager::GetDependencyStamp
+ */
+enum InfoDependency
+{
+  DEPENDS_ON_FRAME         = 0x1, ///< anything without a change notification, re-evaluated every frame
+  DEPENDS_ON_CLOCK         = 0x2, ///< the wall clock, re-evaluated when the second changes
+  DEPENDS_ON_SKIN_SETTINGS = 0x4, ///< skin bools and strings, re-evaluated when they are changed
+  DEPENDS_ON_ITEM          = 0x8  ///< the list item, always evaluated when an item is given
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -38,8 +51,10 @@ public:
   InfoBool(const CStdString &expression, int context)
     : m_value(false),
       m_context(context),
+      m_dependencies(DEPENDS_ON_FRAME),
       m_expression(expression),
-      m_lastUpdate(0)
+      m_stamp(0),
+      m_valid(false)
   {
   };
 
@@ -47,21 +62,33 @@ public:
 
   /*! \brief Get the value of this info bool
    This is called to update (if necessary) and fetch the value of the info bool
-   \param time current time (used to test if we need to update yet)
+   \param stamp current stamp of our dependencies (used to test if we need to update yet)
    \param item the item used to evaluate the bool
+   \sa GetDependencies
    */
-  inline bool Get(unsigned int time, const CGUIListItem *item = NULL)
+  inline bool Get(unsigned int stamp, const CGUIListItem *item = NULL)
   {
-    if (item)
+    if (item && (m_dependencies & DEPENDS_ON_ITEM))
+    {
       Update(item);
-    else if (time - m_lastUpdate > 0)
+      m_valid = false; // the value belongs to the item
+    }
+    else if (!m_valid || stamp != m_stamp)
     {
       Update(NULL);
-      m_lastUpdate = time;
+      m_stamp = stamp;
+      m_valid = true;
     }
     return m_value;
   }
 
+  /*! \brief What can change the value of this info bool
+   \return a combination of InfoDependency flags
+   */
+  unsigned int GetDependencies() const { return m_dependencies; };
+
+  const CStdString &GetExpression() const { return m_expression; };
+
   bool operator==(const InfoBool &right) const
   {
     return (m_context == right.m_context && 
@@ -77,10 +104,12 @@ protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
+  unsigned int m_dependencies; ///< InfoDependency flags of the condition
 
 private:
   CStdString m_expression;     ///< original expression
-  unsigned int m_lastUpdate;   ///< last update time (to determine dirty status)
+  unsigned int m_stamp;        ///< dependency stamp of the current value (to determine dirty status)
+  bool m_valid;                ///< whether m_value is valid for m_stamp
 };
 
 /*! \brief Class to wrap active boolean conditions
@@ -97,6 +126,9 @@ private:
 };
 
 /*! \brief Class to wrap active boolean expressions
+ The expression is compiled into a short program for a single accumulator:
+ operands load their value, ! negates it, and + and | jump past their right
+ hand side as soon as the left hand side decides the result.
  */
 class InfoExpression : public InfoBool
 {
@@ -107,10 +139,12 @@ public:
   virtual void Update(const CGUIListItem *item);
 private:
   void Parse(const CStdString &expression);
-  bool Evaluate(const CGUIListItem *item, bool &result);
+  bool Compile(const std::vector<short> &postfix);
+  void Emit(const std::vector<short> &postfix, const std::vector<int> &left, int node);
+  bool Evaluate(const CGUIListItem *item) const;
   short GetOperator(const char ch) const;
 
-  std::vector<short> m_postfix;         ///< the postfix form of the expression (operators and operand indicies)
+  std::vector<unsigned int> m_program;  ///< the compiled expression (opcode in the low bits, argument above)
   std::vector<unsigned int> m_operands; ///< the operands in the expression
 };
 
@@ -35,6 +35,7 @@ using namespace JSONRPC;
 using namespace std;
 
 bool CJSONRPC::m_initialized = false;
+CResultCache CJSONRPC::m_resultCache;
 
 void CJSONRPC::Initialize()
 {
@@ -97,13 +98,16 @@ void CJSONRPC::Initialize()
 
   for (unsigned int index = 0; index < size; index++)
     CJSONServiceDescription::AddNotification(JSONRPC_SERVICE_NOTIFICATIONS[index]);
-  
+
+  m_resultCache.Initialize();
+
   m_initialized = true;
   CLog::Log(LOGINFO, "JSONRPC v%s: Successfully initialized", CJSONServiceDescription::GetVersion());
 }
 
 void CJSONRPC::Cleanup()
 {
+  m_resultCache.Deinitialize();
   CJSONServiceDescription::Cleanup();
   m_initialized = false;
 }
@@ -221,9 +225,51 @@ JSONRPC_STATUS CJSONRPC::NotifyAll(const CStdString &method, ITransportLayer *tr
   return ACK;
 }
 
+JSONRPC_STATUS CJSONRPC::GetCacheStatistics(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result)
+{
+  m_resultCache.GetStatistics(result);
+  return OK;
+}
+
 CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client)
 {
-  CVariant inputroot, outputroot, result;
+  CVariant outputroot;
+  bool hasResponse = HandleRequest(inputString, transport, client, outputroot);
+
+  CStdString str = hasResponse ? CJSONVariantWriter::Write(outputroot, g_advancedSettings.m_jsonOutputCompact) : "";
+  return str;
+}
+
+bool CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client, IJSONWriterStream &output)
+{
+  CVariant outputroot;
+  if (!HandleRequest(inputString, transport, client, outputroot))
+    return false;
+
+  return CJSONVariantWriter::Write(outputroot, g_advancedSettings.m_jsonOutputCompact, output);
+}
+
+bool CJSONRPC::GetEntityTag(const CStdString &inputString, ITransportLayer *transport, IClient *client, string &etag)
+{
+  CVariant request = CJSONVariantParser::Parse((unsigned char *)inputString.c_str(), inputString.length());
+  if (!IsProperJSONRPC(request) || !request.isMember("id"))
+    return false;
+
+  CStdString methodName = request["method"].asString();
+  methodName = methodName.ToLower();
+
+  // the parameters have to be normalized the same way they are for the call itself
+  JSONRPC::MethodCall method;
+  CVariant params;
+  if (CJSONServiceDescription::CheckCall(methodName, request["params"], transport, client, false, method, params) != OK)
+    return false;
+
+  return m_resultCache.GetEntityTag(methodName, params, request["id"], etag);
+}
+
+bool CJSONRPC::HandleRequest(const CStdString &inputString, ITransportLayer *transport, IClient *client, CVariant &outputroot)
+{
+  CVariant inputroot;
   bool hasResponse = false;
 
   //CLog::Log(LOGDEBUG, "JSONRPC: Incoming request: %s", inputString.c_str());
@@ -245,7 +291,8 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
           CVariant response;
           if (HandleMethodCall(*itr, response, transport, client))
           {
-            outputroot.append(response);
+            outputroot.append(CVariant::ConstNullVariant);
+            outputroot[outputroot.size() - 1].swap(response);
             hasResponse = true;
           }
         }
@@ -261,8 +308,7 @@ CStdString CJSONRPC::MethodCall(const CStdString &inputString, ITransportLayer *
     hasResponse = true;
   }
 
-  CStdString str = hasResponse ? CJSONVariantWriter::Write(outputroot, g_advancedSettings.m_jsonOutputCompact) : "";
-  return str;
+  return hasResponse;
 }
 
 bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
@@ -283,7 +329,15 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
 
     //CLog::Log(LOGDEBUG, "JSONRPC: Calling %s", methodName.c_str());
     if ((errorCode = CJSONServiceDescription::CheckCall(methodName, request["params"], transport, client, isNotification, method, params)) == OK)
-      errorCode = method(methodName, transport, client, params, result);
+    {
+      unsigned int generation = 0;
+      if (!m_resultCache.Get(methodName, params, result, generation))
+      {
+        errorCode = method(methodName, transport, client, params, result);
+        if (errorCode == OK || errorCode == ACK)
+          m_resultCache.Add(methodName, params, result, generation);
+      }
+    }
     else
       result = params;
   }
@@ -293,7 +347,14 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     errorCode = InvalidRequest;
   }
 
-  BuildResponse(request, errorCode, result, response);
+  if (errorCode == OK)
+  {
+    // move the result into the response, it can be large
+    BuildResponse(request, errorCode, CVariant(), response);
+    response["result"].swap(result);
+  }
+  else
+    BuildResponse(request, errorCode, result, response);
 
   return !isNotification;
 }
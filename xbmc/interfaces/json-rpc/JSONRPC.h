@@ -26,9 +26,12 @@
 
 #include "JSONRPCUtils.h"
 #include "JSONServiceDescription.h"
+#include "ResultCache.h"
 #include "interfaces/IAnnouncer.h"
 #include "utils/StdString.h"
 
+class IJSONWriterStream;
+
 namespace JSONRPC
 {
   /*!
@@ -64,6 +67,34 @@ namespace JSONRPC
      */
     static CStdString MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client);
 
+    /*
+     \brief Handles an incoming JSON-RPC request and writes the response to a stream
+     \param inputString received JSON-RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \param output Stream the JSON-RPC response is written to in chunks
+     \return true if a response was written, false if there is none or writing failed
+
+     Same as MethodCall() above, but the response is handed to the stream while
+     it is being serialized instead of being built up as a single string. The
+     method handlers still build their complete result first, so this saves the
+     serialized copy of the response, not the memory used by the result itself.
+     */
+    static bool MethodCall(const CStdString &inputString, ITransportLayer *transport, IClient *client, IJSONWriterStream &output);
+
+    /*!
+     \brief Get the entity tag of the response to a JSON-RPC request
+     \param inputString received JSON-RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \param etag the entity tag of the response
+     \return true if the response has an entity tag, false otherwise
+
+     Only single calls of methods whose results are cached have an entity tag.
+     The tag stays the same as long as the response does.
+     */
+    static bool GetEntityTag(const CStdString &inputString, ITransportLayer *transport, IClient *client, std::string &etag);
+
     static JSONRPC_STATUS Introspect(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Version(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Permission(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -71,14 +102,17 @@ namespace JSONRPC
     static JSONRPC_STATUS GetConfiguration(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS SetConfiguration(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS NotifyAll(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
+    static JSONRPC_STATUS GetCacheStatistics(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
   
   private:
     static void setup();
+    static bool HandleRequest(const CStdString &inputString, ITransportLayer *transport, IClient *client, CVariant &outputroot);
     static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
     inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
 
     static bool m_initialized;
+    static CResultCache m_resultCache;
   };
 }
@@ -54,6 +54,7 @@ JsonRpcMethodMap CJSONServiceDescription::m_methodMaps[] = {
   { "JSONRPC.GetConfiguration",                     CJSONRPC::GetConfiguration },
   { "JSONRPC.SetConfiguration",                     CJSONRPC::SetConfiguration },
   { "JSONRPC.NotifyAll",                            CJSONRPC::NotifyAll },
+  { "JSONRPC.GetCacheStatistics",                   CJSONRPC::GetCacheStatistics },
 
 // Player
   { "Player.GetActivePlayers",                      CPlayerOperations::GetActivePlayers },
@@ -219,7 +220,7 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
     JSONSchemaTypeDefinitionPtr referencedTypeDef = CJSONServiceDescription::GetType(refType);
     if (refType.length() <= 0 || referencedTypeDef.get() == NULL)
     {
-      CLog::Log(LOGDEBUG, "JSONRPC: JSON schema type %s references an unknown type %s", name.c_str(), refType.c_str());
+      CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: JSON schema type %s references an unknown type %s", name.c_str(), refType.c_str());
       missingReference = refType;
       return false;
     }
@@ -281,7 +282,7 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
         JSONSchemaTypeDefinitionPtr extendedTypeDef = CJSONServiceDescription::GetType(extendsName);
         if (extendedTypeDef.get() == NULL)
         {
-          CLog::Log(LOGDEBUG, "JSONRPC: JSON schema type %s extends an unknown type %s", name.c_str(), extendsName.c_str());
+          CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: JSON schema type %s extends an unknown type %s", name.c_str(), extendsName.c_str());
           missingReference = extendsName;
           return false;
         }
@@ -302,7 +303,7 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
           if (extendedTypeDef.get() == NULL)
           {
             extends.clear();
-            CLog::Log(LOGDEBUG, "JSONRPC: JSON schema type %s extends an unknown type %s", name.c_str(), extendsName.c_str());
+            CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: JSON schema type %s extends an unknown type %s", name.c_str(), extendsName.c_str());
             missingReference = extendsName;
             return false;
           }
@@ -312,7 +313,7 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
           else if (extendedType != extendedTypeDef->type)
           {
             extends.clear();
-            CLog::Log(LOGDEBUG, "JSONRPC: JSON schema type %s extends multiple JSON schema types of mismatching types", name.c_str());
+            CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: JSON schema type %s extends multiple JSON schema types of mismatching types", name.c_str());
             return false;
           }
 
@@ -380,13 +381,13 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
           hasAdditionalProperties = false;
           additionalProperties.reset();
           
-          CLog::Log(LOGDEBUG, "JSONRPC: Invalid additionalProperties schema definition in type %s", name.c_str());
+          CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Invalid additionalProperties schema definition in type %s", name.c_str());
           return false;
         }
       }
       else
       {
-        CLog::Log(LOGDEBUG, "JSONRPC: Invalid additionalProperties definition in type %s", name.c_str());
+        CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Invalid additionalProperties definition in type %s", name.c_str());
         return false;
       }
     }
@@ -414,7 +415,7 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
           additionalItems.push_back(additionalItem);
         else
         {
-          CLog::Log(LOGDEBUG, "Invalid \"additionalItems\" value for type %s", name.c_str());
+          CLog::Log(LOGDEBUG | LOGJSONRPC, "Invalid \"additionalItems\" value for type %s", name.c_str());
           missingReference = additionalItem->missingReference;
           return false;
         }
@@ -430,7 +431,7 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
             additionalItems.push_back(additionalItem);
           else
           {
-            CLog::Log(LOGDEBUG, "Invalid \"additionalItems\" value (item %d) for type %s", itemIndex, name.c_str());
+            CLog::Log(LOGDEBUG | LOGJSONRPC, "Invalid \"additionalItems\" value (item %d) for type %s", itemIndex, name.c_str());
             missingReference = additionalItem->missingReference;
             return false;
           }
@@ -440,7 +441,7 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
       // it has an invalid value
       else if (!value["additionalItems"].isBoolean())
       {
-        CLog::Log(LOGDEBUG, "Invalid \"additionalItems\" definition for type %s", name.c_str());
+        CLog::Log(LOGDEBUG | LOGJSONRPC, "Invalid \"additionalItems\" definition for type %s", name.c_str());
         return false;
       }
     }
@@ -454,7 +455,7 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
         JSONSchemaTypeDefinitionPtr item = JSONSchemaTypeDefinitionPtr(new JSONSchemaTypeDefinition());
         if (!item->Parse(value["items"]))
         {
-          CLog::Log(LOGDEBUG, "Invalid item definition in \"items\" for type %s", name.c_str());
+          CLog::Log(LOGDEBUG | LOGJSONRPC, "Invalid item definition in \"items\" for type %s", name.c_str());
           missingReference = item->missingReference;
           return false;
         }
@@ -469,7 +470,7 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
           JSONSchemaTypeDefinitionPtr item = JSONSchemaTypeDefinitionPtr(new JSONSchemaTypeDefinition());
           if (!item->Parse(*itemItr))
           {
-            CLog::Log(LOGDEBUG, "Invalid item definition in \"items\" array for type %s", name.c_str());
+            CLog::Log(LOGDEBUG | LOGJSONRPC, "Invalid item definition in \"items\" array for type %s", name.c_str());
             missingReference = item->missingReference;
             return false;
           }
@@ -563,7 +564,7 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
       // If the type of the default value definition does not
       // match the type of the parameter we have to log this
       if (value.isMember("default") && !IsType(value["default"], type))
-        CLog::Log(LOGDEBUG, "JSONRPC: Parameter %s has an invalid default value", name.c_str());
+        CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Parameter %s has an invalid default value", name.c_str());
       
       // If the type contains an "enum" we need to get the
       // default value from the first enum value
@@ -591,14 +592,14 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
   // Let's check the type of the provided parameter
   if (!IsType(value, type))
   {
-    CLog::Log(LOGDEBUG, "JSONRPC: Type mismatch in type %s", name.c_str());
+    CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Type mismatch in type %s", name.c_str());
     errorMessage.Format("Invalid type %s received", ValueTypeToString(value.type()));
     errorData["message"] = errorMessage.c_str();
     return InvalidParams;
   }
   else if (value.isNull() && !HasType(type, NullValue))
   {
-    CLog::Log(LOGDEBUG, "JSONRPC: Value is NULL in type %s", name.c_str());
+    CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Value is NULL in type %s", name.c_str());
     errorData["message"] = "Received value is null";
     return InvalidParams;
   }
@@ -621,7 +622,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
 
     if (!ok)
     {
-      CLog::Log(LOGDEBUG, "JSONRPC: Value in type %s does not match any of the union type definitions", name.c_str());
+      CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Value in type %s does not match any of the union type definitions", name.c_str());
       errorData["message"] = "Received value does not match any of the union type definitions";
       return InvalidParams;
     }
@@ -638,7 +639,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
 
       if (status != OK)
       {
-        CLog::Log(LOGDEBUG, "JSONRPC: Value does not match extended type %s of type %s", extends.at(extendsIndex)->ID.c_str(), name.c_str());
+        CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Value does not match extended type %s of type %s", extends.at(extendsIndex)->ID.c_str(), name.c_str());
         errorMessage.Format("value does not match extended type %s", extends.at(extendsIndex)->ID.c_str(), name.c_str());
         errorData["message"] = errorMessage.c_str();
         return status;
@@ -655,7 +656,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
     // Check the number of items against minItems and maxItems
     if ((minItems > 0 && value.size() < minItems) || (maxItems > 0 && value.size() > maxItems))
     {
-      CLog::Log(LOGDEBUG, "JSONRPC: Number of array elements does not match minItems and/or maxItems in type %s", name.c_str());
+      CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Number of array elements does not match minItems and/or maxItems in type %s", name.c_str());
       if (minItems > 0 && maxItems > 0)
         errorMessage.Format("Between %d and %d array items expected but %d received", minItems, maxItems, value.size());
       else if (minItems > 0)
@@ -680,7 +681,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
         outputValue.push_back(temp);
         if (status != OK)
         {
-          CLog::Log(LOGDEBUG, "JSONRPC: Array element at index %u does not match in type %s", arrayIndex, name.c_str());
+          CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Array element at index %u does not match in type %s", arrayIndex, name.c_str());
           errorMessage.Format("array element at index %u does not match", arrayIndex);
           errorData["message"] = errorMessage.c_str();
           return status;
@@ -700,7 +701,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
       // allowed there is no need to check every element
       if (value.size() < items.size() || (value.size() != items.size() && additionalItems.size() == 0))
       {
-        CLog::Log(LOGDEBUG, "JSONRPC: One of the array elements does not match in type %s", name.c_str());
+        CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: One of the array elements does not match in type %s", name.c_str());
         errorMessage.Format("%d array elements expected but %d received", items.size(), value.size());
         errorData["message"] = errorMessage.c_str();
         return InvalidParams;
@@ -715,7 +716,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
         JSONRPC_STATUS status = items.at(arrayIndex)->Check(value[arrayIndex], outputValue[arrayIndex], errorData["property"]);
         if (status != OK)
         {
-          CLog::Log(LOGDEBUG, "JSONRPC: Array element at index %u does not match with items schema in type %s", arrayIndex, name.c_str());
+          CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Array element at index %u does not match with items schema in type %s", arrayIndex, name.c_str());
           return status;
         }
       }
@@ -740,7 +741,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
 
           if (!ok)
           {
-            CLog::Log(LOGDEBUG, "JSONRPC: Array contains non-conforming additional items in type %s", name.c_str());
+            CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Array contains non-conforming additional items in type %s", name.c_str());
             errorMessage.Format("Array element at index %u does not match the \"additionalItems\" schema", arrayIndex);
             errorData["message"] = errorMessage.c_str();
             return InvalidParams;
@@ -759,7 +760,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
           // If two elements are the same they are not unique
           if (outputValue[checkingIndex] == outputValue[checkedIndex])
           {
-            CLog::Log(LOGDEBUG, "JSONRPC: Not unique array element at index %u and %u in type %s", checkingIndex, checkedIndex, name.c_str());
+            CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Not unique array element at index %u and %u in type %s", checkingIndex, checkedIndex, name.c_str());
             errorMessage.Format("Array element at index %u is not unique (same as array element at index %u)", checkingIndex, checkedIndex);
             errorData["message"] = errorMessage.c_str();
             return InvalidParams;
@@ -785,7 +786,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
         JSONRPC_STATUS status = propertiesIterator->second->Check(value[propertiesIterator->second->name], outputValue[propertiesIterator->second->name], errorData["property"]);
         if (status != OK)
         {
-          CLog::Log(LOGDEBUG, "JSONRPC: Invalid property \"%s\" in type %s", propertiesIterator->second->name.c_str(), name.c_str());
+          CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Invalid property \"%s\" in type %s", propertiesIterator->second->name.c_str(), name.c_str());
           return status;
         }
         handled++;
@@ -827,7 +828,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
           JSONRPC_STATUS status = additionalProperties->Check(value[iter->first], outputValue[iter->first], errorData["property"]);
           if (status != OK)
           {
-            CLog::Log(LOGDEBUG, "JSONRPC: Invalid additional property \"%s\" in type %s", iter->first.c_str(), name.c_str());
+            CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Invalid additional property \"%s\" in type %s", iter->first.c_str(), name.c_str());
             return status;
           }
         }
@@ -863,7 +864,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
 
     if (!valid)
     {
-      CLog::Log(LOGDEBUG, "JSONRPC: Value does not match any of the enum values in type %s", name.c_str());
+      CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Value does not match any of the enum values in type %s", name.c_str());
       errorData["message"] = "Received value does not match any of the defined enum values";
       return InvalidParams;
     }
@@ -883,7 +884,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
     // Check maximum
         (exclusiveMaximum && numberValue >= maximum) || (!exclusiveMaximum && numberValue > maximum))        
     {
-      CLog::Log(LOGDEBUG, "JSONRPC: Value does not lay between minimum and maximum in type %s", name.c_str());
+      CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Value does not lay between minimum and maximum in type %s", name.c_str());
       if (value.isDouble())
         errorMessage.Format("Value between %f (%s) and %f (%s) expected but %f received", 
           minimum, exclusiveMinimum ? "exclusive" : "inclusive", maximum, exclusiveMaximum ? "exclusive" : "inclusive", numberValue);
@@ -896,7 +897,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
     // Check divisibleBy
     if ((HasType(type, IntegerValue) && divisibleBy > 0 && ((int)numberValue % divisibleBy) != 0))
     {
-      CLog::Log(LOGDEBUG, "JSONRPC: Value does not meet divisibleBy requirements in type %s", name.c_str());
+      CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Value does not meet divisibleBy requirements in type %s", name.c_str());
       errorMessage.Format("Value should be divisible by %d but %d received", divisibleBy, (int)numberValue);
       errorData["message"] = errorMessage.c_str();
       return InvalidParams;
@@ -909,7 +910,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
     int size = value.asString().size();
     if (size < minLength)
     {
-      CLog::Log(LOGDEBUG, "JSONRPC: Value does not meet minLength requirements in type %s", name.c_str());
+      CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Value does not meet minLength requirements in type %s", name.c_str());
       errorMessage.Format("Value should have a minimum length of %d but has a length of %d", minLength, size);
       errorData["message"] = errorMessage.c_str();
       return InvalidParams;
@@ -917,7 +918,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
 
     if (maxLength >= 0 && size > maxLength)
     {
-      CLog::Log(LOGDEBUG, "JSONRPC: Value does not meet maxLength requirements in type %s", name.c_str());
+      CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Value does not meet maxLength requirements in type %s", name.c_str());
       errorMessage.Format("Value should have a maximum length of %d but has a length of %d", maxLength, size);
       errorData["message"] = errorMessage.c_str();
       return InvalidParams;
@@ -1199,7 +1200,7 @@ bool JsonRpcMethod::Parse(const CVariant &value)
          (parameter.isMember("$ref") && !parameter["$ref"].isString()) ||
          (parameter.isMember("extends") && !parameter["extends"].isString() && !parameter["extends"].isArray()))
       {
-        CLog::Log(LOGDEBUG, "JSONRPC: Method %s has a badly defined parameter", name.c_str());
+        CLog::Log(LOGDEBUG | LOGJSONRPC, "JSONRPC: Method %s has a badly defined parameter", name.c_str());
         return false;
       }
 
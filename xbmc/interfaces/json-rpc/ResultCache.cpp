@@ -0,0 +1,263 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include "ResultCache.h"
+#include "dbwrappers/Database.h"
+#include "interfaces/AnnouncementManager.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/Crc32.h"
+#include "utils/JSONVariantWriter.h"
+#include "utils/StringUtils.h"
+
+using namespace ANNOUNCEMENT;
+using namespace JSONRPC;
+using namespace std;
+
+CResultCache::CResultCache()
+{
+  // part of the entity tags so tags handed out before a restart can't match
+  m_epoch = (unsigned int)time(NULL);
+  m_videoGeneration = 0;
+  m_audioGeneration = 0;
+  m_videoChanges = 0;
+  m_audioChanges = 0;
+  m_size = 0;
+  m_uses = 0;
+  m_hits = 0;
+  m_misses = 0;
+  m_invalidations = 0;
+}
+
+void CResultCache::Initialize()
+{
+  CAnnouncementManager::AddAnnouncer(this);
+}
+
+void CResultCache::Deinitialize()
+{
+  CAnnouncementManager::RemoveAnnouncer(this);
+
+  CSingleLock lock(m_critSection);
+  m_entries.clear();
+  m_size = 0;
+}
+
+bool CResultCache::Get(const string &method, const CVariant &params, CVariant &result, unsigned int &generation)
+{
+  int library = GetLibrary(method);
+  if (library == 0 || !IsQuery(method) || g_advancedSettings.m_jsonCacheSize == 0)
+    return false;
+
+  string key = GetKey(method, params);
+
+  CSingleLock lock(m_critSection);
+  generation = Refresh(library);
+
+  CacheMap::iterator entry = m_entries.find(key);
+  if (entry == m_entries.end())
+  {
+    m_misses++;
+    return false;
+  }
+
+  m_hits++;
+  entry->second.lastUsed = ++m_uses;
+  result = entry->second.result;
+  return true;
+}
+
+void CResultCache::Add(const string &method, const CVariant &params, const CVariant &result, unsigned int generation)
+{
+  int library = GetLibrary(method);
+  if (library == 0)
+    return;
+
+  if (!IsQuery(method))
+  {
+    // the library may have been changed without an announcement
+    Invalidate((AnnouncementFlag)library);
+    return;
+  }
+
+  if (g_advancedSettings.m_jsonCacheSize == 0)
+    return;
+
+  // whole library listings can be huge, don't let a single one flush everything else
+  size_t maxSize = (size_t)g_advancedSettings.m_jsonCacheMemory * 1024 * 1024;
+  size_t size = GetSize(result);
+  if (size > maxSize / 4)
+    return;
+
+  string key = GetKey(method, params);
+
+  CSingleLock lock(m_critSection);
+  // the library changed while the result was retrieved
+  if (generation != Refresh(library) || m_entries.find(key) != m_entries.end())
+    return;
+
+  // make room by dropping the least recently used results
+  while (!m_entries.empty() &&
+         (m_entries.size() >= g_advancedSettings.m_jsonCacheSize || m_size + size > maxSize))
+  {
+    CacheMap::iterator oldest = m_entries.begin();
+    for (CacheMap::iterator it = m_entries.begin(); it != m_entries.end(); it++)
+    {
+      if (it->second.lastUsed < oldest->second.lastUsed)
+        oldest = it;
+    }
+    m_size -= oldest->second.size;
+    m_entries.erase(oldest);
+  }
+
+  CacheEntry &entry = m_entries[key];
+  entry.library = library;
+  entry.lastUsed = ++m_uses;
+  entry.size = size;
+  entry.result = result;
+  m_size += size;
+}
+
+bool CResultCache::GetEntityTag(const string &method, const CVariant &params, const CVariant &id, string &etag)
+{
+  int library = GetLibrary(method);
+  if (library == 0 || !IsQuery(method))
+    return false;
+
+  // the id is part of the response so it has to be part of the tag
+  Crc32 crc;
+  crc.Compute(GetKey(method, params) + CJSONVariantWriter::Write(id, true));
+
+  CSingleLock lock(m_critSection);
+  etag = StringUtils::Format("\"%08x-%x-%x\"", (unsigned int)crc, m_epoch, Refresh(library));
+  return true;
+}
+
+void CResultCache::Invalidate(AnnouncementFlag library)
+{
+  CSingleLock lock(m_critSection);
+  InvalidateLocked(library);
+}
+
+void CResultCache::GetStatistics(CVariant &result)
+{
+  CSingleLock lock(m_critSection);
+  result["size"] = g_advancedSettings.m_jsonCacheSize;
+  result["entries"] = (unsigned int)m_entries.size();
+  result["memory"] = (uint64_t)m_size;
+  result["maxmemory"] = (uint64_t)g_advancedSettings.m_jsonCacheMemory * 1024 * 1024;
+  result["hits"] = m_hits;
+  result["misses"] = m_misses;
+  result["hitrate"] = m_hits + m_misses > 0 ? (double)m_hits / (m_hits + m_misses) : 0.0;
+  result["invalidations"] = m_invalidations;
+}
+
+void CResultCache::Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
+{
+  if (flag != VideoLibrary && flag != AudioLibrary)
+    return;
+
+  // nothing has changed yet when a scan or clean starts
+  if (strcmp(message, "OnScanStarted") == 0 || strcmp(message, "OnCleanStarted") == 0)
+    return;
+
+  Invalidate(flag);
+}
+
+int CResultCache::GetLibrary(const string &method)
+{
+  if (StringUtils::StartsWith(method, "videolibrary."))
+    return VideoLibrary;
+  if (StringUtils::StartsWith(method, "audiolibrary."))
+    return AudioLibrary;
+
+  return 0;
+}
+
+bool CResultCache::IsQuery(const string &method)
+{
+  size_t pos = method.find('.');
+  return pos != string::npos && method.compare(pos + 1, 3, "get") == 0;
+}
+
+string CResultCache::GetKey(const string &method, const CVariant &params)
+{
+  // the members of objects are sorted so equal parameters always result in the same key
+  return method + CJSONVariantWriter::Write(params, true);
+}
+
+size_t CResultCache::GetSize(const CVariant &value)
+{
+  // rough estimate of the memory used, good enough to compare results
+  size_t size = sizeof(CVariant);
+  if (value.isString())
+    size += value.size();
+  else if (value.isArray())
+  {
+    for (CVariant::const_iterator_array it = value.begin_array(); it != value.end_array(); it++)
+      size += GetSize(*it);
+  }
+  else if (value.isObject())
+  {
+    for (CVariant::const_iterator_map it = value.begin_map(); it != value.end_map(); it++)
+      size += it->first.size() + GetSize(it->second);
+  }
+  return size;
+}
+
+unsigned int &CResultCache::GetGeneration(int library)
+{
+  return library == AudioLibrary ? m_audioGeneration : m_videoGeneration;
+}
+
+unsigned int CResultCache::Refresh(int library)
+{
+  // not everything changing a library is announced (play counts, resume points, artwork, ...)
+  // so check whether anything was written to its database since we last looked
+  long changes = CDatabase::GetChangeCount(library == AudioLibrary ? "MyMusic" : "MyVideos");
+  long &lastChanges = library == AudioLibrary ? m_audioChanges : m_videoChanges;
+  if (changes != lastChanges)
+  {
+    lastChanges = changes;
+    InvalidateLocked(library);
+  }
+
+  return GetGeneration(library);
+}
+
+void CResultCache::InvalidateLocked(int library)
+{
+  GetGeneration(library)++;
+  m_invalidations++;
+
+  for (CacheMap::iterator it = m_entries.begin(); it != m_entries.end(); )
+  {
+    if (it->second.library == library)
+    {
+      m_size -= it->second.size;
+      m_entries.erase(it++);
+    }
+    else
+      it++;
+  }
+}
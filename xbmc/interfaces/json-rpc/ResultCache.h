@@ -0,0 +1,115 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <string>
+
+#include "interfaces/IAnnouncer.h"
+#include "threads/CriticalSection.h"
+#include "utils/Variant.h"
+
+namespace JSONRPC
+{
+  /*!
+   \ingroup jsonrpc
+   \brief Cache for the results of JSON-RPC library queries
+
+   Keeps the results of the VideoLibrary.Get* and AudioLibrary.Get* methods
+   keyed by the method and its (normalized) parameters. All results of a
+   library are dropped whenever the library announces a change, a method
+   modifying it is called or its database was written to (e.g. play counts,
+   resume points and artwork, which aren't announced). Every invalidation
+   starts a new generation of the library, which is used to build entity tags
+   for conditional requests. The cache is bounded by the number of results
+   and their total (serialized) size.
+   */
+  class CResultCache : public ANNOUNCEMENT::IAnnouncer
+  {
+  public:
+    CResultCache();
+    virtual ~CResultCache() { }
+
+    void Initialize();
+    void Deinitialize();
+
+    /*!
+     \brief Look up the cached result of a method call
+     \param method lower case name of the called method
+     \param params normalized parameters of the call
+     \param result the cached result
+     \param generation the generation of the library the result has to be added with
+     \return true if a cached result was found
+     */
+    bool Get(const std::string &method, const CVariant &params, CVariant &result, unsigned int &generation);
+
+    /*!
+     \brief Add the result of a method call to the cache
+     Calls of methods modifying a library invalidate it instead. The result
+     is not added if the library changed since the given generation.
+     \param generation the generation retrieved by Get()
+     */
+    void Add(const std::string &method, const CVariant &params, const CVariant &result, unsigned int generation);
+
+    /*!
+     \brief Get the entity tag of the result of a method call
+     The tag stays the same until the library changes.
+     \return false if the result of the method can't be cached
+     */
+    bool GetEntityTag(const std::string &method, const CVariant &params, const CVariant &id, std::string &etag);
+
+    void Invalidate(ANNOUNCEMENT::AnnouncementFlag library);
+    void GetStatistics(CVariant &result);
+
+    virtual void Announce(ANNOUNCEMENT::AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data);
+
+  private:
+    static int GetLibrary(const std::string &method);
+    static bool IsQuery(const std::string &method);
+    static std::string GetKey(const std::string &method, const CVariant &params);
+    static size_t GetSize(const CVariant &value);
+    unsigned int &GetGeneration(int library);
+    unsigned int Refresh(int library);
+    void InvalidateLocked(int library);
+
+    typedef struct
+    {
+      int library;
+      unsigned int lastUsed;
+      size_t size;
+      CVariant result;
+    } CacheEntry;
+
+    typedef std::map<std::string, CacheEntry> CacheMap;
+
+    CCriticalSection m_critSection;
+    CacheMap m_entries;
+    size_t m_size;
+    unsigned int m_epoch;
+    unsigned int m_videoGeneration;
+    unsigned int m_audioGeneration;
+    long m_videoChanges;
+    long m_audioChanges;
+    unsigned int m_uses;
+    unsigned int m_hits;
+    unsigned int m_misses;
+    unsigned int m_invalidations;
+  };
+}
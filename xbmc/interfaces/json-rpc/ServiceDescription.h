@@ -22,7 +22,7 @@
 namespace JSONRPC
 {
   const char* const JSONRPC_SERVICE_ID          = "http://www.xbmc.org/jsonrpc/ServiceDescription.json";
-  const char* const JSONRPC_SERVICE_VERSION     = "6.0.3";
+  const char* const JSONRPC_SERVICE_VERSION     = "6.1.0";
   const char* const JSONRPC_SERVICE_DESCRIPTION = "JSON-RPC API of XBMC";
 
   const char* const JSONRPC_SERVICE_TYPES[] = {  
@@ -1358,6 +1358,26 @@ namespace JSONRPC
       "],"
       "\"returns\": \"any\""
     "}",
+    "\"JSONRPC.GetCacheStatistics\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Retrieve statistics of the library query result cache\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"ReadData\","
+      "\"params\": [],"
+      "\"returns\": {"
+        "\"type\": \"object\","
+        "\"properties\": {"
+          "\"size\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true },"
+          "\"entries\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true },"
+          "\"memory\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true },"
+          "\"maxmemory\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true },"
+          "\"hits\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true },"
+          "\"misses\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true },"
+          "\"hitrate\": { \"type\": \"number\", \"minimum\": 0, \"maximum\": 1, \"required\": true },"
+          "\"invalidations\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true }"
+        "}"
+      "}"
+    "}",
     "\"Player.Open\": {"
       "\"type\": \"method\","
       "\"description\": \"Start playback of either the playlist with the given ID, a slideshow with the pictures from the given directory or a single file or an item from the database.\","
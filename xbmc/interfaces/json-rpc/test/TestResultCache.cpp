@@ -0,0 +1,168 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DatabaseManager.h"
+#include "filesystem/Directory.h"
+#include "filesystem/SpecialProtocol.h"
+#include "interfaces/AnnouncementManager.h"
+#include "interfaces/json-rpc/ResultCache.h"
+#include "settings/AdvancedSettings.h"
+#include "video/VideoDatabase.h"
+
+#include "gtest/gtest.h"
+
+using namespace JSONRPC;
+
+// a fresh video database in the temp folder
+class TestResultCache : public testing::Test
+{
+protected:
+  TestResultCache()
+  {
+    m_databaseSettings = g_advancedSettings.m_databaseVideo;
+    m_folder = CSpecialProtocol::TranslatePath("special://temp/resultcache/");
+    XFILE::CDirectory::Remove(m_folder);
+    XFILE::CDirectory::Create(m_folder);
+    g_advancedSettings.m_databaseVideo.Reset();
+    g_advancedSettings.m_databaseVideo.type = "sqlite3";
+    g_advancedSettings.m_databaseVideo.host = m_folder;
+    CDatabaseManager::Get().Initialize();
+
+    m_params["properties"].push_back("title");
+    m_result["movies"].push_back("some movie");
+  }
+
+  ~TestResultCache()
+  {
+    g_advancedSettings.m_databaseVideo = m_databaseSettings;
+    XFILE::CDirectory::Remove(m_folder);
+  }
+
+  // what every JSON-RPC handler does, a connection of its own
+  static void OpenDatabase()
+  {
+    CVideoDatabase db;
+    EXPECT_TRUE(db.Open());
+    db.Close();
+  }
+
+  DatabaseSettings m_databaseSettings;
+  CStdString m_folder;
+  CVariant m_params;
+  CVariant m_result;
+};
+
+TEST_F(TestResultCache, RoundTrip)
+{
+  CResultCache cache;
+  CVariant result;
+  unsigned int generation;
+
+  EXPECT_FALSE(cache.Get("videolibrary.getmovies", m_params, result, generation));
+  OpenDatabase();
+  cache.Add("videolibrary.getmovies", m_params, m_result, generation);
+
+  OpenDatabase();
+  ASSERT_TRUE(cache.Get("videolibrary.getmovies", m_params, result, generation));
+  EXPECT_TRUE(result == m_result);
+
+  // other parameters are another result
+  CVariant params(m_params);
+  params["properties"].push_back("year");
+  EXPECT_FALSE(cache.Get("videolibrary.getmovies", params, result, generation));
+
+  CVariant stats;
+  cache.GetStatistics(stats);
+  EXPECT_EQ(1u, stats["entries"].asUnsignedInteger());
+  EXPECT_EQ(1u, stats["hits"].asUnsignedInteger());
+  EXPECT_EQ(2u, stats["misses"].asUnsignedInteger());
+}
+
+TEST_F(TestResultCache, EntityTag)
+{
+  CResultCache cache;
+  std::string tag, again;
+  ASSERT_TRUE(cache.GetEntityTag("videolibrary.getmovies", m_params, 1, tag));
+
+  // opening connections doesn't change anything
+  OpenDatabase();
+  ASSERT_TRUE(cache.GetEntityTag("videolibrary.getmovies", m_params, 1, again));
+  EXPECT_EQ(tag, again);
+
+  // the id is part of the response
+  ASSERT_TRUE(cache.GetEntityTag("videolibrary.getmovies", m_params, 2, again));
+  EXPECT_NE(tag, again);
+
+  EXPECT_FALSE(cache.GetEntityTag("videolibrary.setmoviedetails", m_params, 1, again));
+  EXPECT_FALSE(cache.GetEntityTag("player.getitem", m_params, 1, again));
+}
+
+TEST_F(TestResultCache, UnannouncedWrite)
+{
+  CResultCache cache;
+  CVariant result;
+  unsigned int generation;
+  std::string tag, again;
+
+  cache.Get("videolibrary.getmovies", m_params, result, generation);
+  cache.Add("videolibrary.getmovies", m_params, m_result, generation);
+  ASSERT_TRUE(cache.Get("videolibrary.getmovies", m_params, result, generation));
+  ASSERT_TRUE(cache.GetEntityTag("videolibrary.getmovies", m_params, 1, tag));
+
+  // e.g. a play count, these aren't announced
+  CVideoDatabase db;
+  ASSERT_TRUE(db.Open());
+  EXPECT_TRUE(db.SetPathHash("smb://server/share/movies/", "1234"));
+  db.Close();
+
+  EXPECT_FALSE(cache.Get("videolibrary.getmovies", m_params, result, generation));
+  ASSERT_TRUE(cache.GetEntityTag("videolibrary.getmovies", m_params, 1, again));
+  EXPECT_NE(tag, again);
+
+  // a result retrieved before a change isn't added after it
+  cache.Get("videolibrary.getmovies", m_params, result, generation);
+  db.Open();
+  db.SetPathHash("smb://server/share/movies/", "5678");
+  db.Close();
+  cache.Add("videolibrary.getmovies", m_params, m_result, generation);
+  EXPECT_FALSE(cache.Get("videolibrary.getmovies", m_params, result, generation));
+}
+
+TEST_F(TestResultCache, Modification)
+{
+  CResultCache cache;
+  CVariant result;
+  unsigned int generation;
+
+  cache.Get("videolibrary.getmovies", m_params, result, generation);
+  cache.Add("videolibrary.getmovies", m_params, m_result, generation);
+  cache.Get("audiolibrary.getalbums", m_params, result, generation);
+  cache.Add("audiolibrary.getalbums", m_params, m_result, generation);
+
+  // a modifying method only drops its own library
+  cache.Add("videolibrary.setmoviedetails", m_params, "OK", generation);
+  EXPECT_FALSE(cache.Get("videolibrary.getmovies", m_params, result, generation));
+  EXPECT_TRUE (cache.Get("audiolibrary.getalbums", m_params, result, generation));
+
+  cache.Announce(ANNOUNCEMENT::AudioLibrary, "xbmc", "OnScanStarted", CVariant());
+  EXPECT_TRUE (cache.Get("audiolibrary.getalbums", m_params, result, generation));
+  cache.Announce(ANNOUNCEMENT::AudioLibrary, "xbmc", "OnUpdate", CVariant());
+  EXPECT_FALSE(cache.Get("audiolibrary.getalbums", m_params, result, generation));
+}
@@ -509,7 +509,6 @@ int CMusicDatabase::AddAlbum(const CStdString& strAlbum1, const CStdString &strA
 
 int CMusicDatabase::AddGenre(const CStdString& strGenre1)
 {
-  CStdString strSQL;
   try
   {
     CStdString strGenre = strGenre1;
@@ -527,14 +526,17 @@ int CMusicDatabase::AddGenre(const CStdString& strGenre1)
       return it->second;
 
 
-    strSQL=PrepareSQL("select * from genre where strGenre like '%s'", strGenre.c_str());
-    m_pDS->query(strSQL.c_str());
-    if (m_pDS->num_rows() == 0)
+    dbiplus::Statement *select = GetStatement("select idGenre from genre where strGenre like ?");
+    dbiplus::StatementReset resetSelect(select);
+    select->bind(1, strGenre);
+    if (!select->step())
     {
-      m_pDS->close();
+      select->reset();
       // doesnt exists, add it
-      strSQL=PrepareSQL("insert into genre (idGenre, strGenre) values( NULL, '%s' )", strGenre.c_str());
-      m_pDS->exec(strSQL.c_str());
+      dbiplus::Statement *insert = GetStatement("insert into genre (idGenre, strGenre) values( NULL, ? )");
+      dbiplus::StatementReset resetInsert(insert);
+      insert->bind(1, strGenre);
+      insert->exec();
 
       int idGenre = (int)m_pDS->lastinsertid();
       m_genreCache.insert(pair<CStdString, int>(strGenre1, idGenre));
@@ -542,15 +544,14 @@ int CMusicDatabase::AddGenre(const CStdString& strGenre1)
     }
     else
     {
-      int idGenre = m_pDS->fv("idGenre").get_asInt();
+      int idGenre = select->getInt(0);
       m_genreCache.insert(pair<CStdString, int>(strGenre1, idGenre));
-      m_pDS->close();
       return idGenre;
     }
   }
   catch (...)
   {
-    CLog::Log(LOGERROR, "musicdatabase:unable to addgenre (%s)", strSQL.c_str());
+    CLog::Log(LOGERROR, "musicdatabase:unable to addgenre (%s)", strGenre1.c_str());
   }
 
   return -1;
@@ -558,7 +559,6 @@ int CMusicDatabase::AddGenre(const CStdString& strGenre1)
 
 int CMusicDatabase::AddArtist(const CStdString& strArtist1)
 {
-  CStdString strSQL;
   try
   {
     CStdString strArtist = strArtist1;
@@ -576,30 +576,32 @@ int CMusicDatabase::AddArtist(const CStdString& strArtist1)
     if (it != m_artistCache.end())
       return it->second;//.idArtist;
 
-    strSQL=PrepareSQL("select * from artist where strArtist like '%s'", strArtist.c_str());
-    m_pDS->query(strSQL.c_str());
-
-    if (m_pDS->num_rows() == 0)
+    dbiplus::Statement *select = GetStatement("select idArtist from artist where strArtist like ?");
+    dbiplus::StatementReset resetSelect(select);
+    select->bind(1, strArtist);
+    if (!select->step())
     {
-      m_pDS->close();
+      select->reset();
       // doesnt exists, add it
-      strSQL=PrepareSQL("insert into artist (idArtist, strArtist) values( NULL, '%s' )", strArtist.c_str());
-      m_pDS->exec(strSQL.c_str());
+      dbiplus::Statement *insert = GetStatement("insert into artist (idArtist, strArtist) values( NULL, ? )");
+      dbiplus::StatementReset resetInsert(insert);
+      insert->bind(1, strArtist);
+      insert->exec();
+
       int idArtist = (int)m_pDS->lastinsertid();
       m_artistCache.insert(pair<CStdString, int>(strArtist1, idArtist));
       return idArtist;
     }
     else
     {
-      int idArtist = (int)m_pDS->fv("idArtist").get_asInt();
+      int idArtist = select->getInt(0);
       m_artistCache.insert(pair<CStdString, int>(strArtist1, idArtist));
-      m_pDS->close();
       return idArtist;
     }
   }
   catch (...)
   {
-    CLog::Log(LOGERROR, "musicdatabase:unable to addartist (%s)", strSQL.c_str());
+    CLog::Log(LOGERROR, "musicdatabase:unable to addartist (%s)", strArtist1.c_str());
   }
 
   return -1;
@@ -838,7 +840,6 @@ bool CMusicDatabase::GetGenresBySong(int idSong, std::vector<int>& genres)
 
 int CMusicDatabase::AddPath(const CStdString& strPath1)
 {
-  CStdString strSQL;
   try
   {
     CStdString strPath(strPath1);
@@ -854,14 +855,17 @@ int CMusicDatabase::AddPath(const CStdString& strPath1)
     if (it != m_pathCache.end())
       return it->second;
 
-    strSQL=PrepareSQL( "select * from path where strPath='%s'", strPath.c_str());
-    m_pDS->query(strSQL.c_str());
-    if (m_pDS->num_rows() == 0)
+    dbiplus::Statement *select = GetStatement("select idPath from path where strPath=?");
+    dbiplus::StatementReset resetSelect(select);
+    select->bind(1, strPath);
+    if (!select->step())
     {
-      m_pDS->close();
+      select->reset();
       // doesnt exists, add it
-      strSQL=PrepareSQL("insert into path (idPath, strPath) values( NULL, '%s' )", strPath.c_str());
-      m_pDS->exec(strSQL.c_str());
+      dbiplus::Statement *insert = GetStatement("insert into path (idPath, strPath) values( NULL, ? )");
+      dbiplus::StatementReset resetInsert(insert);
+      insert->bind(1, strPath);
+      insert->exec();
 
       int idPath = (int)m_pDS->lastinsertid();
       m_pathCache.insert(pair<CStdString, int>(strPath, idPath));
@@ -869,15 +873,14 @@ int CMusicDatabase::AddPath(const CStdString& strPath1)
     }
     else
     {
-      int idPath = m_pDS->fv("idPath").get_asInt();
+      int idPath = select->getInt(0);
       m_pathCache.insert(pair<CStdString, int>(strPath, idPath));
-      m_pDS->close();
       return idPath;
     }
   }
   catch (...)
   {
-    CLog::Log(LOGERROR, "musicdatabase:unable to addpath (%s)", strSQL.c_str());
+    CLog::Log(LOGERROR, "musicdatabase:unable to addpath (%s)", strPath1.c_str());
   }
 
   return -1;
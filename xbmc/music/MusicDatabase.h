@@ -34,7 +34,7 @@ class CFileItem;
 namespace dbiplus
 {
   class field_value;
-  typedef std::vector<field_value> sql_record;
+  class sql_record;
 }
 
 #include <set>
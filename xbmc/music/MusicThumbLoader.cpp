@@ -67,7 +67,7 @@ bool CMusicThumbLoader::LoadItem(CFileItem* pItem)
   if (pItem->m_bIsShareOrDrive)
     return true;
 
-  if (pItem->HasMusicInfoTag() && pItem->GetArt().empty())
+  if (pItem->HasMusicInfoTag() && !pItem->HasArt())
   {
     if (FillLibraryArt(*pItem))
       return true;
@@ -75,7 +75,7 @@ bool CMusicThumbLoader::LoadItem(CFileItem* pItem)
       return true; // no fallback
   }
 
-  if (pItem->HasVideoInfoTag() && pItem->GetArt().empty())
+  if (pItem->HasVideoInfoTag() && !pItem->HasArt())
   { // music video
     CVideoThumbLoader loader;
     if (loader.LoadItem(pItem))
@@ -175,7 +175,7 @@ bool CMusicThumbLoader::FillLibraryArt(CFileItem &item)
     }
     m_database->Close();
   }
-  return !item.GetArt().empty();
+  return item.HasArt();
 }
 
 bool CMusicThumbLoader::GetEmbeddedThumb(const std::string &path, EmbeddedArt &art)
@@ -51,15 +51,76 @@
 #include "music/MusicThumbLoader.h"
 #include "interfaces/AnnouncementManager.h"
 #include "GUIUserMessages.h"
+#include "threads/Atomics.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
 
 #include <algorithm>
+#include <boost/shared_ptr.hpp>
 
 using namespace std;
 using namespace MUSIC_INFO;
 using namespace XFILE;
 using namespace MUSIC_GRABBER;
 
-CMusicInfoScanner::CMusicInfoScanner() : CThread("CMusicInfoScanner")
+// longest time a batch is kept open while the scraper workers have something to write
+#define MAX_BATCH_TIME_SCRAPING 1000
+
+namespace MUSIC_INFO
+{
+  /*! \brief The tags of one listing that are read on the tag reader workers
+   */
+  class CTagReadBatch
+  {
+  public:
+    CTagReadBatch() : m_remaining(1) { } // the reference of the scanner thread
+
+    volatile long m_remaining;
+    CEvent        m_done;
+  };
+  typedef boost::shared_ptr<CTagReadBatch> CTagReadBatchPtr;
+
+  class CTagReadJob : public CJob
+  {
+  public:
+    CTagReadJob(const CFileItemPtr &item, const CTagReadBatchPtr &batch) : m_item(item), m_batch(batch) { }
+
+    virtual const char *GetType() const { return "musictagread"; }
+
+    virtual bool DoWork()
+    {
+      auto_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(m_item->GetPath()));
+      if (NULL != pLoader.get())
+        pLoader->Load(m_item->GetPath(), *m_item->GetMusicInfoTag());
+      if (AtomicDecrement(&m_batch->m_remaining) == 0)
+        m_batch->m_done.Set();
+      return true;
+    }
+
+  private:
+    CFileItemPtr     m_item;
+    CTagReadBatchPtr m_batch;
+  };
+
+  class CMusicScraperWorker : public CThread
+  {
+  public:
+    CMusicScraperWorker(CMusicInfoScanner *scanner) : CThread("MusicScraper"), m_scanner(scanner) { }
+
+  protected:
+    virtual void Process()
+    {
+      SetPriority(GetMinPriority());
+      m_scanner->ScrapeQueued();
+    }
+
+  private:
+    CMusicInfoScanner *m_scanner;
+  };
+}
+
+CMusicInfoScanner::CMusicInfoScanner() : CThread("CMusicInfoScanner"), m_scraperWork(true), m_scrapersDone(true, true)
 {
   m_bRunning = false;
   m_showDialog = false;
@@ -68,6 +129,13 @@ CMusicInfoScanner::CMusicInfoScanner() : CThread("CMusicInfoScanner")
   m_currentItem=0;
   m_itemCount=0;
   m_flags = 0;
+  m_tagQueue = NULL;
+  m_scraperStop = false;
+  m_scrapersQueued = 0;
+  m_scrapersPending = 0;
+  m_inBatch = false;
+  m_batchFolders = 0;
+  m_batchStart = 0;
 }
 
 CMusicInfoScanner::~CMusicInfoScanner()
@@ -103,6 +171,13 @@ void CMusicInfoScanner::Process()
       m_currentItem=0;
       m_itemCount=-1;
 
+      // tags are read and artists and albums are scraped in parallel,
+      // while folders are committed to the database in batches
+      m_statTags.Reset();
+      m_statCommit.Reset();
+      m_statScraper.Reset();
+      StartWorkers();
+
       // Create the thread to count all files to be scanned
       SetPriority( GetMinPriority() );
       CThread fileCountReader(this, "CMusicInfoScanner");
@@ -131,6 +206,14 @@ void CMusicInfoScanner::Process()
         commit = !cancelled;
       }
 
+      if (commit)
+      {
+        CommitBatch();
+        WaitForScrapers();
+      }
+      else
+        RollbackBatch();
+
       if (commit)
       {
         g_infoManager.ResetLibraryBools();
@@ -161,6 +244,18 @@ void CMusicInfoScanner::Process()
 
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "My Music: Scanning for music info using worker thread, operation took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      CLog::Log(LOGNOTICE, "My Music: Read %u tags (%u without tag) in %.1fs, %.1f files/s",
+                m_statTags.items, m_statTags.failed, m_statTags.time / 1000.0f, m_statTags.time ? m_statTags.items * 1000.0f / m_statTags.time : 0.0f);
+      CLog::Log(LOGNOTICE, "My Music: Committed %u folders to the database in %.1fs",
+                m_statCommit.items, m_statCommit.time / 1000.0f);
+      if (m_flags & SCAN_ONLINE)
+      {
+        CSingleLock lock(m_scraperSection);
+        unsigned int scraped = m_statScraper.items + m_statScraper.failed;
+        CLog::Log(LOGNOTICE, "My Music: Fetched info of %u artists and albums (%u failed), %.1fs per item on %d workers, %.1f items/min overall",
+                  scraped, m_statScraper.failed, scraped ? m_statScraper.time / 1000.0f / scraped : 0.0f,
+                  m_scraperThreads.empty() ? 1 : (int)m_scraperThreads.size(), tick ? scraped * 60000.0f / tick : 0.0f);
+      }
     }
     bool bCanceled;
     if (m_scanType == 1) // load album info
@@ -203,8 +298,12 @@ void CMusicInfoScanner::Process()
   catch (...)
   {
     CLog::Log(LOGERROR, "MusicInfoScanner: Exception while scanning.");
+    if (m_inBatch)
+      RollbackBatch();
   }
 
+  StopWorkers();
+
   m_bRunning = false;
   ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::AudioLibrary, "xbmc", "OnScanFinished");
   
@@ -372,7 +471,10 @@ static CStdString Prettify(const CStdString& strDirectory)
 bool CMusicInfoScanner::DoScan(const CStdString& strDirectory)
 {
   if (m_handle)
+  {
+    UpdateScanTitle();
     m_handle->SetText(Prettify(strDirectory));
+  }
 
   /*
    * remove this path from the list we're processing. This must be done prior to
@@ -415,14 +517,28 @@ bool CMusicInfoScanner::DoScan(const CStdString& strDirectory)
     items.Sort(SORT_METHOD_LABEL, SortOrderAscending);
 
     // and then scan in the new information
+    BeginBatch();
     if (RetrieveMusicInfo(items, strDirectory) > 0)
     {
       if (m_handle)
         OnDirectoryScanned(strDirectory);
     }
+    if (m_bStop)
+      return false;
 
     // save information about this folder
     m_musicDatabase.SetPathHash(strDirectory, hash);
+
+    // the scraper workers can't write while the batch is open (sqlite locks the whole
+    // database), so don't keep them waiting for long
+    bool scraping;
+    {
+      CSingleLock lock(m_scraperSection);
+      scraping = m_scrapersPending > 0;
+    }
+    if (++m_batchFolders >= g_advancedSettings.m_musicScannerCommitBatch ||
+        (scraping && XbmcThreads::SystemClockMillis() - m_batchStart >= MAX_BATCH_TIME_SCRAPING))
+      CommitBatch();
   }
   else
   { // path is the same - no need to rescan
@@ -461,6 +577,10 @@ bool CMusicInfoScanner::DoScan(const CStdString& strDirectory)
 
 int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString& strDirectory)
 {
+  // read the tags of all files, this is where most of the time is spent
+  if (!ReadTags(items))
+    return 0;
+
   CSongMap songsMap;
 
   // get all information for all files in current directory from database, and remove them
@@ -495,12 +615,6 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
       CSong *dbSong = songsMap.Find(pItem->GetPath());
 
       CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-      if (!tag.Loaded() )
-      { // read the tag from a file
-        auto_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(pItem->GetPath()));
-        if (NULL != pLoader.get())
-          pLoader->Load(pItem->GetPath(), tag);
-      }
 
       // if we have the itemcount, update our
       // dialog with the progress we made
@@ -543,7 +657,10 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
 //        CLog::Log(LOGDEBUG, "%s - Tag loaded for: %s", __FUNCTION__, pItem->GetPath().c_str());
       }
       else
+      {
         CLog::Log(LOGDEBUG, "%s - No tag found for: %s", __FUNCTION__, pItem->GetPath().c_str());
+        m_statTags.failed++;
+      }
     }
   }
 
@@ -551,86 +668,371 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
   CategoriseAlbums(songsToAdd, albums);
   FindArtForAlbums(albums, items.GetPath());
 
-  // finally, add these to the database
-  m_musicDatabase.BeginTransaction();
+  // finally, add these to the database. The transaction of the current batch
+  // is committed by DoScan() once enough folders have been added.
+  unsigned int start = XbmcThreads::SystemClockMillis();
   int numAdded = 0;
-  set<int> albumsToScan;
-  set<int> artistsToScan;
   for (VECALBUMS::iterator i = albums.begin(); i != albums.end(); ++i)
   {
     vector<int> songIDs;
     int idAlbum = m_musicDatabase.AddAlbum(*i, songIDs);
     numAdded += i->songs.size();
     if (m_bStop)
-    {
-      m_musicDatabase.RollbackTransaction();
       return numAdded;
-    }
 
     // Build the artist & album sets
-    albumsToScan.insert(idAlbum);
+    m_batchAlbums.insert(idAlbum);
     for (vector<int>::iterator j = songIDs.begin(); j != songIDs.end(); ++j)
     {
       vector<int> songArtists;
       m_musicDatabase.GetArtistsBySong(*j, false, songArtists);
-      artistsToScan.insert(songArtists.begin(), songArtists.end());
+      m_batchArtists.insert(songArtists.begin(), songArtists.end());
     }
     std::vector<int> albumArtists;
     m_musicDatabase.GetArtistsByAlbum(idAlbum, false, albumArtists);
-    artistsToScan.insert(albumArtists.begin(), albumArtists.end());
+    m_batchArtists.insert(albumArtists.begin(), albumArtists.end());
+  }
+  m_statCommit.time += XbmcThreads::SystemClockMillis() - start;
+
+  return songsToAdd.size();
+}
+
+bool CMusicInfoScanner::ReadTags(CFileItemList &items)
+{
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  CStdStringArray regexps = g_advancedSettings.m_audioExcludeFromScanRegExps;
+  CTagReadBatchPtr batch(new CTagReadBatch);
+  long queued = 0;
+
+  for (int i = 0; i < items.Size(); ++i)
+  {
+    CFileItemPtr pItem = items[i];
+
+    if (m_bStop)
+      return false;
+
+    // same as in RetrieveMusicInfo()
+    if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
+      continue;
+    if (pItem->m_bIsFolder || pItem->IsPlayList() || pItem->IsPicture() || pItem->IsLyrics())
+      continue;
+
+    CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
+    if (tag.Loaded())
+      continue;
+
+    m_statTags.items++;
+    if (m_tagQueue && CMusicInfoTagLoaderFactory::CanLoadConcurrently(pItem->GetPath()))
+    {
+      AtomicIncrement(&batch->m_remaining);
+      m_tagQueue->AddJob(new CTagReadJob(pItem, batch));
+      queued++;
+    }
+    else
+    { // read the tag from a file
+      auto_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(pItem->GetPath()));
+      if (NULL != pLoader.get())
+        pLoader->Load(pItem->GetPath(), tag);
+    }
   }
+
+  if (AtomicDecrement(&batch->m_remaining) > 0)
+  {
+    // files are counted as done once they're added to the database, until then show the tags read
+    while (!batch->m_done.WaitMSec(100))
+    {
+      if (m_bStop)
+        return false;
+      if (m_handle && m_itemCount > 0)
+        m_handle->SetPercentage((m_currentItem + queued - batch->m_remaining) / (float)m_itemCount * 100);
+    }
+  }
+
+  m_statTags.time += XbmcThreads::SystemClockMillis() - start;
+  return true;
+}
+
+void CMusicInfoScanner::BeginBatch()
+{
+  if (m_inBatch)
+    return;
+
+  // the batch is a deferred transaction that starts with reads, a scraper
+  // writing in between would leave both connections waiting on each other
+  // and sqlite fails the batch instead of calling the busy handler.
+  // Scrapers take the write lock around their writes, so hold it until the
+  // batch is committed or rolled back.
+  m_writeSection.lock();
+  m_musicDatabase.BeginTransaction();
+  m_inBatch = true;
+  m_batchFolders = 0;
+  m_batchStart = XbmcThreads::SystemClockMillis();
+}
+
+void CMusicInfoScanner::CommitBatch()
+{
+  if (!m_inBatch)
+    return;
+
+  if (m_handle)
+    m_handle->SetTitle(g_localizeStrings.Get(328));
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
   m_musicDatabase.CommitTransaction();
+  m_inBatch = false;
+  m_writeSection.unlock();
+  m_statCommit.items += m_batchFolders;
+  m_statCommit.time += XbmcThreads::SystemClockMillis() - start;
 
   // Download info & artwork
   bool bCanceled;
-  for (set<int>::iterator it = artistsToScan.begin(); it != artistsToScan.end(); ++it)
+  for (set<int>::iterator it = m_batchArtists.begin(); it != m_batchArtists.end(); ++it)
   {
-    bCanceled = false;
-    if (find(m_artistsScanned.begin(),m_artistsScanned.end(), *it) == m_artistsScanned.end())
     {
-      CStdString strArtist = m_musicDatabase.GetArtistById(*it);
+      CSingleLock lock(m_scraperSection);
+      if (find(m_artistsScanned.begin(), m_artistsScanned.end(), *it) != m_artistsScanned.end())
+        continue;
       m_artistsScanned.push_back(*it);
-      if (!m_bStop && (m_flags & SCAN_ONLINE))
-      {
-        CStdString strPath;
-        strPath.Format("musicdb://2/%u/", *it);
+    }
 
-        if (!DownloadArtistInfo(strPath, strArtist, bCanceled)) // assume we want to retry
-          m_artistsScanned.pop_back();
-      }
-      else
+    if (!m_bStop && (m_flags & SCAN_ONLINE))
+    {
+      if (!m_scraperThreads.empty())
       {
-        map<string, string> artwork = GetArtistArtwork(*it);
-        m_musicDatabase.SetArtForItem(*it, "artist", artwork);
+        QueueScrape(false, *it);
+        continue;
       }
+
+      CStdString strArtist = m_musicDatabase.GetArtistById(*it);
+      CStdString strPath;
+      strPath.Format("musicdb://2/%u/", *it);
+
+      unsigned int scrapeStart = XbmcThreads::SystemClockMillis();
+      bCanceled = false;
+      bool success = DownloadArtistInfo(strPath, strArtist, bCanceled);
+      OnScraped(false, *it, success, XbmcThreads::SystemClockMillis() - scrapeStart);
+    }
+    else
+    {
+      map<string, string> artwork = GetArtistArtwork(*it);
+      m_musicDatabase.SetArtForItem(*it, "artist", artwork);
     }
   }
 
   if (m_flags & SCAN_ONLINE)
   {
-    for (set<int>::iterator it = albumsToScan.begin(); it != albumsToScan.end(); ++it)
+    for (set<int>::iterator it = m_batchAlbums.begin(); it != m_batchAlbums.end(); ++it)
     {
       if (m_bStop)
-        return songsToAdd.size();
+        break;
+
+      {
+        CSingleLock lock(m_scraperSection);
+        if (find(m_albumsScanned.begin(), m_albumsScanned.end(), *it) != m_albumsScanned.end())
+          continue;
+        m_albumsScanned.push_back(*it);
+      }
+
+      if (!m_scraperThreads.empty())
+      {
+        QueueScrape(true, *it);
+        continue;
+      }
 
       CStdString strPath;
       strPath.Format("musicdb://3/%u/",*it);
 
       CAlbum album;
       m_musicDatabase.GetAlbumInfo(*it, album, NULL);
+      unsigned int scrapeStart = XbmcThreads::SystemClockMillis();
       bCanceled = false;
-      if (find(m_albumsScanned.begin(), m_albumsScanned.end(), *it) == m_albumsScanned.end())
+      CMusicAlbumInfo albumInfo;
+      bool success = DownloadAlbumInfo(strPath, StringUtils::Join(album.artist, g_advancedSettings.m_musicItemSeparator), album.strAlbum, bCanceled, albumInfo);
+      OnScraped(true, *it, success, XbmcThreads::SystemClockMillis() - scrapeStart);
+    }
+  }
+  UpdateScanTitle();
+
+  m_batchArtists.clear();
+  m_batchAlbums.clear();
+  m_batchFolders = 0;
+}
+
+void CMusicInfoScanner::RollbackBatch()
+{
+  if (m_inBatch)
+  {
+    m_musicDatabase.RollbackTransaction();
+    m_writeSection.unlock();
+  }
+  m_inBatch = false;
+
+  m_batchArtists.clear();
+  m_batchAlbums.clear();
+  m_batchFolders = 0;
+}
+
+bool CMusicInfoScanner::WaitForScrapers()
+{
+  if (m_scraperThreads.empty())
+    return true;
+
+  if (m_handle)
+  {
+    m_handle->SetTitle(g_localizeStrings.Get(20097));
+    m_handle->SetText("");
+  }
+
+  while (!m_scrapersDone.WaitMSec(100))
+  {
+    if (m_bStop)
+      return false;
+
+    CSingleLock lock(m_scraperSection);
+    if (m_handle && m_scrapersQueued > 0)
+      m_handle->SetPercentage((m_scrapersQueued - m_scrapersPending) / (float)m_scrapersQueued * 100);
+  }
+  return true;
+}
+
+void CMusicInfoScanner::StartWorkers()
+{
+  // tag reads are short, but there's no need for them to get ahead of thumb and texture jobs
+  if (g_advancedSettings.m_musicScannerTagThreads > 0)
+    m_tagQueue = new CJobQueue(false, g_advancedSettings.m_musicScannerTagThreads, CJob::PRIORITY_LOW);
+
+  {
+    CSingleLock lock(m_scraperSection);
+    m_scraperStop = false;
+    m_scraperItems.clear();
+    m_scrapersQueued = 0;
+    m_scrapersPending = 0;
+    m_scraperWork.Reset();
+    m_scrapersDone.Set();
+  }
+
+  if (m_flags & SCAN_ONLINE)
+  {
+    for (int i = 0; i < g_advancedSettings.m_musicScannerScraperThreads; i++)
+    {
+      CThread *worker = new CMusicScraperWorker(this);
+      worker->Create();
+      m_scraperThreads.push_back(worker);
+    }
+  }
+}
+
+void CMusicInfoScanner::StopWorkers()
+{
+  // running tag reads only refer to their batch, so they can be left behind
+  delete m_tagQueue;
+  m_tagQueue = NULL;
+
+  {
+    CSingleLock lock(m_scraperSection);
+    m_scraperStop = true;
+    m_scrapersPending -= m_scraperItems.size();
+    m_scraperItems.clear();
+    m_scraperWork.Set();
+  }
+
+  // the workers finish the items they are scraping first
+  for (vector<CThread*>::iterator it = m_scraperThreads.begin(); it != m_scraperThreads.end(); ++it)
+  {
+    (*it)->StopThread();
+    delete *it;
+  }
+  m_scraperThreads.clear();
+}
+
+void CMusicInfoScanner::QueueScrape(bool album, long id)
+{
+  CSingleLock lock(m_scraperSection);
+  m_scraperItems.push_back(make_pair(album, id));
+  m_scrapersQueued++;
+  m_scrapersPending++;
+  m_scrapersDone.Reset();
+  m_scraperWork.Set();
+}
+
+void CMusicInfoScanner::ScrapeQueued()
+{
+  // the database of the scanner is used by the scanner thread
+  CMusicDatabase database;
+  database.Open();
+
+  while (true)
+  {
+    pair<bool, long> item;
+    {
+      CSingleLock lock(m_scraperSection);
+      if (m_scraperStop)
+        break;
+      if (m_scraperItems.empty())
       {
-        CMusicAlbumInfo albumInfo;
-        if (DownloadAlbumInfo(strPath, StringUtils::Join(album.artist, g_advancedSettings.m_musicItemSeparator), album.strAlbum, bCanceled, albumInfo))
-          m_albumsScanned.push_back(*it);
+        m_scraperWork.Reset();
+        lock.Leave();
+        m_scraperWork.Wait();
+        continue;
       }
+      item = m_scraperItems.front();
+      m_scraperItems.pop_front();
+    }
+
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    bool bCanceled = false;
+    bool success = false;
+    CStdString strPath;
+    if (item.first)
+    {
+      CAlbum album;
+      database.GetAlbumInfo(item.second, album, NULL);
+      strPath.Format("musicdb://3/%u/", item.second);
+      CMusicAlbumInfo albumInfo;
+      success = DownloadAlbumInfo(database, NULL, strPath, StringUtils::Join(album.artist, g_advancedSettings.m_musicItemSeparator), album.strAlbum, bCanceled, albumInfo, NULL);
+    }
+    else
+    {
+      strPath.Format("musicdb://2/%u/", item.second);
+      success = DownloadArtistInfo(database, NULL, strPath, database.GetArtistById(item.second), bCanceled, NULL);
     }
+    OnScraped(item.first, item.second, success, XbmcThreads::SystemClockMillis() - start);
+
+    CSingleLock lock(m_scraperSection);
+    if (--m_scrapersPending == 0)
+      m_scrapersDone.Set();
   }
-  if (m_handle)
-    m_handle->SetTitle(g_localizeStrings.Get(505));
 
-  return songsToAdd.size();
+  database.Close();
+}
+
+void CMusicInfoScanner::UpdateScanTitle()
+{
+  if (!m_handle)
+    return;
+
+  CStdString title = g_localizeStrings.Get(505);
+  CSingleLock lock(m_scraperSection);
+  if (m_scrapersQueued > 0)
+    title += StringUtils::Format(" (%s %u/%u)", g_localizeStrings.Get(20097).c_str(), m_scrapersQueued - m_scrapersPending, m_scrapersQueued);
+  m_handle->SetTitle(title);
+}
+
+void CMusicInfoScanner::OnScraped(bool album, long id, bool success, unsigned int duration)
+{
+  CSingleLock lock(m_scraperSection);
+  if (success)
+    m_statScraper.items++;
+  else
+  {
+    m_statScraper.failed++;
+    // assume we want to retry
+    vector<long> &scanned = album ? m_albumsScanned : m_artistsScanned;
+    vector<long>::iterator it = find(scanned.begin(), scanned.end(), id);
+    if (it != scanned.end())
+      scanned.erase(it);
+  }
+  m_statScraper.time += duration;
 }
 
 static bool SortSongsByTrack(CSong *song, CSong *song2)
@@ -908,28 +1310,33 @@ int CMusicInfoScanner::GetPathHash(const CFileItemList &items, CStdString &hash)
 #define THRESHOLD .95f
 
 bool CMusicInfoScanner::DownloadAlbumInfo(const CStdString& strPath, const CStdString& strArtist, const CStdString& strAlbum, bool& bCanceled, CMusicAlbumInfo& albumInfo, CGUIDialogProgress* pDialog)
+{
+  return DownloadAlbumInfo(m_musicDatabase, m_handle, strPath, strArtist, strAlbum, bCanceled, albumInfo, pDialog);
+}
+
+bool CMusicInfoScanner::DownloadAlbumInfo(CMusicDatabase &musicDatabase, CGUIDialogProgressBarHandle *handle, const CStdString& strPath, const CStdString& strArtist, const CStdString& strAlbum, bool& bCanceled, CMusicAlbumInfo& albumInfo, CGUIDialogProgress* pDialog)
 {
   CAlbum album;
   VECSONGS songs;
   XFILE::MUSICDATABASEDIRECTORY::CQueryParams params;
   XFILE::MUSICDATABASEDIRECTORY::CDirectoryNode::GetDatabaseInfo(strPath, params);
   bCanceled = false;
-  m_musicDatabase.Open();
-  if (m_musicDatabase.HasAlbumInfo(params.GetAlbumId()) && m_musicDatabase.GetAlbumInfo(params.GetAlbumId(),album,&songs))
+  musicDatabase.Open();
+  if (musicDatabase.HasAlbumInfo(params.GetAlbumId()) && musicDatabase.GetAlbumInfo(params.GetAlbumId(),album,&songs))
     return true;
 
   // find album info
   ADDON::ScraperPtr info;
-  if (!m_musicDatabase.GetScraperForPath(strPath, info, ADDON::ADDON_SCRAPER_ALBUMS) || !info)
+  if (!musicDatabase.GetScraperForPath(strPath, info, ADDON::ADDON_SCRAPER_ALBUMS) || !info)
   {
-    m_musicDatabase.Close();
+    musicDatabase.Close();
     return false;
   }
 
-  if (m_handle)
+  if (handle)
   {
-    m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(20321), info->Name().c_str()));
-    m_handle->SetText(strArtist+" - "+strAlbum);
+    handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(20321), info->Name().c_str()));
+    handle->SetText(strArtist+" - "+strAlbum);
   }
 
   // clear our scraper cache
@@ -939,7 +1346,7 @@ bool CMusicInfoScanner::DownloadAlbumInfo(const CStdString& strPath, const CStdS
 
   // handle nfo files
   CStdString strAlbumPath, strNfo;
-  m_musicDatabase.GetAlbumPath(params.GetAlbumId(),strAlbumPath);
+  musicDatabase.GetAlbumPath(params.GetAlbumId(),strAlbumPath);
   URIUtils::AddFileToFolder(strAlbumPath,"album.nfo",strNfo);
   CNfoFile::NFOResult result=CNfoFile::NO_NFO;
   CNfoFile nfoReader;
@@ -952,9 +1359,12 @@ bool CMusicInfoScanner::DownloadAlbumInfo(const CStdString& strPath, const CStdS
       CLog::Log(LOGDEBUG, "%s Got details from nfo", __FUNCTION__);
       CAlbum album;
       nfoReader.GetDetails(album);
-      m_musicDatabase.SetAlbumInfo(params.GetAlbumId(), album, album.songs);
-      GetAlbumArtwork(params.GetAlbumId(), album);
-      m_musicDatabase.Close();
+      {
+        CSingleLock lock(m_writeSection);
+        musicDatabase.SetAlbumInfo(params.GetAlbumId(), album, album.songs);
+      }
+      GetAlbumArtwork(musicDatabase, params.GetAlbumId(), album);
+      musicDatabase.Close();
       return true;
     }
     else if (result == CNfoFile::URL_NFO || result == CNfoFile::COMBINED_NFO)
@@ -1048,7 +1458,7 @@ bool CMusicInfoScanner::DownloadAlbumInfo(const CStdString& strPath, const CStdS
           relevance = CUtil::AlbumRelevance(info.GetAlbum().strAlbum, strAlbum, StringUtils::Join(info.GetAlbum().artist, g_advancedSettings.m_musicItemSeparator), strArtist);
         if (relevance < THRESHOLD)
         {
-          m_musicDatabase.Close();
+          musicDatabase.Close();
           return false;
         }
         bestRelevance = relevance;
@@ -1081,8 +1491,8 @@ bool CMusicInfoScanner::DownloadAlbumInfo(const CStdString& strPath, const CStdS
           pDialog->SetLine(1, strNewArtist);
           pDialog->Progress();
 
-          m_musicDatabase.Close();
-          return DownloadAlbumInfo(strPath,strNewArtist,strNewAlbum,bCanceled,albumInfo,pDialog);
+          musicDatabase.Close();
+          return DownloadAlbumInfo(musicDatabase,handle,strPath,strNewArtist,strNewAlbum,bCanceled,albumInfo,pDialog);
         }
         iSelectedAlbum = pDlg->GetSelectedItem()->m_idepth;
       }
@@ -1090,7 +1500,7 @@ bool CMusicInfoScanner::DownloadAlbumInfo(const CStdString& strPath, const CStdS
 
     if (iSelectedAlbum < 0)
     {
-      m_musicDatabase.Close();
+      musicDatabase.Close();
       return false;
     }
   }
@@ -1112,58 +1522,65 @@ bool CMusicInfoScanner::DownloadAlbumInfo(const CStdString& strPath, const CStdS
     album = scraper.GetAlbum(iSelectedAlbum).GetAlbum();
     if (result == CNfoFile::COMBINED_NFO)
       nfoReader.GetDetails(album,NULL,true);
-    m_musicDatabase.SetAlbumInfo(params.GetAlbumId(), album, scraper.GetAlbum(iSelectedAlbum).GetSongs(),false);
+    CSingleLock lock(m_writeSection);
+    musicDatabase.SetAlbumInfo(params.GetAlbumId(), album, scraper.GetAlbum(iSelectedAlbum).GetSongs(),false);
   }
   else
   {
-    m_musicDatabase.Close();
+    musicDatabase.Close();
     return false;
   }
 
   // check thumb stuff
-  GetAlbumArtwork(params.GetAlbumId(), album);
-  m_musicDatabase.Close();
+  GetAlbumArtwork(musicDatabase, params.GetAlbumId(), album);
+  musicDatabase.Close();
   return true;
 }
 
-void CMusicInfoScanner::GetAlbumArtwork(long id, const CAlbum &album)
+void CMusicInfoScanner::GetAlbumArtwork(CMusicDatabase &musicDatabase, long id, const CAlbum &album)
 {
   if (album.thumbURL.m_url.size())
   {
-    if (m_musicDatabase.GetArtForItem(id, "album", "thumb").empty())
+    if (musicDatabase.GetArtForItem(id, "album", "thumb").empty())
     {
       string thumb = CScraperUrl::GetThumbURL(album.thumbURL.GetFirstThumb());
       if (!thumb.empty())
       {
         CTextureCache::Get().BackgroundCacheImage(thumb);
-        m_musicDatabase.SetArtForItem(id, "album", "thumb", thumb);
+        CSingleLock lock(m_writeSection);
+        musicDatabase.SetArtForItem(id, "album", "thumb", thumb);
       }
     }
   }
 }
 
 bool CMusicInfoScanner::DownloadArtistInfo(const CStdString& strPath, const CStdString& strArtist, bool& bCanceled, CGUIDialogProgress* pDialog)
+{
+  return DownloadArtistInfo(m_musicDatabase, m_handle, strPath, strArtist, bCanceled, pDialog);
+}
+
+bool CMusicInfoScanner::DownloadArtistInfo(CMusicDatabase &musicDatabase, CGUIDialogProgressBarHandle *handle, const CStdString& strPath, const CStdString& strArtist, bool& bCanceled, CGUIDialogProgress* pDialog)
 {
   XFILE::MUSICDATABASEDIRECTORY::CQueryParams params;
   XFILE::MUSICDATABASEDIRECTORY::CDirectoryNode::GetDatabaseInfo(strPath, params);
   bCanceled = false;
   CArtist artist;
-  m_musicDatabase.Open();
-  if (m_musicDatabase.GetArtistInfo(params.GetArtistId(),artist)) // already got the info
+  musicDatabase.Open();
+  if (musicDatabase.GetArtistInfo(params.GetArtistId(),artist)) // already got the info
     return true;
 
   // find artist info
   ADDON::ScraperPtr info;
-  if (!m_musicDatabase.GetScraperForPath(strPath, info, ADDON::ADDON_SCRAPER_ARTISTS) || !info)
+  if (!musicDatabase.GetScraperForPath(strPath, info, ADDON::ADDON_SCRAPER_ARTISTS) || !info)
   {
-    m_musicDatabase.Close();
+    musicDatabase.Close();
     return false;
   }
 
-  if (m_handle)
+  if (handle)
   {
-    m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(20320), info->Name().c_str()));
-    m_handle->SetText(strArtist);
+    handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(20320), info->Name().c_str()));
+    handle->SetText(strArtist);
   }
 
   // clear our scraper cache
@@ -1172,7 +1589,7 @@ bool CMusicInfoScanner::DownloadArtistInfo(const CStdString& strPath, const CStd
   CMusicInfoScraper scraper(info);
   // handle nfo files
   CStdString strArtistPath, strNfo;
-  m_musicDatabase.GetArtistPath(params.GetArtistId(),strArtistPath);
+  musicDatabase.GetArtistPath(params.GetArtistId(),strArtistPath);
   URIUtils::AddFileToFolder(strArtistPath,"artist.nfo",strNfo);
   CNfoFile::NFOResult result=CNfoFile::NO_NFO;
   CNfoFile nfoReader;
@@ -1185,10 +1602,13 @@ bool CMusicInfoScanner::DownloadArtistInfo(const CStdString& strPath, const CStd
       CLog::Log(LOGDEBUG, "%s Got details from nfo", __FUNCTION__);
       CArtist artist;
       nfoReader.GetDetails(artist);
-      m_musicDatabase.SetArtistInfo(params.GetArtistId(), artist);
-      map<string, string> artwork = GetArtistArtwork(params.GetArtistId(), &artist);
-      m_musicDatabase.SetArtForItem(params.GetArtistId(), "artist", artwork);
-      m_musicDatabase.Close();
+      map<string, string> artwork = GetArtistArtwork(musicDatabase, params.GetArtistId(), &artist);
+      {
+        CSingleLock lock(m_writeSection);
+        musicDatabase.SetArtistInfo(params.GetArtistId(), artist);
+        musicDatabase.SetArtForItem(params.GetArtistId(), "artist", artwork);
+      }
+      musicDatabase.Close();
       return true;
     }
     else if (result == CNfoFile::URL_NFO || result == CNfoFile::COMBINED_NFO)
@@ -1272,8 +1692,8 @@ bool CMusicInfoScanner::DownloadArtistInfo(const CStdString& strPath, const CStd
               pDialog->SetLine(0, strNewArtist);
               pDialog->Progress();
             }
-            m_musicDatabase.Close();
-            return DownloadArtistInfo(strPath,strNewArtist,bCanceled,pDialog);
+            musicDatabase.Close();
+            return DownloadArtistInfo(musicDatabase,handle,strPath,strNewArtist,bCanceled,pDialog);
           }
           iSelectedArtist = pDlg->GetSelectedItem()->m_idepth;
         }
@@ -1281,7 +1701,7 @@ bool CMusicInfoScanner::DownloadArtistInfo(const CStdString& strPath, const CStd
     }
     else
     {
-      m_musicDatabase.Close();
+      musicDatabase.Close();
       return false;
     }
   }
@@ -1302,23 +1722,32 @@ bool CMusicInfoScanner::DownloadArtistInfo(const CStdString& strPath, const CStd
     artist = scraper.GetArtist(iSelectedArtist).GetArtist();
     if (result == CNfoFile::COMBINED_NFO)
       nfoReader.GetDetails(artist,NULL,true);
-    m_musicDatabase.SetArtistInfo(params.GetArtistId(), artist);
+    CSingleLock lock(m_writeSection);
+    musicDatabase.SetArtistInfo(params.GetArtistId(), artist);
   }
 
   // check thumb stuff
-  map<string, string> artwork = GetArtistArtwork(params.GetArtistId(), &artist);
-  m_musicDatabase.SetArtForItem(params.GetArtistId(), "artist", artwork);
+  map<string, string> artwork = GetArtistArtwork(musicDatabase, params.GetArtistId(), &artist);
+  {
+    CSingleLock lock(m_writeSection);
+    musicDatabase.SetArtForItem(params.GetArtistId(), "artist", artwork);
+  }
 
-  m_musicDatabase.Close();
+  musicDatabase.Close();
   return true;
 }
 
 map<string, string> CMusicInfoScanner::GetArtistArtwork(long id, const CArtist *artist)
+{
+  return GetArtistArtwork(m_musicDatabase, id, artist);
+}
+
+map<string, string> CMusicInfoScanner::GetArtistArtwork(CMusicDatabase &musicDatabase, long id, const CArtist *artist)
 {
   CStdString artistPath;
-  m_musicDatabase.Open();
-  bool checkLocal = m_musicDatabase.GetArtistPath(id, artistPath);
-  m_musicDatabase.Close();
+  musicDatabase.Open();
+  bool checkLocal = musicDatabase.GetArtistPath(id, artistPath);
+  musicDatabase.Close();
 
   CFileItem item(artistPath, true);
   map<string, string> artwork;
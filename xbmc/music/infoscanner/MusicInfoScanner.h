@@ -19,15 +19,22 @@
  *
  */
 #include "threads/Thread.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
 #include "music/MusicDatabase.h"
 #include "MusicAlbumInfo.h"
 
+#include <deque>
+
 class CAlbum;
 class CArtist;
 class CGUIDialogProgressBarHandle;
+class CJobQueue;
 
 namespace MUSIC_INFO
 {
+class CMusicScraperWorker;
+
 class CMusicInfoScanner : CThread, public IRunnable
 {
 public:
@@ -95,10 +102,85 @@ public:
 
   std::map<std::string, std::string> GetArtistArtwork(long id, const CArtist *artist = NULL);
 protected:
+  friend class CMusicScraperWorker;
+
+  /*! \brief Throughput of one stage of a scan
+   */
+  struct StageStats
+  {
+    StageStats() { Reset(); }
+    void Reset() { items = 0; failed = 0; time = 0; }
+    unsigned int items;  ///< items done by the stage
+    unsigned int failed; ///< items the stage failed on
+    unsigned int time;   ///< time spent in the stage in ms, summed up over its workers
+  };
+
   virtual void Process();
   int RetrieveMusicInfo(CFileItemList& items, const CStdString& strDirectory);
   int GetPathHash(const CFileItemList &items, CStdString &hash);
-  void GetAlbumArtwork(long id, const CAlbum &artist);
+  void GetAlbumArtwork(CMusicDatabase &musicDatabase, long id, const CAlbum &artist);
+
+  bool DownloadAlbumInfo(CMusicDatabase &musicDatabase, CGUIDialogProgressBarHandle *handle, const CStdString& strPath, const CStdString& strArtist, const CStdString& strAlbum, bool& bCanceled, MUSIC_GRABBER::CMusicAlbumInfo& album, CGUIDialogProgress* pDialog);
+  bool DownloadArtistInfo(CMusicDatabase &musicDatabase, CGUIDialogProgressBarHandle *handle, const CStdString& strPath, const CStdString& strArtist, bool& bCanceled, CGUIDialogProgress* pDialog);
+  std::map<std::string, std::string> GetArtistArtwork(CMusicDatabase &musicDatabase, long id, const CArtist *artist);
+
+  /*! \brief Read the tags of all songs in a listing that haven't got one yet
+   Tags read by TagLib are read in parallel on the tag reader workers, all others on
+   the scanner thread.
+   \param items the listing to read the tags of
+   \return false if the scan was stopped, true otherwise
+   */
+  bool ReadTags(CFileItemList &items);
+
+  /*! \brief Create the tag reader queue and start the scraper workers of a file scan
+   Scraper workers are dedicated threads, as scraping blocks on the network for seconds
+   which would starve the shared job workers.
+   \sa StopWorkers
+   */
+  void StartWorkers();
+
+  /*! \brief Cancel all outstanding tag reads and scrapes and wait for the running ones
+   \sa StartWorkers
+   */
+  void StopWorkers();
+
+  /*! \brief Hand an artist or album to the scraper workers
+   */
+  void QueueScrape(bool album, long id);
+
+  /*! \brief Scrape the queued artists and albums until the workers are stopped, run by each worker
+   */
+  void ScrapeQueued();
+
+  /*! \brief Show the scan and the progress of the scraper workers in the title of the progress bar
+   */
+  void UpdateScanTitle();
+
+  /*! \brief Start a batch of folders to be committed to the database in one go
+   \sa CommitBatch, RollbackBatch
+   */
+  void BeginBatch();
+
+  /*! \brief Commit the current batch of folders and fetch the info of their new artists and albums
+   When scraping online the artists and albums are handed to the scraper workers, which
+   fetch their info while the scan goes on.
+   \sa BeginBatch, RollbackBatch
+   */
+  void CommitBatch();
+
+  /*! \brief Discard the current batch of folders
+   \sa BeginBatch, CommitBatch
+   */
+  void RollbackBatch();
+
+  /*! \brief Wait for the scraper workers to fetch the info of all queued artists and albums
+   \return false if the scan was stopped while waiting, true otherwise
+   */
+  bool WaitForScrapers();
+
+  /*! \brief Called by the scraper workers when the info of an artist or album has been fetched
+   */
+  void OnScraped(bool album, long id, bool success, unsigned int duration);
 
   bool DoScan(const CStdString& strDirectory);
 
@@ -124,5 +206,27 @@ protected:
   std::vector<long> m_artistsScanned;
   std::vector<long> m_albumsScanned;
   int m_flags;
+
+  CJobQueue *m_tagQueue;
+  std::vector<CThread*> m_scraperThreads;
+  CCriticalSection m_scraperSection;
+  std::deque<std::pair<bool, long> > m_scraperItems; ///< queued albums (true) and artists (false)
+  CEvent m_scraperWork;   ///< set while there are queued items or the workers should stop
+  CEvent m_scrapersDone;  ///< set while no items are pending
+  bool m_scraperStop;
+  unsigned int m_scrapersQueued;
+  unsigned int m_scrapersPending; ///< items queued or being scraped
+  CCriticalSection m_writeSection; ///< held by an open batch and around every scraper write
+
+  // the folders of the current transaction, and the artists and albums added by them
+  bool m_inBatch;
+  int m_batchFolders;
+  unsigned int m_batchStart;
+  std::set<int> m_batchArtists;
+  std::set<int> m_batchAlbums;
+
+  StageStats m_statTags;
+  StageStats m_statCommit;
+  StageStats m_statScraper;
 };
 }
@@ -0,0 +1,377 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "music/infoscanner/MusicInfoScanner.h"
+#include "music/tags/MusicInfoTag.h"
+#include "DatabaseManager.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/Settings.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "FileItem.h"
+
+#include "gtest/gtest.h"
+
+#define TEST_SONGS 8
+
+using namespace MUSIC_INFO;
+using namespace XFILE;
+
+// gives the tests access to the stages of a scan
+class CTestMusicInfoScanner : public CMusicInfoScanner
+{
+public:
+  using CMusicInfoScanner::ReadTags;
+  using CMusicInfoScanner::DoScan;
+  using CMusicInfoScanner::CommitBatch;
+  using CMusicInfoScanner::RollbackBatch;
+  using CMusicInfoScanner::StartWorkers;
+  using CMusicInfoScanner::StopWorkers;
+  using CMusicInfoScanner::QueueScrape;
+  using CMusicInfoScanner::WaitForScrapers;
+  using CMusicInfoScanner::OnScraped;
+
+  using CMusicInfoScanner::m_musicDatabase;
+  using CMusicInfoScanner::m_flags;
+  using CMusicInfoScanner::m_inBatch;
+  using CMusicInfoScanner::m_artistsScanned;
+  using CMusicInfoScanner::m_scrapersQueued;
+  using CMusicInfoScanner::m_scrapersPending;
+  using CMusicInfoScanner::m_statTags;
+  using CMusicInfoScanner::m_statScraper;
+  using CMusicInfoScanner::m_writeSection;
+};
+
+// writes album art on its own connection the way the scraper workers do
+class CTestScraperWriter : public CThread
+{
+public:
+  CTestScraperWriter(CTestMusicInfoScanner &scanner) :
+    CThread("CTestScraperWriter"), m_writes(0), m_scanner(scanner) {}
+
+  volatile int m_writes;
+
+protected:
+  virtual void Process()
+  {
+    CMusicDatabase database;
+    if (!database.Open())
+      return;
+    while (!m_bStop)
+    {
+      {
+        CSingleLock lock(m_scanner.m_writeSection);
+        database.SetArtForItem(m_writes + 1, "album", "thumb", StringUtils::Format("thumb%d.jpg", m_writes + 1));
+      }
+      m_writes++;
+      Sleep(1);
+    }
+    database.Close();
+  }
+
+  CTestMusicInfoScanner &m_scanner;
+};
+
+static void AppendFrame(std::string &tag, const char *id, const std::string &text)
+{
+  // ID3v2.3 text frame: id, big endian size, flags, ISO-8859-1 encoding and the text
+  size_t size = text.size() + 1;
+  tag.append(id, 4);
+  tag += (char)((size >> 24) & 0xff);
+  tag += (char)((size >> 16) & 0xff);
+  tag += (char)((size >> 8) & 0xff);
+  tag += (char)(size & 0xff);
+  tag.append(2, '\0');
+  tag += '\0';
+  tag += text;
+}
+
+// an ID3v2 tagged mp3 of a couple of silent frames
+static bool WriteSong(const std::string &path, const std::string &title, const std::string &artist, const std::string &album, int track)
+{
+  std::string frames;
+  AppendFrame(frames, "TIT2", title);
+  AppendFrame(frames, "TPE1", artist);
+  AppendFrame(frames, "TALB", album);
+  AppendFrame(frames, "TRCK", StringUtils::Format("%d", track));
+
+  std::string data("ID3\x03\x00\x00", 6);
+  size_t size = frames.size();
+  data += (char)((size >> 21) & 0x7f);
+  data += (char)((size >> 14) & 0x7f);
+  data += (char)((size >> 7) & 0x7f);
+  data += (char)(size & 0x7f);
+  data += frames;
+
+  // MPEG 1 layer III, 128 kbit/s, 44.1 kHz: 417 bytes per frame
+  for (int i = 0; i < 4; i++)
+  {
+    data.append("\xff\xfb\x90\x00", 4);
+    data.append(417 - 4, '\0');
+  }
+
+  CFile file;
+  if (!file.OpenForWrite(path, true))
+    return false;
+  bool ok = file.Write(data.c_str(), data.size()) == (int)data.size();
+  file.Close();
+  return ok;
+}
+
+class TestMusicInfoScanner : public testing::Test
+{
+protected:
+  TestMusicInfoScanner()
+  {
+    m_databaseSettings = g_advancedSettings.m_databaseMusic;
+    m_tagThreads = g_advancedSettings.m_musicScannerTagThreads;
+    m_commitBatch = g_advancedSettings.m_musicScannerCommitBatch;
+    m_scraperThreads = g_advancedSettings.m_musicScannerScraperThreads;
+    m_musicExtensions = g_settings.m_musicExtensions;
+
+    // a fresh database in the temp folder for every test
+    static int count = 0;
+    m_folder = CSpecialProtocol::TranslatePath(StringUtils::Format("special://temp/musicscanner%d/", count++));
+    g_advancedSettings.m_databaseMusic.Reset();
+    g_advancedSettings.m_databaseMusic.type = "sqlite3";
+    g_advancedSettings.m_databaseMusic.host = m_folder;
+    g_settings.m_musicExtensions = ".mp3";
+
+    m_path = URIUtils::AddFileToFolder(m_folder, "album/");
+    CDirectory::Create(m_folder);
+    CDirectory::Create(m_path);
+
+    // creates the tables, databases can't be opened before they are updated
+    CDatabaseManager::Get().Initialize();
+    for (int i = 0; i < TEST_SONGS; i++)
+      WriteSong(URIUtils::AddFileToFolder(m_path, StringUtils::Format("%02d.mp3", i + 1)),
+                StringUtils::Format("Song %d", i + 1), "Artist", "Album", i + 1);
+    // not a song, must be skipped by all stages
+    CFile::Cache(URIUtils::AddFileToFolder(m_path, "01.mp3"), URIUtils::AddFileToFolder(m_path, "folder.jpg"));
+  }
+
+  ~TestMusicInfoScanner()
+  {
+    g_advancedSettings.m_databaseMusic = m_databaseSettings;
+    g_advancedSettings.m_musicScannerTagThreads = m_tagThreads;
+    g_advancedSettings.m_musicScannerCommitBatch = m_commitBatch;
+    g_advancedSettings.m_musicScannerScraperThreads = m_scraperThreads;
+    g_settings.m_musicExtensions = m_musicExtensions;
+    CDirectory::Remove(m_folder);
+  }
+
+  // the number of songs of the test album committed to the database, as seen by another connection
+  int CommittedSongs(bool &hasHash)
+  {
+    CMusicDatabase database;
+    if (!database.Open())
+      return -1;
+    CStdString hash;
+    hasHash = database.GetPathHash(m_path, hash);
+    CSongMap songs;
+    database.GetSongsByPath(m_path, songs);
+    database.Close();
+    return songs.Size();
+  }
+
+  DatabaseSettings m_databaseSettings;
+  int m_tagThreads;
+  int m_commitBatch;
+  int m_scraperThreads;
+  CStdString m_musicExtensions;
+  std::string m_folder;
+  std::string m_path;
+};
+
+TEST_F(TestMusicInfoScanner, ReadTags)
+{
+  // on the scanner thread and on the tag reader workers
+  int threads[] = { 0, 4 };
+  for (unsigned int i = 0; i < sizeof(threads) / sizeof(threads[0]); i++)
+  {
+    g_advancedSettings.m_musicScannerTagThreads = threads[i];
+
+    CFileItemList items;
+    ASSERT_TRUE(CDirectory::GetDirectory(m_path, items, ".mp3|.jpg"));
+    ASSERT_EQ(TEST_SONGS + 1, items.Size());
+
+    CTestMusicInfoScanner scanner;
+    scanner.StartWorkers();
+    EXPECT_TRUE(scanner.ReadTags(items));
+    scanner.StopWorkers();
+
+    EXPECT_EQ((unsigned int)TEST_SONGS, scanner.m_statTags.items);
+    for (int j = 0; j < items.Size(); j++)
+    {
+      CFileItemPtr item = items[j];
+      if (item->IsPicture())
+      {
+        EXPECT_FALSE(item->HasMusicInfoTag() && item->GetMusicInfoTag()->Loaded());
+        continue;
+      }
+      ASSERT_TRUE(item->GetMusicInfoTag()->Loaded()) << item->GetPath();
+      int track = atoi(URIUtils::GetFileName(item->GetPath()).c_str());
+      EXPECT_EQ(StringUtils::Format("Song %d", track), item->GetMusicInfoTag()->GetTitle());
+      EXPECT_EQ(track, item->GetMusicInfoTag()->GetTrackNumber());
+    }
+  }
+}
+
+TEST_F(TestMusicInfoScanner, CommitBatch)
+{
+  g_advancedSettings.m_musicScannerCommitBatch = 1000;
+
+  CTestMusicInfoScanner scanner;
+  ASSERT_TRUE(scanner.m_musicDatabase.Open());
+  scanner.StartWorkers();
+
+  // nothing is visible to others until the batch is committed
+  bool hasHash = true;
+  EXPECT_TRUE(scanner.DoScan(m_path));
+  EXPECT_TRUE(scanner.m_inBatch);
+  scanner.CommitBatch();
+  EXPECT_FALSE(scanner.m_inBatch);
+  EXPECT_EQ(TEST_SONGS, CommittedSongs(hasHash));
+  EXPECT_TRUE(hasHash);
+
+  // and an unchanged folder is skipped
+  EXPECT_TRUE(scanner.DoScan(m_path));
+  EXPECT_FALSE(scanner.m_inBatch);
+
+  scanner.StopWorkers();
+  scanner.m_musicDatabase.Close();
+}
+
+TEST_F(TestMusicInfoScanner, RollbackBatch)
+{
+  g_advancedSettings.m_musicScannerCommitBatch = 1000;
+
+  CTestMusicInfoScanner scanner;
+  ASSERT_TRUE(scanner.m_musicDatabase.Open());
+  scanner.StartWorkers();
+
+  // the songs and the path hash of a rolled back folder are gone
+  bool hasHash = true;
+  EXPECT_TRUE(scanner.DoScan(m_path));
+  scanner.RollbackBatch();
+  EXPECT_FALSE(scanner.m_inBatch);
+  EXPECT_EQ(0, CommittedSongs(hasHash));
+  EXPECT_FALSE(hasHash);
+
+  // so the next scan picks the folder up again
+  EXPECT_TRUE(scanner.DoScan(m_path));
+  EXPECT_TRUE(scanner.m_inBatch);
+  scanner.CommitBatch();
+  EXPECT_EQ(TEST_SONGS, CommittedSongs(hasHash));
+  EXPECT_TRUE(hasHash);
+
+  scanner.StopWorkers();
+  scanner.m_musicDatabase.Close();
+}
+
+TEST_F(TestMusicInfoScanner, ConcurrentScraperWrites)
+{
+  g_advancedSettings.m_musicScannerCommitBatch = 1000;
+
+  CTestMusicInfoScanner scanner;
+  ASSERT_TRUE(scanner.m_musicDatabase.Open());
+  scanner.StartWorkers();
+
+  CTestScraperWriter writer(scanner);
+  writer.Create();
+  while (writer.m_writes < 10)
+    Sleep(1);
+
+  // the writer waits for the batch instead of failing it
+  bool hasHash = false;
+  EXPECT_TRUE(scanner.DoScan(m_path));
+  EXPECT_TRUE(scanner.m_inBatch);
+  int writes = writer.m_writes;
+  Sleep(50);
+  EXPECT_EQ(writes, writer.m_writes);
+  scanner.CommitBatch();
+  while (writer.m_writes < writes + 10)
+    Sleep(1);
+  writer.StopThread();
+
+  EXPECT_EQ(TEST_SONGS, CommittedSongs(hasHash));
+  EXPECT_TRUE(hasHash);
+
+  // and none of its writes were lost
+  CMusicDatabase database;
+  ASSERT_TRUE(database.Open());
+  for (int i = 1; i <= writer.m_writes; i++)
+    EXPECT_EQ(StringUtils::Format("thumb%d.jpg", i), database.GetArtForItem(i, "album", "thumb"));
+  database.Close();
+
+  scanner.StopWorkers();
+  scanner.m_musicDatabase.Close();
+}
+
+TEST_F(TestMusicInfoScanner, ScraperAccounting)
+{
+  g_advancedSettings.m_musicScannerScraperThreads = 2;
+
+  CTestMusicInfoScanner scanner;
+  scanner.m_flags = CMusicInfoScanner::SCAN_ONLINE;
+  scanner.StartWorkers();
+
+  // there's no scraper in the test environment so everything fails
+  for (long id = 1; id <= 5; id++)
+  {
+    scanner.m_artistsScanned.push_back(id);
+    scanner.QueueScrape(false, id);
+  }
+  EXPECT_TRUE(scanner.WaitForScrapers());
+  EXPECT_EQ(5U, scanner.m_scrapersQueued);
+  EXPECT_EQ(0U, scanner.m_scrapersPending);
+  EXPECT_EQ(0U, scanner.m_statScraper.items);
+  EXPECT_EQ(5U, scanner.m_statScraper.failed);
+  // failed items are retried by the next scan
+  EXPECT_TRUE(scanner.m_artistsScanned.empty());
+
+  scanner.OnScraped(true, 6, true, 100);
+  EXPECT_EQ(1U, scanner.m_statScraper.items);
+  EXPECT_EQ(5U, scanner.m_statScraper.failed);
+
+  scanner.StopWorkers();
+  EXPECT_EQ(0U, scanner.m_scrapersPending);
+}
+
+TEST_F(TestMusicInfoScanner, StopWorkers)
+{
+  g_advancedSettings.m_musicScannerScraperThreads = 0;
+
+  // without workers nothing is ever scraped, stopping drops the queued items
+  CTestMusicInfoScanner scanner;
+  scanner.m_flags = CMusicInfoScanner::SCAN_ONLINE;
+  scanner.StartWorkers();
+  scanner.QueueScrape(true, 1);
+  scanner.QueueScrape(false, 2);
+  EXPECT_EQ(2U, scanner.m_scrapersPending);
+  scanner.StopWorkers();
+  EXPECT_EQ(0U, scanner.m_scrapersPending);
+  EXPECT_EQ(0U, scanner.m_statScraper.items + scanner.m_statScraper.failed);
+}
@@ -49,6 +49,24 @@ CMusicInfoTagLoaderFactory::CMusicInfoTagLoaderFactory()
 CMusicInfoTagLoaderFactory::~CMusicInfoTagLoaderFactory()
 {}
 
+static bool IsTagLibExtension(const CStdString& strExtension)
+{
+  return (strExtension == "aac" ||
+          strExtension == "ape" || strExtension == "mac" ||
+          strExtension == "mp3" || 
+          strExtension == "wma" || 
+          strExtension == "flac" || 
+          strExtension == "m4a" || strExtension == "mp4" ||
+          strExtension == "mpc" || strExtension == "mpp" || strExtension == "mp+" ||
+          strExtension == "ogg" || strExtension == "oga" || strExtension == "oggstream" ||
+#ifdef HAS_MOD_PLAYER
+          ModPlayer::IsSupportedFormat(strExtension) ||
+          strExtension == "mod" || strExtension == "nsf" || strExtension == "nsfstream" ||
+          strExtension == "s3m" || strExtension == "it" || strExtension == "xm" ||
+#endif
+          strExtension == "wv");
+}
+
 IMusicInfoTagLoader* CMusicInfoTagLoaderFactory::CreateLoader(const CStdString& strFileName)
 {
   // dont try to read the tags for streams & shoutcast
@@ -67,20 +85,7 @@ IMusicInfoTagLoader* CMusicInfoTagLoaderFactory::CreateLoader(const CStdString&
   if (strExtension.IsEmpty())
     return NULL;
 
-  if (strExtension == "aac" ||
-      strExtension == "ape" || strExtension == "mac" ||
-      strExtension == "mp3" || 
-      strExtension == "wma" || 
-      strExtension == "flac" || 
-      strExtension == "m4a" || strExtension == "mp4" ||
-      strExtension == "mpc" || strExtension == "mpp" || strExtension == "mp+" ||
-      strExtension == "ogg" || strExtension == "oga" || strExtension == "oggstream" ||
-#ifdef HAS_MOD_PLAYER
-      ModPlayer::IsSupportedFormat(strExtension) ||
-      strExtension == "mod" || strExtension == "nsf" || strExtension == "nsfstream" ||
-      strExtension == "s3m" || strExtension == "it" || strExtension == "xm" ||
-#endif
-      strExtension == "wv")
+  if (IsTagLibExtension(strExtension))
   {
     CTagLoaderTagLib *pTagLoader = new CTagLoaderTagLib();
     return (IMusicInfoTagLoader*)pTagLoader;
@@ -127,3 +132,13 @@ IMusicInfoTagLoader* CMusicInfoTagLoaderFactory::CreateLoader(const CStdString&
 
   return NULL;
 }
+
+bool CMusicInfoTagLoaderFactory::CanLoadConcurrently(const CStdString& strFileName)
+{
+  CStdString strExtension;
+  URIUtils::GetExtension(strFileName, strExtension);
+  strExtension.ToLower();
+  strExtension.TrimLeft('.');
+
+  return !strExtension.IsEmpty() && IsTagLibExtension(strExtension);
+}
@@ -30,6 +30,13 @@ namespace MUSIC_INFO
       virtual ~CMusicInfoTagLoaderFactory();
 
       static IMusicInfoTagLoader* CreateLoader(const CStdString& strFileName);
+
+      /*! \brief Whether the tag of a file may be read while other tags are read
+       Only TagLib based loaders share no state between instances.
+       \param strFileName the file to read the tag of
+       \return true if the loader of the file may be used alongside others on other threads
+       */
+      static bool CanLoadConcurrently(const CStdString& strFileName);
   };
 }
 
@@ -29,6 +29,7 @@
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "interfaces/AnnouncementManager.h"
 #include "utils/log.h"
+#include "utils/JSONVariantWriter.h"
 #include "utils/Variant.h"
 #include "threads/SingleLock.h"
 #include "websocket/WebSocketManager.h"
@@ -537,14 +538,23 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
   return true;
 }
 
-void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
+bool CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
 {
   unsigned int sent = 0;
   do
   {
     CSingleLock lock (m_critSection);
-    sent += send(m_socket, data, size - sent, 0);
+    int result = send(m_socket, data + sent, size - sent, 0);
+    if (result < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      CLog::Log(LOGDEBUG, "JSONRPC Server: Failed to send data to client: %d", errno);
+      return false;
+    }
+    sent += result;
   } while (sent < size);
+  return true;
 }
 
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -575,8 +585,45 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
         m_endBrackets++;
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        Send(line.c_str(), line.size());
+        if (CanStream())
+        {
+          // the response is written to the socket while it is being
+          // serialized. The client lock is taken with the first chunk (i.e.
+          // once the request has been handled) and held until the response
+          // is complete so that announcements can't end up in the middle of it.
+          // Once sending fails the rest of the response is not serialized.
+          class CResponseStream : public IJSONWriterStream
+          {
+          public:
+            CResponseStream(CTCPClient *client) : m_client(client), m_locked(false), m_failed(false) { }
+            ~CResponseStream() { if (m_locked) m_client->m_critSection.unlock(); }
+
+            virtual bool Write(const char *data, size_t size)
+            {
+              if (m_failed)
+                return false;
+              if (!m_locked)
+              {
+                m_client->m_critSection.lock();
+                m_locked = true;
+              }
+              if (m_client->m_socket == INVALID_SOCKET || !m_client->Send(data, size))
+                m_failed = true;
+              return !m_failed;
+            }
+          private:
+            CTCPClient *m_client;
+            bool m_locked;
+            bool m_failed;
+          } stream(this);
+
+          CJSONRPC::MethodCall(m_buffer, host, this, stream);
+        }
+        else
+        {
+          std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
+          Send(line.c_str(), line.size());
+        }
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
       }
@@ -640,15 +687,19 @@ CTCPServer::CWebSocketClient& CTCPServer::CWebSocketClient::operator=(const CWeb
   return *this;
 }
 
-void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
+bool CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
 {
   const CWebSocketMessage *msg = m_websocket->Send(WebSocketTextFrame, data, size);
   if (msg == NULL || !msg->IsComplete())
-    return;
+    return false;
 
   std::vector<const CWebSocketFrame *> frames = msg->GetFrames();
   for (unsigned int index = 0; index < frames.size(); index++)
-    CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
+  {
+    if (!CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength()))
+      return false;
+  }
+  return true;
 }
 
 void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
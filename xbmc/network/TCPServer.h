@@ -65,12 +65,21 @@ namespace JSONRPC
       virtual int  GetAnnouncementFlags();
       virtual bool SetAnnouncementFlags(int flags);
 
-      virtual void Send(const char *data, unsigned int size);
+      /*!
+       \brief Send data to the client
+       \return true if all of the data was sent, false if sending failed
+       */
+      virtual bool Send(const char *data, unsigned int size);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
       virtual bool IsNew() const { return m_new; }
       virtual bool Closing() const { return false; }
+      /*!
+       \brief Whether a response may be passed to Send() in several chunks
+       while it is being serialized
+       */
+      virtual bool CanStream() const { return true; }
 
       SOCKET           m_socket;
       sockaddr_storage m_cliaddr;
@@ -96,12 +105,14 @@ namespace JSONRPC
       CWebSocketClient& operator=(const CWebSocketClient& client);
       ~CWebSocketClient();
 
-      virtual void Send(const char *data, unsigned int size);
+      virtual bool Send(const char *data, unsigned int size);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
       virtual bool IsNew() const { return m_websocket == NULL; }
       virtual bool Closing() const { return m_websocket != NULL && m_websocket->GetState() == WebSocketStateClosed; }
+      // every Send() results in a separate websocket message
+      virtual bool CanStream() const { return false; }
 
     private:
       CWebSocket *m_websocket;
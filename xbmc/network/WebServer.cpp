@@ -21,6 +21,10 @@
 #include "WebServer.h"
 #ifdef HAS_WEB_SERVER
 #include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/StringUtils.h"
+#include "TextureCache.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
@@ -31,9 +35,12 @@
 
 #ifdef _WIN32
 #pragma comment(lib, "libmicrohttpd.dll.lib")
+#else
+#include <fcntl.h>
 #endif
 
 #define MAX_POST_BUFFER_SIZE 2048
+#define FILE_DOWNLOAD_BLOCK_SIZE 32768
 
 #define PAGE_FILE_NOT_FOUND "<html><head><title>File not found</title></head><body>File not found</body></html>"
 #define NOT_SUPPORTED       "<html><head><title>Not Supported</title></head><body>The method you are trying to use is not supported by this server</body></html>"
@@ -361,6 +368,13 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
   if (file->Open(strURL, READ_NO_CACHE))
   {
     bool getData = true;
+    int64_t fileLength = file->GetLength();
+    int64_t firstPosition = 0;
+    int64_t lastPosition = fileLength - 1;
+
+    struct __stat64 statBuffer;
+    bool hasStat = file->Stat(&statBuffer) == 0;
+
     if (methodType != HEAD)
     {
       if (methodType == GET)
@@ -371,8 +385,7 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
           CDateTime ifModifiedSinceDate;
           ifModifiedSinceDate.SetFromRFC1123DateTime(ifModifiedSince);
 
-          struct __stat64 statBuffer;
-          if (file->Stat(&statBuffer) == 0)
+          if (hasStat)
           {
             struct tm *time = localtime((time_t *)&statBuffer.st_mtime);
             if (time != NULL)
@@ -387,13 +400,52 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
             }
           }
         }
+
+        // a conditional range request (If-Range) always gets the whole file
+        string range = GetRequestHeaderValue(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_RANGE);
+        if (getData && !range.empty() && fileLength > 0 &&
+            GetRequestHeaderValue(connection, MHD_HEADER_KIND, "If-Range").empty())
+        {
+          switch (ParseRangeHeader(range, fileLength, firstPosition, lastPosition))
+          {
+            case RangeValid:
+              responseCode = MHD_HTTP_PARTIAL_CONTENT;
+              break;
+
+            case RangeNotSatisfiable:
+            {
+              getData = false;
+              response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
+              responseCode = MHD_HTTP_REQUESTED_RANGE_NOT_SATISFIABLE;
+              if (response != NULL)
+              {
+                CStdString contentRange;
+                contentRange.Format("bytes */%" PRId64, fileLength);
+                MHD_add_response_header(response, "Content-Range", contentRange);
+              }
+              break;
+            }
+
+            default:
+              // ignore anything we don't understand and send the whole file
+              firstPosition = 0;
+              lastPosition = fileLength - 1;
+              break;
+          }
+        }
       }
 
       if (getData)
-        response = MHD_create_response_from_callback(file->GetLength(),
-                                                     2048,
-                                                     &CWebServer::ContentReaderCallback, file,
-                                                     &CWebServer::ContentReaderFreeCallback);
+      {
+        int64_t length = lastPosition - firstPosition + 1;
+        response = CreateFileContentResponse(file, strURL, firstPosition, length);
+        if (responseCode == MHD_HTTP_PARTIAL_CONTENT && response != NULL)
+        {
+          CStdString contentRange;
+          contentRange.Format("bytes %" PRId64 "-%" PRId64 "/%" PRId64, firstPosition, lastPosition, fileLength);
+          MHD_add_response_header(response, "Content-Range", contentRange);
+        }
+      }
       if (response == NULL)
       {
         file->Close();
@@ -406,7 +458,7 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
       getData = false;
 
       CStdString contentLength;
-      contentLength.Format("%I64d", file->GetLength());
+      contentLength.Format("%I64d", fileLength);
 
       response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
       if (response == NULL)
@@ -418,6 +470,8 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
       MHD_add_response_header(response, "Content-Length", contentLength);
     }
 
+    MHD_add_response_header(response, "Accept-Ranges", "bytes");
+
     // set the Content-Type header
     CStdString ext = URIUtils::GetExtension(strURL);
     ext = ext.ToLower();
@@ -426,8 +480,7 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
       MHD_add_response_header(response, "Content-Type", mime);
 
     // set the Last-Modified header
-    struct __stat64 statBuffer;
-    if (file->Stat(&statBuffer) == 0)
+    if (hasStat)
     {
       struct tm *time = localtime((time_t *)&statBuffer.st_mtime);
       if (time != NULL)
@@ -461,6 +514,129 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
   return MHD_YES;
 }
 
+CWebServer::RangeResult CWebServer::ParseRangeHeader(const string &range, int64_t fileLength, int64_t &firstPosition, int64_t &lastPosition)
+{
+  // only a single byte range is supported ("bytes=first-last", "bytes=first-" or "bytes=-suffix")
+  if (range.compare(0, 6, "bytes=") != 0 || range.find(',') != string::npos)
+    return RangeInvalid;
+
+  string value = range.substr(6);
+  StringUtils::Trim(value);
+  size_t dash = value.find('-');
+  if (dash == string::npos)
+    return RangeInvalid;
+
+  string first = value.substr(0, dash);
+  string last = value.substr(dash + 1);
+  StringUtils::Trim(first);
+  StringUtils::Trim(last);
+  if ((first.empty() && last.empty()) ||
+      (!first.empty() && !StringUtils::IsNaturalNumber(first)) ||
+      (!last.empty() && !StringUtils::IsNaturalNumber(last)))
+    return RangeInvalid;
+
+  if (first.empty())
+  {
+    // the last n bytes of the file
+    int64_t suffix = strtoll(last.c_str(), NULL, 10);
+    if (suffix <= 0)
+      return RangeNotSatisfiable;
+
+    firstPosition = suffix < fileLength ? fileLength - suffix : 0;
+    lastPosition = fileLength - 1;
+    return RangeValid;
+  }
+
+  firstPosition = strtoll(first.c_str(), NULL, 10);
+  lastPosition = last.empty() ? fileLength - 1 : strtoll(last.c_str(), NULL, 10);
+  if (lastPosition < firstPosition)
+    return RangeInvalid;
+  if (firstPosition >= fileLength)
+    return RangeNotSatisfiable;
+  if (lastPosition >= fileLength)
+    lastPosition = fileLength - 1;
+
+  return RangeValid;
+}
+
+string CWebServer::GetLocalPath(const string &strURL)
+{
+  CStdString path = strURL;
+
+  // images are served from the texture cache
+  if (path.Left(8).Equals("image://"))
+  {
+    bool needsRecaching = false;
+    path = CTextureCache::Get().CheckCachedImage(path, false, needsRecaching);
+    if (path.IsEmpty())
+      return "";
+  }
+
+  if (URIUtils::IsSpecial(path))
+    path = CSpecialProtocol::TranslatePath(path);
+
+  // anything with a protocol (including archives and stacks) has to go through the VFS
+  CURL url(path);
+  if (!url.GetProtocol().IsEmpty())
+    return "";
+
+  return path;
+}
+
+struct MHD_Response *CWebServer::CreateFileContentResponse(CFile *&file, const string &strURL, int64_t offset, int64_t length)
+{
+  struct MHD_Response *response = NULL;
+
+#if !defined(_WIN32) && (MHD_VERSION >= 0x00091800)
+  // hand local files to libmicrohttpd as a file descriptor so that it can
+  // send them with sendfile() instead of copying them through a CFile
+  string localPath = GetLocalPath(strURL);
+  if (!localPath.empty())
+  {
+#if (MHD_VERSION >= 0x00093700)
+    int fd = open(localPath.c_str(), O_RDONLY);
+#else
+    // older versions take the length as a size_t, anything larger than that has to go through CFile
+    int fd = (uint64_t)length <= SIZE_MAX ? open(localPath.c_str(), O_RDONLY) : -1;
+#endif
+    if (fd >= 0)
+    {
+      // libmicrohttpd closes the descriptor when the response is destroyed
+#if (MHD_VERSION >= 0x00093700)
+      response = MHD_create_response_from_fd_at_offset64(length, fd, offset);
+#else
+      response = MHD_create_response_from_fd_at_offset((size_t)length, fd, offset);
+#endif
+      if (response != NULL)
+      {
+        file->Close();
+        delete file;
+        file = NULL;
+        return response;
+      }
+      close(fd);
+    }
+  }
+#endif
+
+  HttpFileDownloadContext *context = new HttpFileDownloadContext;
+  context->file = file;
+  context->offset = offset;
+  response = MHD_create_response_from_callback(length,
+                                               FILE_DOWNLOAD_BLOCK_SIZE,
+                                               &CWebServer::ContentReaderCallback, context,
+                                               &CWebServer::ContentReaderFreeCallback);
+  if (response == NULL)
+  {
+    delete context;
+    return NULL;
+  }
+
+  // the file is owned by the response now
+  file = NULL;
+  return response;
+}
+
 int CWebServer::CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response)
 {
   size_t payloadSize = 0;
@@ -510,7 +686,7 @@ int CWebServer::SendErrorResponse(struct MHD_Connection *connection, int errorTy
 
 void* CWebServer::UriRequestLogger(void *cls, const char *uri)
 {
-  CLog::Log(LOGDEBUG, "webserver: request received for %s", uri);
+  CLog::Log(LOGDEBUG | LOGWEBSERVER, "webserver: request received for %s", uri);
   return NULL;
 }
 
@@ -522,10 +698,11 @@ int CWebServer::ContentReaderCallback(void *cls, uint64_t pos, char *buf, int ma
 int CWebServer::ContentReaderCallback(void *cls, size_t pos, char *buf, int max)
 #endif
 {
-  CFile *file = (CFile *)cls;
-  if((unsigned int)pos != file->GetPosition())
-    file->Seek(pos);
-  unsigned res = file->Read(buf, max);
+  HttpFileDownloadContext *context = (HttpFileDownloadContext *)cls;
+  int64_t position = context->offset + (int64_t)pos;
+  if (position != context->file->GetPosition())
+    context->file->Seek(position);
+  unsigned res = context->file->Read(buf, max);
   if(res == 0)
     return -1;
   return res;
@@ -533,10 +710,11 @@ int CWebServer::ContentReaderCallback(void *cls, size_t pos, char *buf, int max)
 
 void CWebServer::ContentReaderFreeCallback(void *cls)
 {
-  CFile *file = (CFile *)cls;
-  file->Close();
+  HttpFileDownloadContext *context = (HttpFileDownloadContext *)cls;
+  context->file->Close();
 
-  delete file;
+  delete context->file;
+  delete context;
 }
 
 struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
@@ -544,7 +722,7 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
   // WARNING: when using MHD_USE_THREAD_PER_CONNECTION, set MHD_OPTION_CONNECTION_TIMEOUT to something higher than 1
   // otherwise on libmicrohttpd 0.4.4-1 it spins a busy loop
 
-  unsigned int timeout = 60 * 60 * 24;
+  unsigned int timeout = g_advancedSettings.m_webserverConnectionTimeout;
   // MHD_USE_THREAD_PER_CONNECTION = one thread per connection
   // MHD_USE_SELECT_INTERNALLY = use main thread for each connection, can only handle one request at a time [unless you set the thread pool size]
 
@@ -555,7 +733,7 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
                           &CWebServer::AnswerToConnection,
                           this,
 #if (MHD_VERSION >= 0x00040002)
-                          MHD_OPTION_THREAD_POOL_SIZE, 4,
+                          MHD_OPTION_THREAD_POOL_SIZE, g_advancedSettings.m_webserverThreads,
 #endif
                           MHD_OPTION_CONNECTION_LIMIT, 512,
                           MHD_OPTION_CONNECTION_TIMEOUT, timeout,
@@ -568,6 +746,11 @@ bool CWebServer::Start(int port, const string &username, const string &password)
   SetCredentials(username, password);
   if (!m_running)
   {
+#if defined(TARGET_LINUX) && (MHD_VERSION >= 0x00093300)
+    // a fixed pool of event driven workers, each handling many connections through epoll
+    m_daemon = StartMHD(MHD_USE_SELECT_INTERNALLY | MHD_USE_EPOLL_LINUX_ONLY, port);
+    if (m_daemon == NULL)
+#endif
     m_daemon = StartMHD(MHD_USE_SELECT_INTERNALLY, port);
 
     m_running = m_daemon != NULL;
@@ -33,6 +33,11 @@
 #include "threads/CriticalSection.h"
 #include "httprequesthandler/IHTTPRequestHandler.h"
 
+namespace XFILE
+{
+  class CFile;
+}
+
 class CWebServer : public JSONRPC::ITransportLayer
 {
 public:
@@ -92,6 +97,7 @@ private:
   static void ContentReaderFreeCallback (void *cls);
   static int CreateRedirect(struct MHD_Connection *connection, const std::string &strURL, struct MHD_Response *&response);
   static int CreateFileDownloadResponse(struct MHD_Connection *connection, const std::string &strURL, HTTPMethod methodType, struct MHD_Response *&response, int &responseCode);
+  static struct MHD_Response *CreateFileContentResponse(XFILE::CFile *&file, const std::string &strURL, int64_t offset, int64_t length);
   static int CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response);
   static int CreateMemoryDownloadResponse(struct MHD_Connection *connection, void *data, size_t size, bool free, bool copy, struct MHD_Response *&response);
 
@@ -103,6 +109,28 @@ private:
 
   static const char *CreateMimeTypeFromExtension(const char *ext);
 
+  enum RangeResult
+  {
+    RangeInvalid,
+    RangeNotSatisfiable,
+    RangeValid
+  };
+
+  /*!
+   \brief Parse the value of a Range header for a file of the given length
+   Only a single byte range is supported.
+   \return RangeValid with the positions of the first and last requested byte,
+   RangeNotSatisfiable if the range lies outside of the file and RangeInvalid
+   if the header should be ignored.
+   */
+  static RangeResult ParseRangeHeader(const std::string &range, int64_t fileLength, int64_t &firstPosition, int64_t &lastPosition);
+
+  /*!
+   \brief Get the path of a file in the local filesystem
+   \return the local path or an empty string if the file has to be read through the VFS
+   */
+  static std::string GetLocalPath(const std::string &strURL);
+
   struct MHD_Daemon *m_daemon;
   bool m_running, m_needcredentials;
   std::string m_Credentials64Encoded;
@@ -114,5 +142,11 @@ private:
     IHTTPRequestHandler *requestHandler;
     struct MHD_PostProcessor *postprocessor;
   } ConnectionHandler;
+
+  typedef struct HttpFileDownloadContext
+  {
+    XFILE::CFile *file;
+    int64_t offset;
+  } HttpFileDownloadContext;
 };
 #endif
@@ -67,14 +67,47 @@ int CHTTPJsonRpcHandler::HandleHTTPRequest(const HTTPRequest &request)
     }
   }
 
+  // the response is serialized straight into the buffer handed to the webserver
+  m_response.clear();
+  CJSONWriterStringStream output(m_response);
   if (isRequest)
-    m_response = CJSONRPC::MethodCall(m_request, request.webserver, &client);
+  {
+    // the entity tag has to be retrieved before the call so that it can't
+    // belong to a library state newer than the response
+    string etag;
+    if (CJSONRPC::GetEntityTag(m_request, request.webserver, &client, etag))
+    {
+      m_responseHeaderFields.insert(pair<string, string>("ETag", etag));
+
+      // RFC 7232: a matching If-None-Match means "not modified" for GET only,
+      // for any other method the precondition failed
+      string ifNoneMatch = CWebServer::GetRequestHeaderValue(request.connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_NONE_MATCH);
+      if (!ifNoneMatch.empty() && (ifNoneMatch == "*" || ifNoneMatch.find(etag) != string::npos))
+      {
+        m_request.clear();
+
+        if (request.method == GET)
+        {
+          m_responseType = HTTPMemoryDownloadNoFreeCopy;
+          m_responseCode = MHD_HTTP_NOT_MODIFIED;
+        }
+        else
+        {
+          m_responseType = HTTPError;
+          m_responseCode = MHD_HTTP_PRECONDITION_FAILED;
+        }
+        return MHD_YES;
+      }
+    }
+
+    CJSONRPC::MethodCall(m_request, request.webserver, &client, output);
+  }
   else
   {
     // get the whole output of JSONRPC.Introspect
     CVariant result;
     CJSONServiceDescription::Print(result, request.webserver, &client);
-    m_response = CJSONVariantWriter::Write(result, false);
+    CJSONVariantWriter::Write(result, false, output);
   }
 
   m_responseHeaderFields.insert(pair<string, string>("Content-Type", "application/json"));
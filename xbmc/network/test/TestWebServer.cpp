@@ -0,0 +1,273 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "network/WebServer.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <map>
+#include <vector>
+
+#define TEST_FILE_SIZE  65536
+
+// port the webserver of the current test listens on
+static int testPort = 0;
+
+// asks the system for a port nobody is listening on
+static int GetFreePort()
+{
+  int sock = socket(AF_INET, SOCK_STREAM, 0);
+  if (sock < 0)
+    return 0;
+
+  struct sockaddr_in addr;
+  socklen_t size = sizeof(addr);
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = 0;
+  addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+  int port = 0;
+  if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) == 0 &&
+      getsockname(sock, (struct sockaddr *)&addr, &size) == 0)
+    port = ntohs(addr.sin_port);
+
+  close(sock);
+  return port;
+}
+
+// serves the test file either directly ("/webservertest/local") or through
+// the VFS ("/webservertest/vfs") to cover both ways of sending files
+class CTestFileHandler : public IHTTPRequestHandler
+{
+public:
+  virtual IHTTPRequestHandler* GetInstance() { return new CTestFileHandler(); }
+  virtual bool CheckHTTPRequest(const HTTPRequest &request) { return request.url.find("/webservertest/") == 0; }
+  virtual int HandleHTTPRequest(const HTTPRequest &request)
+  {
+    m_path = request.url == "/webservertest/vfs" ? "file://" + m_file : m_file;
+    m_responseCode = MHD_HTTP_OK;
+    m_responseType = HTTPFileDownload;
+    return MHD_YES;
+  }
+  virtual std::string GetHTTPResponseFile() const { return m_path; }
+
+  static std::string m_file;
+private:
+  std::string m_path;
+};
+
+std::string CTestFileHandler::m_file;
+
+typedef struct
+{
+  int status;
+  std::map<std::string, std::string> headers;
+  std::string body;
+} HttpResponse;
+
+// a minimal HTTP/1.1 client keeping its connection alive between requests
+class CHttpTestClient
+{
+public:
+  CHttpTestClient() : m_socket(-1) { }
+  ~CHttpTestClient() { Disconnect(); }
+
+  bool Connect()
+  {
+    m_socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_socket < 0)
+      return false;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(testPort);
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    return connect(m_socket, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+  }
+
+  void Disconnect()
+  {
+    if (m_socket >= 0)
+      close(m_socket);
+    m_socket = -1;
+    m_buffer.clear();
+  }
+
+  bool Get(const std::string &url, const std::string &extraHeaders, HttpResponse &response)
+  {
+    std::string request = "GET " + url + " HTTP/1.1\r\nHost: 127.0.0.1\r\n" + extraHeaders + "\r\n";
+    if (send(m_socket, request.c_str(), request.size(), 0) != (ssize_t)request.size())
+      return false;
+
+    size_t end;
+    while ((end = m_buffer.find("\r\n\r\n")) == std::string::npos)
+    {
+      if (!Receive())
+        return false;
+    }
+
+    std::vector<std::string> lines = StringUtils::Split(m_buffer.substr(0, end), "\r\n");
+    m_buffer.erase(0, end + 4);
+    if (lines.empty() || lines[0].size() < 12)
+      return false;
+
+    response.status = atoi(lines[0].substr(9, 3).c_str());
+    response.headers.clear();
+    for (size_t i = 1; i < lines.size(); i++)
+    {
+      size_t colon = lines[i].find(':');
+      if (colon == std::string::npos)
+        continue;
+      std::string value = lines[i].substr(colon + 1);
+      std::string name = lines[i].substr(0, colon);
+      StringUtils::Trim(value);
+      StringUtils::ToLower(name);
+      response.headers[name] = value;
+    }
+
+    size_t length = atoi(response.headers["content-length"].c_str());
+    while (m_buffer.size() < length)
+    {
+      if (!Receive())
+        return false;
+    }
+    response.body = m_buffer.substr(0, length);
+    m_buffer.erase(0, length);
+    return true;
+  }
+
+private:
+  bool Receive()
+  {
+    char buffer[16384];
+    ssize_t received = recv(m_socket, buffer, sizeof(buffer), 0);
+    if (received <= 0)
+      return false;
+    m_buffer.append(buffer, received);
+    return true;
+  }
+
+  int m_socket;
+  std::string m_buffer;
+};
+
+class TestWebServer : public testing::Test
+{
+protected:
+  TestWebServer()
+  {
+    m_data.resize(TEST_FILE_SIZE);
+    for (size_t i = 0; i < m_data.size(); i++)
+      m_data[i] = (char)('a' + i % 26);
+
+    m_file = XBMC_CREATETEMPFILE(".bin");
+    m_file->Write(m_data.c_str(), m_data.size());
+    m_file->Flush();
+    CTestFileHandler::m_file = XBMC_TEMPFILEPATH(m_file);
+
+    CWebServer::RegisterRequestHandler(&m_handler);
+    // retry in case someone else grabbed the port in the meantime
+    for (int i = 0; i < 5 && !m_webserver.IsStarted(); i++)
+    {
+      testPort = GetFreePort();
+      if (testPort > 0)
+        m_webserver.Start(testPort, "", "");
+    }
+  }
+
+  ~TestWebServer()
+  {
+    m_webserver.Stop();
+    CWebServer::UnregisterRequestHandler(&m_handler);
+    XBMC_DELETETEMPFILE(m_file);
+  }
+
+  CWebServer m_webserver;
+  CTestFileHandler m_handler;
+  XFILE::CFile *m_file;
+  std::string m_data;
+};
+
+TEST_F(TestWebServer, Download)
+{
+  ASSERT_TRUE(m_webserver.IsStarted());
+
+  CHttpTestClient client;
+  ASSERT_TRUE(client.Connect());
+
+  const char *urls[] = { "/webservertest/local", "/webservertest/vfs" };
+  for (unsigned int i = 0; i < sizeof(urls) / sizeof(urls[0]); i++)
+  {
+    HttpResponse response;
+    ASSERT_TRUE(client.Get(urls[i], "", response));
+    EXPECT_EQ(MHD_HTTP_OK, response.status);
+    EXPECT_STREQ("bytes", response.headers["accept-ranges"].c_str());
+    EXPECT_TRUE(response.body == m_data);
+  }
+}
+
+TEST_F(TestWebServer, RangeRequests)
+{
+  ASSERT_TRUE(m_webserver.IsStarted());
+
+  CHttpTestClient client;
+  ASSERT_TRUE(client.Connect());
+
+  const char *urls[] = { "/webservertest/local", "/webservertest/vfs" };
+  for (unsigned int i = 0; i < sizeof(urls) / sizeof(urls[0]); i++)
+  {
+    HttpResponse response;
+    ASSERT_TRUE(client.Get(urls[i], "Range: bytes=10-19\r\n", response));
+    EXPECT_EQ(MHD_HTTP_PARTIAL_CONTENT, response.status);
+    EXPECT_STREQ(StringUtils::Format("bytes 10-19/%d", TEST_FILE_SIZE).c_str(), response.headers["content-range"].c_str());
+    EXPECT_TRUE(response.body == m_data.substr(10, 10));
+
+    // open ended and suffix ranges
+    ASSERT_TRUE(client.Get(urls[i], "Range: bytes=65000-\r\n", response));
+    EXPECT_EQ(MHD_HTTP_PARTIAL_CONTENT, response.status);
+    EXPECT_TRUE(response.body == m_data.substr(65000));
+
+    ASSERT_TRUE(client.Get(urls[i], "Range: bytes=-100\r\n", response));
+    EXPECT_EQ(MHD_HTTP_PARTIAL_CONTENT, response.status);
+    EXPECT_TRUE(response.body == m_data.substr(TEST_FILE_SIZE - 100));
+
+    // the range ends behind the end of the file
+    ASSERT_TRUE(client.Get(urls[i], "Range: bytes=65530-70000\r\n", response));
+    EXPECT_EQ(MHD_HTTP_PARTIAL_CONTENT, response.status);
+    EXPECT_TRUE(response.body == m_data.substr(65530));
+
+    ASSERT_TRUE(client.Get(urls[i], "Range: bytes=70000-\r\n", response));
+    EXPECT_EQ(MHD_HTTP_REQUESTED_RANGE_NOT_SATISFIABLE, response.status);
+    EXPECT_STREQ(StringUtils::Format("bytes */%d", TEST_FILE_SIZE).c_str(), response.headers["content-range"].c_str());
+
+    // multiple ranges aren't supported and get the whole file
+    ASSERT_TRUE(client.Get(urls[i], "Range: bytes=0-9,20-29\r\n", response));
+    EXPECT_EQ(MHD_HTTP_OK, response.status);
+    EXPECT_TRUE(response.body == m_data);
+  }
+}
@@ -38,6 +38,14 @@
 #include "cores/omxplayer/OMXImage.h"
 #endif
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef __ARM_NEON__
+#include <arm_neon.h>
+#endif
+
 using namespace XFILE;
 
 bool CPicture::CreateThumbnailFromSurface(const unsigned char *buffer, int width, int height, int stride, const CStdString &thumbFile)
@@ -216,8 +224,87 @@ void CPicture::GetScale(unsigned int width, unsigned int height, unsigned int &o
     out_height = (unsigned int)(out_width / aspect + 0.5f);
 }
 
+// rounded average of two bytes, matching _mm_avg_epu8 and vrhadd
+#define AVG_U8(a, b) (uint8_t)(((unsigned int)(a) + (unsigned int)(b) + 1) >> 1)
+
+void CPicture::HalveImage(const uint8_t *in_pixels, unsigned int in_width, unsigned int in_height, unsigned int in_pitch,
+                          uint8_t *out_pixels, unsigned int out_pitch)
+{
+  unsigned int out_width = in_width / 2;
+  unsigned int out_height = in_height / 2;
+  for (unsigned int y = 0; y < out_height; y++)
+  {
+    const uint8_t *src0 = in_pixels + 2 * y * in_pitch;
+    const uint8_t *src1 = src0 + in_pitch;
+    uint8_t *dst = out_pixels + y * out_pitch;
+    unsigned int x = 0;
+#if defined(__SSE2__)
+    // 8 source pixels from each row -> 4 output pixels
+    for (; x + 4 <= out_width; x += 4)
+    {
+      __m128i a = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(src0 + 8 * x)), _mm_loadu_si128((const __m128i*)(src1 + 8 * x)));
+      __m128i b = _mm_avg_epu8(_mm_loadu_si128((const __m128i*)(src0 + 8 * x + 16)), _mm_loadu_si128((const __m128i*)(src1 + 8 * x + 16)));
+      __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0));
+      __m128 odd  = _mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(3, 1, 3, 1));
+      _mm_storeu_si128((__m128i*)(dst + 4 * x), _mm_avg_epu8(_mm_castps_si128(even), _mm_castps_si128(odd)));
+    }
+#elif defined(__ARM_NEON__)
+    for (; x + 4 <= out_width; x += 4)
+    {
+      uint32x4x2_t row0 = vld2q_u32((const uint32_t*)(src0 + 8 * x));
+      uint32x4x2_t row1 = vld2q_u32((const uint32_t*)(src1 + 8 * x));
+      uint8x16_t even = vrhaddq_u8(vreinterpretq_u8_u32(row0.val[0]), vreinterpretq_u8_u32(row1.val[0]));
+      uint8x16_t odd  = vrhaddq_u8(vreinterpretq_u8_u32(row0.val[1]), vreinterpretq_u8_u32(row1.val[1]));
+      vst1q_u8(dst + 4 * x, vrhaddq_u8(even, odd));
+    }
+#endif
+    for (; x < out_width; x++)
+    {
+      const uint8_t *s0 = src0 + 8 * x;
+      const uint8_t *s1 = src1 + 8 * x;
+      for (unsigned int c = 0; c < 4; c++)
+        dst[4 * x + c] = AVG_U8(AVG_U8(s0[c], s1[c]), AVG_U8(s0[c + 4], s1[c + 4]));
+    }
+  }
+}
+
 bool CPicture::ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned int in_height, unsigned int in_pitch,
                           uint8_t *out_pixels, unsigned int out_width, unsigned int out_height, unsigned int out_pitch)
+{
+  // big reductions go through a box filtered mip chain first: swscale's fast bilinear only samples
+  // 2 taps, so it both aliases and has to walk every source row when shrinking by a large factor.
+  uint8_t *halved[2] = { NULL, NULL };
+  unsigned int level = 0;
+  while (in_width >= 2 * out_width && in_height >= 2 * out_height && in_width >= 2 && in_height >= 2)
+  {
+    uint8_t *dest = halved[level & 1];
+    if (!dest) // allocated at its first (and largest) use
+      dest = halved[level & 1] = new uint8_t[(in_width / 2) * (in_height / 2) * 4];
+    HalveImage(in_pixels, in_width, in_height, in_pitch, dest, (in_width / 2) * 4);
+    in_pixels = dest;
+    in_width /= 2;
+    in_height /= 2;
+    in_pitch = in_width * 4;
+    level++;
+  }
+
+  bool success = false;
+  if (in_width == out_width && in_height == out_height)
+  { // the box filter got us there exactly
+    for (unsigned int y = 0; y < out_height; y++)
+      memcpy(out_pixels + y * out_pitch, in_pixels + y * in_pitch, out_width * 4);
+    success = true;
+  }
+  else
+    success = SwScaleImage(in_pixels, in_width, in_height, in_pitch, out_pixels, out_width, out_height, out_pitch);
+
+  delete[] halved[0];
+  delete[] halved[1];
+  return success;
+}
+
+bool CPicture::SwScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned int in_height, unsigned int in_pitch,
+                            uint8_t *out_pixels, unsigned int out_width, unsigned int out_height, unsigned int out_pitch)
 {
   DllSwScale dllSwScale;
   dllSwScale.Load();
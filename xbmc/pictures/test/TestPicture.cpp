@@ -0,0 +1,82 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "pictures/Picture.h"
+
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <vector>
+
+static void FillImage(std::vector<uint8_t> &image, unsigned int seed)
+{
+  srand(seed);
+  for (size_t i = 0; i < image.size(); i++)
+    image[i] = (uint8_t)(rand() & 0xff);
+}
+
+static uint8_t Avg(uint8_t a, uint8_t b)
+{
+  return (uint8_t)((a + b + 1) >> 1);
+}
+
+TEST(TestPicture, HalveImage)
+{
+  // odd sizes and a padded pitch exercise the scalar tail as well as the SIMD body
+  const unsigned int width = 37, height = 21, pitch = width * 4 + 12;
+  std::vector<uint8_t> in(pitch * height);
+  FillImage(in, 1);
+
+  const unsigned int out_width = width / 2, out_height = height / 2, out_pitch = out_width * 4;
+  std::vector<uint8_t> out(out_pitch * out_height);
+  CPicture::HalveImage(&in[0], width, height, pitch, &out[0], out_pitch);
+
+  for (unsigned int y = 0; y < out_height; y++)
+  {
+    for (unsigned int x = 0; x < out_width; x++)
+    {
+      for (unsigned int c = 0; c < 4; c++)
+      {
+        const uint8_t *s0 = &in[2 * y * pitch + 8 * x + c];
+        const uint8_t *s1 = s0 + pitch;
+        EXPECT_EQ(Avg(Avg(s0[0], s1[0]), Avg(s0[4], s1[4])), out[y * out_pitch + 4 * x + c]);
+      }
+    }
+  }
+}
+
+TEST(TestPicture, HalveImageFlat)
+{
+  const unsigned int width = 64, height = 64;
+  std::vector<uint8_t> in(width * height * 4);
+  for (size_t i = 0; i < in.size(); i += 4)
+  {
+    in[i + 0] = 0x10; in[i + 1] = 0x80; in[i + 2] = 0xfe; in[i + 3] = 0xff;
+  }
+  std::vector<uint8_t> out(width * height);
+  CPicture::HalveImage(&in[0], width, height, width * 4, &out[0], width * 2);
+  for (size_t i = 0; i < out.size(); i += 4)
+  {
+    EXPECT_EQ(0x10, out[i + 0]);
+    EXPECT_EQ(0x80, out[i + 1]);
+    EXPECT_EQ(0xfe, out[i + 2]);
+    EXPECT_EQ(0xff, out[i + 3]);
+  }
+}
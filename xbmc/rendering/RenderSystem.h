@@ -97,6 +97,12 @@ public:
 
   virtual bool TestRender() = 0;
 
+  /**
+   * Number of frames since the current back buffer was last presented, 0 if its
+   * content is undefined or -1 if unknown. Lets the GUI redraw only what changed.
+   */
+  virtual int GetBufferAge() { return -1; }
+
   /**
    * Project (x,y,z) 3d scene coordinates to (x,y) 2d screen coordinates
    */
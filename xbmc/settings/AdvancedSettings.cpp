@@ -35,6 +35,7 @@
 #include "utils/XMLUtils.h"
 #include "utils/log.h"
 #include "filesystem/SpecialProtocol.h"
+#include "cores/AudioEngine/Interfaces/AEResample.h"
 
 using namespace XFILE;
 
@@ -50,6 +51,7 @@ void CAdvancedSettings::Initialize()
   m_audioApplyDrc = true;
   m_dvdplayerIgnoreDTSinWAV = false;
   m_audioResample = 0;
+  m_audioResampleQuality = AE_RESAMPLE_MEDIUM;
   m_allowTranscode44100 = false;
   m_audioForceDirectSound = false;
   m_audioAudiophile = false;
@@ -207,6 +209,9 @@ void CAdvancedSettings::Initialize()
   m_prioritiseAPEv2tags = false;
   m_musicItemSeparator = " / ";
   m_videoItemSeparator = " / ";
+  m_musicScannerTagThreads = 4;
+  m_musicScannerCommitBatch = 20;
+  m_musicScannerScraperThreads = 4;
 
   m_bVideoLibraryHideAllItems = false;
   m_bVideoLibraryAllItemsOnBottom = false;
@@ -217,6 +222,7 @@ void CAdvancedSettings::Initialize()
   m_bVideoLibraryImportWatchedState = false;
   m_bVideoLibraryImportResumePoint = false;
   m_bVideoScannerIgnoreErrors = false;
+  m_videoScannerDirectoryThreads = 4;
   m_iVideoLibraryDateAdded = 1; // prefer mtime over ctime and current time
 
   m_iTuxBoxStreamtsPort = 31339;
@@ -303,17 +309,26 @@ void CAdvancedSettings::Initialize()
   m_measureRefreshrate = false;
 
   m_cacheMemBufferSize = 1024 * 1024 * 20;
+  m_cacheMemBufferFileBacked = false;
+  m_cacheMemBufferRanges = 1;
   m_addonPackageFolderSize = 200;
 
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
+  m_jsonCacheSize = 50;
+  m_jsonCacheMemory = 32;
+
+  m_webserverThreads = 4;
+  m_webserverConnectionTimeout = 60 * 60 * 24;
 
   m_enableMultimediaKeys = false;
 
   m_canWindowed = true;
   m_guiVisualizeDirtyRegions = false;
+  m_guiProfileConditions = false;
   m_guiAlgorithmDirtyRegions = 3;
   m_guiDirtyRegionNoFlipTimeout = 0;
+  m_guiTextureUploadBudget = 4;
   m_enableNetworkManager  = false;
   m_showNetworkPassPhrase = true;
   m_logEnableAirtunes = false;
@@ -326,6 +341,7 @@ void CAdvancedSettings::Initialize()
   m_databaseVideo.Reset();
 
   m_logLevelHint = m_logLevel = LOG_LEVEL_NORMAL;
+  m_logMaxSize = 0;
 }
 
 bool CAdvancedSettings::Load()
@@ -394,6 +410,16 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "percentseekbackwardbig", m_musicPercentSeekBackwardBig, -100, 0);
 
     XMLUtils::GetInt(pElement, "resample", m_audioResample, 0, 192000);
+    CStdString resampleQuality;
+    if (XMLUtils::GetString(pElement, "resamplequality", resampleQuality))
+    {
+      if (resampleQuality.Equals("low"))
+        m_audioResampleQuality = AE_RESAMPLE_LOW;
+      else if (resampleQuality.Equals("high"))
+        m_audioResampleQuality = AE_RESAMPLE_HIGH;
+      else
+        m_audioResampleQuality = AE_RESAMPLE_MEDIUM;
+    }
     XMLUtils::GetBoolean(pElement, "allowtranscode44100", m_allowTranscode44100);
     XMLUtils::GetBoolean(pElement, "forceDirectSound", m_audioForceDirectSound);
     XMLUtils::GetBoolean(pElement, "audiophile", m_audioAudiophile);
@@ -664,10 +690,19 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "dateadded", m_iVideoLibraryDateAdded);
   }
 
+  pElement = pRootElement->FirstChildElement("musicscanner");
+  if (pElement)
+  {
+    XMLUtils::GetInt(pElement, "tagthreads", m_musicScannerTagThreads, 0, 32);
+    XMLUtils::GetInt(pElement, "commitbatch", m_musicScannerCommitBatch, 1, 1000);
+    XMLUtils::GetInt(pElement, "scraperthreads", m_musicScannerScraperThreads, 0, 16);
+  }
+
   pElement = pRootElement->FirstChildElement("videoscanner");
   if (pElement)
   {
     XMLUtils::GetBoolean(pElement, "ignoreerrors", m_bVideoScannerIgnoreErrors);
+    XMLUtils::GetInt(pElement, "directorythreads", m_videoScannerDirectoryThreads, 0, 32);
   }
 
   // Backward-compatibility of ExternalPlayer config
@@ -700,6 +735,8 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
     XMLUtils::GetUInt(pElement, "cachemembuffersize", m_cacheMemBufferSize);
+    XMLUtils::GetBoolean(pElement, "cachemembufferfilebacked", m_cacheMemBufferFileBacked);
+    XMLUtils::GetUInt(pElement, "cachemembufferranges", m_cacheMemBufferRanges, 1, 64);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -707,6 +744,15 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   {
     XMLUtils::GetBoolean(pElement, "compactoutput", m_jsonOutputCompact);
     XMLUtils::GetUInt(pElement, "tcpport", m_jsonTcpPort);
+    XMLUtils::GetUInt(pElement, "cachesize", m_jsonCacheSize, 0, 1000);
+    XMLUtils::GetUInt(pElement, "cachememory", m_jsonCacheMemory, 1, 1024);
+  }
+
+  pElement = pRootElement->FirstChildElement("webserver");
+  if (pElement)
+  {
+    XMLUtils::GetUInt(pElement, "threads", m_webserverThreads, 1, 64);
+    XMLUtils::GetUInt(pElement, "connectiontimeout", m_webserverConnectionTimeout, 1, 60 * 60 * 24);
   }
 
   pElement = pRootElement->FirstChildElement("samba");
@@ -743,6 +789,27 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     CLog::SetLogLevel(g_advancedSettings.m_logLevel);
   }
 
+  pElement = pRootElement->FirstChildElement("logging");
+  if (pElement)
+  {
+    // size in MB at which xbmc.log is rotated to xbmc.old.log, 0 to never rotate
+    XMLUtils::GetUInt(pElement, "maxsize", m_logMaxSize, 0, 4096);
+    CLog::SetMaxLogSize((int64_t)m_logMaxSize * 1024 * 1024);
+
+    // log levels (0 = debug ... 7 = none) of single components
+    TiXmlElement *pComponents = pElement->FirstChildElement("components");
+    if (pComponents)
+    {
+      int level;
+      if (XMLUtils::GetInt(pComponents, "database", level, LOGDEBUG, LOGNONE))
+        CLog::SetComponentLogLevel(LOGDATABASE, level);
+      if (XMLUtils::GetInt(pComponents, "webserver", level, LOGDEBUG, LOGNONE))
+        CLog::SetComponentLogLevel(LOGWEBSERVER, level);
+      if (XMLUtils::GetInt(pComponents, "jsonrpc", level, LOGDEBUG, LOGNONE))
+        CLog::SetComponentLogLevel(LOGJSONRPC, level);
+    }
+  }
+
   XMLUtils::GetString(pRootElement, "cddbaddress", m_cddbAddress);
 
   //network manager
@@ -1081,6 +1148,8 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
     XMLUtils::GetInt(pElement, "nofliptimeout",             m_guiDirtyRegionNoFlipTimeout);
+    XMLUtils::GetBoolean(pElement, "profileconditions",     m_guiProfileConditions);
+    XMLUtils::GetInt(pElement, "textureuploadbudget",       m_guiTextureUploadBudget, 0, 1000);
   }
 
   // load in the GUISettings overrides:
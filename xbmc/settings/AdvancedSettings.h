@@ -104,6 +104,7 @@ class CAdvancedSettings
     float m_audioPlayCountMinimumPercent;
     bool m_dvdplayerIgnoreDTSinWAV;
     int m_audioResample;
+    int m_audioResampleQuality; ///< AEResampleQuality tier used by the audio engine streams, medium keeps the libsamplerate sinc used before
     bool m_allowTranscode44100;
     bool m_audioForceDirectSound;
     bool m_audioAudiophile;
@@ -182,6 +183,7 @@ class CAdvancedSettings
     int m_songInfoDuration;
     int m_logLevel;
     int m_logLevelHint;
+    unsigned int m_logMaxSize;
     CStdString m_cddbAddress;
 
     // network manager
@@ -248,6 +250,9 @@ class CAdvancedSettings
     CStdString m_musicItemSeparator;
     CStdString m_videoItemSeparator;
     std::vector<CStdString> m_musicTagsFromFileFilters;
+    int m_musicScannerTagThreads;     ///< tags read in parallel by the music scanner, 0 to read them on the scanner thread
+    int m_musicScannerCommitBatch;    ///< folders committed to the music database in one transaction
+    int m_musicScannerScraperThreads; ///< artists and albums scraped in parallel, 0 to scrape them on the scanner thread
 
     bool m_bVideoLibraryHideAllItems;
     bool m_bVideoLibraryAllItemsOnBottom;
@@ -259,6 +264,7 @@ class CAdvancedSettings
     bool m_bVideoLibraryImportResumePoint;
 
     bool m_bVideoScannerIgnoreErrors;
+    int m_videoScannerDirectoryThreads; ///< folders read ahead in parallel by the video scanner, 0 to disable
     int m_iVideoLibraryDateAdded;
 
     std::vector<CStdString> m_vecTokens; // cleaning strings tied to language
@@ -356,12 +362,21 @@ class CAdvancedSettings
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     int  m_guiDirtyRegionNoFlipTimeout;
+    bool m_guiProfileConditions;
+    int  m_guiTextureUploadBudget; ///< milliseconds per frame spent uploading large textures, 0 for no limit
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemBufferSize;
+    bool m_cacheMemBufferFileBacked;
+    unsigned int m_cacheMemBufferRanges;
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
+    unsigned int m_jsonCacheSize;
+    unsigned int m_jsonCacheMemory; ///< \brief size limit of the query result cache in MB
+
+    unsigned int m_webserverThreads;
+    unsigned int m_webserverConnectionTimeout;
 
     bool m_enableMultimediaKeys;
     std::vector<CStdString> m_settingsFiles;
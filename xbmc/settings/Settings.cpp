@@ -61,6 +61,7 @@ using namespace XFILE;
 
 CSettings::CSettings(void)
 {
+  m_skinSettingsVersion = 0;
 }
 
 void CSettings::Initialize()
@@ -1421,6 +1422,7 @@ void CSettings::LoadSkinSettings(const TiXmlElement* pRootElement)
   {
     m_skinStrings.clear();
     m_skinBools.clear();
+    m_skinSettingsVersion++;
     const TiXmlElement *pChild = pElement->FirstChildElement("setting");
     while (pChild)
     {
@@ -1487,6 +1489,7 @@ void CSettings::Clear()
   m_mapRssUrls.clear();
   m_skinStrings.clear();
   m_skinBools.clear();
+  m_skinSettingsVersion++;
 
   m_programSources.clear();
   m_pictureSources.clear();
@@ -1521,6 +1524,7 @@ int CSettings::TranslateSkinString(const CStdString &setting)
   CSkinString skinString;
   skinString.name = settingName;
   m_skinStrings.insert(pair<int, CSkinString>(m_skinStrings.size() + m_skinBools.size(), skinString));
+  m_skinSettingsVersion++;
   return m_skinStrings.size() + m_skinBools.size() - 1;
 }
 
@@ -1540,6 +1544,7 @@ void CSettings::SetSkinString(int setting, const CStdString &label)
   if (it != m_skinStrings.end())
   {
     (*it).second.value = label;
+    m_skinSettingsVersion++;
     return;
   }
   assert(false);
@@ -1556,6 +1561,7 @@ void CSettings::ResetSkinSetting(const CStdString &setting)
     if (settingName.Equals((*it).second.name))
     {
       (*it).second.value = "";
+      m_skinSettingsVersion++;
       return;
     }
   }
@@ -1565,6 +1571,7 @@ void CSettings::ResetSkinSetting(const CStdString &setting)
     if (settingName.Equals((*it).second.name))
     {
       (*it).second.value = false;
+      m_skinSettingsVersion++;
       return;
     }
   }
@@ -1585,6 +1592,7 @@ int CSettings::TranslateSkinBool(const CStdString &setting)
   skinBool.name = settingName;
   skinBool.value = false;
   m_skinBools.insert(pair<int, CSkinBool>(m_skinBools.size() + m_skinStrings.size(), skinBool));
+  m_skinSettingsVersion++;
   return m_skinBools.size() + m_skinStrings.size() - 1;
 }
 
@@ -1605,6 +1613,7 @@ void CSettings::SetSkinBool(int setting, bool set)
   if (it != m_skinBools.end())
   {
     (*it).second.value = set;
+    m_skinSettingsVersion++;
     return;
   }
   assert(false);
@@ -1633,6 +1642,7 @@ void CSettings::ResetSkinSettings()
 
     it2++;
   }
+  m_skinSettingsVersion++;
   g_infoManager.ResetCache();
 }
 
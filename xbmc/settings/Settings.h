@@ -157,6 +157,12 @@ public:
   void ResetSkinSetting(const CStdString &setting);
   void ResetSkinSettings();
 
+  /*! \brief Get the version of the skin settings
+   The version changes whenever a skin bool or string is set, reset or loaded.
+   \return the current version of the skin settings
+   */
+  unsigned int GetSkinSettingsVersion() const { return m_skinSettingsVersion; };
+
   CStdString m_pictureExtensions;
   CStdString m_musicExtensions;
   CStdString m_videoExtensions;
@@ -409,6 +415,7 @@ private:
   unsigned int m_lastUsedProfile;
   unsigned int m_currentProfile;
   int m_nextIdProfile; // for tracking the next available id to give to a new profile to ensure id's are not re-used
+  unsigned int m_skinSettingsVersion; // bumped whenever a skin setting changes
 };
 
 extern class CSettings g_settings;
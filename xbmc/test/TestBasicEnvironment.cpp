@@ -26,6 +26,7 @@
 #include "powermanagement/PowerManager.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/GUISettings.h"
+#include "settings/Settings.h"
 #include "Util.h"
 
 #include <cstdio>
@@ -97,6 +98,18 @@ void TestBasicEnvironment::SetUp()
     TearDown();
     SetUpError();
   }
+
+  /* Keep the master profile (databases, thumbnails) in the temporary
+   * directory as well, so that tests using them don't touch the working
+   * directory.
+   */
+  CStdString userdata = CSpecialProtocol::TranslatePath("special://temp/userdata/");
+  if (!XFILE::CDirectory::Create(userdata))
+    SetUpError();
+  CSpecialProtocol::SetMasterProfilePath(userdata);
+  CSpecialProtocol::SetProfilePath("special://masterprofile/");
+  g_settings.AddProfile(CProfile("special://masterprofile/"));
+  g_settings.CreateProfileFolders();
 }
 
 void TestBasicEnvironment::TearDown()
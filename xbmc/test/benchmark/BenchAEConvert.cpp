@@ -0,0 +1,97 @@
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEConvert.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <vector>
+#include <iostream>
+
+#define BENCH_SAMPLES 8192
+#define BENCH_LOOPS   256
+
+static const enum AEDataFormat toFloatFormats[] =
+{
+  AE_FMT_U8, AE_FMT_S8, AE_FMT_S16LE, AE_FMT_S16BE, AE_FMT_S24LE4, AE_FMT_S24BE4,
+  AE_FMT_S24LE3, AE_FMT_S24BE3, AE_FMT_S32LE, AE_FMT_S32BE
+};
+
+static const enum AEDataFormat frFloatFormats[] =
+{
+  AE_FMT_U8, AE_FMT_S8, AE_FMT_S16LE, AE_FMT_S16BE, AE_FMT_S24NE4, AE_FMT_S24NE3,
+  AE_FMT_S32LE, AE_FMT_S32BE
+};
+
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
+
+/* samples per second */
+static double RunToFloat(CAEConvert::AEConvertToFn fn, uint8_t *in, float *out)
+{
+  int64_t start = CurrentHostCounter();
+  for (int i = 0; i < BENCH_LOOPS; ++i)
+    fn(in, BENCH_SAMPLES, out);
+  return (double)BENCH_SAMPLES * BENCH_LOOPS * CurrentHostFrequency() / (CurrentHostCounter() - start);
+}
+
+static double RunFrFloat(CAEConvert::AEConvertFrFn fn, float *in, uint8_t *out)
+{
+  int64_t start = CurrentHostCounter();
+  for (int i = 0; i < BENCH_LOOPS; ++i)
+    fn(in, BENCH_SAMPLES, out);
+  return (double)BENCH_SAMPLES * BENCH_LOOPS * CurrentHostFrequency() / (CurrentHostCounter() - start);
+}
+
+/* scalar against SIMD for every format the engine converts */
+TEST(BenchAEConvert, Formats)
+{
+  std::vector<uint8_t> bytes(BENCH_SAMPLES * 8);
+  std::vector<float>   floats(BENCH_SAMPLES);
+
+  srand(1);
+  for (unsigned int i = 0; i < bytes.size(); ++i)
+    bytes[i] = rand() & 0xFF;
+
+  for (unsigned int f = 0; f < ARRAY_SIZE(toFloatFormats); ++f)
+  {
+    double scalar = RunToFloat(CAEConvert::ToFloat(toFloatFormats[f], false), &bytes[0], &floats[0]);
+    double simd   = RunToFloat(CAEConvert::ToFloat(toFloatFormats[f]       ), &bytes[0], &floats[0]);
+    std::cout << CAEUtil::DataFormatToStr(toFloatFormats[f]) << " -> FLOAT: "
+              << scalar / 1000000.0 << " Msamples/s scalar, "
+              << simd   / 1000000.0 << " Msamples/s simd ("
+              << simd / scalar << "x)" << std::endl;
+  }
+
+  for (unsigned int f = 0; f < ARRAY_SIZE(frFloatFormats); ++f)
+  {
+    for (unsigned int i = 0; i < floats.size(); ++i)
+      floats[i] = (rand() / (float)RAND_MAX) * 2.0f - 1.0f;
+
+    double scalar = RunFrFloat(CAEConvert::FrFloat(frFloatFormats[f], false), &floats[0], &bytes[0]);
+    double simd   = RunFrFloat(CAEConvert::FrFloat(frFloatFormats[f]       ), &floats[0], &bytes[0]);
+    std::cout << "FLOAT -> " << CAEUtil::DataFormatToStr(frFloatFormats[f]) << ": "
+              << scalar / 1000000.0 << " Msamples/s scalar, "
+              << simd   / 1000000.0 << " Msamples/s simd ("
+              << simd / scalar << "x)" << std::endl;
+  }
+}
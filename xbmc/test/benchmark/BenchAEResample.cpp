@@ -0,0 +1,90 @@
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEResamplePolyphase.h"
+#include "cores/AudioEngine/Utils/AEResampleSRC.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+#include <iostream>
+
+#define BENCH_CHANNELS 2
+#define BENCH_SECONDS  10
+
+#define ARRAY_SIZE(x) (sizeof(x) / sizeof(x[0]))
+
+static void RunResampler(const char *name, IAEResample &resampler, std::vector<float> &in)
+{
+  unsigned int inFrames = in.size() / BENCH_CHANNELS;
+  unsigned int outMax   = (unsigned int)(inFrames * resampler.GetRatio()) + 64;
+  std::vector<float> out(outMax * BENCH_CHANNELS);
+
+  int64_t start = CurrentHostCounter();
+  unsigned int pos = 0, produced = 0;
+  while (pos < inFrames)
+  {
+    unsigned int used;
+    int ret = resampler.Resample(&in[pos * BENCH_CHANNELS], std::min(4410u, inFrames - pos), used, &out[produced * BENCH_CHANNELS], outMax - produced);
+    if (ret < 0)
+      break;
+    pos      += used;
+    produced += ret;
+  }
+  double seconds = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+
+  std::cout << name << ": " << seconds * 1000.0 << " ms, "
+            << produced * BENCH_CHANNELS / seconds / 1000000.0 << " Msamples/s, "
+            << BENCH_SECONDS / seconds << "x realtime" << std::endl;
+}
+
+/* cost of stereo 44.1k -> 48k for every tier */
+TEST(BenchAEResample, Tiers)
+{
+  std::vector<float> in(44100 * BENCH_SECONDS * BENCH_CHANNELS);
+  for (unsigned int f = 0; f < in.size() / BENCH_CHANNELS; ++f)
+    for (unsigned int c = 0; c < BENCH_CHANNELS; ++c)
+      in[f * BENCH_CHANNELS + c] = 0.5f * sinf(2.0f * (float)M_PI * (1000.0f + 500.0f * c) * f / 44100);
+
+  CAEResamplePolyphase lowC   (AE_RESAMPLE_LOW   , 44100, 48000, false);
+  CAEResamplePolyphase lowSIMD(AE_RESAMPLE_LOW   , 44100, 48000);
+  CAEResamplePolyphase medC   (AE_RESAMPLE_MEDIUM, 44100, 48000, false);
+  CAEResamplePolyphase medSIMD(AE_RESAMPLE_MEDIUM, 44100, 48000);
+  ASSERT_TRUE(lowC   .Initialize(BENCH_CHANNELS, 48000.0 / 44100.0));
+  ASSERT_TRUE(lowSIMD.Initialize(BENCH_CHANNELS, 48000.0 / 44100.0));
+  ASSERT_TRUE(medC   .Initialize(BENCH_CHANNELS, 48000.0 / 44100.0));
+  ASSERT_TRUE(medSIMD.Initialize(BENCH_CHANNELS, 48000.0 / 44100.0));
+  RunResampler("polyphase low scalar"   , lowC   , in);
+  RunResampler("polyphase low simd"     , lowSIMD, in);
+  RunResampler("polyphase medium scalar", medC   , in);
+  RunResampler("polyphase medium simd"  , medSIMD, in);
+
+  static const enum AEResampleQuality tiers[] = { AE_RESAMPLE_LOW, AE_RESAMPLE_MEDIUM, AE_RESAMPLE_HIGH };
+  static const char *names[] = { "libsamplerate low", "libsamplerate medium", "libsamplerate high" };
+  for (unsigned int t = 0; t < ARRAY_SIZE(tiers); ++t)
+  {
+    CAEResampleSRC resampler(tiers[t]);
+    if (resampler.Initialize(BENCH_CHANNELS, 48000.0 / 44100.0))
+      RunResampler(names[t], resampler, in);
+  }
+}
@@ -0,0 +1,168 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUIFont.h"
+#include "guilib/GUIFontTTF.h"
+#include "guilib/Texture.h"
+#include "test/TestUtils.h"
+#include "utils/CharsetConverter.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+
+/* A font that goes through glyph caching, layout and vertex generation like
+ * the GL and DX fonts, but keeps its texture in memory and counts the vertices
+ * of each batch instead of drawing them. */
+class CBenchFont : public CGUIFontTTFBase
+{
+public:
+  CBenchFont(const CStdString &fileName) : CGUIFontTTFBase(fileName), m_vertices(0), m_batches(0) { }
+
+  virtual void Begin()
+  {
+    if (m_nestedBeginCount == 0)
+      m_vertex_count = 0;
+    m_nestedBeginCount++;
+  }
+
+  virtual void End()
+  {
+    if (m_nestedBeginCount == 0 || --m_nestedBeginCount > 0)
+      return;
+    m_vertices += m_vertex_count;
+    m_batches++;
+  }
+
+  void DrawText(float x, float y, const CStdString &text, float maxWidth)
+  {
+    CStdStringW wide;
+    g_charsetConverter.utf8ToW(text, wide, false);
+    vecText chars(wide.begin(), wide.end());
+    vecColors colors(1, 0xffffffff);
+    DrawTextInternal(x, y, colors, chars, XBFONT_TRUNCATED, maxWidth, false);
+  }
+
+  unsigned int m_vertices;
+  unsigned int m_batches;
+
+protected:
+  virtual CBaseTexture* ReallocTexture(unsigned int& newHeight)
+  {
+    newHeight = CBaseTexture::PadPow2(newHeight);
+    CBaseTexture *newTexture = new CTexture(m_textureWidth, newHeight, XB_FMT_A8);
+    m_textureHeight = newTexture->GetHeight();
+    m_textureWidth = newTexture->GetWidth();
+    memset(newTexture->GetPixels(), 0, m_textureHeight * newTexture->GetPitch());
+    if (m_texture)
+    {
+      for (unsigned int y = 0; y < m_texture->GetHeight(); y++)
+        memcpy(newTexture->GetPixels() + y * newTexture->GetPitch(), m_texture->GetPixels() + y * m_texture->GetPitch(), m_texture->GetPitch());
+      delete m_texture;
+    }
+    return newTexture;
+  }
+
+  virtual bool CopyCharToTexture(const unsigned char *pixels, unsigned int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
+  {
+    unsigned char *target = m_texture->GetPixels() + y1 * m_texture->GetPitch() + x1;
+    for (unsigned int y = y1; y < y2; y++, pixels += pitch, target += m_texture->GetPitch())
+      memcpy(target, pixels, x2 - x1);
+    return true;
+  }
+
+  virtual void DeleteHardwareTexture() { }
+};
+
+static const char *titles[] = {
+  "2001: A Space Odyssey", "Amélie", "Das Boot", "Der Himmel über Berlin", "Ghost in the Shell",
+  "Lawrence of Arabia", "Los Olvidados", "Oldboy", "Solaris (Солярис)", "Spirited Away",
+  "The Seventh Seal", "Ζ (Z)", "Wages of Fear", "Yojimbo", "Crouching Tiger, Hidden Dragon"
+};
+
+static const char *plot =
+  "An epic drama of adventure and exploration, following the crew of a ship as they "
+  "travel across uncharted waters. Along the way they meet friends, foes and strangers, "
+  "and learn that the journey matters more than where it ends. Nominated for eight "
+  "awards, the film was restored in 2012 from the original negatives.";
+
+/* Renders the text of a Confluence style list window: a heading, 20 list rows
+ * with a label and a label2 each, and a plot that wraps over five lines. The
+ * first frame has to rasterise every glyph, later frames only lay out text and
+ * build vertices, which is what a window costs on the CPU every frame. */
+TEST(BenchGUIFontTTF, WindowRender)
+{
+  const unsigned int frames = 500;
+  const unsigned int rows = 20;
+  const unsigned int titleCount = sizeof(titles) / sizeof(titles[0]);
+
+  CBenchFont heading(""), label(""), small("");
+  ASSERT_TRUE(heading.Load(XBMC_REF_FILE_PATH("addons/skin.confluence/fonts/Roboto-Bold.ttf"), 30.0f));
+  ASSERT_TRUE(label.Load(XBMC_REF_FILE_PATH("addons/skin.confluence/fonts/Roboto-Regular.ttf"), 22.0f));
+  ASSERT_TRUE(small.Load(XBMC_REF_FILE_PATH("addons/skin.confluence/fonts/Roboto-Regular.ttf"), 18.0f, 1.0f, 1.0f, true));
+
+  std::vector<CStdString> plotLines;
+  CStdString text(plot);
+  for (size_t pos = 0; pos < text.size(); pos += 60)
+    plotLines.push_back(text.substr(pos, 60));
+
+  int64_t firstFrame = 0;
+  int64_t start = CurrentHostCounter();
+  for (unsigned int frame = 0; frame < frames; frame++)
+  {
+    int64_t frameStart = CurrentHostCounter();
+
+    heading.Begin();
+    heading.DrawText(60, 20, "Movies - Title", 800);
+    heading.End();
+
+    // list controls draw each label through its own Begin()/End()
+    for (unsigned int row = 0; row < rows; row++)
+    {
+      const char *title = titles[(frame / 50 + row) % titleCount]; // scrolling every 50 frames
+      label.Begin();
+      label.DrawText(60, 80.0f + row * 30, title, 500);
+      label.End();
+      label.Begin();
+      label.DrawText(600, 80.0f + row * 30, "2h 14min", 100);
+      label.End();
+    }
+
+    small.Begin();
+    for (unsigned int line = 0; line < plotLines.size(); line++)
+      small.DrawText(760, 80.0f + line * 24, plotLines[line], 480);
+    small.End();
+
+    if (frame == 0)
+      firstFrame = CurrentHostCounter() - frameStart;
+  }
+  int64_t total = CurrentHostCounter() - start;
+
+  unsigned int vertices = heading.m_vertices + label.m_vertices + small.m_vertices;
+  unsigned int batches = heading.m_batches + label.m_batches + small.m_batches;
+  EXPECT_GT(vertices, 0U);
+
+  double msec = 1000.0 / CurrentHostFrequency();
+  std::cout << "Rendering the text of a list window, " << frames << " frames:" << std::endl
+            << "  first frame: " << firstFrame * msec << " ms" << std::endl
+            << "  total: " << total * msec << " ms, " << total * msec / frames << " ms per frame" << std::endl
+            << "  " << vertices / frames << " vertices in " << batches / frames << " batches per frame" << std::endl;
+}
@@ -0,0 +1,182 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/JSONVariantWriter.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <iostream>
+#if defined(TARGET_LINUX)
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+// keeps track of the output size and the largest chunk it was handed
+class CCountingStream : public IJSONWriterStream
+{
+public:
+  CCountingStream() : m_size(0), m_largestChunk(0), m_chunks(0) { }
+
+  virtual bool Write(const char *data, size_t size)
+  {
+    m_size += size;
+    m_largestChunk = std::max(m_largestChunk, size);
+    m_chunks++;
+    return true;
+  }
+
+  size_t m_size;
+  size_t m_largestChunk;
+  size_t m_chunks;
+};
+
+#if defined(TARGET_LINUX)
+// reads a size in kB from /proc/self/status
+static long GetProcessStatus(const char *field)
+{
+  FILE *file = fopen("/proc/self/status", "r");
+  if (!file)
+    return -1;
+
+  long value = -1;
+  char line[256];
+  while (fgets(line, sizeof(line), file))
+  {
+    if (strncmp(line, field, strlen(field)) == 0)
+    {
+      value = atol(line + strlen(field));
+      break;
+    }
+  }
+  fclose(file);
+  return value;
+}
+#endif
+
+/* Measures the peak resident memory of a piece of code. Free heap memory is
+ * handed back to the system first and the high water mark of the process is
+ * reset, so the peak is what the code really had resident at once. Only
+ * available on Linux, elsewhere Peak() is -1. */
+class CPeakMemory
+{
+public:
+  CPeakMemory() : m_start(-1)
+  {
+#if defined(TARGET_LINUX)
+    malloc_trim(0);
+    FILE *file = fopen("/proc/self/clear_refs", "w");
+    if (file)
+    {
+      if (fputs("5", file) >= 0)
+        m_start = GetProcessStatus("VmRSS:");
+      fclose(file);
+    }
+#endif
+  }
+
+  // peak growth of the resident memory in kB since construction
+  long Peak() const
+  {
+#if defined(TARGET_LINUX)
+    if (m_start >= 0)
+      return GetProcessStatus("VmHWM:") - m_start;
+#endif
+    return -1;
+  }
+
+private:
+  long m_start;
+};
+
+// a library response like VideoLibrary.GetMovies returns it
+static void FillMovies(CVariant &result, unsigned int count)
+{
+  result["limits"]["start"] = 0;
+  result["limits"]["end"] = count;
+  result["limits"]["total"] = count;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    CVariant movie;
+    movie["movieid"] = i;
+    movie["label"] = StringUtils::Format("Movie %u", i);
+    movie["title"] = StringUtils::Format("Movie %u", i);
+    movie["originaltitle"] = StringUtils::Format("Original title of movie %u", i);
+    movie["year"] = 1950 + i % 60;
+    movie["rating"] = (i % 100) / 10.0;
+    movie["votes"] = StringUtils::Format("%u", i * 7);
+    movie["runtime"] = 5400 + i % 3600;
+    movie["playcount"] = i % 3;
+    movie["plot"] = "A fairly long plot outline which is there to give every movie a realistic amount of text to be escaped and written.";
+    movie["tagline"] = "Some tagline";
+    movie["mpaa"] = "Rated PG-13";
+    movie["file"] = StringUtils::Format("smb://server/share/movies/Movie %u (%u)/movie.mkv", i, 1950 + i % 60);
+    movie["thumbnail"] = StringUtils::Format("image://smb%%3a%%2f%%2fserver%%2fshare%%2fmovies%%2fMovie %u%%2fposter.jpg/", i);
+    movie["fanart"] = StringUtils::Format("image://smb%%3a%%2f%%2fserver%%2fshare%%2fmovies%%2fMovie %u%%2ffanart.jpg/", i);
+    movie["dateadded"] = "2012-11-01 20:15:00";
+    movie["lastplayed"] = "";
+    movie["genre"].push_back("Drama");
+    movie["genre"].push_back("Thriller");
+    movie["director"].push_back("Some Director");
+    movie["studio"].push_back("Some Studio");
+    result["movies"].push_back(movie);
+  }
+}
+
+/* Writes a 30000 movie VideoLibrary.GetMovies response into a string, as
+ * before, and into a stream that only counts, as the web server sends it. */
+TEST(BenchJSONVariantWriter, Movies)
+{
+  const unsigned int count = 30000;
+
+  CVariant variant;
+  FillMovies(variant, count);
+
+  size_t stringSize;
+  long stringPeak;
+  int64_t start = CurrentHostCounter();
+  {
+    CPeakMemory memory;
+    std::string str = CJSONVariantWriter::Write(variant, true);
+    stringPeak = memory.Peak();
+    stringSize = str.size();
+  }
+  int64_t stringTime = CurrentHostCounter() - start;
+
+  CCountingStream stream;
+  start = CurrentHostCounter();
+  CPeakMemory memory;
+  EXPECT_TRUE(CJSONVariantWriter::Write(variant, true, stream));
+  long streamPeak = memory.Peak();
+  int64_t streamTime = CurrentHostCounter() - start;
+
+  EXPECT_EQ(stringSize, stream.m_size);
+  EXPECT_LT(stream.m_largestChunk, stringSize);
+
+  // peak growth of the resident memory while writing, the variant was already built
+  double msec = 1000.0 / CurrentHostFrequency();
+  std::cout << "Writing " << count << " movies (" << stringSize << " bytes):" << std::endl
+            << "  string: " << stringTime * msec << " ms, peak " << stringPeak << " kB" << std::endl
+            << "  stream: " << streamTime * msec << " ms, peak " << streamPeak << " kB, largest chunk " << stream.m_largestChunk << " bytes in " << stream.m_chunks << " chunks" << std::endl;
+}
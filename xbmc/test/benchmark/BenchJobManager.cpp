@@ -0,0 +1,130 @@
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/JobManager.h"
+#include "utils/TimeUtils.h"
+#include "threads/Atomics.h"
+#include "threads/SingleLock.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#define BENCHMARK_JOBS 3000
+
+/* Mixed load: mostly longer low priority jobs (thumbs, scanning), some normal
+ * and a few short high priority ones, a third of them with an affinity. */
+class BenchmarkJob : public CJob
+{
+public:
+  BenchmarkJob(CJob::PRIORITY priority, unsigned int work, unsigned int affinity)
+    : m_priority(priority), m_work(work), m_affinity(affinity), m_sum(0)
+  {
+    m_queued = CurrentHostCounter();
+    m_started = 0;
+  }
+
+  virtual bool DoWork()
+  {
+    m_started = CurrentHostCounter();
+    for (unsigned int i = 0; i < m_work; ++i)
+      m_sum += i * i;
+    return true;
+  }
+
+  virtual unsigned int GetAffinity() const { return m_affinity; }
+
+  CJob::PRIORITY m_priority;
+  unsigned int   m_work;
+  unsigned int   m_affinity;
+  volatile unsigned int m_sum;
+  int64_t        m_queued;
+  int64_t        m_started;
+};
+
+class BenchmarkCallback : public IJobCallback
+{
+public:
+  BenchmarkCallback() : m_done(0) {}
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job)
+  {
+    BenchmarkJob *benchmark = (BenchmarkJob*)job;
+    {
+      CSingleLock lock(m_section);
+      m_latency[benchmark->m_priority].push_back(benchmark->m_started - benchmark->m_queued);
+    }
+    if (AtomicIncrement(&m_done) == BENCHMARK_JOBS)
+      m_finished.Set();
+  }
+
+  std::vector<int64_t> m_latency[CJob::PRIORITY_HIGH+1];
+  CCriticalSection     m_section;
+  CEvent               m_finished;
+  volatile long        m_done;
+};
+
+TEST(BenchJobManager, MixedLoad)
+{
+  BenchmarkCallback callback;
+  int64_t start = CurrentHostCounter();
+  for (unsigned int i = 0; i < BENCHMARK_JOBS; ++i)
+  {
+    CJob::PRIORITY priority = CJob::PRIORITY_LOW;
+    unsigned int work = 20000;
+    if (i % 10 == 0)
+    {
+      priority = CJob::PRIORITY_HIGH;
+      work = 2000;
+    }
+    else if (i % 10 < 3)
+    {
+      priority = CJob::PRIORITY_NORMAL;
+      work = 10000;
+    }
+    unsigned int affinity = (i % 3 == 0) ? i % 7 + 1 : 0;
+    EXPECT_NE(0U, CJobManager::GetInstance().AddJob(new BenchmarkJob(priority, work, affinity), &callback, priority));
+  }
+
+  EXPECT_TRUE(callback.m_finished.WaitMSec(60000));
+  int64_t elapsed = CurrentHostCounter() - start;
+  double freq = (double)CurrentHostFrequency();
+
+  std::cout << "jobs: " << BENCHMARK_JOBS
+            << " throughput: " << (int)(BENCHMARK_JOBS * freq / elapsed) << " jobs/s" << std::endl;
+
+  static const char *names[] = { "low", "normal", "high" };
+  for (int priority = CJob::PRIORITY_HIGH; priority >= CJob::PRIORITY_LOW; --priority)
+  {
+    CSingleLock lock(callback.m_section);
+    std::vector<int64_t> &latency = callback.m_latency[priority];
+    if (latency.empty())
+      continue;
+    std::sort(latency.begin(), latency.end());
+    std::cout << names[priority] << " queue latency ms:"
+              << " p50 " << latency[latency.size() / 2] * 1000.0 / freq
+              << " p99 " << latency[latency.size() * 99 / 100] * 1000.0 / freq
+              << " max " << latency.back() * 1000.0 / freq << std::endl;
+  }
+
+  EXPECT_EQ(BENCHMARK_JOBS, callback.m_done);
+}
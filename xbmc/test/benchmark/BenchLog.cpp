@@ -0,0 +1,107 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/log.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "threads/Thread.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+#include <vector>
+
+class CLogBenchWriter : public IRunnable
+{
+public:
+  CLogBenchWriter(int level, bool macro, unsigned int messages) : m_level(level), m_macro(macro), m_messages(messages), m_duration(0) { }
+
+  virtual void Run()
+  {
+    int64_t start = CurrentHostCounter();
+    if (m_macro)
+    {
+      for (unsigned int i = 0; i < m_messages; i++)
+        CLOG(m_level, "log writer bench message %u from %p", i, (void *)this);
+    }
+    else
+    {
+      for (unsigned int i = 0; i < m_messages; i++)
+        CLog::Log(m_level, "log writer bench message %u from %p", i, (void *)this);
+    }
+    m_duration = CurrentHostCounter() - start;
+  }
+
+  int m_level;
+  bool m_macro;
+  unsigned int m_messages;
+  int64_t m_duration;
+};
+
+/* Logs from several threads at once and returns the mean time of a call in ns */
+static double LogFromThreads(int level, bool macro, unsigned int threadCount, unsigned int messages)
+{
+  std::vector<CLogBenchWriter *> runners;
+  std::vector<CThread *> threads;
+  for (unsigned int i = 0; i < threadCount; i++)
+  {
+    runners.push_back(new CLogBenchWriter(level, macro, messages));
+    threads.push_back(new CThread(runners.back(), "LogBench"));
+    threads.back()->Create();
+  }
+
+  int64_t duration = 0;
+  for (unsigned int i = 0; i < threadCount; i++)
+  {
+    threads[i]->StopThread(true);
+    duration += runners[i]->m_duration;
+    delete threads[i];
+    delete runners[i];
+  }
+  return duration * 1000000000.0 / CurrentHostFrequency() / (threadCount * messages);
+}
+
+/* 8 threads log 20000 messages each: below the level through CLog::Log and
+ * through CLOG, and at a logged level. */
+TEST(BenchLog, Contention)
+{
+  CStdString logfile;
+  const unsigned int threadCount = 8;
+  const unsigned int messages = 20000;
+
+  logfile = CSpecialProtocol::TranslatePath("special://temp/") + "xbmc.log";
+  EXPECT_TRUE(CLog::Init(CSpecialProtocol::TranslatePath("special://temp/")));
+
+  int logLevel = CLog::GetLogLevel();
+  CLog::SetLogLevel(LOG_LEVEL_NORMAL);
+  double suppressed = LogFromThreads(LOGDEBUG, false, threadCount, messages);
+  double skipped = LogFromThreads(LOGDEBUG, true, threadCount, messages);
+  double logged = LogFromThreads(LOGNOTICE, false, threadCount, messages);
+  CLog::SetLogLevel(logLevel);
+  CLog::Close();
+
+  std::cout << threadCount << " threads x " << messages << " messages" << std::endl
+            << "  suppressed level, CLog::Log: " << suppressed << " ns/call" << std::endl
+            << "  suppressed level, CLOG:      " << skipped << " ns/call" << std::endl
+            << "  logged level:                " << logged << " ns/call" << std::endl;
+
+  EXPECT_TRUE(XFILE::CFile::Delete(logfile));
+}
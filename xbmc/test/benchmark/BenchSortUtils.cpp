@@ -0,0 +1,104 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <iostream>
+
+#define BENCHMARK_ITEMS 25000
+
+/* A synthetic library in random order: titles with articles, mixed case,
+ * non-ASCII letters and numbers of varying width, plus some folders and items
+ * sorted on top or bottom. */
+static void FillLibrary(SortItems &items, unsigned int count)
+{
+  static const char *words[] = { "The", "a", "Star", "wars", "Episode", "Alien", "alien",
+                                 "Zebra", "\xc3\xbc" "ber", "\xc3\x84rger", "(Extended)", "Part", "-" };
+  unsigned int seed = 42;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    std::string title;
+    for (unsigned int w = 0; w < 3; w++)
+    {
+      seed = seed * 1103515245 + 12345;
+      title += words[(seed >> 16) % (sizeof(words) / sizeof(words[0]))];
+      title += " ";
+    }
+    seed = seed * 1103515245 + 12345;
+    char number[16];
+    sprintf(number, (seed >> 16) % 2 ? "%u" : "%03u", (seed >> 17) % 200);
+    title += number;
+
+    SortItem item;
+    item[FieldId] = i;
+    item[FieldTitle] = title;
+    item[FieldFolder] = i % 50 == 0;
+    item[FieldSortSpecial] = i % 997 == 0 ? SortSpecialOnTop : (i % 991 == 0 ? SortSpecialOnBottom : SortSpecialNone);
+    items.push_back(item);
+  }
+}
+
+/* Compares the labels through the item maps, as the sorters used to */
+static bool CompareItems(const SortItem &left, const SortItem &right)
+{
+  int64_t leftSpecial = left.at(FieldSortSpecial).asInteger();
+  int64_t rightSpecial = right.at(FieldSortSpecial).asInteger();
+  if (leftSpecial != rightSpecial)
+    return leftSpecial == SortSpecialOnTop || rightSpecial == SortSpecialOnBottom;
+  if (leftSpecial != SortSpecialNone)
+    return false;
+  if (left.at(FieldFolder).asBoolean() != right.at(FieldFolder).asBoolean())
+    return left.at(FieldFolder).asBoolean();
+  return StringUtils::AlphaNumericCompare(left.at(FieldSort).asWideString().c_str(), right.at(FieldSort).asWideString().c_str()) < 0;
+}
+
+static bool ById(const SortItem &left, const SortItem &right)
+{
+  return left.at(FieldId).asInteger() < right.at(FieldId).asInteger();
+}
+
+/* Sorts a library of 25000 titles with the collation keys SortUtils builds,
+ * then sorts the same labels again by comparing the item maps. */
+TEST(BenchSortUtils, SyntheticLibrary)
+{
+  SortItems items;
+  FillLibrary(items, BENCHMARK_ITEMS);
+
+  int64_t start = CurrentHostCounter();
+  SortUtils::Sort(SortByTitle, SortOrderAscending, SortAttributeIgnoreArticle, items);
+  int64_t sorted = CurrentHostCounter();
+
+  std::sort(items.begin(), items.end(), ById);
+  int64_t restored = CurrentHostCounter();
+  std::stable_sort(items.begin(), items.end(), CompareItems);
+  int64_t compared = CurrentHostCounter();
+
+  double msec = 1000.0 / CurrentHostFrequency();
+  std::cout << "items: " << items.size()
+            << " collation keys: " << (sorted - start) * msec << " ms"
+            << " item comparisons: " << (compared - restored) * msec << " ms" << std::endl;
+  EXPECT_EQ(BENCHMARK_ITEMS, (int)items.size());
+}
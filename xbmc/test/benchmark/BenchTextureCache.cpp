@@ -0,0 +1,130 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DatabaseManager.h"
+#include "TextureCache.h"
+#include "TextureDatabase.h"
+#include "filesystem/Directory.h"
+#include "filesystem/SpecialProtocol.h"
+#include "pictures/Picture.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <iostream>
+#include <vector>
+
+/* 8 megapixel photos, as fanart and posters come from a camera or a scraper
+ * in full size, cached down to the 1280x720 the texture cache keeps. */
+#define BENCHMARK_WIDTH  3264
+#define BENCHMARK_HEIGHT 2448
+#define BENCHMARK_IMAGES 24
+
+// a gradient with noise, so the jpeg costs about as much to decode as a photo
+static bool CreateSourceImage(const CStdString &file, unsigned int seed)
+{
+  std::vector<uint8_t> image(BENCHMARK_WIDTH * BENCHMARK_HEIGHT * 4);
+  srand(seed);
+  for (unsigned int y = 0; y < BENCHMARK_HEIGHT; y++)
+  {
+    uint8_t *row = &image[y * BENCHMARK_WIDTH * 4];
+    for (unsigned int x = 0; x < BENCHMARK_WIDTH; x++)
+    {
+      row[x * 4 + 0] = (uint8_t)(x * 255 / BENCHMARK_WIDTH + rand() % 32);
+      row[x * 4 + 1] = (uint8_t)(y * 255 / BENCHMARK_HEIGHT + rand() % 32);
+      row[x * 4 + 2] = (uint8_t)((x + y + seed * 17) & 0xff);
+      row[x * 4 + 3] = 0xff;
+    }
+  }
+  return CPicture::CreateThumbnailFromSurface(&image[0], BENCHMARK_WIDTH, BENCHMARK_HEIGHT, BENCHMARK_WIDTH * 4, file);
+}
+
+static void PrintThroughput(const char *name, int64_t total)
+{
+  double msec = total * 1000.0 / CurrentHostFrequency();
+  std::cout << "  " << name << ": " << msec << " ms, "
+            << BENCHMARK_IMAGES * 1000.0 / msec << " images/sec, "
+            << BENCHMARK_IMAGES * (double)BENCHMARK_WIDTH * BENCHMARK_HEIGHT / (msec * 1000.0) << " MPixels/sec" << std::endl;
+}
+
+/* Caches a batch of images through CTextureCache the way the library does:
+ * decode, scale, encode to the thumbnails folder and add to the textures
+ * database. The first batch is cached synchronously on this thread like
+ * CacheImage() does for an image that is shown right away, the second in
+ * the background like art after a scan, spread over the cache's workers.
+ * Both report the total time of the batch over its number of images. */
+TEST(BenchTextureCache, CacheImages)
+{
+  CDatabaseManager::Get().Initialize();
+  CTextureCache::Get().Initialize();
+
+  CStdString folder = CSpecialProtocol::TranslatePath("special://temp/texturebench/");
+  XFILE::CDirectory::Create(folder);
+
+  std::vector<CStdString> foreground, background;
+  for (unsigned int i = 0; i < 2 * BENCHMARK_IMAGES; i++)
+  {
+    CStdString file = URIUtils::AddFileToFolder(folder, StringUtils::Format("image%u.jpg", i));
+    ASSERT_TRUE(CreateSourceImage(file, i));
+    // a previous run may have left it in the cache
+    CTextureCache::Get().ClearCachedImage(file);
+    if (i < BENCHMARK_IMAGES)
+      foreground.push_back(file);
+    else
+      background.push_back(file);
+  }
+
+  int64_t start = CurrentHostCounter();
+  for (unsigned int i = 0; i < foreground.size(); i++)
+    EXPECT_FALSE(CTextureCache::Get().CacheImage(foreground[i]).IsEmpty());
+  int64_t synchronous = CurrentHostCounter() - start;
+
+  /* Asking the texture cache whether an image is done would put the miss in
+   * its index for a while, so the database is polled directly. */
+  CTextureDatabase database;
+  ASSERT_TRUE(database.Open());
+  start = CurrentHostCounter();
+  for (unsigned int i = 0; i < background.size(); i++)
+    CTextureCache::Get().BackgroundCacheImage(background[i]);
+  for (unsigned int i = 0; i < background.size(); i++)
+  {
+    CTextureDetails details;
+    while (!database.GetCachedTexture(background[i], details))
+      Sleep(5);
+  }
+  int64_t parallel = CurrentHostCounter() - start;
+  database.Close();
+
+  std::cout << "Caching " << BENCHMARK_IMAGES << " images of " << BENCHMARK_WIDTH << "x" << BENCHMARK_HEIGHT << ":" << std::endl;
+  PrintThroughput("synchronous", synchronous);
+  PrintThroughput("background", parallel);
+
+  // removes the cached copies and the source images
+  for (unsigned int i = 0; i < BENCHMARK_IMAGES; i++)
+  {
+    CTextureCache::Get().ClearCachedImage(foreground[i], true);
+    CTextureCache::Get().ClearCachedImage(background[i], true);
+  }
+  XFILE::CDirectory::Remove(folder);
+  CTextureCache::Get().Deinitialize();
+}
@@ -0,0 +1,217 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DatabaseManager.h"
+#include "FileItem.h"
+#include "dbwrappers/dataset.h"
+#include "filesystem/Directory.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "utils/StreamDetails.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+#include "video/VideoDatabase.h"
+
+#include "gtest/gtest.h"
+
+#include <iostream>
+
+#define BENCHMARK_FILES  20000
+#define BENCHMARK_MOVIES 30000
+
+// exposes the lookups a scan makes, and the formatted queries they replaced
+class CBenchVideoDatabase : public CVideoDatabase
+{
+public:
+  int GetFileId(const CStdString &url) { return CVideoDatabase::GetFileId(url); }
+
+  // GetFileId() as it was before prepared statements, a formatted query for the path and the file
+  int GetFileIdFormatted(const CStdString &url)
+  {
+    CStdString path, file;
+    URIUtils::Split(url, path, file);
+    m_pDS->query(PrepareSQL("select idPath from path where strPath='%s'", path.c_str()).c_str());
+    int idPath = m_pDS->eof() ? -1 : m_pDS->fv("path.idPath").get_asInt();
+    m_pDS->close();
+    if (idPath < 0)
+      return -1;
+
+    m_pDS->query(PrepareSQL("select idFile from files where strFileName='%s' and idPath=%i", file.c_str(), idPath).c_str());
+    int idFile = m_pDS->eof() ? -1 : m_pDS->fv("files.idFile").get_asInt();
+    m_pDS->close();
+    return idFile;
+  }
+
+  // a movie row with columns about as long as a scraped movie has them
+  void AddMovie(int idFile, unsigned int i)
+  {
+    CStdString sql = "insert into movie (idMovie, idFile, idSet";
+    for (int c = 0; c < VIDEODB_MAX_COLUMNS; c++)
+      sql.AppendFormat(", c%02d", c);
+    sql += PrepareSQL(") values (NULL, %i, NULL, 'Movie %u', '%s', '%s', 'Some tagline', '%u', '%.1f', 'Some Writer / Another Writer', '%u', "
+                      "'', 'tt%07u', '', '%u', 'Rated PG-13', '0', 'Drama / Thriller', 'Some Director', 'Original title of movie %u', '', "
+                      "'Some Studio', '', '', 'United States', 'smb://server/share/movies/', '1')",
+                      idFile, i,
+                      "A fairly long plot which is there to give every movie a realistic amount of text, as scrapers return a paragraph or two for most movies.",
+                      "A shorter plot outline.",
+                      i * 7, (i % 100) / 10.0, 1950 + i % 60, i, 90 + i % 60, i);
+    m_pDS->exec(sql.c_str());
+  }
+
+  // loads the whole movieview into the result set, the first half of GetMoviesByWhere()
+  unsigned int QueryMovieView(size_t &memory)
+  {
+    m_pDS->query("select * from movieview");
+    unsigned int rows = m_pDS->num_rows();
+    memory = m_pDS->get_result_set().records.memory_used();
+    m_pDS->close();
+    return rows;
+  }
+};
+
+// a fresh video database in the temp folder
+class BenchVideoDatabase : public testing::Test
+{
+protected:
+  BenchVideoDatabase()
+  {
+    m_databaseSettings = g_advancedSettings.m_databaseVideo;
+    m_folder = CSpecialProtocol::TranslatePath("special://temp/videobench/");
+    XFILE::CDirectory::Remove(m_folder);
+    XFILE::CDirectory::Create(m_folder);
+    g_advancedSettings.m_databaseVideo.Reset();
+    g_advancedSettings.m_databaseVideo.type = "sqlite3";
+    g_advancedSettings.m_databaseVideo.host = m_folder;
+
+    // creates the tables, databases can't be opened before they are updated
+    CDatabaseManager::Get().Initialize();
+  }
+
+  ~BenchVideoDatabase()
+  {
+    g_advancedSettings.m_databaseVideo = m_databaseSettings;
+    XFILE::CDirectory::Remove(m_folder);
+  }
+
+  static CStdString GetFile(unsigned int i)
+  {
+    return StringUtils::Format("smb://server/share/movies/Movie %u (%u)/movie.mkv", i, 1950 + i % 60);
+  }
+
+  static void PrintThroughput(const char *name, int64_t total, unsigned int count)
+  {
+    double msec = total * 1000.0 / CurrentHostFrequency();
+    std::cout << "  " << name << ": " << msec << " ms, " << count * 1000.0 / msec << " per sec" << std::endl;
+  }
+
+  DatabaseSettings m_databaseSettings;
+  CStdString m_folder;
+};
+
+/* The per file work of a scan of a 20k movie library: adding the path and
+ * file, looking the file up again and storing its stream details, through
+ * the cached prepared statements. The lookups are also timed with the
+ * formatted queries they used before. */
+TEST_F(BenchVideoDatabase, FileLookups)
+{
+  CBenchVideoDatabase database;
+  ASSERT_TRUE(database.Open());
+
+  CStreamDetails details;
+  CStreamDetailVideo *video = new CStreamDetailVideo();
+  video->m_strCodec = "h264";
+  video->m_fAspect = 1.78f;
+  video->m_iWidth = 1920;
+  video->m_iHeight = 1080;
+  video->m_iDuration = 6000;
+  details.AddStream(video);
+  CStreamDetailAudio *audio = new CStreamDetailAudio();
+  audio->m_strCodec = "dca";
+  audio->m_iChannels = 6;
+  audio->m_strLanguage = "eng";
+  details.AddStream(audio);
+  CStreamDetailSubtitle *subtitle = new CStreamDetailSubtitle();
+  subtitle->m_strLanguage = "eng";
+  details.AddStream(subtitle);
+
+  database.BeginTransaction();
+  int64_t start = CurrentHostCounter();
+  for (unsigned int i = 0; i < BENCHMARK_FILES; i++)
+    EXPECT_GE(database.AddFile(GetFile(i)), 0);
+  int64_t add = CurrentHostCounter() - start;
+  database.CommitTransaction();
+
+  // each call commits its own transaction, like the scanner does per item
+  start = CurrentHostCounter();
+  for (unsigned int i = 0; i < BENCHMARK_FILES; i++)
+    database.SetStreamDetailsForFileId(details, i + 1);
+  int64_t streams = CurrentHostCounter() - start;
+
+  start = CurrentHostCounter();
+  for (unsigned int i = 0; i < BENCHMARK_FILES; i++)
+    EXPECT_EQ((int)i + 1, database.GetFileId(GetFile(i)));
+  int64_t prepared = CurrentHostCounter() - start;
+
+  start = CurrentHostCounter();
+  for (unsigned int i = 0; i < BENCHMARK_FILES; i++)
+    EXPECT_EQ((int)i + 1, database.GetFileIdFormatted(GetFile(i)));
+  int64_t formatted = CurrentHostCounter() - start;
+
+  database.Close();
+
+  std::cout << BENCHMARK_FILES << " files:" << std::endl;
+  PrintThroughput("AddFile", add, BENCHMARK_FILES);
+  PrintThroughput("SetStreamDetailsForFileId", streams, BENCHMARK_FILES);
+  PrintThroughput("GetFileId, prepared", prepared, BENCHMARK_FILES);
+  PrintThroughput("GetFileId, formatted", formatted, BENCHMARK_FILES);
+}
+
+/* Lists the movies of a 30k movie library through GetMoviesByWhere() on
+ * the real movieview, as the movie titles node does. Loading the view into
+ * the result set is also timed on its own. */
+TEST_F(BenchVideoDatabase, MoviesByWhere)
+{
+  CBenchVideoDatabase database;
+  ASSERT_TRUE(database.Open());
+
+  database.BeginTransaction();
+  for (unsigned int i = 0; i < BENCHMARK_MOVIES; i++)
+    database.AddMovie(database.AddFile(GetFile(i)), i);
+  ASSERT_TRUE(database.CommitTransaction());
+
+  size_t memory;
+  int64_t start = CurrentHostCounter();
+  EXPECT_EQ((unsigned int)BENCHMARK_MOVIES, database.QueryMovieView(memory));
+  int64_t query = CurrentHostCounter() - start;
+
+  CFileItemList items;
+  start = CurrentHostCounter();
+  EXPECT_TRUE(database.GetMoviesByWhere("videodb://1/2/", CDatabase::Filter(), items));
+  int64_t list = CurrentHostCounter() - start;
+  EXPECT_EQ(BENCHMARK_MOVIES, items.Size());
+
+  database.Close();
+
+  std::cout << BENCHMARK_MOVIES << " movies:" << std::endl;
+  PrintThroughput("query movieview", query, BENCHMARK_MOVIES);
+  std::cout << "  result memory: " << memory / 1024 << " KiB" << std::endl;
+  PrintThroughput("GetMoviesByWhere", list, BENCHMARK_MOVIES);
+}
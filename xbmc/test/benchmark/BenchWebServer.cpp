@@ -0,0 +1,309 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "network/WebServer.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "threads/Thread.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#define TEST_FILE_SIZE  65536
+
+// port the webserver of the current test listens on
+static int testPort = 0;
+
+// asks the system for a port nobody is listening on
+static int GetFreePort()
+{
+  int sock = socket(AF_INET, SOCK_STREAM, 0);
+  if (sock < 0)
+    return 0;
+
+  struct sockaddr_in addr;
+  socklen_t size = sizeof(addr);
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = 0;
+  addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+
+  int port = 0;
+  if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) == 0 &&
+      getsockname(sock, (struct sockaddr *)&addr, &size) == 0)
+    port = ntohs(addr.sin_port);
+
+  close(sock);
+  return port;
+}
+
+// serves the test file either directly ("/webservertest/local") or through
+// the VFS ("/webservertest/vfs") to cover both ways of sending files
+class CTestFileHandler : public IHTTPRequestHandler
+{
+public:
+  virtual IHTTPRequestHandler* GetInstance() { return new CTestFileHandler(); }
+  virtual bool CheckHTTPRequest(const HTTPRequest &request) { return request.url.find("/webservertest/") == 0; }
+  virtual int HandleHTTPRequest(const HTTPRequest &request)
+  {
+    m_path = request.url == "/webservertest/vfs" ? "file://" + m_file : m_file;
+    m_responseCode = MHD_HTTP_OK;
+    m_responseType = HTTPFileDownload;
+    return MHD_YES;
+  }
+  virtual std::string GetHTTPResponseFile() const { return m_path; }
+
+  static std::string m_file;
+private:
+  std::string m_path;
+};
+
+std::string CTestFileHandler::m_file;
+
+typedef struct
+{
+  int status;
+  std::map<std::string, std::string> headers;
+  std::string body;
+} HttpResponse;
+
+// a minimal HTTP/1.1 client keeping its connection alive between requests
+class CHttpTestClient
+{
+public:
+  CHttpTestClient() : m_socket(-1) { }
+  ~CHttpTestClient() { Disconnect(); }
+
+  bool Connect()
+  {
+    m_socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_socket < 0)
+      return false;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(testPort);
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    return connect(m_socket, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+  }
+
+  void Disconnect()
+  {
+    if (m_socket >= 0)
+      close(m_socket);
+    m_socket = -1;
+    m_buffer.clear();
+  }
+
+  bool Get(const std::string &url, const std::string &extraHeaders, HttpResponse &response)
+  {
+    std::string request = "GET " + url + " HTTP/1.1\r\nHost: 127.0.0.1\r\n" + extraHeaders + "\r\n";
+    if (send(m_socket, request.c_str(), request.size(), 0) != (ssize_t)request.size())
+      return false;
+
+    size_t end;
+    while ((end = m_buffer.find("\r\n\r\n")) == std::string::npos)
+    {
+      if (!Receive())
+        return false;
+    }
+
+    std::vector<std::string> lines = StringUtils::Split(m_buffer.substr(0, end), "\r\n");
+    m_buffer.erase(0, end + 4);
+    if (lines.empty() || lines[0].size() < 12)
+      return false;
+
+    response.status = atoi(lines[0].substr(9, 3).c_str());
+    response.headers.clear();
+    for (size_t i = 1; i < lines.size(); i++)
+    {
+      size_t colon = lines[i].find(':');
+      if (colon == std::string::npos)
+        continue;
+      std::string value = lines[i].substr(colon + 1);
+      std::string name = lines[i].substr(0, colon);
+      StringUtils::Trim(value);
+      StringUtils::ToLower(name);
+      response.headers[name] = value;
+    }
+
+    size_t length = atoi(response.headers["content-length"].c_str());
+    while (m_buffer.size() < length)
+    {
+      if (!Receive())
+        return false;
+    }
+    response.body = m_buffer.substr(0, length);
+    m_buffer.erase(0, length);
+    return true;
+  }
+
+private:
+  bool Receive()
+  {
+    char buffer[16384];
+    ssize_t received = recv(m_socket, buffer, sizeof(buffer), 0);
+    if (received <= 0)
+      return false;
+    m_buffer.append(buffer, received);
+    return true;
+  }
+
+  int m_socket;
+  std::string m_buffer;
+};
+
+class BenchWebServer : public testing::Test
+{
+protected:
+  BenchWebServer()
+  {
+    m_data.resize(TEST_FILE_SIZE);
+    for (size_t i = 0; i < m_data.size(); i++)
+      m_data[i] = (char)('a' + i % 26);
+
+    m_file = XBMC_CREATETEMPFILE(".bin");
+    m_file->Write(m_data.c_str(), m_data.size());
+    m_file->Flush();
+    CTestFileHandler::m_file = XBMC_TEMPFILEPATH(m_file);
+
+    CWebServer::RegisterRequestHandler(&m_handler);
+    // retry in case someone else grabbed the port in the meantime
+    for (int i = 0; i < 5 && !m_webserver.IsStarted(); i++)
+    {
+      testPort = GetFreePort();
+      if (testPort > 0)
+        m_webserver.Start(testPort, "", "");
+    }
+  }
+
+  ~BenchWebServer()
+  {
+    m_webserver.Stop();
+    CWebServer::UnregisterRequestHandler(&m_handler);
+    XBMC_DELETETEMPFILE(m_file);
+  }
+
+  CWebServer m_webserver;
+  CTestFileHandler m_handler;
+  XFILE::CFile *m_file;
+  std::string m_data;
+};
+
+class CLoadTestClient : public IRunnable
+{
+public:
+  CLoadTestClient(const std::string &url, unsigned int requests) : m_url(url), m_requests(requests), m_failed(0) { }
+
+  virtual void Run()
+  {
+    CHttpTestClient client;
+    if (!client.Connect())
+    {
+      m_failed = m_requests;
+      return;
+    }
+
+    for (unsigned int i = 0; i < m_requests; i++)
+    {
+      HttpResponse response;
+      int64_t start = CurrentHostCounter();
+      if (!client.Get(m_url, "", response) || response.status != MHD_HTTP_OK || response.body.size() != TEST_FILE_SIZE)
+      {
+        m_failed++;
+        // the connection may be in an undefined state
+        client.Disconnect();
+        client.Connect();
+        continue;
+      }
+      m_latencies.push_back(CurrentHostCounter() - start);
+    }
+  }
+
+  std::string m_url;
+  unsigned int m_requests;
+  unsigned int m_failed;
+  std::vector<int64_t> m_latencies;
+};
+
+static double Percentile(const std::vector<int64_t> &sorted, double percentile)
+{
+  if (sorted.empty())
+    return 0.0;
+  size_t index = std::min(sorted.size() - 1, (size_t)(percentile / 100.0 * sorted.size()));
+  return sorted[index] * 1000.0 / CurrentHostFrequency();
+}
+
+/* 16 keep-alive clients download the test file 200 times each, straight from
+ * disk and through the VFS. Reports the throughput and the latency
+ * percentiles of each. */
+TEST_F(BenchWebServer, LoadTest)
+{
+  ASSERT_TRUE(m_webserver.IsStarted());
+
+  const unsigned int clients = 16;
+  const unsigned int requests = 200;
+  const char *urls[] = { "/webservertest/local", "/webservertest/vfs" };
+
+  for (unsigned int u = 0; u < sizeof(urls) / sizeof(urls[0]); u++)
+  {
+    std::vector<CLoadTestClient *> runners;
+    std::vector<CThread *> threads;
+    int64_t start = CurrentHostCounter();
+    for (unsigned int i = 0; i < clients; i++)
+    {
+      runners.push_back(new CLoadTestClient(urls[u], requests));
+      threads.push_back(new CThread(runners.back(), "WebServerLoadTest"));
+      threads.back()->Create();
+    }
+
+    std::vector<int64_t> latencies;
+    unsigned int failed = 0;
+    for (unsigned int i = 0; i < clients; i++)
+    {
+      threads[i]->StopThread(true);
+      latencies.insert(latencies.end(), runners[i]->m_latencies.begin(), runners[i]->m_latencies.end());
+      failed += runners[i]->m_failed;
+      delete threads[i];
+      delete runners[i];
+    }
+    double seconds = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+
+    EXPECT_EQ(0U, failed);
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << urls[u] << ": " << clients << " clients x " << requests << " requests of " << TEST_FILE_SIZE << " bytes" << std::endl
+              << "  " << (seconds > 0 ? latencies.size() / seconds : 0) << " requests/s, latency"
+              << " p50 " << Percentile(latencies, 50) << " ms"
+              << " p90 " << Percentile(latencies, 90) << " ms"
+              << " p99 " << Percentile(latencies, 99) << " ms"
+              << " max " << Percentile(latencies, 100) << " ms" << std::endl;
+  }
+}
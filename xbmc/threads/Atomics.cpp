@@ -97,6 +97,22 @@ long cas(volatile long *pAddr, long expectedVal, long swapVal)
 #endif
 }
 
+///////////////////////////////////////////////////////////////////////////
+// Pointer sized atomic compare-and-swap
+// Returns previous value of *pAddr
+///////////////////////////////////////////////////////////////////////////
+void* casptr(void* volatile* pAddr, void* expectedVal, void* swapVal)
+{
+#if defined(HAS_BUILTIN_SYNC_VAL_COMPARE_AND_SWAP)
+  return(__sync_val_compare_and_swap(pAddr, expectedVal, swapVal));
+#elif defined(WIN32)
+  return InterlockedCompareExchangePointer(pAddr, swapVal, expectedVal);
+#else
+  // long is as wide as a pointer on all other (ILP32 and LP64) targets
+  return (void*)cas((volatile long*)pAddr, (long)expectedVal, (long)swapVal);
+#endif
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // 64-bit atomic compare-and-swap
 // Returns previous value of *pAddr
@@ -455,6 +471,24 @@ long AtomicSubtract(volatile long* pAddr, long amount)
 #endif
 }
 
+///////////////////////////////////////////////////////////////////////////
+// Full memory barrier
+// No load or store is moved across it, by the compiler or the cpu
+///////////////////////////////////////////////////////////////////////////
+void AtomicMemoryBarrier()
+{
+#if defined(WIN32)
+  MemoryBarrier();
+
+#elif defined(__ppc__) || defined(__powerpc__) // PowerPC
+  __asm__ __volatile__ ("sync" : : : "memory");
+
+#else
+  __sync_synchronize();
+
+#endif
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // Fast spinlock implmentation. No backoff when busy
 ///////////////////////////////////////////////////////////////////////////
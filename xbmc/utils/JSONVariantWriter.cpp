@@ -24,10 +24,8 @@
 
 using namespace std;
 
-string CJSONVariantWriter::Write(const CVariant &value, bool compact)
+yajl_gen CJSONVariantWriter::CreateGenerator(bool compact)
 {
-  string output;
-
 #if YAJL_MAJOR == 2
   yajl_gen g = yajl_gen_alloc(NULL);
   yajl_gen_config(g, yajl_gen_beautify, compact ? 0 : 1);
@@ -36,6 +34,14 @@ string CJSONVariantWriter::Write(const CVariant &value, bool compact)
   yajl_gen_config conf = { compact ? 0 : 1, "\t" };
   yajl_gen g = yajl_gen_alloc(&conf, NULL);
 #endif
+  return g;
+}
+
+string CJSONVariantWriter::Write(const CVariant &value, bool compact)
+{
+  string output;
+
+  yajl_gen g = CreateGenerator(compact);
 
   // Set locale to classic ("C") to ensure valid JSON numbers
   const char *currentLocale = setlocale(LC_NUMERIC, NULL);
@@ -66,6 +72,95 @@ string CJSONVariantWriter::Write(const CVariant &value, bool compact)
   return output;
 }
 
+bool CJSONVariantWriter::Write(CVariant &value, bool compact, IJSONWriterStream &stream, size_t chunkSize)
+{
+  yajl_gen g = CreateGenerator(compact);
+
+  // Set locale to classic ("C") to ensure valid JSON numbers
+  const char *currentLocale = setlocale(LC_NUMERIC, NULL);
+  if (currentLocale != NULL)
+    setlocale(LC_NUMERIC, "C");
+
+  bool success = InternalWrite(g, value, stream, chunkSize) && Flush(g, stream, 0);
+
+  // Re-set locale to what it was before using yajl
+  if (currentLocale != NULL)
+    setlocale(LC_NUMERIC, currentLocale);
+
+  yajl_gen_clear(g);
+  yajl_gen_free(g);
+
+  return success;
+}
+
+bool CJSONVariantWriter::Flush(yajl_gen g, IJSONWriterStream &stream, size_t chunkSize)
+{
+  const unsigned char * buffer;
+#if YAJL_MAJOR == 2
+  size_t length;
+#else
+  unsigned int length;
+#endif
+  yajl_gen_get_buf(g, &buffer, &length);
+
+  if (length == 0 || length < chunkSize)
+    return true;
+
+  bool success = stream.Write((const char *)buffer, length);
+  yajl_gen_clear(g);
+  return success;
+}
+
+bool CJSONVariantWriter::InternalWrite(yajl_gen g, CVariant &value, IJSONWriterStream &stream, size_t chunkSize)
+{
+  bool success = false;
+
+  switch (value.type())
+  {
+  case CVariant::VariantTypeArray:
+    success = yajl_gen_status_ok == yajl_gen_array_open(g);
+
+    for (CVariant::iterator_array itr = value.begin_array(); itr != value.end_array() && success; itr++)
+    {
+      success &= InternalWrite(g, *itr, stream, chunkSize);
+      *itr = CVariant::ConstNullVariant;
+      if (success)
+        success &= Flush(g, stream, chunkSize);
+    }
+
+    if (success)
+      success = yajl_gen_status_ok == yajl_gen_array_close(g);
+
+    break;
+  case CVariant::VariantTypeObject:
+    success = yajl_gen_status_ok == yajl_gen_map_open(g);
+
+    for (CVariant::iterator_map itr = value.begin_map(); itr != value.end_map() && success; itr++)
+    {
+#if YAJL_MAJOR == 2
+      success &= yajl_gen_status_ok == yajl_gen_string(g, (const unsigned char*)itr->first.c_str(), (size_t)itr->first.length());
+#else
+      success &= yajl_gen_status_ok == yajl_gen_string(g, (const unsigned char*)itr->first.c_str(), itr->first.length());
+#endif
+      if (success)
+        success &= InternalWrite(g, itr->second, stream, chunkSize);
+      itr->second = CVariant::ConstNullVariant;
+      if (success)
+        success &= Flush(g, stream, chunkSize);
+    }
+
+    if (success)
+      success &= yajl_gen_status_ok == yajl_gen_map_close(g);
+
+    break;
+  default:
+    success = InternalWrite(g, (const CVariant &)value);
+    break;
+  }
+
+  return success;
+}
+
 bool CJSONVariantWriter::InternalWrite(yajl_gen g, const CVariant &value)
 {
   bool success = false;
@@ -26,10 +26,56 @@
 #include <yajl/yajl_version.h>
 #endif
 
+/*!
+ \brief Receiver of JSON output written in chunks by CJSONVariantWriter
+ */
+class IJSONWriterStream
+{
+public:
+  virtual ~IJSONWriterStream() { }
+
+  /*!
+   \brief Write the next chunk of JSON output
+   \return false to abort writing
+   */
+  virtual bool Write(const char *data, size_t size) = 0;
+};
+
+/*!
+ \brief Stream appending the JSON output to a string
+ */
+class CJSONWriterStringStream : public IJSONWriterStream
+{
+public:
+  CJSONWriterStringStream(std::string &output) : m_output(output) { }
+
+  virtual bool Write(const char *data, size_t size) { m_output.append(data, size); return true; }
+private:
+  std::string &m_output;
+};
+
 class CJSONVariantWriter
 {
 public:
   static std::string Write(const CVariant &value, bool compact);
+
+  /*!
+   \brief Write a variant to a stream in chunks
+   The output is handed to the stream whenever more than chunkSize bytes are pending,
+   and every array element or object member is released as soon as it has been written.
+   This avoids holding the serialized output next to the variant, but the variant itself
+   has to be complete before writing starts, so the peak memory use is still that of the
+   whole variant.
+   \param value the variant to write, it is consumed by writing it
+   \param compact whether to write compact JSON
+   \param stream the receiver of the output
+   \param chunkSize the size of the chunks handed to the stream
+   \return true if the whole variant was written
+   */
+  static bool Write(CVariant &value, bool compact, IJSONWriterStream &stream, size_t chunkSize = 16384);
 private:
   static bool InternalWrite(yajl_gen g, const CVariant &value);
+  static bool InternalWrite(yajl_gen g, CVariant &value, IJSONWriterStream &stream, size_t chunkSize);
+  static bool Flush(yajl_gen g, IJSONWriterStream &stream, size_t chunkSize);
+  static yajl_gen CreateGenerator(bool compact);
 };
@@ -141,6 +141,18 @@ public:
    */
   virtual const char *GetType() const { return ""; };
 
+  /*!
+   \brief Function that returns the affinity of the job.
+
+   Jobs with the same non-zero affinity are preferably queued on the same worker, so jobs
+   touching the same data (a folder, a database, a file) tend to run one after the other
+   on one thread.  Any idle worker may still pick them up, so this is only a hint.
+
+   \return the affinity of the job, 0 for no preference.
+   \sa CJobManager
+   */
+  virtual unsigned int GetAffinity() const { return 0; };
+
   virtual bool operator==(const CJob* job) const
   {
     return false;
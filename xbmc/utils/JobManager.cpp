@@ -21,6 +21,8 @@
 #include "JobManager.h"
 #include <algorithm>
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/Atomics.h"
 #include "utils/log.h"
 
 #include "system.h"
@@ -28,6 +30,9 @@
 
 using namespace std;
 
+// low priority jobs waiting this long are run as normal priority ones
+#define JOB_AGING_MS 2000
+
 bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
 {
   if (m_callback)
@@ -167,6 +172,8 @@ CJobManager &CJobManager::GetInstance()
 CJobManager::CJobManager()
 {
   m_jobCounter = 0;
+  m_processingCount = 0;
+  m_pausedCount = 0;
   m_running = true;
 }
 
@@ -182,11 +189,25 @@ void CJobManager::CancelJobs()
     m_jobQueue[priority].clear();
   }
 
-  // cancel any callbacks on jobs still processing
-  for_each(m_processing.begin(), m_processing.end(), mem_fun_ref(&CWorkItem::Cancel));
+  for (unsigned int i = 0; i < MAX_WORKERS; ++i)
+  {
+    CWorkerSlot &slot = m_slots[i];
+    {
+      CSingleLock slotLock(slot.m_section);
+      for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+      {
+        for_each(slot.m_jobQueue[priority].begin(), slot.m_jobQueue[priority].end(), mem_fun_ref(&CWorkItem::FreeJob));
+        slot.m_jobQueue[priority].clear();
+      }
+    }
+
+    // cancel any callbacks on jobs still processing
+    CSingleLock processingLock(slot.m_processingSection);
+    slot.m_processing.Cancel();
+  }
 
   // tell our workers to finish
-  while (m_workers.size())
+  while (GetNumWorkers())
   {
     lock.Leave();
     m_jobEvent.Set();
@@ -213,7 +234,18 @@ unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORI
 
   // create a work item for this job
   CWorkItem work(job, m_jobCounter, callback);
-  m_jobQueue[priority].push_back(work);
+  work.m_queued = XbmcThreads::SystemClockMillis();
+
+  // queue it on the worker it has affinity with, if that one is around
+  unsigned int affinity = job->GetAffinity();
+  CWorkerSlot *slot = affinity ? &m_slots[affinity % MAX_WORKERS] : NULL;
+  if (slot && slot->m_worker)
+  {
+    CSingleLock slotLock(slot->m_section);
+    slot->m_jobQueue[priority].push_back(work);
+  }
+  else
+    m_jobQueue[priority].push_back(work);
 
   StartWorkers(priority);
   return work.m_id;
@@ -221,6 +253,8 @@ unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORI
 
 void CJobManager::CancelJob(unsigned int jobID)
 {
+  // held throughout, RemoveWorker() moves jobs from the queues of the workers
+  // back to ours under it, so the job can't slip past between the scans
   CSingleLock lock(m_section);
 
   // check whether we have this job in the queue
@@ -234,10 +268,35 @@ void CJobManager::CancelJob(unsigned int jobID)
       return;
     }
   }
+
+  // or in the queue of a worker. TakeJob() hands a job over to processing
+  // while its queue is locked, so checking processing last can't miss it.
+  for (unsigned int slot = 0; slot < MAX_WORKERS; ++slot)
+  {
+    CSingleLock slotLock(m_slots[slot].m_section);
+    JobQueue *jobQueue = m_slots[slot].m_jobQueue;
+    for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+    {
+      JobQueue::iterator i = find(jobQueue[priority].begin(), jobQueue[priority].end(), jobID);
+      if (i != jobQueue[priority].end())
+      {
+        delete i->m_job;
+        jobQueue[priority].erase(i);
+        return;
+      }
+    }
+  }
+
   // or if we're processing it
-  Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
-  if (it != m_processing.end())
-    it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
+  for (unsigned int slot = 0; slot < MAX_WORKERS; ++slot)
+  {
+    CSingleLock processingLock(m_slots[slot].m_processingSection);
+    if (m_slots[slot].m_processing.m_job && m_slots[slot].m_processing == jobID)
+    {
+      m_slots[slot].m_processing.Cancel(); // job is in progress, so only thing to do is to remove callback
+      return;
+    }
+  }
 }
 
 void CJobManager::StartWorkers(CJob::PRIORITY priority)
@@ -245,100 +304,153 @@ void CJobManager::StartWorkers(CJob::PRIORITY priority)
   CSingleLock lock(m_section);
 
   // check how many free threads we have
-  if (m_processing.size() >= GetMaxWorkers(priority))
+  unsigned int processing = (unsigned int)m_processingCount;
+  if (processing >= GetMaxWorkers(priority))
     return;
 
   // do we have any sleeping threads?
-  if (m_processing.size() < m_workers.size())
+  if (processing < GetNumWorkers())
   {
     m_jobEvent.Set();
     return;
   }
 
   // everyone is busy - we need more workers
-  m_workers.push_back(new CJobWorker(this));
+  for (unsigned int slot = 0; slot < MAX_WORKERS; ++slot)
+  {
+    if (!m_slots[slot].m_worker)
+    {
+      m_slots[slot].m_worker = new CJobWorker(this);
+      return;
+    }
+  }
 }
 
-CJob *CJobManager::PopJob()
+bool CJobManager::ReserveWorker(CJob::PRIORITY priority)
 {
-  CSingleLock lock(m_section);
+  long maxWorkers = (long)GetMaxWorkers(priority);
+  while (true)
+  {
+    long processing = m_processingCount;
+    if (processing >= maxWorkers)
+      return false;
+    if (cas(&m_processingCount, processing, processing + 1) == processing)
+      return true;
+  }
+}
+
+CJob *CJobManager::PopJob(unsigned int slot)
+{
+  CWorkerSlot &own = m_slots[slot];
   for (int priority = CJob::PRIORITY_HIGH; priority >= CJob::PRIORITY_LOW; --priority)
   {
-    if (m_jobQueue[priority].size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
+    if (!ReserveWorker((CJob::PRIORITY)priority))
+      continue;
+
+    // our own queue, then the global one
+    CJob *job = TakeJob(own.m_jobQueue, own.m_section, (CJob::PRIORITY)priority, own);
+    if (!job)
+      job = TakeJob(m_jobQueue, m_section, (CJob::PRIORITY)priority, own);
+
+    // then see if another worker has something queued we can take off its hands
+    for (unsigned int i = 1; i < MAX_WORKERS && !job; ++i)
     {
-      // skip adding any paused types
-      if (!SkipPausedJobs((CJob::PRIORITY)priority))
-        return NULL;
-
-      // pop the job off the queue
-      CWorkItem job = m_jobQueue[priority].front();
-      m_jobQueue[priority].pop_front();
-
-      // add to the processing vector
-      m_processing.push_back(job);
-      job.m_job->m_callback = this;
-      return job.m_job;
+      CWorkerSlot &other = m_slots[(slot + i) % MAX_WORKERS];
+      job = TakeJob(other.m_jobQueue, other.m_section, (CJob::PRIORITY)priority, own);
     }
+
+    if (job)
+      return job;
+
+    AtomicDecrement(&m_processingCount);
   }
   return NULL;
 }
 
+CJob *CJobManager::TakeJob(JobQueue *jobQueue, CCriticalSection &section, CJob::PRIORITY priority, CWorkerSlot &slot)
+{
+  CSingleLock lock(section);
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  JobQueue *queue = &jobQueue[priority];
+  JobQueue::iterator i = FindRunnable(*queue, priority, now, false);
+  if (i == queue->end() && priority == CJob::PRIORITY_NORMAL)
+  {
+    queue = &jobQueue[CJob::PRIORITY_LOW];
+    i = FindRunnable(*queue, CJob::PRIORITY_LOW, now, true);
+  }
+  if (i == queue->end())
+    return NULL;
+
+  // hand it over to the worker while the queue is still locked,
+  // so CancelJob() always finds it in one of the two places
+  CSingleLock processingLock(slot.m_processingSection);
+  slot.m_processing = *i;
+  slot.m_processing.m_job->m_callback = this;
+  queue->erase(i);
+  return slot.m_processing.m_job;
+}
+
+CJobManager::JobQueue::iterator CJobManager::FindRunnable(JobQueue &queue, CJob::PRIORITY priority, unsigned int now, bool agedOnly)
+{
+  for (JobQueue::iterator i = queue.begin(); i != queue.end(); ++i)
+  {
+    // jobs are queued in order, so the rest hasn't waited long enough either
+    if (agedOnly && now - i->m_queued < JOB_AGING_MS)
+      break;
+
+    // skip any paused types
+    if (priority > CJob::PRIORITY_LOW || !m_pausedCount || !IsPausedType(i->m_job->GetType()))
+      return i;
+  }
+  return queue.end();
+}
+
 void CJobManager::Pause(const std::string &pausedType)
 {
-  CSingleLock lock(m_section);
+  CSingleLock lock(m_pausedSection);
   // just push it in so we get ref counting,
   // the queue will resume when all Pause requests
   // for a given type have been UnPaused.
   m_pausedTypes.push_back(pausedType);
+  m_pausedCount = m_pausedTypes.size();
 }
 
 void CJobManager::UnPause(const std::string &pausedType)
 {
-  CSingleLock lock(m_section);
+  CSingleLock lock(m_pausedSection);
   std::vector<std::string>::iterator i = find(m_pausedTypes.begin(), m_pausedTypes.end(), pausedType);
   if (i != m_pausedTypes.end())
     m_pausedTypes.erase(i);
+  m_pausedCount = m_pausedTypes.size();
 }
 
 bool CJobManager::IsPaused(const std::string &pausedType)
 {
-  CSingleLock lock(m_section);
+  CSingleLock lock(m_pausedSection);
   std::vector<std::string>::iterator i = find(m_pausedTypes.begin(), m_pausedTypes.end(), pausedType);
   return (i != m_pausedTypes.end());
 }
 
-bool CJobManager::SkipPausedJobs(CJob::PRIORITY priority)
+bool CJobManager::IsPausedType(const char *type)
 {
-  if (priority > CJob::PRIORITY_LOW)
-    return true;
-
-  // find the first unpaused job
-  JobQueue::iterator first_job = m_jobQueue[priority].begin();
-  for (; first_job != m_jobQueue[priority].end(); ++first_job)
+  CSingleLock lock(m_pausedSection);
+  for (std::vector<std::string>::iterator i = m_pausedTypes.begin(); i != m_pausedTypes.end(); ++i)
   {
-    std::vector<std::string>::iterator i = find(m_pausedTypes.begin(), m_pausedTypes.end(), first_job->m_job->GetType());
-    if (i == m_pausedTypes.end())
-      break; // found a job that can be performed
+    if (*i == type)
+      return true;
   }
-  if (first_job == m_jobQueue[priority].end())
-    return false; // no jobs ready to go
-
-  // shunt all the paused ones to the back of the queue
-  for (JobQueue::iterator i = m_jobQueue[priority].begin(); i != first_job; i++)
-  {
-    m_jobQueue[priority].push_back(*i);
-    m_jobQueue[priority].pop_front();
-  }
-  return true;
+  return false;
 }
 
 int CJobManager::IsProcessing(const std::string &pausedType)
 {
   int jobsMatched = 0;
-  CSingleLock lock(m_section);
-  for(Processing::iterator it = m_processing.begin(); it < m_processing.end(); it++)
+  for (unsigned int slot = 0; slot < MAX_WORKERS; ++slot)
   {
-    if (pausedType == std::string(it->m_job->GetType()))
+    CSingleLock lock(m_slots[slot].m_processingSection);
+    CJob *job = m_slots[slot].m_processing.m_job;
+    if (job && pausedType == std::string(job->GetType()))
       jobsMatched++;
   }
   return jobsMatched;
@@ -347,22 +459,27 @@ int CJobManager::IsProcessing(const std::string &pausedType)
 CJob *CJobManager::GetNextJob(const CJobWorker *worker)
 {
   CSingleLock lock(m_section);
+  unsigned int slot = 0;
+  while (slot < MAX_WORKERS && m_slots[slot].m_worker != worker)
+    slot++;
+  if (slot == MAX_WORKERS)
+    return NULL;
+  lock.Leave();
+
   while (m_running)
   {
-    // grab a job off the queue if we have one
-    CJob *job = PopJob();
+    // grab a job off the queues if we have one
+    CJob *job = PopJob(slot);
     if (job)
       return job;
     // no jobs are left - sleep for 30 seconds to allow new jobs to come in
-    lock.Leave();
-    bool newJob = m_jobEvent.WaitMSec(30000);
-    lock.Enter();
-    if (!newJob)
+    if (!m_jobEvent.WaitMSec(30000))
       break;
   }
   // ensure no jobs have come in during the period after
   // timeout and before we held the lock
-  CJob *job = PopJob();
+  lock.Enter();
+  CJob *job = PopJob(slot);
   if (job)
     return job;
   // have no jobs
@@ -372,17 +489,20 @@ CJob *CJobManager::GetNextJob(const CJobWorker *worker)
 
 bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
 {
-  CSingleLock lock(m_section);
-  // find the job in the processing queue, and check whether it's cancelled (no callback)
-  Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  // find the job in the processing slots, and check whether it's cancelled (no callback)
+  for (unsigned int slot = 0; slot < MAX_WORKERS; ++slot)
   {
-    CWorkItem item(*i);
-    lock.Leave(); // leave section prior to call
-    if (item.m_callback)
+    CSingleLock lock(m_slots[slot].m_processingSection);
+    if (m_slots[slot].m_processing.m_job == job)
     {
-      item.m_callback->OnJobProgress(item.m_id, progress, total, job);
-      return false;
+      CWorkItem item(m_slots[slot].m_processing);
+      lock.Leave(); // leave section prior to call
+      if (item.m_callback)
+      {
+        item.m_callback->OnJobProgress(item.m_id, progress, total, job);
+        return false;
+      }
+      break;
     }
   }
   return true; // couldn't find the job, or it's been cancelled
@@ -390,13 +510,15 @@ bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const
 
 void CJobManager::OnJobComplete(bool success, CJob *job)
 {
-  CSingleLock lock(m_section);
-  // remove the job from the processing queue
-  Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  // find the job in the processing slots
+  for (unsigned int slot = 0; slot < MAX_WORKERS; ++slot)
   {
+    CSingleLock lock(m_slots[slot].m_processingSection);
+    if (m_slots[slot].m_processing.m_job != job)
+      continue;
+
     // tell any listeners we're done with the job, then delete it
-    CWorkItem item(*i);
+    CWorkItem item(m_slots[slot].m_processing);
     lock.Leave();
     try
     {
@@ -408,11 +530,11 @@ void CJobManager::OnJobComplete(bool success, CJob *job)
       CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
     }
     lock.Enter();
-    Processing::iterator j = find(m_processing.begin(), m_processing.end(), job);
-    if (j != m_processing.end())
-      m_processing.erase(j);
+    m_slots[slot].m_processing = CWorkItem(NULL, 0, NULL);
     lock.Leave();
     item.FreeJob();
+    AtomicDecrement(&m_processingCount);
+    return;
   }
 }
 
@@ -420,13 +542,36 @@ void CJobManager::RemoveWorker(const CJobWorker *worker)
 {
   CSingleLock lock(m_section);
   // remove our worker
-  Workers::iterator i = find(m_workers.begin(), m_workers.end(), worker);
-  if (i != m_workers.end())
-    m_workers.erase(i); // workers auto-delete
+  for (unsigned int slot = 0; slot < MAX_WORKERS; ++slot)
+  {
+    if (m_slots[slot].m_worker != worker)
+      continue;
+
+    // workers auto-delete, hand anything still queued for it to the others
+    m_slots[slot].m_worker = NULL;
+    CSingleLock slotLock(m_slots[slot].m_section);
+    for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+    {
+      JobQueue &jobQueue = m_slots[slot].m_jobQueue[priority];
+      m_jobQueue[priority].insert(m_jobQueue[priority].end(), jobQueue.begin(), jobQueue.end());
+      jobQueue.clear();
+    }
+    break;
+  }
 }
 
 unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority) const
 {
-  static const unsigned int max_workers = 5;
-  return max_workers - (CJob::PRIORITY_HIGH - priority);
+  return MAX_WORKERS - (CJob::PRIORITY_HIGH - priority);
+}
+
+unsigned int CJobManager::GetNumWorkers() const
+{
+  unsigned int workers = 0;
+  for (unsigned int slot = 0; slot < MAX_WORKERS; ++slot)
+  {
+    if (m_slots[slot].m_worker)
+      workers++;
+  }
+  return workers;
 }
@@ -158,6 +158,13 @@ private:
  priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ Each worker has its own queue next to the global one. Jobs with an affinity go
+ to the queue of the worker that affinity maps to, all others to the global queue.
+ Workers take jobs from their own queue first, then from the global queue, and
+ finally steal from the queues of other workers, highest priority first. Low
+ priority jobs that have waited for a while are treated as normal priority ones
+ so they aren't starved.
+
  \sa CJob and IJobCallback
  */
 class CJobManager
@@ -170,6 +177,7 @@ class CJobManager
       m_job = job;
       m_id = id;
       m_callback = callback;
+      m_queued = 0;
     }
     bool operator==(unsigned int jobID) const
     {
@@ -191,6 +199,25 @@ class CJobManager
     CJob         *m_job;
     unsigned int  m_id;
     IJobCallback *m_callback;
+    unsigned int  m_queued;
+  };
+
+  typedef std::deque<CWorkItem>    JobQueue;
+
+  /*!
+   \brief Jobs queued for, and the job processed by, one worker.
+   The queue and the job being processed have their own locks, the latter is
+   only ever taken on its own or right after the former.
+   */
+  class CWorkerSlot
+  {
+  public:
+    CWorkerSlot() : m_processing(NULL, 0, NULL), m_worker(NULL) {};
+    JobQueue          m_jobQueue[CJob::PRIORITY_HIGH+1];
+    CCriticalSection  m_section;
+    CWorkItem         m_processing;
+    CCriticalSection  m_processingSection;
+    CJobWorker       *m_worker;
   };
 
 public:
@@ -295,35 +322,54 @@ private:
   CJobManager const& operator=(CJobManager const&);
   virtual ~CJobManager();
 
-  /*! \brief Pop a job off the job queue and add to the processing queue ready to process
+  enum { MAX_WORKERS = 5 };
+
+  /*! \brief Pop a job off the job queues and make it the one processed by the given worker slot
+   \param slot index of the worker slot
+   \return the job to process, NULL if no jobs are available
+   */
+  CJob *PopJob(unsigned int slot);
+
+  /*! \brief Take the first runnable job of a given priority from a set of queues.
+   Low priority jobs that waited long enough are taken when asked for normal priority.
+   \param jobQueue the queues to take the job from, one per priority
+   \param section the lock guarding jobQueue
+   \param priority the priority to take a job of
+   \param slot the worker slot that is going to process the job
    \return the job to process, NULL if no jobs are available
    */
-  CJob *PopJob();
+  CJob *TakeJob(JobQueue *jobQueue, CCriticalSection &section, CJob::PRIORITY priority, CWorkerSlot &slot);
+
+  /*! \brief Find the first job in a queue that isn't paused
+   \param queue the queue to search
+   \param priority priority of the queue
+   \param now time to compare the queue time with
+   \param agedOnly only consider jobs waiting for longer than the aging time
+   */
+  JobQueue::iterator FindRunnable(JobQueue &queue, CJob::PRIORITY priority, unsigned int now, bool agedOnly);
+
+  /*! \brief Reserve a worker for a job of the given priority
+   \return true if the number of processing jobs was below the maximum for the priority
+   */
+  bool ReserveWorker(CJob::PRIORITY priority);
 
   void StartWorkers(CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker *worker);
   unsigned int GetMaxWorkers(CJob::PRIORITY priority) const;
-
-  /*! \brief skips over any paused jobs of given priority.
-   Moves any paused jobs at the front of the queue to the back of the
-   queue, allowing unpaused jobs to continue processing.
-   \param priority the priority queue to consider.
-   \return true if an unpaused job is available, false if no unpaused jobs are available.
-   */
-  bool SkipPausedJobs(CJob::PRIORITY priority);
+  unsigned int GetNumWorkers() const;
+  bool IsPausedType(const char *type);
 
   unsigned int m_jobCounter;
 
-  typedef std::deque<CWorkItem>    JobQueue;
-  typedef std::vector<CWorkItem>   Processing;
-  typedef std::vector<CJobWorker*> Workers;
-
-  JobQueue   m_jobQueue[CJob::PRIORITY_HIGH+1];
-  Processing m_processing;
-  Workers    m_workers;
+  JobQueue    m_jobQueue[CJob::PRIORITY_HIGH+1];
+  CWorkerSlot m_slots[MAX_WORKERS];
+  volatile long m_processingCount;
 
   CCriticalSection m_section;
   CEvent           m_jobEvent;
   bool             m_running;
+
   std::vector<std::string>  m_pausedTypes;
+  volatile long             m_pausedCount;
+  CCriticalSection          m_pausedSection;
 };
@@ -28,6 +28,9 @@
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
+#include <algorithm>
+#include <locale>
+
 using namespace std;
 
 string ArrayToString(SortAttribute attributes, const CVariant &variant, const string &seperator = " / ")
@@ -517,6 +520,130 @@ bool SorterIgnoreFoldersDescending(const SortItem &left, const SortItem &right)
   return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
 }
 
+/* Collation keys: instead of looking up and comparing the FieldSort labels of
+ * two items n*log(n) times, every label is encoded once into a flat buffer of
+ * 32 bit units whose lexicographical order matches AlphaNumericCompare() with
+ * the classic collation. Unit 0 marks the end of a key so prefixes sort first,
+ * ASCII letters are lower cased and every other character keeps its code
+ * point. A run of up to 15 digits becomes a marker (ordered like any digit
+ * against other characters) followed by its value in two 25 bit halves, so
+ * numbers compare by value. */
+#define SORTKEY_NUMBER     ((uint32_t)L'0' + 1)
+#define SORTKEY_HALF_BITS  25
+
+typedef struct
+{
+  uint64_t      prefix;   // first two units of the key
+  unsigned int  offset;   // of the key in the unit buffer
+  unsigned int  length;
+  unsigned int  index;    // of the item in the unsorted list
+  unsigned char special;  // 0 on top, 1 none, 2 on bottom
+  unsigned char folder;   // 0 folder, 1 no folder, 2 unknown or folders ignored
+} SortKey;
+
+static void AppendSortKey(const std::wstring &label, vector<uint32_t> &units)
+{
+  const wchar_t *c = label.c_str();
+  while (*c != 0)
+  {
+    if (*c >= L'0' && *c <= L'9')
+    {
+      const wchar_t *start = c;
+      uint64_t number = 0;
+      while (*c >= L'0' && *c <= L'9' && c < start + 15)
+        number = number * 10 + (*c++ - L'0');
+      units.push_back(SORTKEY_NUMBER);
+      units.push_back((uint32_t)(number >> SORTKEY_HALF_BITS) + 1);
+      units.push_back((uint32_t)(number & ((1 << SORTKEY_HALF_BITS) - 1)) + 1);
+      continue;
+    }
+
+    wchar_t lc = *c++;
+    if (lc >= L'A' && lc <= L'Z')
+      lc += L'a' - L'A';
+    units.push_back((uint32_t)lc + 1);
+  }
+}
+
+static SortKey MakeSortKey(const SortItem &item, const std::wstring &label, unsigned int index, bool handleFolder, vector<uint32_t> &units)
+{
+  SortKey key;
+  key.offset = units.size();
+  AppendSortKey(label, units);
+  key.length = units.size() - key.offset;
+  key.index = index;
+
+  key.prefix = 0;
+  if (key.length > 0)
+    key.prefix = (uint64_t)units[key.offset] << 32;
+  if (key.length > 1)
+    key.prefix |= units[key.offset + 1];
+
+  key.special = 1;
+  SortItem::const_iterator it = item.find(FieldSortSpecial);
+  if (it != item.end())
+  {
+    if (it->second.asInteger() == SortSpecialOnTop)
+      key.special = 0;
+    else if (it->second.asInteger() == SortSpecialOnBottom)
+      key.special = 2;
+  }
+
+  key.folder = 2;
+  if (handleFolder && (it = item.find(FieldFolder)) != item.end())
+    key.folder = it->second.asBoolean() ? 0 : 1;
+
+  return key;
+}
+
+class SortKeyCompare
+{
+public:
+  SortKeyCompare(const vector<uint32_t> &units, bool descending)
+    : m_units(units), m_descending(descending)
+  { }
+
+  bool operator()(const SortKey &left, const SortKey &right) const
+  {
+    // items sorted on top or bottom keep their order amongst each other
+    if (left.special != right.special)
+      return left.special < right.special;
+    if (left.special != 1)
+      return false;
+
+    // folders go first, whatever the sort order, as long as it is known
+    // whether both items are folders (like preliminarySort())
+    if (left.folder != right.folder && left.folder != 2 && right.folder != 2)
+      return left.folder < right.folder;
+
+    int result = compare(left, right);
+    return m_descending ? result > 0 : result < 0;
+  }
+
+private:
+  int compare(const SortKey &left, const SortKey &right) const
+  {
+    if (left.prefix != right.prefix)
+      return left.prefix < right.prefix ? -1 : 1;
+
+    unsigned int length = min(left.length, right.length);
+    for (unsigned int i = 2; i < length; i++)
+    {
+      uint32_t l = m_units[left.offset + i];
+      uint32_t r = m_units[right.offset + i];
+      if (l != r)
+        return l < r ? -1 : 1;
+    }
+
+    if (left.length != right.length)
+      return left.length < right.length ? -1 : 1;
+    return 0;
+  }
+
+  const vector<uint32_t> &m_units;
+  bool m_descending;
+};
+
 map<SortBy, SortUtils::SortPreparator> fillPreparators()
 {
   map<SortBy, SortUtils::SortPreparator> preparators;
@@ -652,8 +779,21 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
     {
       Fields sortingFields = GetFieldsForSorting(sortBy);
 
+      // the collation keys mirror AlphaNumericCompare() for the classic
+      // collation only, any other locale goes through the item sorters
+      bool useKeys = locale() == locale::classic();
+      bool handleFolder = !(attributes & SortAttributeIgnoreFolders);
+      vector<SortKey> keys;
+      vector<uint32_t> units;
+      if (useKeys)
+      {
+        keys.reserve(items.size());
+        units.reserve(items.size() * 16);
+      }
+
       // Prepare the string used for sorting and store it under FieldSort
-      for (SortItems::iterator item = items.begin(); item != items.end(); item++)
+      unsigned int index = 0;
+      for (SortItems::iterator item = items.begin(); item != items.end(); item++, index++)
       {
         // add all fields to the item that are required for sorting if they are currently missing
         for (Fields::const_iterator field = sortingFields.begin(); field != sortingFields.end(); field++)
@@ -664,11 +804,29 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
 
         CStdStringW sortLabel;
         g_charsetConverter.utf8ToW(preparator(attributes, *item), sortLabel, false);
-        item->insert(pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
+        pair<SortItem::iterator, bool> sortField = item->insert(pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
+
+        if (useKeys)
+        {
+          // an item that already had a sort label is sorted by that one
+          if (!sortField.second)
+            sortLabel = sortField.first->second.asWideString();
+          keys.push_back(MakeSortKey(*item, sortLabel, index, handleFolder, units));
+        }
       }
 
       // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
+      if (useKeys)
+      {
+        std::stable_sort(keys.begin(), keys.end(), SortKeyCompare(units, sortOrder == SortOrderDescending));
+
+        SortItems sorted(keys.size());
+        for (unsigned int i = 0; i < keys.size(); i++)
+          sorted[i].swap(items[keys[i].index]);
+        items.swap(sorted);
+      }
+      else
+        std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
     }
   }
 
@@ -22,6 +22,7 @@
 #include "log.h"
 #include "stdio_utf8.h"
 #include "stat_utf8.h"
+#include "threads/Atomics.h"
 #include "threads/CriticalSection.h"
 #include "threads/SingleLock.h"
 #include "threads/Thread.h"
@@ -38,10 +39,63 @@
 #define m_repeatLogLevel XBMC_GLOBAL_USE(CLog::CLogGlobals).m_repeatLogLevel
 #define m_repeatLine XBMC_GLOBAL_USE(CLog::CLogGlobals).m_repeatLine
 #define m_logLevel XBMC_GLOBAL_USE(CLog::CLogGlobals).m_logLevel
+#define m_componentLevels XBMC_GLOBAL_USE(CLog::CLogGlobals).m_componentLevels
+#define m_queue XBMC_GLOBAL_USE(CLog::CLogGlobals).m_queue
+#define m_pending XBMC_GLOBAL_USE(CLog::CLogGlobals).m_pending
+#define m_queueEvent XBMC_GLOBAL_USE(CLog::CLogGlobals).m_queueEvent
+#define m_writer XBMC_GLOBAL_USE(CLog::CLogGlobals).m_writer
+#define m_logFile XBMC_GLOBAL_USE(CLog::CLogGlobals).m_logFile
+#define m_logFileOld XBMC_GLOBAL_USE(CLog::CLogGlobals).m_logFileOld
+#define m_bytesWritten XBMC_GLOBAL_USE(CLog::CLogGlobals).m_bytesWritten
+#define m_maxSize XBMC_GLOBAL_USE(CLog::CLogGlobals).m_maxSize
 
 static char levelNames[][8] =
 {"DEBUG", "INFO", "NOTICE", "WARNING", "ERROR", "SEVERE", "FATAL", "NONE"};
 
+static const char* prefixFormat = "%02.2d:%02.2d:%02.2d T:%"PRIu64" %7s: ";
+
+struct CLog::LogEntry
+{
+  LogEntry *next;
+  int       level;
+  SYSTEMTIME time;
+  uint64_t  threadId;
+  CStdString message;
+};
+
+/*!
+ \brief Writes the queued log messages to the log file.
+ Callers of CLog::Log() only format their message and push it onto the
+ queue, the file I/O (and the flush) is done here once per batch.
+ */
+class CLogWriter : public CThread
+{
+public:
+  CLogWriter() : CThread("LogWriter") {}
+
+  virtual void StopThread(bool bWait = true)
+  {
+    m_bStop = true;
+    m_queueEvent.Set();
+    CThread::StopThread(bWait);
+  }
+
+protected:
+  virtual void Process()
+  {
+    while (!m_bStop)
+    {
+      m_queueEvent.WaitMSec(1000);
+      // reset before taking the queue so that a message pushed after it is
+      // taken signals the event again
+      long pending = m_pending;
+      while (cas(&m_pending, pending, 0) != pending)
+        pending = m_pending;
+      CLog::Flush();
+    }
+  }
+};
+
 CLog::CLog()
 {}
 
@@ -50,8 +104,21 @@ CLog::~CLog()
 
 void CLog::Close()
 {
-  
+  CThread *writer;
+  {
+    CSingleLock waitLock(critSec);
+    writer = m_writer;
+    m_writer = NULL;
+  }
+  // the writer flushes under our lock, so it has to be stopped without it
+  if (writer)
+  {
+    writer->StopThread(true);
+    delete writer;
+  }
+
   CSingleLock waitLock(critSec);
+  Flush();
   if (m_file)
   {
     fclose(m_file);
@@ -62,76 +129,153 @@ void CLog::Close()
 
 void CLog::Log(int loglevel, const char *format, ... )
 {
-  static const char* prefixFormat = "%02.2d:%02.2d:%02.2d T:%"PRIu64" %7s: ";
+  if (!IsLogLevelLogged(loglevel) || !m_file)
+    return;
+
+  // the entry belongs to the writer once it is queued
+  const int level = loglevel & LOGMASK;
+  LogEntry *entry = new LogEntry;
+  entry->level = level;
+  GetLocalTime(&entry->time);
+  entry->threadId = (uint64_t)CThread::GetCurrentThreadId();
+
+  va_list va;
+  va_start(va, format);
+  entry->message.FormatV(format, va);
+  va_end(va);
+
+  LogEntry *top;
+  do
+  {
+    top = m_queue;
+    entry->next = top;
+  } while (casptr((void* volatile*)&m_queue, top, entry) != top);
+
+  // severe errors are written right away as we might be about to crash
+  if (!m_writer || level >= LOGSEVERE)
+    Flush();
+  else if (AtomicIncrement(&m_pending) == 1)
+    m_queueEvent.Set();
+}
+
+void CLog::Flush()
+{
   CSingleLock waitLock(critSec);
-#if !(defined(_DEBUG) || defined(PROFILE))
-  if (m_logLevel > LOG_LEVEL_NORMAL ||
-     (m_logLevel > LOG_LEVEL_NONE && loglevel >= LOGNOTICE))
-#endif
+
+  // take all queued messages at once, they are queued newest first
+  LogEntry *entries = m_queue;
+  while (casptr((void* volatile*)&m_queue, entries, NULL) != entries)
+    entries = m_queue;
+  if (!entries)
+    return;
+
+  LogEntry *ordered = NULL;
+  while (entries)
   {
-    if (!m_file)
-      return;
+    LogEntry *next = entries->next;
+    entries->next = ordered;
+    ordered = entries;
+    entries = next;
+  }
 
-    SYSTEMTIME time;
-    GetLocalTime(&time);
+  while (ordered)
+  {
+    LogEntry *next = ordered->next;
+    if (m_file)
+      WriteEntry(ordered);
+    delete ordered;
+    ordered = next;
+  }
 
-    CStdString strPrefix, strData;
+  if (m_file)
+  {
+    fflush(m_file);
+    if (m_maxSize > 0 && m_bytesWritten > m_maxSize)
+      Rotate();
+  }
+}
 
-    strData.reserve(16384);
-    va_list va;
-    va_start(va, format);
-    strData.FormatV(format,va);
-    va_end(va);
+void CLog::WriteEntry(LogEntry *entry)
+{
+  CStdString strPrefix;
+  CStdString &strData = entry->message;
+  const SYSTEMTIME &time = entry->time;
 
-    if (m_repeatLogLevel == loglevel && m_repeatLine == strData)
-    {
-      m_repeatCount++;
-      return;
-    }
-    else if (m_repeatCount)
-    {
-      CStdString strData2;
-      strPrefix.Format(prefixFormat, time.wHour, time.wMinute, time.wSecond, (uint64_t)CThread::GetCurrentThreadId(), levelNames[m_repeatLogLevel]);
-
-      strData2.Format("Previous line repeats %d times." LINE_ENDING, m_repeatCount);
-      fputs(strPrefix.c_str(), m_file);
-      fputs(strData2.c_str(), m_file);
-      OutputDebugString(strData2);
-      m_repeatCount = 0;
-    }
-    
-    m_repeatLine      = strData;
-    m_repeatLogLevel  = loglevel;
+  if (m_repeatLogLevel == entry->level && m_repeatLine == strData)
+  {
+    m_repeatCount++;
+    return;
+  }
+  else if (m_repeatCount)
+  {
+    CStdString strData2;
+    strPrefix.Format(prefixFormat, time.wHour, time.wMinute, time.wSecond, entry->threadId, levelNames[m_repeatLogLevel]);
 
-    unsigned int length = 0;
-    while ( length != strData.length() )
-    {
-      length = strData.length();
-      strData.TrimRight(" ");
-      strData.TrimRight('\n');
-      strData.TrimRight("\r");
-    }
+    strData2.Format("Previous line repeats %d times." LINE_ENDING, m_repeatCount);
+    fputs(strPrefix.c_str(), m_file);
+    fputs(strData2.c_str(), m_file);
+    m_bytesWritten += strPrefix.size() + strData2.size();
+    OutputDebugString(strData2);
+    m_repeatCount = 0;
+  }
+
+  m_repeatLine      = strData;
+  m_repeatLogLevel  = entry->level;
 
-    if (!length)
-      return;
-    
-    OutputDebugString(strData);
+  unsigned int length = 0;
+  while ( length != strData.length() )
+  {
+    length = strData.length();
+    strData.TrimRight(" ");
+    strData.TrimRight('\n');
+    strData.TrimRight("\r");
+  }
 
-    /* fixup newline alignment, number of spaces should equal prefix length */
-    strData.Replace("\n", LINE_ENDING"                                            ");
-    strData += LINE_ENDING;
+  if (!length)
+    return;
 
-    strPrefix.Format(prefixFormat, time.wHour, time.wMinute, time.wSecond, (uint64_t)CThread::GetCurrentThreadId(), levelNames[loglevel]);
+  OutputDebugString(strData);
+
+  /* fixup newline alignment, number of spaces should equal prefix length */
+  strData.Replace("\n", LINE_ENDING"                                            ");
+  strData += LINE_ENDING;
+
+  strPrefix.Format(prefixFormat, time.wHour, time.wMinute, time.wSecond, entry->threadId, levelNames[entry->level]);
 
 //print to adb
 #if defined(TARGET_ANDROID) && defined(_DEBUG)
   CXBMCApp::android_printf("%s%s",strPrefix.c_str(), strData.c_str());
 #endif
 
-    fputs(strPrefix.c_str(), m_file);
-    fputs(strData.c_str(), m_file);
-    fflush(m_file);
+  fputs(strPrefix.c_str(), m_file);
+  fputs(strData.c_str(), m_file);
+  m_bytesWritten += strPrefix.size() + strData.size();
+}
+
+bool CLog::Rotate()
+{
+  fclose(m_file);
+  m_file = NULL;
+  m_bytesWritten = 0;
+
+  struct stat64 info;
+  if ((stat64_utf8(m_logFileOld.c_str(),&info) == 0 &&
+       remove_utf8(m_logFileOld.c_str()) != 0) ||
+      rename_utf8(m_logFile.c_str(),m_logFileOld.c_str()) != 0)
+  {
+    // keep logging to the current file rather than not at all
+    m_file = fopen64_utf8(m_logFile.c_str(),"ab");
+    return false;
   }
+
+  m_file = fopen64_utf8(m_logFile.c_str(),"wb");
+  if (!m_file)
+    return false;
+
+  unsigned char BOM[3] = {0xEF, 0xBB, 0xBF};
+  fwrite(BOM, sizeof(BOM), 1, m_file);
+  m_bytesWritten = sizeof(BOM);
+  return true;
 }
 
 bool CLog::Init(const char* path)
@@ -162,12 +306,22 @@ bool CLog::Init(const char* path)
       return false;
 
     m_file = fopen64_utf8(strLogFile.c_str(),"wb");
+    m_logFile = strLogFile;
+    m_logFileOld = strLogFileOld;
+    m_bytesWritten = 0;
   }
 
   if (m_file)
   {
     unsigned char BOM[3] = {0xEF, 0xBB, 0xBF};
     fwrite(BOM, sizeof(BOM), 1, m_file);
+    m_bytesWritten += sizeof(BOM);
+
+    if (!m_writer)
+    {
+      m_writer = new CLogWriter();
+      m_writer->Create();
+    }
   }
 
   return m_file != NULL;
@@ -218,6 +372,39 @@ int CLog::GetLogLevel()
   return m_logLevel;
 }
 
+void CLog::SetComponentLogLevel(int component, int level)
+{
+  int index = component >> LOGMASKBIT;
+  if (index <= 0 || index >= LOGCOMPONENT_COUNT)
+    return;
+
+  CSingleLock waitLock(critSec);
+  m_componentLevels[index] = level;
+  CLog::Log(LOGNOTICE, "Log level of component %d changed to %d", index, level);
+}
+
+bool CLog::IsLogLevelLogged(int loglevel)
+{
+#if defined(_DEBUG) || defined(PROFILE)
+  return true;
+#else
+  if (m_logLevel <= LOG_LEVEL_NONE)
+    return false;
+
+  int component = loglevel >> LOGMASKBIT;
+  if (component > 0 && component < LOGCOMPONENT_COUNT && m_componentLevels[component] >= 0)
+    return (loglevel & LOGMASK) >= m_componentLevels[component];
+
+  return m_logLevel > LOG_LEVEL_NORMAL || (loglevel & LOGMASK) >= LOGNOTICE;
+#endif
+}
+
+void CLog::SetMaxLogSize(int64_t size)
+{
+  CSingleLock waitLock(critSec);
+  m_maxSize = size;
+}
+
 void CLog::OutputDebugString(const std::string& line)
 {
 #if defined(_DEBUG) || defined(PROFILE)
@@ -25,6 +25,7 @@
 
 #include "commons/ilog.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
 #include "utils/GlobalsHandling.h"
 
 #ifdef __GNUC__
@@ -33,19 +34,44 @@
 #define ATTRIB_LOG_FORMAT
 #endif
 
+/*!
+ \brief Log a message only if its level is logged
+ Unlike CLog::Log() the arguments aren't evaluated and the message isn't
+ formatted at all if the level (and component) isn't logged.
+ */
+#define CLOG(loglevel, ...) \
+  do { if (CLog::IsLogLevelLogged(loglevel)) CLog::Log(loglevel, __VA_ARGS__); } while (0)
+
+class CThread;
+
 class CLog
 {
 public:
+  struct LogEntry;
 
   class CLogGlobals
   {
   public:
-    CLogGlobals() : m_file(NULL), m_repeatCount(0), m_repeatLogLevel(-1), m_logLevel(LOG_LEVEL_DEBUG) {}
+    CLogGlobals() : m_file(NULL), m_repeatCount(0), m_repeatLogLevel(-1), m_logLevel(LOG_LEVEL_DEBUG),
+                    m_queue(NULL), m_pending(0), m_writer(NULL), m_bytesWritten(0), m_maxSize(0)
+    {
+      for (int i = 0; i < LOGCOMPONENT_COUNT; i++)
+        m_componentLevels[i] = -1;
+    }
     FILE*       m_file;
     int         m_repeatCount;
     int         m_repeatLogLevel;
     std::string m_repeatLine;
     int         m_logLevel;
+    int         m_componentLevels[LOGCOMPONENT_COUNT];
+    LogEntry * volatile m_queue;   // messages waiting to be written, newest first
+    volatile long m_pending;
+    CEvent      m_queueEvent;
+    CThread*    m_writer;
+    std::string m_logFile;
+    std::string m_logFileOld;
+    int64_t     m_bytesWritten;
+    int64_t     m_maxSize;
     CCriticalSection critSec;
   };
 
@@ -57,7 +83,26 @@ public:
   static bool Init(const char* path);
   static void SetLogLevel(int level);
   static int  GetLogLevel();
+  /*!
+   \brief Set the level of the messages logged for a component
+   \param component one of the LOG* components
+   \param level the lowest level (LOGDEBUG - LOGNONE) that is logged, -1 to follow the global log level
+   */
+  static void SetComponentLogLevel(int component, int level);
+  static bool IsLogLevelLogged(int loglevel);
+  /*!
+   \brief Set the size at which the log file is rotated to xbmc.old.log
+   \param size size in bytes, 0 to never rotate the log file
+   */
+  static void SetMaxLogSize(int64_t size);
+  /*!
+   \brief Write all queued messages to the log file
+   Messages are written by a background thread, this writes them right away.
+   */
+  static void Flush();
 private:
+  static void WriteEntry(LogEntry *entry);
+  static bool Rotate();
   static void OutputDebugString(const std::string& line);
 };
 
@@ -19,9 +19,45 @@
  */
 
 #include "utils/JSONVariantWriter.h"
+#include "utils/StringUtils.h"
 
 #include "gtest/gtest.h"
 
+// a library response like VideoLibrary.GetMovies returns it
+static void FillMovies(CVariant &result, unsigned int count)
+{
+  result["limits"]["start"] = 0;
+  result["limits"]["end"] = count;
+  result["limits"]["total"] = count;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    CVariant movie;
+    movie["movieid"] = i;
+    movie["label"] = StringUtils::Format("Movie %u", i);
+    movie["title"] = StringUtils::Format("Movie %u", i);
+    movie["originaltitle"] = StringUtils::Format("Original title of movie %u", i);
+    movie["year"] = 1950 + i % 60;
+    movie["rating"] = (i % 100) / 10.0;
+    movie["votes"] = StringUtils::Format("%u", i * 7);
+    movie["runtime"] = 5400 + i % 3600;
+    movie["playcount"] = i % 3;
+    movie["plot"] = "A fairly long plot outline which is there to give every movie a realistic amount of text to be escaped and written.";
+    movie["tagline"] = "Some tagline";
+    movie["mpaa"] = "Rated PG-13";
+    movie["file"] = StringUtils::Format("smb://server/share/movies/Movie %u (%u)/movie.mkv", i, 1950 + i % 60);
+    movie["thumbnail"] = StringUtils::Format("image://smb%%3a%%2f%%2fserver%%2fshare%%2fmovies%%2fMovie %u%%2fposter.jpg/", i);
+    movie["fanart"] = StringUtils::Format("image://smb%%3a%%2f%%2fserver%%2fshare%%2fmovies%%2fMovie %u%%2ffanart.jpg/", i);
+    movie["dateadded"] = "2012-11-01 20:15:00";
+    movie["lastplayed"] = "";
+    movie["genre"].push_back("Drama");
+    movie["genre"].push_back("Thriller");
+    movie["director"].push_back("Some Director");
+    movie["studio"].push_back("Some Studio");
+    result["movies"].push_back(movie);
+  }
+}
+
+
 TEST(TestJSONVariantWriter, Write)
 {
   CVariant variant;
@@ -30,3 +66,24 @@ TEST(TestJSONVariantWriter, Write)
   str = CJSONVariantWriter::Write(variant, false);
   EXPECT_STREQ("null\n", str.c_str());
 }
+
+TEST(TestJSONVariantWriter, WriteStream)
+{
+  for (int compact = 0; compact < 2; compact++)
+  {
+    CVariant expected, variant;
+    FillMovies(expected, 50);
+    FillMovies(variant, 50);
+    std::string str = CJSONVariantWriter::Write(expected, compact != 0);
+
+    // small chunks make sure the output is split in many places
+    std::string output;
+    CJSONWriterStringStream stream(output);
+    EXPECT_TRUE(CJSONVariantWriter::Write(variant, compact != 0, stream, 64));
+    EXPECT_STREQ(str.c_str(), output.c_str());
+
+    // everything written has been released
+    EXPECT_TRUE(variant["movies"][0].isNull());
+    EXPECT_TRUE(variant["movies"][49].isNull());
+  }
+}
@@ -19,10 +19,13 @@
  */
 
 #include "utils/SortUtils.h"
+#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+
 TEST(TestSortUtils, Sort_SortBy)
 {
   SortItems items;
@@ -131,3 +134,145 @@ TEST(TestSortUtils, GetFieldsForSorting)
   EXPECT_EQ(FieldTrackNumber, *it);
   EXPECT_EQ((unsigned int)4, fields.size());
 }
+
+TEST(TestSortUtils, Sort_NaturalOrder)
+{
+  const char *labels[] = { "Episode 10", "episode 9", "Episode 9b", "Episode 09a",
+                           "\xc3\x89pisode 1", "Episode", "[Episode]", "Episode 100000000000000001" };
+  const char *expected[] = { "[Episode]", "Episode", "episode 9", "Episode 09a",
+                             "Episode 9b", "Episode 10", "Episode 100000000000000001", "\xc3\x89pisode 1" };
+
+  SortItems items;
+  for (unsigned int i = 0; i < sizeof(labels) / sizeof(labels[0]); i++)
+  {
+    SortItem item;
+    item[FieldLabel] = labels[i];
+    items.push_back(item);
+  }
+
+  SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeNone, items);
+  for (unsigned int i = 0; i < items.size(); i++)
+    EXPECT_STREQ(expected[i], items[i][FieldLabel].asString().c_str());
+
+  SortUtils::Sort(SortByLabel, SortOrderDescending, SortAttributeNone, items);
+  for (unsigned int i = 0; i < items.size(); i++)
+    EXPECT_STREQ(expected[items.size() - i - 1], items[i][FieldLabel].asString().c_str());
+}
+
+TEST(TestSortUtils, Sort_MissingFolder)
+{
+  // folders only go first when both items say whether they are one
+  SortItems items;
+  SortItem item;
+  item[FieldLabel] = "c";
+  item[FieldFolder] = false;
+  items.push_back(item);
+  item[FieldLabel] = "b";
+  item[FieldFolder] = true;
+  items.push_back(item);
+  item.clear();
+  item[FieldLabel] = "a";
+  items.push_back(item);
+
+  SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeNone, items);
+  ASSERT_EQ(3U, items.size());
+  EXPECT_STREQ("a", items[0][FieldLabel].asString().c_str());
+  EXPECT_STREQ("b", items[1][FieldLabel].asString().c_str());
+  EXPECT_STREQ("c", items[2][FieldLabel].asString().c_str());
+
+  SortUtils::Sort(SortByLabel, SortOrderDescending, SortAttributeNone, items);
+  EXPECT_STREQ("b", items[0][FieldLabel].asString().c_str());
+  EXPECT_STREQ("c", items[1][FieldLabel].asString().c_str());
+  EXPECT_STREQ("a", items[2][FieldLabel].asString().c_str());
+}
+
+/* A synthetic library in random order: titles with articles, mixed case,
+ * non-ASCII letters and numbers of varying width, plus some folders and items
+ * sorted on top or bottom. */
+static void FillLibrary(SortItems &items, unsigned int count)
+{
+  static const char *words[] = { "The", "a", "Star", "wars", "Episode", "Alien", "alien",
+                                 "Zebra", "\xc3\xbc" "ber", "\xc3\x84rger", "(Extended)", "Part", "-" };
+  unsigned int seed = 42;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    std::string title;
+    for (unsigned int w = 0; w < 3; w++)
+    {
+      seed = seed * 1103515245 + 12345;
+      title += words[(seed >> 16) % (sizeof(words) / sizeof(words[0]))];
+      title += " ";
+    }
+    seed = seed * 1103515245 + 12345;
+    char number[16];
+    sprintf(number, (seed >> 16) % 2 ? "%u" : "%03u", (seed >> 17) % 200);
+    title += number;
+
+    SortItem item;
+    item[FieldId] = i;
+    item[FieldTitle] = title;
+    item[FieldFolder] = i % 50 == 0;
+    item[FieldSortSpecial] = i % 997 == 0 ? SortSpecialOnTop : (i % 991 == 0 ? SortSpecialOnBottom : SortSpecialNone);
+    items.push_back(item);
+  }
+}
+
+/* The ordering SortUtils documents, written against the item maps */
+static int CompareItems(const SortItem &left, const SortItem &right, bool handleFolder)
+{
+  int64_t leftSpecial = left.at(FieldSortSpecial).asInteger();
+  int64_t rightSpecial = right.at(FieldSortSpecial).asInteger();
+  if (leftSpecial != rightSpecial)
+    return leftSpecial == SortSpecialOnTop || rightSpecial == SortSpecialOnBottom ? -1 : 1;
+  if (leftSpecial != SortSpecialNone)
+    return 0;
+  if (handleFolder && left.at(FieldFolder).asBoolean() != right.at(FieldFolder).asBoolean())
+    return left.at(FieldFolder).asBoolean() ? -1 : 1;
+  return 2;
+}
+
+static bool ReferenceAscending(const SortItem &left, const SortItem &right)
+{
+  int result = CompareItems(left, right, true);
+  if (result != 2)
+    return result < 0;
+  return StringUtils::AlphaNumericCompare(left.at(FieldSort).asWideString().c_str(), right.at(FieldSort).asWideString().c_str()) < 0;
+}
+
+static bool ReferenceIgnoreFoldersDescending(const SortItem &left, const SortItem &right)
+{
+  int result = CompareItems(left, right, false);
+  if (result != 2)
+    return result < 0;
+  return StringUtils::AlphaNumericCompare(left.at(FieldSort).asWideString().c_str(), right.at(FieldSort).asWideString().c_str()) > 0;
+}
+
+static bool ById(const SortItem &left, const SortItem &right)
+{
+  return left.at(FieldId).asInteger() < right.at(FieldId).asInteger();
+}
+
+TEST(TestSortUtils, Sort_MatchesAlphaNumericCompare)
+{
+  SortItems items;
+  FillLibrary(items, 3000);
+  SortUtils::Sort(SortByTitle, SortOrderAscending, SortAttributeNone, items);
+
+  // the items keep their sort labels, so sorting them again by id and then
+  // with the reference ordering has to give the same list
+  SortItems reference = items;
+  std::sort(reference.begin(), reference.end(), ById);
+  std::stable_sort(reference.begin(), reference.end(), ReferenceAscending);
+  for (unsigned int i = 0; i < items.size(); i++)
+    EXPECT_EQ(reference[i][FieldId].asInteger(), items[i][FieldId].asInteger());
+
+  items.clear();
+  FillLibrary(items, 3000);
+  SortUtils::Sort(SortByTitle, SortOrderDescending, (SortAttribute)(SortAttributeIgnoreArticle | SortAttributeIgnoreFolders), items);
+
+  reference = items;
+  std::sort(reference.begin(), reference.end(), ById);
+  std::stable_sort(reference.begin(), reference.end(), ReferenceIgnoreFoldersDescending);
+  for (unsigned int i = 0; i < items.size(); i++)
+    EXPECT_EQ(reference[i][FieldId].asInteger(), items[i][FieldId].asInteger());
+}
@@ -22,6 +22,8 @@
 #include "utils/RegExp.h"
 #include "filesystem/File.h"
 #include "filesystem/SpecialProtocol.h"
+#include "threads/Thread.h"
+#include "utils/TimeUtils.h"
 
 #include "test/TestUtils.h"
 
@@ -38,6 +40,8 @@ protected:
     g_log_globalsRef->m_repeatCount = 0;
     g_log_globalsRef->m_repeatLogLevel = -1;
     g_log_globalsRef->m_logLevel = LOG_LEVEL_DEBUG;
+    for (int i = 0; i < LOGCOMPONENT_COUNT; i++)
+      g_log_globalsRef->m_componentLevels[i] = -1;
   }
 };
 
@@ -146,3 +150,157 @@ TEST_F(Testlog, SetLogLevel)
   CLog::Close();
   EXPECT_TRUE(XFILE::CFile::Delete(logfile));
 }
+
+#if !(defined(_DEBUG) || defined(PROFILE))
+TEST_F(Testlog, ComponentLogLevel)
+{
+  CLog::SetLogLevel(LOG_LEVEL_NORMAL);
+  EXPECT_FALSE(CLog::IsLogLevelLogged(LOGDEBUG));
+  EXPECT_FALSE(CLog::IsLogLevelLogged(LOGDEBUG | LOGDATABASE));
+  EXPECT_TRUE(CLog::IsLogLevelLogged(LOGERROR | LOGDATABASE));
+
+  CLog::SetComponentLogLevel(LOGDATABASE, LOGDEBUG);
+  EXPECT_FALSE(CLog::IsLogLevelLogged(LOGDEBUG));
+  EXPECT_TRUE(CLog::IsLogLevelLogged(LOGDEBUG | LOGDATABASE));
+  EXPECT_FALSE(CLog::IsLogLevelLogged(LOGDEBUG | LOGWEBSERVER));
+
+  CLog::SetLogLevel(LOG_LEVEL_DEBUG);
+  CLog::SetComponentLogLevel(LOGDATABASE, LOGNONE);
+  EXPECT_TRUE(CLog::IsLogLevelLogged(LOGDEBUG));
+  EXPECT_FALSE(CLog::IsLogLevelLogged(LOGERROR | LOGDATABASE));
+
+  CLog::SetComponentLogLevel(LOGDATABASE, -1);
+  EXPECT_TRUE(CLog::IsLogLevelLogged(LOGDEBUG | LOGDATABASE));
+}
+
+static int evaluated = 0;
+
+static int Evaluate()
+{
+  return ++evaluated;
+}
+
+TEST_F(Testlog, CLOG)
+{
+  // the arguments of messages below the level are never evaluated
+  evaluated = 0;
+  CLog::SetLogLevel(LOG_LEVEL_NORMAL);
+  CLOG(LOGDEBUG, "not logged %d", Evaluate());
+  CLOG(LOGDEBUG | LOGDATABASE, "not logged %d", Evaluate());
+  EXPECT_EQ(0, evaluated);
+
+  CLOG(LOGNOTICE, "logged %d", Evaluate());
+  EXPECT_EQ(1, evaluated);
+
+  CLog::SetComponentLogLevel(LOGDATABASE, LOGDEBUG);
+  CLOG(LOGDEBUG | LOGDATABASE, "logged %d", Evaluate());
+  CLOG(LOGDEBUG, "not logged %d", Evaluate());
+  EXPECT_EQ(2, evaluated);
+
+  CLog::SetLogLevel(LOG_LEVEL_NONE);
+  CLOG(LOGERROR, "not logged %d", Evaluate());
+  EXPECT_EQ(2, evaluated);
+
+  // and the macro is a single statement
+  CLog::SetLogLevel(LOG_LEVEL_DEBUG);
+  if (evaluated == 2)
+    CLOG(LOGDEBUG, "logged %d", Evaluate());
+  else
+    CLOG(LOGDEBUG, "not logged %d", Evaluate());
+  EXPECT_EQ(3, evaluated);
+}
+#endif
+
+class CLogTestWriter : public IRunnable
+{
+public:
+  CLogTestWriter(int level, unsigned int messages) : m_level(level), m_messages(messages), m_duration(0) { }
+
+  virtual void Run()
+  {
+    int64_t start = CurrentHostCounter();
+    for (unsigned int i = 0; i < m_messages; i++)
+      CLog::Log(m_level, "log writer test message %u from %p", i, (void *)this);
+    m_duration = CurrentHostCounter() - start;
+  }
+
+  int m_level;
+  unsigned int m_messages;
+  int64_t m_duration;
+};
+
+/* Logs from several threads at once and returns the mean time of a call */
+static double LogFromThreads(int level, unsigned int threadCount, unsigned int messages)
+{
+  std::vector<CLogTestWriter *> runners;
+  std::vector<CThread *> threads;
+  for (unsigned int i = 0; i < threadCount; i++)
+  {
+    runners.push_back(new CLogTestWriter(level, messages));
+    threads.push_back(new CThread(runners.back(), "LogTest"));
+    threads.back()->Create();
+  }
+
+  int64_t duration = 0;
+  for (unsigned int i = 0; i < threadCount; i++)
+  {
+    threads[i]->StopThread(true);
+    duration += runners[i]->m_duration;
+    delete threads[i];
+    delete runners[i];
+  }
+  return duration * 1000000000.0 / CurrentHostFrequency() / (threadCount * messages);
+}
+
+TEST_F(Testlog, Threads)
+{
+  CStdString logfile, logstring;
+  char buf[4096];
+  unsigned int bytesread;
+  XFILE::CFile file;
+
+  logfile = CSpecialProtocol::TranslatePath("special://temp/") + "xbmc.log";
+  EXPECT_TRUE(CLog::Init(CSpecialProtocol::TranslatePath("special://temp/")));
+
+  LogFromThreads(LOGNOTICE, 4, 500);
+  CLog::Close();
+
+  EXPECT_TRUE(file.Open(logfile));
+  while ((bytesread = file.Read(buf, sizeof(buf) - 1)) > 0)
+  {
+    buf[bytesread] = '\0';
+    logstring.append(buf);
+  }
+  file.Close();
+
+  // every message is written exactly once
+  size_t count = 0;
+  for (size_t pos = logstring.find("log writer test message"); pos != std::string::npos; pos = logstring.find("log writer test message", pos + 1))
+    count++;
+  EXPECT_EQ(4U * 500U, count);
+
+  EXPECT_TRUE(XFILE::CFile::Delete(logfile));
+}
+
+TEST_F(Testlog, Rotate)
+{
+  CStdString logfile, logfileOld;
+
+  logfile = CSpecialProtocol::TranslatePath("special://temp/") + "xbmc.log";
+  logfileOld = CSpecialProtocol::TranslatePath("special://temp/") + "xbmc.old.log";
+  EXPECT_TRUE(CLog::Init(CSpecialProtocol::TranslatePath("special://temp/")));
+  CLog::SetMaxLogSize(4096);
+
+  for (unsigned int i = 0; i < 200; i++)
+    CLog::Log(LOGNOTICE, "rotate test message %u", i);
+  CLog::Close();
+  CLog::SetMaxLogSize(0);
+
+  EXPECT_TRUE(XFILE::CFile::Exists(logfileOld));
+  struct __stat64 info;
+  EXPECT_EQ(0, XFILE::CFile::Stat(logfile, &info));
+  EXPECT_GE(4096, info.st_size);
+
+  EXPECT_TRUE(XFILE::CFile::Delete(logfile));
+  EXPECT_TRUE(XFILE::CFile::Delete(logfileOld));
+}
@@ -464,7 +464,6 @@ void CVideoDatabase::CreateViews()
 //********************************************************************************************************************************
 int CVideoDatabase::GetPathId(const CStdString& strPath)
 {
-  CStdString strSQL;
   try
   {
     int idPath=-1;
@@ -477,17 +476,17 @@ int CVideoDatabase::GetPathId(const CStdString& strPath)
 
     URIUtils::AddSlashAtEnd(strPath1);
 
-    strSQL=PrepareSQL("select idPath from path where strPath='%s'",strPath1.c_str());
-    m_pDS->query(strSQL.c_str());
-    if (!m_pDS->eof())
-      idPath = m_pDS->fv("path.idPath").get_asInt();
+    Statement *stmt = GetStatement("select idPath from path where strPath=?");
+    StatementReset resetStmt(stmt);
+    stmt->bind(1, strPath1);
+    if (stmt->step())
+      idPath = stmt->getInt(0);
 
-    m_pDS->close();
     return idPath;
   }
   catch (...)
   {
-    CLog::Log(LOGERROR, "%s unable to getpath (%s)", __FUNCTION__, strSQL.c_str());
+    CLog::Log(LOGERROR, "%s unable to getpath (%s)", __FUNCTION__, strPath.c_str());
   }
   return -1;
 }
@@ -629,7 +628,6 @@ bool CVideoDatabase::GetSubPaths(const CStdString &basepath, vector< pair<int,st
 
 int CVideoDatabase::AddPath(const CStdString& strPath, const CStdString &strDateAdded /*= "" */)
 {
-  CStdString strSQL;
   try
   {
     int idPath = GetPathId(strPath);
@@ -645,18 +643,21 @@ int CVideoDatabase::AddPath(const CStdString& strPath, const CStdString &strDate
 
     URIUtils::AddSlashAtEnd(strPath1);
 
+    Statement *stmt = GetStatement("insert into path (idPath, strPath, strContent, strScraper, dateAdded) values (NULL,?,'','',?)");
+    StatementReset resetStmt(stmt);
+    stmt->bind(1, strPath1);
     // only set dateadded if we got one
     if (!strDateAdded.empty())
-      strSQL=PrepareSQL("insert into path (idPath, strPath, strContent, strScraper, dateAdded) values (NULL,'%s','','', '%s')", strPath1.c_str(), strDateAdded.c_str());
+      stmt->bind(2, strDateAdded);
     else
-      strSQL=PrepareSQL("insert into path (idPath, strPath, strContent, strScraper) values (NULL,'%s','','')", strPath1.c_str());
-    m_pDS->exec(strSQL.c_str());
+      stmt->bindNull(2);
+    stmt->exec();
     idPath = (int)m_pDS->lastinsertid();
     return idPath;
   }
   catch (...)
   {
-    CLog::Log(LOGERROR, "%s unable to addpath (%s)", __FUNCTION__, strSQL.c_str());
+    CLog::Log(LOGERROR, "%s unable to addpath (%s)", __FUNCTION__, strPath.c_str());
   }
   return -1;
 }
@@ -683,10 +684,34 @@ bool CVideoDatabase::GetPathHash(const CStdString &path, CStdString &hash)
   return false;
 }
 
+bool CVideoDatabase::GetPathHash(const CStdString &path, CStdString &hash, bool &noUpdate, bool &exclude)
+{
+  noUpdate = exclude = false;
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString strSQL=PrepareSQL("select strHash,noUpdate,exclude from path where strPath='%s'", path.c_str());
+    m_pDS->query(strSQL.c_str());
+    if (m_pDS->num_rows() == 0)
+      return false;
+    hash = m_pDS->fv("strHash").get_asString();
+    noUpdate = m_pDS->fv("noUpdate").get_asBool();
+    exclude = m_pDS->fv("exclude").get_asBool();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s) failed", __FUNCTION__, path.c_str());
+  }
+
+  return false;
+}
+
 //********************************************************************************************************************************
 int CVideoDatabase::AddFile(const CStdString& strFileNameAndPath)
 {
-  CStdString strSQL = "";
   try
   {
     int idFile;
@@ -700,25 +725,25 @@ int CVideoDatabase::AddFile(const CStdString& strFileNameAndPath)
     if (idPath < 0)
       return -1;
 
-    CStdString strSQL=PrepareSQL("select idFile from files where strFileName='%s' and idPath=%i", strFileName.c_str(),idPath);
-
-    m_pDS->query(strSQL.c_str());
-    if (m_pDS->num_rows() > 0)
-    {
-      idFile = m_pDS->fv("idFile").get_asInt() ;
-      m_pDS->close();
-      return idFile;
-    }
-    m_pDS->close();
-
-    strSQL=PrepareSQL("insert into files (idFile, idPath, strFileName) values(NULL, %i, '%s')", idPath, strFileName.c_str());
-    m_pDS->exec(strSQL.c_str());
+    Statement *select = GetStatement("select idFile from files where strFileName=? and idPath=?");
+    StatementReset resetSelect(select);
+    select->bind(1, strFileName);
+    select->bind(2, idPath);
+    if (select->step())
+      return select->getInt(0);
+    select->reset();
+
+    Statement *insert = GetStatement("insert into files (idFile, idPath, strFileName) values(NULL, ?, ?)");
+    StatementReset resetInsert(insert);
+    insert->bind(1, idPath);
+    insert->bind(2, strFileName);
+    insert->exec();
     idFile = (int)m_pDS->lastinsertid();
     return idFile;
   }
   catch (...)
   {
-    CLog::Log(LOGERROR, "%s unable to addfile (%s)", __FUNCTION__, strSQL.c_str());
+    CLog::Log(LOGERROR, "%s unable to addfile (%s)", __FUNCTION__, strFileNameAndPath.c_str());
   }
   return -1;
 }
@@ -919,15 +944,11 @@ int CVideoDatabase::GetFileId(const CStdString& strFilenameAndPath)
     int idPath = GetPathId(strPath);
     if (idPath >= 0)
     {
-      CStdString strSQL;
-      strSQL=PrepareSQL("select idFile from files where strFileName='%s' and idPath=%i", strFileName.c_str(),idPath);
-      m_pDS->query(strSQL.c_str());
-      if (m_pDS->num_rows() > 0)
-      {
-        int idFile = m_pDS->fv("files.idFile").get_asInt();
-        m_pDS->close();
-        return idFile;
-      }
+      Statement *stmt = GetStatement("select idFile from files where strFileName=? and idPath=?");
+      StatementReset resetStmt(stmt);
+      stmt->bind(1, strFileName);
+      stmt->bind(2, idPath);
+      return stmt->step() ? stmt->getInt(0) : -1;
     }
   }
   catch (...)
@@ -2336,33 +2357,54 @@ void CVideoDatabase::SetStreamDetailsForFileId(const CStreamDetails& details, in
   try
   {
     BeginTransaction();
-    m_pDS->exec(PrepareSQL("DELETE FROM streamdetails WHERE idFile = %i", idFile));
-
+    Statement *stmt = GetStatement("DELETE FROM streamdetails WHERE idFile = ?");
+    StatementReset resetDelete(stmt);
+    stmt->bind(1, idFile);
+    stmt->exec();
+
+    Statement *video = GetStatement("INSERT INTO streamdetails "
+      "(idFile, iStreamType, strVideoCodec, fVideoAspect, iVideoWidth, iVideoHeight, iVideoDuration) "
+      "VALUES (?,?,?,?,?,?,?)");
+    StatementReset resetVideo(video);
     for (int i=1; i<=details.GetVideoStreamCount(); i++)
     {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
-        "(idFile, iStreamType, strVideoCodec, fVideoAspect, iVideoWidth, iVideoHeight, iVideoDuration) "
-        "VALUES (%i,%i,'%s',%f,%i,%i,%i)",
-        idFile, (int)CStreamDetail::VIDEO,
-        details.GetVideoCodec(i).c_str(), details.GetVideoAspect(i),
-        details.GetVideoWidth(i), details.GetVideoHeight(i), details.GetVideoDuration(i)));
-    }
+      video->reset();
+      video->bind(1, idFile);
+      video->bind(2, (int)CStreamDetail::VIDEO);
+      video->bind(3, details.GetVideoCodec(i));
+      video->bind(4, (double)details.GetVideoAspect(i));
+      video->bind(5, details.GetVideoWidth(i));
+      video->bind(6, details.GetVideoHeight(i));
+      video->bind(7, details.GetVideoDuration(i));
+      video->exec();
+    }
+
+    Statement *audio = GetStatement("INSERT INTO streamdetails "
+      "(idFile, iStreamType, strAudioCodec, iAudioChannels, strAudioLanguage) "
+      "VALUES (?,?,?,?,?)");
+    StatementReset resetAudio(audio);
     for (int i=1; i<=details.GetAudioStreamCount(); i++)
     {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
-        "(idFile, iStreamType, strAudioCodec, iAudioChannels, strAudioLanguage) "
-        "VALUES (%i,%i,'%s',%i,'%s')",
-        idFile, (int)CStreamDetail::AUDIO,
-        details.GetAudioCodec(i).c_str(), details.GetAudioChannels(i),
-        details.GetAudioLanguage(i).c_str()));
+      audio->reset();
+      audio->bind(1, idFile);
+      audio->bind(2, (int)CStreamDetail::AUDIO);
+      audio->bind(3, details.GetAudioCodec(i));
+      audio->bind(4, details.GetAudioChannels(i));
+      audio->bind(5, details.GetAudioLanguage(i));
+      audio->exec();
     }
+
+    Statement *subtitle = GetStatement("INSERT INTO streamdetails "
+      "(idFile, iStreamType, strSubtitleLanguage) "
+      "VALUES (?,?,?)");
+    StatementReset resetSubtitle(subtitle);
     for (int i=1; i<=details.GetSubtitleStreamCount(); i++)
     {
-      m_pDS->exec(PrepareSQL("INSERT INTO streamdetails "
-        "(idFile, iStreamType, strSubtitleLanguage) "
-        "VALUES (%i,%i,'%s')",
-        idFile, (int)CStreamDetail::SUBTITLE,
-        details.GetSubtitleLanguage(i).c_str()));
+      subtitle->reset();
+      subtitle->bind(1, idFile);
+      subtitle->bind(2, (int)CStreamDetail::SUBTITLE);
+      subtitle->bind(3, details.GetSubtitleLanguage(i));
+      subtitle->exec();
     }
 
     // update the runtime information, if empty
@@ -37,7 +37,7 @@ class CGUIDialogProgressBarHandle;
 namespace dbiplus
 {
   class field_value;
-  typedef std::vector<field_value> sql_record;
+  class sql_record;
 }
 
 #ifndef my_offsetof
@@ -528,6 +528,15 @@ public:
   // scanning hashes and paths scanned
   bool SetPathHash(const CStdString &path, const CStdString &hash);
   bool GetPathHash(const CStdString &path, CStdString &hash);
+
+  /*! \brief Retrieve the hash of a path along with its scan flags in a single query
+   \param path the path to look up
+   \param hash [out] the stored hash of the path
+   \param noUpdate [out] whether the path is set to not be updated
+   \param exclude [out] whether the path is excluded from the library
+   \return true if the path is in the database, false otherwise
+   */
+  bool GetPathHash(const CStdString &path, CStdString &hash, bool &noUpdate, bool &exclude);
   bool GetPaths(std::set<CStdString> &paths);
   bool GetPathsForTvShow(int idShow, std::set<int>& paths);
 
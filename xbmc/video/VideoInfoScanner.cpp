@@ -50,13 +50,59 @@
 #include "TextureCache.h"
 #include "GUIUserMessages.h"
 #include "URL.h"
+#include "threads/Event.h"
+#include "utils/JobManager.h"
 
 using namespace std;
 using namespace XFILE;
 using namespace ADDON;
 
+// folders read ahead per prefetch thread
+#define PREFETCH_WINDOW_PER_THREAD 2
+
 namespace VIDEO
 {
+  class CPrefetchedDirectory
+  {
+  public:
+    CPrefetchedDirectory(const CStdString &path, const CStdString &dbHash)
+    : m_path(path), m_dbHash(dbHash), m_listed(false)
+    {
+    }
+
+    CStdString    m_path;
+    CStdString    m_dbHash;   ///< hash stored in the database when the folder was queued
+    CStdString    m_fastHash; ///< hash of the modification time of the folder
+    CStdString    m_hash;     ///< hash of the listing, only computed if the fast hash changed
+    CFileItemList m_items;    ///< the (stacked) listing, only fetched if the fast hash changed
+    bool          m_listed;
+    CEvent        m_done;
+  };
+
+  class CDirectoryPrefetchJob : public CJob
+  {
+  public:
+    CDirectoryPrefetchJob(const CPrefetchedDirectoryPtr &directory) : m_directory(directory) { }
+
+    virtual const char *GetType() const { return "directoryprefetch"; }
+
+    virtual bool DoWork()
+    {
+      m_directory->m_fastHash = CVideoInfoScanner::GetFastHash(m_directory->m_path);
+      if (m_directory->m_fastHash.IsEmpty() || m_directory->m_fastHash != m_directory->m_dbHash)
+      {
+        CDirectory::GetDirectory(m_directory->m_path, m_directory->m_items, g_settings.m_videoExtensions);
+        m_directory->m_items.Stack();
+        CVideoInfoScanner::GetPathHash(m_directory->m_items, m_directory->m_hash);
+        m_directory->m_listed = true;
+      }
+      m_directory->m_done.Set();
+      return true;
+    }
+
+  private:
+    CPrefetchedDirectoryPtr m_directory;
+  };
 
   CVideoInfoScanner::CVideoInfoScanner() : CThread("CVideoInfoScanner")
   {
@@ -68,6 +114,11 @@ namespace VIDEO
     m_itemCount = 0;
     m_bClean = false;
     m_scanAll = false;
+    m_prefetchQueue = NULL;
+    m_statDirectories = 0;
+    m_statUnchanged = 0;
+    m_statListed = 0;
+    m_statItems = 0;
   }
 
   CVideoInfoScanner::~CVideoInfoScanner()
@@ -99,6 +150,13 @@ namespace VIDEO
       m_currentItem = 0;
       m_itemCount = -1;
 
+      m_statDirectories = 0;
+      m_statUnchanged = 0;
+      m_statListed = 0;
+      m_statItems = 0;
+      if (g_advancedSettings.m_videoScannerDirectoryThreads > 0)
+        m_prefetchQueue = new CJobQueue(false, g_advancedSettings.m_videoScannerDirectoryThreads, CJob::PRIORITY_NORMAL);
+
       SetPriority(GetMinPriority());
 
       // Database operations should not be canceled
@@ -146,11 +204,18 @@ namespace VIDEO
 
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Finished scan. Scanning for video info took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      CLog::Log(LOGNOTICE, "VideoInfoScanner: Checked %u folders (%u unchanged, %u listed with %u items), %.1f folders/s",
+                m_statDirectories, m_statUnchanged, m_statListed, m_statItems, tick ? m_statDirectories * 1000.0f / tick : 0.0f);
     }
     catch (...)
     {
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
     }
+
+    delete m_prefetchQueue; // cancels any outstanding prefetches
+    m_prefetchQueue = NULL;
+    m_prefetched.clear();
+    m_prefetchPending.clear();
     
     m_bRunning = false;
     ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnScanFinished");
@@ -240,6 +305,9 @@ namespace VIDEO
     bool foundDirectly = false;
     bool bSkip = false;
 
+    // take the folder out of the read-ahead window before any early return
+    CPrefetchedDirectoryPtr prefetched = TakePrefetched(strDirectory);
+
     SScanSettings settings;
     ScraperPtr info = m_database.GetScraperForPath(strDirectory, settings, foundDirectly);
     CONTENT_TYPE content = info ? info->Content() : CONTENT_NONE;
@@ -264,19 +332,43 @@ namespace VIDEO
         m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(str), info->Name().c_str()));
       }
 
-      CStdString fastHash = GetFastHash(strDirectory);
-      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.IsEmpty() && fastHash == dbHash)
+      m_statDirectories++;
+      if (prefetched && !WaitForPrefetch(prefetched))
+        prefetched.reset();
+      CStdString fastHash;
+      if (prefetched)
+      { // the hash was read from the database when the folder was queued
+        fastHash = prefetched->m_fastHash;
+        dbHash = prefetched->m_dbHash;
+      }
+      else
+      {
+        fastHash = GetFastHash(strDirectory);
+        m_database.GetPathHash(strDirectory, dbHash);
+      }
+      if (!fastHash.IsEmpty() && fastHash == dbHash)
       { // fast hashes match - no need to process anything
         CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change (fasthash)", strDirectory.c_str());
         hash = fastHash;
         bSkip = true;
+        m_statUnchanged++;
       }
       if (!bSkip)
       { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, g_settings.m_videoExtensions);
-        items.Stack();
-        // compute hash
-        GetPathHash(items, hash);
+        if (prefetched && prefetched->m_listed)
+        {
+          items.Assign(prefetched->m_items);
+          hash = prefetched->m_hash;
+        }
+        else
+        {
+          CDirectory::GetDirectory(strDirectory, items, g_settings.m_videoExtensions);
+          items.Stack();
+          // compute hash
+          GetPathHash(items, hash);
+        }
+        m_statListed++;
+        m_statItems += items.Size();
         if (hash != dbHash && !hash.IsEmpty())
         {
           if (dbHash.IsEmpty())
@@ -356,6 +448,9 @@ namespace VIDEO
     if (m_handle)
       OnDirectoryScanned(strDirectory);
 
+    if (settings.recurse > 0 && (content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS))
+      PrefetchDirectories(items);
+
     for (int i = 0; i < items.Size(); ++i)
     {
       CFileItemPtr pItem = items[i];
@@ -1671,7 +1766,7 @@ namespace VIDEO
     return items.GetFolderCount() == 0;
   }
 
-  CStdString CVideoInfoScanner::GetFastHash(const CStdString &directory) const
+  CStdString CVideoInfoScanner::GetFastHash(const CStdString &directory)
   {
     struct __stat64 buffer;
     if (XFILE::CFile::Stat(directory, &buffer) == 0)
@@ -1689,6 +1784,79 @@ namespace VIDEO
     return "";
   }
 
+  void CVideoInfoScanner::PrefetchDirectories(const CFileItemList &items)
+  {
+    if (!m_prefetchQueue)
+      return;
+
+    // subfolders are scanned before the remaining siblings of their parent
+    deque<CStdString>::iterator pos = m_prefetchPending.begin();
+    for (int i = 0; i < items.Size(); ++i)
+    {
+      const CFileItemPtr pItem = items[i];
+      if (!pItem->m_bIsFolder || pItem->IsParentFolder() || pItem->IsPlayList())
+        continue;
+
+      pos = m_prefetchPending.insert(pos, pItem->GetPath());
+      ++pos;
+    }
+    FillPrefetchWindow();
+  }
+
+  void CVideoInfoScanner::FillPrefetchWindow()
+  {
+    if (!m_prefetchQueue)
+      return;
+
+    unsigned int window = PREFETCH_WINDOW_PER_THREAD * g_advancedSettings.m_videoScannerDirectoryThreads;
+    while (m_prefetched.size() < window && !m_prefetchPending.empty())
+    {
+      CStdString path = m_prefetchPending.front();
+      m_prefetchPending.pop_front();
+
+      // don't list folders that DoScan() will skip.  Only movies and music videos are prefetched.
+      if (CUtil::ExcludeFileOrFolder(path, g_advancedSettings.m_moviesExcludeFromScanRegExps))
+        continue;
+
+      // the database is only accessed from the scanner thread
+      CStdString dbHash;
+      bool noUpdate, exclude;
+      m_database.GetPathHash(path, dbHash, noUpdate, exclude);
+      if (exclude || (noUpdate && !m_scanAll))
+        continue;
+
+      CPrefetchedDirectoryPtr directory(new CPrefetchedDirectory(path, dbHash));
+      m_prefetched[path] = directory;
+      m_prefetchQueue->AddJob(new CDirectoryPrefetchJob(directory));
+    }
+  }
+
+  CPrefetchedDirectoryPtr CVideoInfoScanner::TakePrefetched(const CStdString &directory)
+  {
+    CPrefetchedDirectoryPtr prefetched;
+    map<CStdString, CPrefetchedDirectoryPtr>::iterator it = m_prefetched.find(directory);
+    if (it != m_prefetched.end())
+    {
+      prefetched = it->second;
+      m_prefetched.erase(it);
+    }
+    else if (!m_prefetchPending.empty() && m_prefetchPending.front() == directory)
+      m_prefetchPending.pop_front(); // reached before a slot in the window was free
+
+    FillPrefetchWindow();
+    return prefetched;
+  }
+
+  bool CVideoInfoScanner::WaitForPrefetch(const CPrefetchedDirectoryPtr &prefetched)
+  {
+    while (!prefetched->m_done.WaitMSec(100))
+    {
+      if (m_bStop)
+        return false;
+    }
+    return true;
+  }
+
   void CVideoInfoScanner::GetSeasonThumbs(const CVideoInfoTag &show, map<int, map<string, string> > &seasonArt, const vector<string> &artTypes, bool useLocal)
   {
     bool lookForThumb = find(artTypes.begin(), artTypes.end(), "thumb") == artTypes.end();
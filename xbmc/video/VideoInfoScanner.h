@@ -22,10 +22,13 @@
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
 #include "NfoFile.h"
+#include <boost/shared_ptr.hpp>
+#include <deque>
 
 class CRegExp;
 class CFileItem;
 class CFileItemList;
+class CJobQueue;
 
 namespace VIDEO
 {
@@ -48,6 +51,10 @@ namespace VIDEO
                   INFO_NOT_FOUND,
                   INFO_ADDED };
 
+  class CPrefetchedDirectory;
+  class CDirectoryPrefetchJob;
+  typedef boost::shared_ptr<CPrefetchedDirectory> CPrefetchedDirectoryPtr;
+
   class CVideoInfoScanner : CThread
   {
   public:
@@ -121,6 +128,8 @@ namespace VIDEO
     static std::string GetFanart(CFileItem *pItem, bool useLocal);
 
   protected:
+    friend class CDirectoryPrefetchJob;
+
     virtual void Process();
     bool DoScan(const CStdString& strDirectory);
 
@@ -188,7 +197,35 @@ namespace VIDEO
      \param directory folder to hash
      \return the hash of the folder of the form "fast<datetime>"
      */
-    CStdString GetFastHash(const CStdString &directory) const;
+    static CStdString GetFastHash(const CStdString &directory);
+
+    /*! \brief Read the subfolders of a listing ahead of the scan
+     Queues the fast hash, and if that has changed the listing and its hash, of each
+     subfolder that will be recursed into on the prefetch workers, so that the
+     filesystem round trips overlap with the scan of the preceding folders.
+     The subfolders are queued in scan order and only a small window of them is
+     outstanding at any time, see FillPrefetchWindow.
+     \param items the directory listing whose subfolders are prefetched
+     \sa TakePrefetched
+     */
+    void PrefetchDirectories(const CFileItemList &items);
+
+    /*! \brief Hand the next pending folders to the prefetch workers until the window is full
+     Folders that are excluded or set to not be updated are dropped without being listed.
+     */
+    void FillPrefetchWindow();
+
+    /*! \brief Remove a folder from the read-ahead window and refill the window
+     \param directory the folder about to be scanned
+     \return the prefetched state, which may still be in progress, or an empty pointer if the folder was not prefetched
+     \sa WaitForPrefetch
+     */
+    CPrefetchedDirectoryPtr TakePrefetched(const CStdString &directory);
+
+    /*! \brief Wait for a prefetch taken with TakePrefetched to complete
+     \return true once the prefetch is done, false if the scan was stopped first
+     */
+    bool WaitForPrefetch(const CPrefetchedDirectoryPtr &prefetched);
 
     /*! \brief Decide whether a folder listing could use the "fast" hash
      Fast hashing can be done whenever the folder contains no scannable subfolders, as the
@@ -238,6 +275,16 @@ namespace VIDEO
     std::set<CStdString> m_pathsToCount;
     std::set<int> m_pathsToClean;
     CNfoFile m_nfoReader;
+
+    CJobQueue *m_prefetchQueue;
+    std::map<CStdString, CPrefetchedDirectoryPtr> m_prefetched; ///< outstanding prefetches, at most PREFETCH_WINDOW_PER_THREAD per thread
+    std::deque<CStdString> m_prefetchPending;                    ///< folders waiting for a slot in the window, in scan order
+
+    // scan throughput statistics
+    unsigned int m_statDirectories;
+    unsigned int m_statUnchanged;
+    unsigned int m_statListed;
+    unsigned int m_statItems;
   };
 }
 
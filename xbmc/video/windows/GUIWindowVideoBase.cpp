@@ -70,6 +70,7 @@
 #include "Autorun.h"
 #include "URL.h"
 #include "utils/EdenVideoArtUpdater.h"
+#include "TextureCache.h"
 #include "GUIInfoManager.h"
 #include "utils/GroupUtils.h"
 #include "filesystem/File.h"
@@ -611,13 +612,9 @@ bool CGUIWindowVideoBase::ShowIMDB(CFileItem *item, const ScraperPtr &info2)
       // show dialog that we're downloading the movie info
 
       // clear artwork and invalidate hashes
-      CTextureDatabase db;
-      if (db.Open())
-      {
-        for (CGUIListItem::ArtMap::const_iterator i = item->GetArt().begin(); i != item->GetArt().end(); ++i)
-          db.InvalidateCachedTexture(i->second);
-        db.Close();
-      }
+      CGUIListItem::ArtMap art = item->GetArt();
+      for (CGUIListItem::ArtMap::const_iterator i = art.begin(); i != art.end(); ++i)
+        CTextureCache::Get().InvalidateCachedImage(i->second);
       item->ClearArt();
 
       CFileItemList list;
@@ -28,6 +28,10 @@
 #include "EGLNativeTypeRaspberryPI.h"
 #include "EGLWrapper.h"
 
+#ifndef EGL_BUFFER_AGE_EXT
+#define EGL_BUFFER_AGE_EXT 0x313D
+#endif
+
 #define CheckError() m_result = eglGetError(); if(m_result != EGL_SUCCESS) CLog::Log(LOGERROR, "EGL error in %s: %x",__FUNCTION__, m_result);
 
 CEGLWrapper::CEGLWrapper()
@@ -284,6 +288,39 @@ bool CEGLWrapper::GetSurfaceSize(EGLDisplay display, EGLSurface surface, EGLint
   return true;
 }
 
+bool CEGLWrapper::GetBufferAge(EGLDisplay display, EGLSurface surface, EGLint *age)
+{
+  if (!age || display == EGL_NO_DISPLAY || surface == EGL_NO_SURFACE)
+    return false;
+
+  // requires EGL_EXT_buffer_age
+  return eglQuerySurface(display, surface, EGL_BUFFER_AGE_EXT, age) && *age >= 0;
+}
+
+bool CEGLWrapper::IsBufferPreserved(EGLDisplay display, EGLSurface surface)
+{
+  EGLint behavior = EGL_BUFFER_DESTROYED;
+  if (display == EGL_NO_DISPLAY || surface == EGL_NO_SURFACE)
+    return false;
+
+  if (!eglQuerySurface(display, surface, EGL_SWAP_BEHAVIOR, &behavior))
+    return false;
+
+  return behavior == EGL_BUFFER_PRESERVED;
+}
+
+bool CEGLWrapper::SetBufferPreserved(EGLDisplay display, EGLSurface surface)
+{
+  if (display == EGL_NO_DISPLAY || surface == EGL_NO_SURFACE)
+    return false;
+
+  // requires a config with EGL_SWAP_BEHAVIOR_PRESERVED_BIT in its surface type
+  EGLBoolean status;
+  status = eglSurfaceAttrib(display, surface, EGL_SWAP_BEHAVIOR, EGL_BUFFER_PRESERVED);
+  CheckError();
+  return status;
+}
+
 bool CEGLWrapper::BindContext(EGLDisplay display, EGLSurface surface, EGLContext context)
 {
   EGLBoolean status;
@@ -372,9 +409,9 @@ void CEGLWrapper::SwapBuffers(EGLDisplay display, EGLSurface surface)
 
 bool CEGLWrapper::GetConfigAttrib(EGLDisplay display, EGLConfig config, EGLint attribute, EGLint *value)
 {
-  if (display == EGL_NO_DISPLAY || !config || !attribute)
-    return eglGetConfigAttrib(display, config, attribute, value);
-  return false;
+  if (display == EGL_NO_DISPLAY || !config || !attribute || !value)
+    return false;
+  return eglGetConfigAttrib(display, config, attribute, value);
 }
 #endif
 
@@ -50,6 +50,9 @@ public:
   bool CreateContext(EGLDisplay display, EGLConfig config, EGLint *contextAttrs, EGLContext *context);
   bool CreateSurface(EGLDisplay display, EGLConfig config, EGLSurface *surface);
   bool GetSurfaceSize(EGLDisplay display, EGLSurface surface, EGLint *width, EGLint *height);
+  bool GetBufferAge(EGLDisplay display, EGLSurface surface, EGLint *age);
+  bool IsBufferPreserved(EGLDisplay display, EGLSurface surface);
+  bool SetBufferPreserved(EGLDisplay display, EGLSurface surface);
   bool BindContext(EGLDisplay display, EGLSurface surface, EGLContext context);
   bool BindAPI(EGLint type);
   bool ReleaseContext(EGLDisplay display);
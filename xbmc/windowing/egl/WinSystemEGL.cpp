@@ -44,6 +44,9 @@ CWinSystemEGL::CWinSystemEGL() : CWinSystemBase()
 
   m_egl               = NULL;
   m_iVSyncMode        = 0;
+
+  m_bufferAgeSupported = false;
+  m_bufferPreserved    = false;
 }
 
 CWinSystemEGL::~CWinSystemEGL()
@@ -107,7 +110,24 @@ bool CWinSystemEGL::InitWindowSystem()
         EGL_NONE
   };
 
-  if (!m_egl->ChooseConfig(m_display, configAttrs, &m_config))
+  m_extensions = m_egl->GetExtensions(m_display);
+  m_bufferAgeSupported = m_extensions.find(" EGL_EXT_buffer_age ") != std::string::npos;
+  CLog::Log(LOGDEBUG, "%s: Buffer age is %s", __FUNCTION__, m_bufferAgeSupported ? "supported" : "not supported");
+
+  // without buffer age, dirty region rendering needs the back buffer to be
+  // preserved across swaps. Prefer a config that can, but don't require it.
+  bool haveConfig = false;
+  if (!m_bufferAgeSupported)
+  {
+    EGLint *surfaceType = configAttrs;
+    while (*surfaceType != EGL_SURFACE_TYPE)
+      surfaceType += 2;
+    surfaceType[1] = EGL_WINDOW_BIT | EGL_SWAP_BEHAVIOR_PRESERVED_BIT;
+    haveConfig = m_egl->ChooseConfig(m_display, configAttrs, &m_config);
+    surfaceType[1] = EGL_WINDOW_BIT;
+  }
+
+  if (!haveConfig && !m_egl->ChooseConfig(m_display, configAttrs, &m_config))
   {
     CLog::Log(LOGERROR, "%s: Could not find a compatible configuration",__FUNCTION__);
     return false;
@@ -123,7 +143,6 @@ bool CWinSystemEGL::InitWindowSystem()
     CreateWindow(temp);
   }
 
-  m_extensions = m_egl->GetExtensions(m_display);
   return CWinSystemBase::InitWindowSystem();
 }
 
@@ -190,6 +209,15 @@ bool CWinSystemEGL::CreateWindow(RESOLUTION_INFO &res)
     return false;
   }
 
+  // ask for a preserved back buffer when the config allows it, see InitWindowSystem()
+  EGLint surfaceType = 0;
+  if (!m_bufferAgeSupported &&
+      m_egl->GetConfigAttrib(m_display, m_config, EGL_SURFACE_TYPE, &surfaceType) &&
+      (surfaceType & EGL_SWAP_BEHAVIOR_PRESERVED_BIT))
+    m_egl->SetBufferPreserved(m_display, m_surface);
+
+  m_bufferPreserved = m_egl->IsBufferPreserved(m_display, m_surface);
+  CLog::Log(LOGDEBUG, "%s: Back buffer is %s across swaps", __FUNCTION__, m_bufferPreserved ? "preserved" : "not preserved");
   m_bWindowCreated = true;
 
   return true;
@@ -384,6 +412,23 @@ bool CWinSystemEGL::IsExtSupported(const char* extension)
   return (m_extensions.find(name) != std::string::npos || CRenderSystemGLES::IsExtSupported(extension));
 }
 
+int CWinSystemEGL::GetBufferAge()
+{
+  if (m_bufferAgeSupported)
+  {
+    EGLint age = 0;
+    if (m_egl->GetBufferAge(m_display, m_surface, &age))
+      return age;
+    return 0;
+  }
+
+  // a preserved back buffer always holds the previous frame
+  if (m_bufferPreserved)
+    return 1;
+
+  return -1;
+}
+
 bool CWinSystemEGL::PresentRenderImpl(const CDirtyRegionList &dirty)
 {
   m_egl->SwapBuffers(m_display, m_surface);
@@ -58,6 +58,8 @@ public:
   virtual bool  Support3D(int width, int height, uint32_t mode)     const;
   virtual bool  ClampToGUIDisplayLimits(int &width, int &height);
 
+  virtual int   GetBufferAge();
+
 protected:
   virtual bool  PresentRenderImpl(const CDirtyRegionList &dirty);
   virtual void  SetVSyncImpl(bool enable);
@@ -76,6 +78,8 @@ protected:
 
   CEGLWrapper           *m_egl;
   std::string           m_extensions;
+  bool                  m_bufferAgeSupported;
+  bool                  m_bufferPreserved;
 };
 
 XBMC_GLOBAL_REF(CWinSystemEGL,g_Windowing);